@@ -0,0 +1,65 @@
+/**
+ * Tests that an insert batch containing documents which fail to insert reports exactly those
+ * documents, and inserts all the others, when the server falls back from inserting the batch as a
+ * group to retrying parts of it.
+ *
+ * @tags: [assumes_unsharded_collection]
+ */
+(function() {
+"use strict";
+
+const coll = db.insert_batch_partial_failure;
+const kNumDocs = 20;
+
+function makeDocs(dupKeyPositions) {
+    let docs = [];
+    for (let i = 0; i < kNumDocs; ++i) {
+        docs.push({_id: i, x: dupKeyPositions.includes(i) ? 0 : i + 1});
+    }
+    return docs;
+}
+
+function reset() {
+    coll.drop();
+    assert.commandWorked(coll.createIndex({x: 1}, {unique: true}));
+    assert.commandWorked(coll.insert({_id: -1, x: 0}));
+}
+
+// Two documents in different halves of an unordered batch collide with an existing document. Each
+// of them is reported at its position and every other document is inserted.
+reset();
+let res = coll.runCommand("insert", {documents: makeDocs([3, 15]), ordered: false});
+assert.eq(kNumDocs - 2, res.n, tojson(res));
+assert.eq([3, 15], res.writeErrors.map(e => e.index), tojson(res));
+res.writeErrors.forEach(e => assert.eq(ErrorCodes.DuplicateKey, e.code, tojson(res)));
+assert.eq(kNumDocs - 1, coll.find().itcount());
+assert.eq(0, coll.find({_id: {$in: [3, 15]}}).itcount());
+
+// Several failures in the same half.
+reset();
+res = coll.runCommand("insert", {documents: makeDocs([1, 2, 7, 8]), ordered: false});
+assert.eq(kNumDocs - 4, res.n, tojson(res));
+assert.eq([1, 2, 7, 8], res.writeErrors.map(e => e.index), tojson(res));
+assert.eq(kNumDocs - 3, coll.find().itcount());
+
+// An ordered batch stops at the first failure, having inserted every document before it.
+reset();
+res = coll.runCommand("insert", {documents: makeDocs([13]), ordered: true});
+assert.eq(13, res.n, tojson(res));
+assert.eq([13], res.writeErrors.map(e => e.index), tojson(res));
+assert.eq(14, coll.find().itcount());
+assert.eq(0, coll.find({_id: {$gte: 13}}).itcount());
+
+// Two documents of the same batch collide with each other in the unique index. The first of them is
+// inserted and the second one is reported.
+coll.drop();
+assert.commandWorked(coll.createIndex({x: 1}, {unique: true}));
+let docs = makeDocs([]);
+docs[9].x = docs[4].x;
+res = coll.runCommand("insert", {documents: docs, ordered: false});
+assert.eq(kNumDocs - 1, res.n, tojson(res));
+assert.eq([9], res.writeErrors.map(e => e.index), tojson(res));
+assert.eq(ErrorCodes.DuplicateKey, res.writeErrors[0].code, tojson(res));
+assert.eq(1, coll.find({_id: 4}).itcount());
+assert.eq(0, coll.find({_id: 9}).itcount());
+})();
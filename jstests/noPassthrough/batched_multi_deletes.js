@@ -0,0 +1,135 @@
+/**
+ * Tests that multi-deletes performed by the batched delete stage are logged as 'applyOps' entries
+ * which secondaries apply and change streams unwind into delete events, that deletes from
+ * collections which record pre-images are not batched, and that a batch never spans more than one
+ * 'applyOps' entry.
+ *
+ * @tags: [
+ *   requires_replication,
+ *   requires_snapshot_read,
+ *   uses_change_streams,
+ * ]
+ */
+(function() {
+"use strict";
+
+const rst = new ReplSetTest({
+    nodes: 2,
+    nodeOptions: {
+        setParameter: {batchUserMultiDeletes: true, batchedDeletesTargetBatchDocs: 10},
+    }
+});
+rst.startSet();
+rst.initiate();
+
+const primary = rst.getPrimary();
+const secondary = rst.getSecondary();
+const testDB = primary.getDB("test");
+const oplog = primary.getDB("local").oplog.rs;
+const kNumDocs = 35;
+
+function getLatestOplogTimestamp() {
+    return oplog.find().sort({$natural: -1}).limit(1).next().ts;
+}
+
+function insertDocs(coll) {
+    const docs = [];
+    for (let i = 0; i < kNumDocs; ++i) {
+        docs.push({_id: i, x: i});
+    }
+    assert.commandWorked(coll.insert(docs));
+}
+
+// Deletes from a regular collection are batched.
+const coll = testDB.batched;
+insertDocs(coll);
+const changeStream = coll.watch();
+const startTime = getLatestOplogTimestamp();
+
+assert.commandWorked(coll.deleteMany({}));
+assert.eq(0, coll.find().itcount());
+
+// The deletes are logged as 'applyOps' entries of at most 10 operations each, rather than as
+// individual delete entries.
+const applyOpsEntries =
+    oplog.find({ts: {$gt: startTime}, op: "c", "o.applyOps.ns": coll.getFullName()}).toArray();
+assert.eq(Math.ceil(kNumDocs / 10), applyOpsEntries.length, tojson(applyOpsEntries));
+applyOpsEntries.forEach((entry) => {
+    assert.lte(entry.o.applyOps.length, 10, tojson(entry));
+    entry.o.applyOps.forEach((op) => assert.eq("d", op.op, tojson(entry)));
+});
+assert.eq(0, oplog.find({ts: {$gt: startTime}, op: "d", ns: coll.getFullName()}).itcount());
+
+// Change streams report one delete event per document.
+const deletedIds = [];
+for (let i = 0; i < kNumDocs; ++i) {
+    assert.soon(() => changeStream.hasNext());
+    const event = changeStream.next();
+    assert.eq("delete", event.operationType, tojson(event));
+    deletedIds.push(event.documentKey._id);
+}
+assert.sameMembers(Array.from({length: kNumDocs}, (_, i) => i), deletedIds);
+changeStream.close();
+
+// The secondary applies the batches.
+rst.awaitReplication();
+assert.eq(0, secondary.getDB("test").batched.find().itcount());
+
+// Deletes from a collection which records pre-images are logged individually, along with their
+// pre-images.
+assert.commandWorked(testDB.createCollection("preImages", {recordPreImages: true}));
+const preImagesColl = testDB.preImages;
+insertDocs(preImagesColl);
+const preImagesStartTime = getLatestOplogTimestamp();
+
+assert.commandWorked(preImagesColl.deleteMany({}));
+const preImagesNs = preImagesColl.getFullName();
+assert.eq(0,
+          oplog.find({ts: {$gt: preImagesStartTime}, op: "c", "o.applyOps.ns": preImagesNs})
+              .itcount());
+assert.eq(kNumDocs,
+          oplog.find({ts: {$gt: preImagesStartTime}, op: "d", ns: preImagesNs}).itcount());
+
+rst.awaitReplication();
+assert.eq(0, secondary.getDB("test").preImages.find().itcount());
+
+// A batch whose deletes would not fit in one 'applyOps' entry is cut short, so that each entry is
+// committed in a storage transaction of its own, at the timestamp of that entry.
+const largeColl = testDB.largeIds;
+const kNumLargeDocs = 10;
+const largeIdPadding = "x".repeat(2 * 1024 * 1024);
+for (let i = 0; i < kNumLargeDocs; ++i) {
+    assert.commandWorked(largeColl.insert({_id: i + largeIdPadding}));
+}
+const largeStartTime = getLatestOplogTimestamp();
+
+assert.commandWorked(largeColl.deleteMany({}));
+assert.eq(0, largeColl.find().itcount());
+
+const largeNs = largeColl.getFullName();
+const largeEntries = oplog.find({ts: {$gt: largeStartTime}, op: "c", "o.applyOps.ns": largeNs})
+                         .sort({$natural: 1})
+                         .toArray();
+assert.gt(largeEntries.length, 1, tojson(largeEntries.map((entry) => entry.ts)));
+let numLargeDocsLeft = kNumLargeDocs;
+largeEntries.forEach((entry) => {
+    assert.lte(Object.bsonsize(entry), 16 * 1024 * 1024 + 16 * 1024, tojson(entry.ts));
+    numLargeDocsLeft -= entry.o.applyOps.length;
+
+    // Reading at the timestamp of the entry sees exactly the deletes logged up to it.
+    const res = assert.commandWorked(testDB.runCommand({
+        aggregate: largeColl.getName(),
+        pipeline: [{$count: "count"}],
+        cursor: {},
+        readConcern: {level: "snapshot", atClusterTime: entry.ts},
+    }));
+    const count = res.cursor.firstBatch.length ? res.cursor.firstBatch[0].count : 0;
+    assert.eq(numLargeDocsLeft, count, tojson(entry.ts));
+});
+assert.eq(0, numLargeDocsLeft);
+
+rst.awaitReplication();
+assert.eq(0, secondary.getDB("test").largeIds.find().itcount());
+
+rst.stopSet();
+})();
@@ -0,0 +1,93 @@
+/**
+ * Tests the recording of pre- and post-images in the change stream images collection for
+ * collections with the 'recordChangeStreamImages' option: the images are keyed by the timestamp of
+ * their oplog entry, deletes no longer log their pre-image to the oplog, images which do not fit in
+ * one document are counted and skipped, and the images expire through TTL.
+ *
+ * @tags: [uses_change_streams, requires_replication]
+ */
+(function() {
+"use strict";
+
+const kExpireAfterSeconds = 5;
+const rst = new ReplSetTest({
+    nodes: 1,
+    nodeOptions: {
+        setParameter:
+            {changeStreamImagesExpireAfterSeconds: kExpireAfterSeconds, ttlMonitorSleepSecs: 1}
+    }
+});
+rst.startSet();
+rst.initiate();
+
+const primary = rst.getPrimary();
+const testDB = primary.getDB(jsTestName());
+const oplog = primary.getDB("local").oplog.rs;
+const imagesColl = primary.getDB("config").system.changeStreamImages;
+
+const coll = testDB.coll;
+assert.commandWorked(testDB.createCollection(coll.getName(), {recordChangeStreamImages: true}));
+
+const csCursor = coll.watch([], {fullDocumentBeforeChange: "whenAvailable"});
+
+assert.commandWorked(coll.insert([{_id: 0, a: 0}, {_id: 1, a: 1}]));
+assert.commandWorked(coll.update({_id: 0}, {$set: {a: 10}}));
+assert.commandWorked(coll.remove({_id: 1}));
+
+// The images of each write are recorded under the timestamp of its oplog entry.
+const updateEntry = oplog.findOne({ns: coll.getFullName(), op: "u"});
+const deleteEntry = oplog.findOne({ns: coll.getFullName(), op: "d"});
+assert.neq(null, updateEntry);
+assert.neq(null, deleteEntry);
+
+const updateImages = imagesColl.findOne({ts: updateEntry.ts});
+assert.neq(null, updateImages, imagesColl.find().toArray());
+assert.eq({_id: 0, a: 0}, updateImages.preImage);
+assert.eq({_id: 0, a: 10}, updateImages.postImage);
+
+const deleteImages = imagesColl.findOne({ts: deleteEntry.ts});
+assert.neq(null, deleteImages, imagesColl.find().toArray());
+assert.eq({_id: 1, a: 1}, deleteImages.preImage);
+assert(!deleteImages.hasOwnProperty("postImage"), deleteImages);
+
+// The pre-image of the delete is not logged to the oplog.
+assert(!deleteEntry.hasOwnProperty("preImageOpTime"), deleteEntry);
+assert.eq(0, oplog.find({op: "n", o: {_id: 1, a: 1}}).itcount());
+
+// The images collection is ordered by timestamp.
+assert.eq([updateEntry.ts, deleteEntry.ts], imagesColl.find().toArray().map(doc => doc.ts));
+
+// Change streams see the recorded pre-images.
+const events = [];
+assert.soon(() => {
+    while (csCursor.hasNext()) {
+        events.push(csCursor.next());
+    }
+    return events.length === 4;
+});
+assert.eq("update", events[2].operationType, events);
+assert.eq({_id: 0, a: 0}, events[2].fullDocumentBeforeChange, events);
+assert.eq("delete", events[3].operationType, events);
+assert.eq({_id: 1, a: 1}, events[3].fullDocumentBeforeChange, events);
+csCursor.close();
+
+// Images which do not fit in one document are skipped, and counted.
+const getOversizeSkipped = () =>
+    assert.commandWorked(primary.adminCommand({serverStatus: 1}))
+        .metrics.changeStreamImages.oversizeSkipped;
+const oversizeSkippedBefore = getOversizeSkipped();
+const kLargeString = "x".repeat(9 * 1024 * 1024);
+assert.commandWorked(coll.insert({_id: 2, s: kLargeString}));
+assert.commandWorked(coll.update({_id: 2}, {$set: {s: kLargeString + "y"}}));
+assert.eq(oversizeSkippedBefore + 1, getOversizeSkipped());
+const largeUpdateEntry = oplog.findOne({ns: coll.getFullName(), op: "u", "o2._id": 2});
+assert.neq(null, largeUpdateEntry);
+assert.eq(null, imagesColl.findOne({ts: largeUpdateEntry.ts}));
+
+// The images expire once they are older than 'changeStreamImagesExpireAfterSeconds'.
+assert.soon(() => imagesColl.find().itcount() === 0,
+            () => "images did not expire: " + tojson(imagesColl.find({}, {ts: 1}).toArray()),
+            10 * kExpireAfterSeconds * 1000);
+
+rst.stopSet();
+})();
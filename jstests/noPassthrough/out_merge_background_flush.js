@@ -0,0 +1,116 @@
+/**
+ * Tests $out and $merge with internalDocumentSourceWriterBackgroundFlush enabled, under which the
+ * batches are written by a background thread. Checks that the batches are written on behalf of the
+ * users running the aggregation, and that interrupting the aggregation also interrupts the batch
+ * being written.
+ *
+ * @tags: [
+ *   sbe_incompatible,
+ * ]
+ */
+(function() {
+"use strict";
+
+load("jstests/libs/fail_point_util.js");
+
+const conn = MongoRunner.runMongod(
+    {auth: "", setParameter: {internalDocumentSourceWriterBackgroundFlush: true}});
+assert.neq(null, conn, "mongod was unable to start up");
+
+const adminDB = conn.getDB("admin");
+adminDB.createUser({user: "admin", pwd: "pwd", roles: ["root"]});
+assert(adminDB.auth("admin", "pwd"));
+
+// The user runs its aggregations on a connection of its own, while this one stays authenticated as
+// an administrator to manage the failpoints.
+const kDBName = "out_merge_background_flush";
+const testDB = conn.getDB(kDBName);
+testDB.createUser({user: "writer", pwd: "pwd", roles: ["readWrite"]});
+
+// Large enough documents that the output is split into several batches.
+const kNumDocs = 40;
+const kLargeString = "x".repeat(1024 * 1024);
+const inputColl = testDB.inputColl;
+const bulk = inputColl.initializeUnorderedBulkOp();
+for (let i = 0; i < kNumDocs; ++i) {
+    bulk.insert({_id: i, s: kLargeString});
+}
+assert.commandWorked(bulk.execute());
+
+const userConn = new Mongo(conn.host);
+const userDB = userConn.getDB(kDBName);
+assert(userDB.auth("writer", "pwd"));
+
+// Every batch is written, in order, whichever the stage.
+userDB.inputColl.aggregate([{$out: "outColl"}]);
+assert.eq(kNumDocs, userDB.outColl.find().itcount());
+
+userDB.inputColl.aggregate([{$project: {s: 0}}, {$merge: {into: "outColl"}}]);
+assert.eq(kNumDocs, userDB.outColl.find({s: {$exists: false}}).itcount());
+
+function runAggregateInParallel(pipeline, comment) {
+    return startParallelShell(`
+        const testDB = db.getSiblingDB("${kDBName}");
+        assert(testDB.auth("writer", "pwd"));
+        const res = testDB.runCommand({
+            aggregate: "inputColl",
+            pipeline: ${tojson(pipeline)},
+            comment: "${comment}",
+            cursor: {}
+        });
+        assert.commandFailedWithCode(res, ErrorCodes.Interrupted);
+    `, conn.port);
+}
+
+function testKillOp(pipeline, comment) {
+    const fp = configureFailPoint(conn, "hangDuringBatchInsert", {shouldCheckForInterrupt: true});
+
+    const awaitShell = runAggregateInParallel(pipeline, comment);
+    fp.wait();
+
+    // The batch being written belongs to the user running the aggregation, so that the user sees
+    // it among its own operations.
+    assert.soon(() => userDB.getSiblingDB("admin")
+                          .aggregate([
+                              {$currentOp: {allUsers: false}},
+                              {$match: {failpointMsg: "hangDuringBatchInsert"}}
+                          ])
+                          .itcount() === 1);
+
+    const aggOps = userDB.getSiblingDB("admin")
+                       .aggregate([
+                           {$currentOp: {allUsers: false}},
+                           {$match: {"command.comment": comment}}
+                       ])
+                       .toArray();
+    assert.eq(1, aggOps.length, aggOps);
+    assert.commandWorked(userDB.killOp(aggOps[0].opid));
+
+    // Killing the aggregation also kills the batch being written, while the failpoint is still
+    // enabled.
+    assert.soon(() => userDB.getSiblingDB("admin")
+                          .aggregate([
+                              {$currentOp: {allUsers: false}},
+                              {$match: {failpointMsg: "hangDuringBatchInsert"}}
+                          ])
+                          .itcount() === 0);
+    awaitShell();
+    fp.off();
+}
+
+testKillOp([{$out: "killedOutColl"}], "out_background_flush_killop");
+testKillOp([{$merge: {into: "killedMergeColl"}}], "merge_background_flush_killop");
+
+// A batch written in the background is still bound by the deadline of the aggregation.
+const fp = configureFailPoint(conn, "hangDuringBatchInsert", {shouldCheckForInterrupt: true});
+assert.commandFailedWithCode(userDB.runCommand({
+    aggregate: "inputColl",
+    pipeline: [{$merge: {into: "timedOutColl"}}],
+    maxTimeMS: 1000,
+    cursor: {}
+}),
+                             ErrorCodes.MaxTimeMSExpired);
+fp.off();
+
+MongoRunner.stopMongod(conn);
+})();
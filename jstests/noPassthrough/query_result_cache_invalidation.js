@@ -0,0 +1,44 @@
+/**
+ * Tests that writes to a collection with the 'cacheQueryResults' option invalidate its cached
+ * query results, including writes made while the option was turned off.
+ */
+(function() {
+"use strict";
+
+const conn = MongoRunner.runMongod();
+const testDB = conn.getDB("test");
+const coll = testDB.query_result_cache_invalidation;
+
+function cacheStats() {
+    return assert.commandWorked(testDB.adminCommand({serverStatus: 1})).queryResultCache;
+}
+
+function findIds() {
+    return coll.find({}, {_id: 1}).sort({_id: 1}).toArray().map(doc => doc._id);
+}
+
+assert.commandWorked(testDB.createCollection(coll.getName(), {cacheQueryResults: true}));
+assert.commandWorked(coll.insert([{_id: 0}, {_id: 1}]));
+
+// The second run of the same query is served from the cache.
+assert.eq([0, 1], findIds());
+const hits = cacheStats().hits;
+assert.eq([0, 1], findIds());
+assert.eq(hits + 1, cacheStats().hits);
+
+// A write makes the cached result unreachable.
+assert.commandWorked(coll.insert({_id: 2}));
+assert.eq([0, 1, 2], findIds());
+assert.commandWorked(coll.remove({_id: 0}));
+assert.eq([1, 2], findIds());
+
+// Writes to a collection without the option do not invalidate anything, so they may go unseen by
+// the cache. Turning the option back on must not bring back the results cached before them.
+assert.eq([1, 2], findIds());
+assert.commandWorked(testDB.runCommand({collMod: coll.getName(), cacheQueryResults: false}));
+assert.commandWorked(coll.insert({_id: 3}));
+assert.commandWorked(testDB.runCommand({collMod: coll.getName(), cacheQueryResults: true}));
+assert.eq([1, 2, 3], findIds());
+
+MongoRunner.stopMongod(conn);
+})();
@@ -0,0 +1,61 @@
+// Test that the TTL monitor deletes expired documents with several workers, splitting a TTL index
+// into ranges, and while rate limited. Also checks the per-collection progress it reports.
+(function() {
+"use strict";
+
+const runner = MongoRunner.runMongod({
+    setParameter: {
+        ttlMonitorSleepSecs: 1,
+        ttlMonitorWorkers: 4,
+        ttlMonitorIndexRangePartitions: 4,
+    }
+});
+const db = runner.getDB("test");
+
+const numDocs = 1000;
+const now = new Date();
+const colls = [db.ttl_parallel_a, db.ttl_parallel_b];
+for (let coll of colls) {
+    coll.drop();
+    assert.commandWorked(coll.createIndex({x: 1}, {expireAfterSeconds: 0}));
+
+    const bulk = coll.initializeUnorderedBulkOp();
+    for (let i = 0; i < numDocs; i++) {
+        // Spread the expired documents over a day so that every range gets some of them.
+        bulk.insert({x: new Date(now.getTime() - i * 86 * 1000)});
+    }
+    // Not expired yet.
+    bulk.insert({x: new Date(now.getTime() + 24 * 60 * 60 * 1000)});
+    assert.commandWorked(bulk.execute());
+}
+
+assert.soon(() => colls.every(coll => coll.find().itcount() === 1),
+            "TTL monitor didn't delete the expired documents");
+
+const ttlStats = () => assert.commandWorked(db.serverStatus({ttl: 1})).ttl;
+assert.soon(() => {
+    const stats = ttlStats();
+    return colls.every(coll => {
+        const collStats = stats.collections[coll.getFullName()];
+        return collStats && collStats.deletedDocuments === numDocs && collStats.backlogSecs === 0;
+    });
+}, () => "Unexpected TTL stats: " + tojson(ttlStats()));
+
+// Deletion is paced when a deletion rate is set.
+assert.commandWorked(db.adminCommand({setParameter: 1, ttlMonitorMaxDeletesPerSecond: 200}));
+const throttledColl = db.ttl_parallel_throttled;
+throttledColl.drop();
+assert.commandWorked(throttledColl.createIndex({x: 1}, {expireAfterSeconds: 0}));
+const bulk = throttledColl.initializeUnorderedBulkOp();
+for (let i = 0; i < numDocs; i++) {
+    bulk.insert({x: now});
+}
+assert.commandWorked(bulk.execute());
+
+const throttledMillis = db.serverStatus().metrics.ttl.throttledMillis;
+assert.soon(() => throttledColl.find().itcount() === 0,
+            "TTL monitor didn't delete the expired documents while rate limited");
+assert.gt(db.serverStatus().metrics.ttl.throttledMillis, throttledMillis);
+
+MongoRunner.stopMongod(runner);
+})();
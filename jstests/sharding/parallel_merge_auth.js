@@ -0,0 +1,81 @@
+/**
+ * Tests that mongos can merge the partial results of a $group on several threads when auth is
+ * enabled.
+ */
+(function() {
+"use strict";
+
+// The index consistency checker doesn't take into account that authentication is needed for
+// contacting the shards of this cluster.
+TestData.skipCheckingIndexesConsistentAcrossCluster = true;
+
+const st = new ShardingTest({shards: 2, mongos: 1, other: {keyFile: 'jstests/libs/key1'}});
+
+const adminDB = st.s.getDB('admin');
+adminDB.createUser({user: 'admin', pwd: 'pwd', roles: jsTest.adminUserRoles});
+assert(adminDB.auth('admin', 'pwd'));
+
+const testDB = st.s.getDB('test');
+const coll = testDB.parallel_merge_auth;
+assert.commandWorked(adminDB.runCommand({enableSharding: testDB.getName()}));
+st.ensurePrimaryShard(testDB.getName(), st.shard0.shardName);
+assert.commandWorked(adminDB.runCommand({shardCollection: coll.getFullName(), key: {_id: 1}}));
+assert.commandWorked(adminDB.runCommand({split: coll.getFullName(), middle: {_id: 500}}));
+assert.commandWorked(adminDB.runCommand(
+    {moveChunk: coll.getFullName(), find: {_id: 500}, to: st.shard1.shardName}));
+
+const bulk = coll.initializeUnorderedBulkOp();
+for (let i = 0; i < 1000; ++i) {
+    bulk.insert({_id: i, group: i % 37, val: i});
+}
+assert.commandWorked(bulk.execute());
+
+testDB.createUser({user: 'reader', pwd: 'pwd', roles: ['read']});
+assert.commandWorked(adminDB.runCommand({setParameter: 1, internalQueryMongosMergeParallelism: 4}));
+adminDB.logout();
+
+const pipeline = [{$group: {_id: '$group', total: {$sum: '$val'}, count: {$sum: 1}}}];
+const expected = {};
+for (let i = 0; i < 1000; ++i) {
+    expected[i % 37] = expected[i % 37] || {total: 0, count: 0};
+    expected[i % 37].total += i;
+    expected[i % 37].count += 1;
+}
+
+function checkResults(results) {
+    assert.eq(results.length, 37, tojson(results));
+    for (let result of results) {
+        assert.eq(expected[result._id].total, result.total, tojson(result));
+        assert.eq(expected[result._id].count, result.count, tojson(result));
+    }
+}
+
+// A user which is allowed to read the collection can run the merge on several threads, and the
+// workers establish the remote cursors on its behalf.
+assert(testDB.auth('reader', 'pwd'));
+checkResults(coll.aggregate(pipeline, {cursor: {batchSize: 5}}).toArray());
+
+// The merge runs within the deadline of each command which consumes its results. The workers keep
+// running for the getMores on the cursor, so the deadline of the aggregate does not apply to them.
+checkResults(coll.aggregate(pipeline, {maxTimeMS: 5 * 60 * 1000}).toArray());
+let res = assert.commandWorked(testDB.runCommand(
+    {aggregate: coll.getName(), pipeline: pipeline, cursor: {batchSize: 1}, maxTimeMS: 1000}));
+let results = res.cursor.firstBatch;
+sleep(2000);
+while (res.cursor.id != 0) {
+    res = assert.commandWorked(
+        testDB.runCommand({getMore: res.cursor.id, collection: coll.getName(), batchSize: 5}));
+    results = results.concat(res.cursor.nextBatch);
+}
+checkResults(results);
+testDB.logout();
+
+// Unauthenticated clients cannot use the merge to read the collection.
+assert.commandFailedWithCode(
+    testDB.runCommand({aggregate: coll.getName(), pipeline: pipeline, cursor: {}}),
+    ErrorCodes.Unauthorized);
+
+assert(adminDB.auth('admin', 'pwd'));
+assert.commandWorked(adminDB.runCommand({setParameter: 1, internalQueryMongosMergeParallelism: 1}));
+st.stop();
+})();
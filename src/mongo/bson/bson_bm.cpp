@@ -31,6 +31,7 @@
 
 #include "mongo/platform/basic.h"
 
+#include <algorithm>
 #include <benchmark/benchmark.h>
 
 #include "mongo/bson/bson_validate.h"
@@ -59,6 +60,20 @@ BSONObj buildSampleObj(long long unsigned int i) {
                        << "random" << random << "phone_no" << phone_no << "long_string"
                        << long_string);
 }
+
+/**
+ * Builds a flat document with 'numFields' int fields, named "field" followed by a zero-padded
+ * index and padded with 'x' to at least 'nameLen' characters.
+ */
+BSONObj buildWideObj(int numFields, size_t nameLen) {
+    BSONObjBuilder builder;
+    for (int i = 0; i < numFields; i++) {
+        std::string name = fmt::format("field{:04d}", i);
+        name.resize(std::max(name.size(), nameLen), 'x');
+        builder.append(name, i);
+    }
+    return builder.obj();
+}
 }  // namespace
 
 void BM_arrayBuilder(benchmark::State& state) {
@@ -112,8 +127,40 @@ void BM_validate(benchmark::State& state) {
     state.SetBytesProcessed(totalSize);
 }
 
+void BM_validateWide(benchmark::State& state) {
+    BSONObj obj = buildWideObj(state.range(0), state.range(1));
+    size_t totalSize = 0;
+
+    for (auto _ : state) {
+        benchmark::ClobberMemory();
+        benchmark::DoNotOptimize(validateBSON(obj.objdata(), obj.objsize()));
+        totalSize += obj.objsize();
+    }
+    state.SetBytesProcessed(totalSize);
+}
+
+void BM_getFieldWide(benchmark::State& state) {
+    BSONObj obj = buildWideObj(state.range(0), state.range(1));
+
+    // Look up the last field, which has to skip over all the others.
+    std::string name;
+    for (auto&& elem : obj)
+        name = elem.fieldName();
+    size_t totalFields = 0;
+
+    for (auto _ : state) {
+        benchmark::ClobberMemory();
+        benchmark::DoNotOptimize(obj.getField(name));
+        totalFields += state.range(0);
+    }
+    state.SetItemsProcessed(totalFields);
+}
+
 BENCHMARK(BM_arrayBuilder)->Ranges({{{1}, {100'000}}});
 BENCHMARK(BM_arrayLookup)->Ranges({{{1}, {100'000}}});
 BENCHMARK(BM_validate)->Ranges({{{1}, {1'000}}});
+// Arguments are the number of fields and the field name length, below and above a vector size.
+BENCHMARK(BM_validateWide)->Args({16, 8})->Args({256, 8})->Args({16, 32})->Args({256, 32});
+BENCHMARK(BM_getFieldWide)->Args({16, 8})->Args({256, 8})->Args({16, 32})->Args({256, 32});
 
 }  // namespace mongo
@@ -722,6 +722,24 @@ TEST(BSONObj, addFields) {
     ASSERT_BSONOBJ_EQ(output, BSON("p" << 1 << "q" << 1 << "b" << 2 << "d" << 2 << "c" << 2));
 }
 
+TEST(BSONObj, getFieldNameLengths) {
+    // Field names both shorter and longer than a vector load, where some are prefixes of others.
+    BSONObjBuilder builder;
+    for (int len = 0; len <= 40; ++len)
+        builder.append(std::string(len, 'f'), len);
+    BSONObj obj = builder.obj();
+
+    for (int len = 0; len <= 40; ++len) {
+        BSONElement elem = obj.getField(std::string(len, 'f'));
+        ASSERT_EQ(elem.fieldNameStringData(), std::string(len, 'f'));
+        ASSERT_EQ(elem.numberInt(), len);
+    }
+    ASSERT(obj.getField(std::string(41, 'f')).eoo());
+    ASSERT(obj.getField("g").eoo());
+    ASSERT(BSON("f" << 0).getField(std::string("f\0", 2)).eoo());
+    ASSERT(BSONObj().getField("").eoo());
+}
+
 TEST(BSONObj, sizeChecks) {
     auto generateBuffer = [](std::int32_t size) {
         std::vector<char> buffer(size);
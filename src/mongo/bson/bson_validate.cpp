@@ -35,6 +35,7 @@
 #include "mongo/bson/bson_depth.h"
 #include "mongo/bson/bson_validate.h"
 #include "mongo/bson/bsonelement.h"
+#include "mongo/db/fts/unicode/byte_vector.h"
 #include "mongo/logv2/log.h"
 
 namespace mongo {
@@ -150,6 +151,17 @@ private:
             // This is actually by far the hottest code in all of BSON validation.
             dassert(ptr < end);
             size_t len = 0;
+#ifdef MONGO_HAVE_FAST_BYTE_VECTOR
+            // Look for the NUL a vector at a time while a whole vector fits in the buffer. Most
+            // field names are shorter than a vector, so this usually takes a single load.
+            using unicode::ByteVector;
+            while (end - (ptr + len) >= ByteVector::size) {
+                if (auto mask = ByteVector::load(ptr + len).compareEQ(0).maskAny())
+                    return len + ByteVector::countInitialZeros(mask);
+                len += ByteVector::size;
+            }
+#endif
+            // The buffer ends with the EOO byte of the outermost object, so this always stops.
             while (ptr[len])
                 ++len;
             return len;
@@ -431,4 +431,19 @@ TEST(BSONValidateFast, MaxNestingDepth) {
     Status status = validateBSON(tooDeepNesting.objdata(), tooDeepNesting.objsize());
     ASSERT_EQ(status.code(), ErrorCodes::Overflow);
 }
+
+TEST(BSONValidateFast, FieldNameLengths) {
+    // Exercise field names that are shorter, as long as, and longer than a vector load, including
+    // ones that end right before the EOO byte.
+    for (size_t len = 0; len <= 40; ++len) {
+        std::string name(len, 'a');
+        BSONObj obj = BSON(name << 1 << "b" << BSON(name << "x") << name << BSONNULL);
+        ASSERT_OK(validateBSON(obj.objdata(), obj.objsize()));
+
+        // Overwriting the NUL terminating the last field name makes it run into the EOO byte.
+        std::string buffer(obj.objdata(), obj.objsize());
+        buffer[buffer.size() - 2] = 'a';
+        ASSERT_NOT_OK(validateBSON(buffer.data(), buffer.size()));
+    }
+}
 }  // namespace
@@ -37,6 +37,7 @@
 #include "mongo/bson/generator_extended_canonical_2_0_0.h"
 #include "mongo/bson/generator_extended_relaxed_2_0_0.h"
 #include "mongo/bson/generator_legacy_strict.h"
+#include "mongo/db/fts/unicode/byte_vector.h"
 #include "mongo/db/json.h"
 #include "mongo/logv2/log.h"
 #include "mongo/util/allocator.h"
@@ -561,15 +562,41 @@ void BSONObj::getFields(unsigned n, const char** fieldNames, BSONElement* fields
 }
 
 BSONElement BSONObj::getField(StringData name) const {
-    BSONObjIterator i(*this);
-    while (i.more()) {
-        BSONElement e = i.next();
-        // We know that e has a cached field length since BSONObjIterator::next internally
-        // called BSONElement::size on the BSONElement that it returned, so it is more
-        // efficient to re-use that information by obtaining the field name as a
-        // StringData, which will be pre-populated with the cached length.
+    const char* elem = objdata() + 4;
+
+#ifdef MONGO_HAVE_FAST_BYTE_VECTOR
+    using unicode::ByteVector;
+    if (name.size() < static_cast<size_t>(ByteVector::size)) {
+        // Load each field name once. The same vector gives the name length, which is needed to
+        // skip the element, and whether the name matches 'name'.
+        char padded[ByteVector::size] = {};
+        std::memcpy(padded, name.rawData(), name.size());
+        const auto target = ByteVector::load(padded);
+        const auto wanted = static_cast<ByteVector::Mask>((1u << name.size()) - 1);
+
+        const char* const end = objdata() + objsize();
+        while (*elem != EOO && end - (elem + 1) >= ByteVector::size) {
+            const auto bytes = ByteVector::load(elem + 1);
+            const auto nulMask = bytes.compareEQ(0).maskAny();
+            if (!nulMask)
+                break;  // A long field name: leave it to the loop below.
+
+            const auto nameLen = ByteVector::countInitialZeros(nulMask);
+            BSONElement e(elem, nameLen + 1, -1, BSONElement::CachedSizeTag());
+            if (nameLen == name.size() && (bytes.compareEQ(target).maskAny() & wanted) == wanted)
+                return e;
+            elem += e.size();
+        }
+    }
+#endif
+
+    while (*elem != EOO) {
+        BSONElement e(elem);
+        // Comparing the StringData with the cached field name length first is cheaper than a
+        // string compare.
         if (name == e.fieldNameStringData())
             return e;
+        elem += e.size();
     }
     return BSONElement();
 }
@@ -35,10 +35,14 @@
 namespace mongo {
 namespace mutablebson {
 
-// A damage event represents a change of size 'size' byte at starting at offset
+// A damage event represents a change of size 'targetSize' bytes starting at offset
 // 'target_offset' in some target buffer, with the replacement data being 'size' bytes of
 // data from the 'source' offset. The base addresses against which these offsets are to be
 // applied are not captured here.
+//
+// When 'size' and 'targetSize' differ the target grows or shrinks. The events of a DamageVector
+// are applied in order, and the 'targetOffset' of each event refers to the target as modified by
+// the events before it.
 struct DamageEvent {
     typedef uint32_t OffsetSizeType;
 
@@ -48,8 +52,11 @@ struct DamageEvent {
     // Offset of target data (in some buffer held elsewhere).
     OffsetSizeType targetOffset;
 
-    // Size of the damage region.
+    // Size of the replacement data.
     size_t size;
+
+    // Size of the damaged region of the target.
+    size_t targetSize;
 };
 
 typedef std::vector<DamageEvent> DamageVector;
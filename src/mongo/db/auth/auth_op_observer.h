@@ -173,6 +173,10 @@ public:
                        const NamespaceString& collectionName,
                        OptionalCollectionUUID uuid) final;
 
+    void onBatchedWriteStart(OperationContext* opCtx) final {}
+    void onBatchedWriteCommit(OperationContext* opCtx) final {}
+    void onBatchedWriteAbort(OperationContext* opCtx) final {}
+
     void onUnpreparedTransactionCommit(OperationContext* opCtx,
                                        std::vector<repl::ReplOperation>* statements,
                                        size_t numberOfPreImagesToWrite) final {}
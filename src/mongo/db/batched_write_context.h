@@ -0,0 +1,95 @@
+/**
+ *    Copyright (C) 2021-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#pragma once
+
+#include <vector>
+
+#include "mongo/db/operation_context.h"
+#include "mongo/db/repl/oplog_entry.h"
+
+namespace mongo {
+
+/**
+ * Buffers the replicated operations of a batch of writes performed in a single WriteUnitOfWork, so
+ * that the OpObserver can log them as one 'applyOps' oplog entry when the batch commits. See
+ * OpObserver::onBatchedWriteStart().
+ *
+ * Only one batch can be in progress on an operation at a time.
+ */
+class BatchedWriteContext {
+public:
+    static const OperationContext::Decoration<BatchedWriteContext> get;
+
+    BatchedWriteContext() = default;
+    BatchedWriteContext(const BatchedWriteContext&) = delete;
+    BatchedWriteContext& operator=(const BatchedWriteContext&) = delete;
+
+    bool writesAreBatched() const {
+        return _batchWrites;
+    }
+
+    void setWritesAreBatched(bool batched) {
+        _batchWrites = batched;
+    }
+
+    /**
+     * Adds an operation to the batch. All operations of a batch must agree on 'fromMigrate'.
+     */
+    void addBatchedOperation(const repl::ReplOperation& operation, bool fromMigrate);
+
+    std::vector<repl::ReplOperation>& getBatchedOperations() {
+        return _batchedOperations;
+    }
+
+    /**
+     * The sum of DurableOplogEntry::getDurableReplOperationSize() over the operations of the batch.
+     */
+    size_t getBatchedOperationsSizeBytes() const {
+        return _batchedOperationsSizeBytes;
+    }
+
+    /**
+     * Whether the operations of the batch are part of a chunk migration.
+     */
+    bool isFromMigrate() const {
+        return _fromMigrate;
+    }
+
+    void clearBatchedOperations();
+
+private:
+    bool _batchWrites = false;
+    bool _fromMigrate = false;
+    std::vector<repl::ReplOperation> _batchedOperations;
+    size_t _batchedOperationsSizeBytes = 0;
+};
+
+}  // namespace mongo
@@ -40,6 +40,7 @@
 #include "mongo/db/catalog/collection_options.h"
 #include "mongo/db/catalog/index_catalog.h"
 #include "mongo/db/catalog/index_key_validate.h"
+#include "mongo/db/change_stream_images.h"
 #include "mongo/db/client.h"
 #include "mongo/db/commands/create_gen.h"
 #include "mongo/db/concurrency/write_conflict_exception.h"
@@ -110,6 +111,8 @@ struct CollModRequest {
     boost::optional<ValidationActionEnum> collValidationAction;
     boost::optional<ValidationLevelEnum> collValidationLevel;
     bool recordPreImages = false;
+    boost::optional<bool> recordChangeStreamImages;
+    boost::optional<bool> cacheQueryResults;
 };
 
 StatusWith<CollModRequest> parseCollModRequest(OperationContext* opCtx,
@@ -291,6 +294,20 @@ StatusWith<CollModRequest> parseCollModRequest(OperationContext* opCtx,
             }
 
             cmr.recordPreImages = e.trueValue();
+        } else if (fieldName == "recordChangeStreamImages") {
+            if (isView) {
+                return {ErrorCodes::InvalidOptions,
+                        str::stream() << "option not supported on a view: " << fieldName};
+            }
+
+            cmr.recordChangeStreamImages = e.trueValue();
+        } else if (fieldName == "cacheQueryResults") {
+            if (isView) {
+                return {ErrorCodes::InvalidOptions,
+                        str::stream() << "option not supported on a view: " << fieldName};
+            }
+
+            cmr.cacheQueryResults = e.trueValue();
         } else if (fieldName == "clusteredIndex") {
             if (!nss.isTimeseriesBucketsCollection()) {
                 return Status(
@@ -586,6 +603,17 @@ Status _collModInternal(OperationContext* opCtx,
             coll.getWritableCollection()->setRecordPreImages(opCtx, cmrNew.recordPreImages);
         }
 
+        if (cmrNew.recordChangeStreamImages &&
+            *cmrNew.recordChangeStreamImages != oldCollOptions.recordChangeStreamImages) {
+            coll.getWritableCollection()->setRecordChangeStreamImages(
+                opCtx, *cmrNew.recordChangeStreamImages);
+        }
+
+        if (cmrNew.cacheQueryResults &&
+            *cmrNew.cacheQueryResults != oldCollOptions.cacheQueryResults) {
+            coll.getWritableCollection()->setCacheQueryResults(opCtx, *cmrNew.cacheQueryResults);
+        }
+
         // Only observe non-view collMods, as view operations are observed as operations on the
         // system.views collection.
         auto* const opObserver = opCtx->getServiceContext()->getOpObserver();
@@ -603,6 +631,12 @@ Status collMod(OperationContext* opCtx,
                const NamespaceString& nss,
                const BSONObj& cmdObj,
                BSONObjBuilder* result) {
+    // The images collection is created by its own replicated operation, so only do it when this
+    // collMod is not being applied from the oplog.
+    if (cmdObj["recordChangeStreamImages"].trueValue() && opCtx->writesAreReplicated()) {
+        change_stream_images::createImagesCollectionIfNeeded(opCtx);
+    }
+
     return _collModInternal(opCtx, nss, cmdObj, result);
 }
 
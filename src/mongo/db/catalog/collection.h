@@ -93,6 +93,7 @@ struct CollectionUpdateArgs {
 
     StoreDocOption storeDocOption = StoreDocOption::None;
     bool preImageRecordingEnabledForCollection = false;
+    bool changeStreamImagesRecordingEnabledForCollection = false;
 
     // Set if an OpTime was reserved for the update ahead of time.
     boost::optional<OplogSlot> oplogSlot = boost::none;
@@ -496,6 +497,16 @@ public:
     virtual bool getRecordPreImages() const = 0;
     virtual void setRecordPreImages(OperationContext* opCtx, bool val) = 0;
 
+    virtual bool getRecordChangeStreamImages() const = 0;
+    virtual void setRecordChangeStreamImages(OperationContext* opCtx, bool val) = 0;
+
+    /**
+     * Whether eligible read-only queries against this collection may be answered from the
+     * QueryResultCache.
+     */
+    virtual bool getCacheQueryResults() const = 0;
+    virtual void setCacheQueryResults(OperationContext* opCtx, bool val) = 0;
+
     /**
      * Returns true if this is a temporary collection.
      *
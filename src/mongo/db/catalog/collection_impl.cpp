@@ -70,8 +70,12 @@
 #include "mongo/db/storage/durable_catalog.h"
 #include "mongo/db/storage/key_string.h"
 #include "mongo/db/storage/record_store.h"
+#include "mongo/db/storage/storage_engine.h"
 #include "mongo/db/ttl_collection_cache.h"
+#include "mongo/db/update/document_diff_applier.h"
 #include "mongo/db/update/update_driver.h"
+#include "mongo/db/update/update_oplog_entry_serialization.h"
+#include "mongo/db/update/update_oplog_entry_version.h"
 
 #include "mongo/db/auth/user_document_parser.h"  // XXX-ANDY
 #include "mongo/logv2/log.h"
@@ -210,6 +214,31 @@ Status validatePreImageRecording(OperationContext* opCtx, const NamespaceString&
     return Status::OK();
 }
 
+Status validateChangeStreamImageRecording(OperationContext* opCtx, const NamespaceString& ns) {
+    if (ns.db() == NamespaceString::kAdminDb || ns.db() == NamespaceString::kLocalDb ||
+        ns.db() == NamespaceString::kConfigDb) {
+        return {ErrorCodes::InvalidOptions,
+                str::stream() << "recordChangeStreamImages collection option is not supported on "
+                                 "the "
+                              << ns.db() << " database"};
+    }
+
+    if (serverGlobalParams.clusterRole != ClusterRole::None) {
+        return {ErrorCodes::InvalidOptions,
+                "recordChangeStreamImages collection option is not supported on shards or config "
+                "servers"};
+    }
+
+    // The images collection is clustered by _id so that the TTL monitor can expire it.
+    if (!opCtx->getServiceContext()->getStorageEngine()->supportsClusteredIdIndex()) {
+        return {ErrorCodes::InvalidOptions,
+                "recordChangeStreamImages collection option is not supported by the storage "
+                "engine"};
+    }
+
+    return Status::OK();
+}
+
 }  // namespace
 
 CollectionImpl::SharedState::SharedState(CollectionImpl* collection,
@@ -314,6 +343,11 @@ void CollectionImpl::init(OperationContext* opCtx) {
         uassertStatusOK(validatePreImageRecording(opCtx, _ns));
         _recordPreImages = true;
     }
+    if (collectionOptions.recordChangeStreamImages) {
+        uassertStatusOK(validateChangeStreamImageRecording(opCtx, _ns));
+        _recordChangeStreamImages = true;
+    }
+    _cacheQueryResults = collectionOptions.cacheQueryResults;
 
     // Store the result (OK / error) of parsing the validator, but do not enforce that the result is
     // OK. This is intentional, as users may have validators on disk which were considered well
@@ -865,7 +899,7 @@ void CollectionImpl::deleteDocument(OperationContext* opCtx,
 
     boost::optional<BSONObj> deletedDoc;
     if ((storeDeletedDoc == Collection::StoreDeletedDoc::On && opCtx->getTxnNumber()) ||
-        getRecordPreImages()) {
+        getRecordPreImages() || (getRecordChangeStreamImages() && !opCtx->getTxnNumber())) {
         deletedDoc.emplace(doc.value().getOwned());
     }
 
@@ -945,9 +979,12 @@ RecordId CollectionImpl::updateDocument(OperationContext* opCtx,
         args->preImageDoc = oldDoc.value().getOwned();
     }
     args->preImageRecordingEnabledForCollection = getRecordPreImages();
+    args->changeStreamImagesRecordingEnabledForCollection = getRecordChangeStreamImages();
 
-    uassertStatusOK(_shared->_recordStore->updateRecord(
-        opCtx, oldLocation, newDoc.objdata(), newDoc.objsize()));
+    if (!_updateRecordWithDiff(opCtx, oldLocation, oldDoc.value(), newDoc, args->update)) {
+        uassertStatusOK(_shared->_recordStore->updateRecord(
+            opCtx, oldLocation, newDoc.objdata(), newDoc.objsize()));
+    }
 
     if (indexesAffected) {
         int64_t keysInserted, keysDeleted;
@@ -975,6 +1012,62 @@ RecordId CollectionImpl::updateDocument(OperationContext* opCtx,
     return {oldLocation};
 }
 
+bool CollectionImpl::_updateRecordWithDiff(OperationContext* opCtx,
+                                           const RecordId& loc,
+                                           const BSONObj& oldDoc,
+                                           const BSONObj& newDoc,
+                                           const BSONObj& update) const {
+    // Only bother with large documents, for which rewriting the whole record costs noticeably
+    // more than applying a handful of small changes to it.
+    const int kMinLengthForDamages = 1024;
+    const size_t kMaxDamages = 16;
+    const size_t kMaxDamagedBytes = newDoc.objsize() / 10;
+
+    if (newDoc.objsize() <= kMinLengthForDamages ||
+        !_shared->_recordStore->updateWithDamagesSupported()) {
+        return false;
+    }
+
+    // Capped collections may have to delete documents when one grows, and the collections in the
+    // local database are logged by the storage engine, which then cannot apply damages in place.
+    // Rewriting the record is no more expensive for either of them.
+    if (isCapped() || ns().isLocal()) {
+        return false;
+    }
+
+    // Only $v:2 delta updates describe the change precisely enough to compute damages from.
+    const auto versionElt = update[kUpdateOplogEntryVersionFieldName];
+    const auto diffElt = update[update_oplog_entry::kDiffObjectFieldName];
+    if (!versionElt.isNumber() ||
+        versionElt.numberInt() != static_cast<int>(UpdateOplogEntryVersion::kDeltaV2) ||
+        diffElt.type() != BSONType::Object) {
+        return false;
+    }
+
+    auto damagesOutput = doc_diff::computeDamages(oldDoc, diffElt.embeddedObject());
+    if (!damagesOutput || damagesOutput->damages.size() > kMaxDamages) {
+        return false;
+    }
+
+    size_t damagedBytes = 0;
+    for (const auto& damage : damagesOutput->damages) {
+        damagedBytes += damage.size;
+    }
+    if (damagedBytes > kMaxDamagedBytes) {
+        return false;
+    }
+
+    auto newRecord = uassertStatusOK(
+        _shared->_recordStore->updateWithDamages(opCtx,
+                                                 loc,
+                                                 RecordData(oldDoc.objdata(), oldDoc.objsize()),
+                                                 damagesOutput->damageSource.get(),
+                                                 damagesOutput->damages));
+    dassert(newRecord.size() == newDoc.objsize() &&
+            std::memcmp(newRecord.data(), newDoc.objdata(), newDoc.objsize()) == 0);
+    return true;
+}
+
 bool CollectionImpl::updateWithDamagesSupported() const {
     if (!_validator.isOK() || _validator.filter.getValue() != nullptr)
         return false;
@@ -996,7 +1089,7 @@ StatusWith<RecordData> CollectionImpl::updateDocumentWithDamages(
     // For in-place updates we need to grab an owned copy of the pre-image doc if pre-image
     // recording is enabled and we haven't already set the pre-image due to this update being
     // a retryable findAndModify or a possible update to the shard key.
-    if (!args->preImageDoc && getRecordPreImages()) {
+    if (!args->preImageDoc && (getRecordPreImages() || getRecordChangeStreamImages())) {
         args->preImageDoc = oldRec.value().toBson().getOwned();
     }
 
@@ -1006,6 +1099,7 @@ StatusWith<RecordData> CollectionImpl::updateDocumentWithDamages(
     if (newRecStatus.isOK()) {
         args->updatedDoc = newRecStatus.getValue().toBson();
         args->preImageRecordingEnabledForCollection = getRecordPreImages();
+        args->changeStreamImagesRecordingEnabledForCollection = getRecordChangeStreamImages();
         OplogUpdateEntryArgs entryArgs(*args, ns(), _uuid);
         getGlobalServiceContext()->getOpObserver()->onUpdate(opCtx, entryArgs);
     }
@@ -1032,6 +1126,27 @@ void CollectionImpl::setRecordPreImages(OperationContext* opCtx, bool val) {
     _recordPreImages = val;
 }
 
+bool CollectionImpl::getRecordChangeStreamImages() const {
+    return _recordChangeStreamImages;
+}
+
+void CollectionImpl::setRecordChangeStreamImages(OperationContext* opCtx, bool val) {
+    if (val) {
+        uassertStatusOK(validateChangeStreamImageRecording(opCtx, _ns));
+    }
+    DurableCatalog::get(opCtx)->setRecordChangeStreamImages(opCtx, getCatalogId(), val);
+    _recordChangeStreamImages = val;
+}
+
+bool CollectionImpl::getCacheQueryResults() const {
+    return _cacheQueryResults;
+}
+
+void CollectionImpl::setCacheQueryResults(OperationContext* opCtx, bool val) {
+    DurableCatalog::get(opCtx)->setCacheQueryResults(opCtx, getCatalogId(), val);
+    _cacheQueryResults = val;
+}
+
 bool CollectionImpl::isCapped() const {
     return _shared->_cappedNotifier.get();
 }
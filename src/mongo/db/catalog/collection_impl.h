@@ -297,6 +297,12 @@ public:
     bool getRecordPreImages() const final;
     void setRecordPreImages(OperationContext* opCtx, bool val) final;
 
+    bool getRecordChangeStreamImages() const final;
+    void setRecordChangeStreamImages(OperationContext* opCtx, bool val) final;
+
+    bool getCacheQueryResults() const final;
+    void setCacheQueryResults(OperationContext* opCtx, bool val) final;
+
     bool isTemporary(OperationContext* opCtx) const final;
 
     bool isClustered() const final;
@@ -387,6 +393,17 @@ private:
      */
     Status checkValidation(OperationContext* opCtx, const BSONObj& document) const;
 
+    /**
+     * Writes 'newDoc' over 'oldDoc' at 'loc' by applying the $v:2 diff in 'update' to the record
+     * in-place, when the record store supports it and the diff is small relative to the document.
+     * Returns false, without writing anything, if the caller should rewrite the whole record.
+     */
+    bool _updateRecordWithDiff(OperationContext* opCtx,
+                               const RecordId& loc,
+                               const BSONObj& oldDoc,
+                               const BSONObj& newDoc,
+                               const BSONObj& update) const;
+
     /**
      * same semantics as insertDocument, but doesn't do:
      *  - some user error checks
@@ -475,6 +492,8 @@ private:
     bool _clustered = false;
 
     bool _recordPreImages = false;
+    bool _recordChangeStreamImages = false;
+    bool _cacheQueryResults = false;
 
     // The earliest snapshot that is allowed to use this collection.
     boost::optional<Timestamp> _minVisibleSnapshot;
@@ -244,6 +244,22 @@ public:
         std::abort();
     }
 
+    bool getRecordChangeStreamImages() const {
+        std::abort();
+    }
+
+    void setRecordChangeStreamImages(OperationContext* opCtx, bool val) {
+        std::abort();
+    }
+
+    bool getCacheQueryResults() const {
+        std::abort();
+    }
+
+    void setCacheQueryResults(OperationContext* opCtx, bool val) {
+        std::abort();
+    }
+
     bool isCapped() const {
         std::abort();
     }
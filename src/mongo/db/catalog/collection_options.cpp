@@ -133,6 +133,10 @@ StatusWith<CollectionOptions> CollectionOptions::parse(const BSONObj& options, P
             collectionOptions.temp = e.trueValue();
         } else if (fieldName == "recordPreImages") {
             collectionOptions.recordPreImages = e.trueValue();
+        } else if (fieldName == "recordChangeStreamImages") {
+            collectionOptions.recordChangeStreamImages = e.trueValue();
+        } else if (fieldName == "cacheQueryResults") {
+            collectionOptions.cacheQueryResults = e.trueValue();
         } else if (fieldName == "storageEngine") {
             if (e.type() != mongo::Object) {
                 return {ErrorCodes::TypeMismatch, "'storageEngine' must be a document"};
@@ -299,6 +303,12 @@ CollectionOptions CollectionOptions::fromCreateCommand(const CreateCommand& cmd)
     if (auto recordPreImages = cmd.getRecordPreImages()) {
         options.recordPreImages = *recordPreImages;
     }
+    if (auto recordChangeStreamImages = cmd.getRecordChangeStreamImages()) {
+        options.recordChangeStreamImages = *recordChangeStreamImages;
+    }
+    if (auto cacheQueryResults = cmd.getCacheQueryResults()) {
+        options.cacheQueryResults = *cacheQueryResults;
+    }
     if (auto timeseries = cmd.getTimeseries()) {
         options.timeseries = std::move(*timeseries);
     }
@@ -338,6 +348,14 @@ void CollectionOptions::appendBSON(BSONObjBuilder* builder) const {
         builder->appendBool("recordPreImages", true);
     }
 
+    if (recordChangeStreamImages) {
+        builder->appendBool("recordChangeStreamImages", true);
+    }
+
+    if (cacheQueryResults) {
+        builder->appendBool("cacheQueryResults", true);
+    }
+
     if (!storageEngine.isEmpty()) {
         builder->append("storageEngine", storageEngine);
     }
@@ -405,6 +423,14 @@ bool CollectionOptions::matchesStorageOptions(const CollectionOptions& other,
         return false;
     }
 
+    if (recordChangeStreamImages != other.recordChangeStreamImages) {
+        return false;
+    }
+
+    if (cacheQueryResults != other.cacheQueryResults) {
+        return false;
+    }
+
     if (temp != other.temp) {
         return false;
     }
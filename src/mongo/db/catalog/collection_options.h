@@ -124,6 +124,8 @@ struct CollectionOptions {
 
     bool temp = false;
     bool recordPreImages = false;
+    bool recordChangeStreamImages = false;
+    bool cacheQueryResults = false;
 
     // Storage engine collection options. Always owned or empty.
     BSONObj storageEngine;
@@ -40,6 +40,7 @@
 #include "mongo/db/catalog/collection_catalog.h"
 #include "mongo/db/catalog/database_holder.h"
 #include "mongo/db/catalog/index_key_validate.h"
+#include "mongo/db/change_stream_images.h"
 #include "mongo/db/commands.h"
 #include "mongo/db/concurrency/write_conflict_exception.h"
 #include "mongo/db/curop.h"
@@ -395,6 +396,13 @@ Status createCollection(OperationContext* opCtx,
                 str::stream() << "Cannot create system collection " << ns
                               << " within a transaction.",
                 !opCtx->inMultiDocumentTransaction() || !ns.isSystem());
+        if (options.recordChangeStreamImages && opCtx->writesAreReplicated()) {
+            uassert(ErrorCodes::OperationNotSupportedInTransaction,
+                    "Cannot create a collection recording change stream images in a "
+                    "multi-document transaction.",
+                    !opCtx->inMultiDocumentTransaction());
+            change_stream_images::createImagesCollectionIfNeeded(opCtx);
+        }
         return _createCollection(opCtx, ns, std::move(options), idIndex);
     }
 }
@@ -33,6 +33,7 @@
 
 #include "mongo/db/catalog/index_catalog_impl.h"
 
+#include <algorithm>
 #include <vector>
 
 #include "mongo/base/init.h"
@@ -1366,6 +1367,21 @@ Status IndexCatalogImpl::_indexFilteredRecords(OperationContext* opCtx,
     InsertDeleteOptions options;
     prepareInsertDeleteOptions(opCtx, coll->ns(), index->descriptor(), &options);
 
+    // The keys of a batch of records can only be inserted out of record order when the records are
+    // written at the same timestamp: a key must be written at the timestamp of its record, and the
+    // timestamps of a storage transaction only move forward. On a replica set every document of
+    // an insert batch gets its own oplog timestamp, so in practice this path is taken on standalone
+    // nodes, where the timestamps are null, and for batches written at a single timestamp. Keys of
+    // an index that is being built go to its side table.
+    const bool shareTimestamp =
+        std::all_of(bsonRecords.begin(), bsonRecords.end(), [&](const BsonRecord& bsonRecord) {
+            return bsonRecord.ts == bsonRecords.front().ts;
+        });
+    if (bsonRecords.size() > 1 && shareTimestamp && !index->isHybridBuilding()) {
+        return _indexFilteredRecordsSorted(
+            opCtx, coll, index, bsonRecords, options, keysInsertedOut);
+    }
+
     for (auto bsonRecord : bsonRecords) {
         invariant(bsonRecord.id != RecordId());
 
@@ -1407,6 +1423,77 @@ Status IndexCatalogImpl::_indexFilteredRecords(OperationContext* opCtx,
     return Status::OK();
 }
 
+Status IndexCatalogImpl::_indexFilteredRecordsSorted(OperationContext* opCtx,
+                                                     const CollectionPtr& coll,
+                                                     IndexCatalogEntry* index,
+                                                     const std::vector<BsonRecord>& bsonRecords,
+                                                     const InsertDeleteOptions& options,
+                                                     int64_t* keysInsertedOut) {
+    auto& executionCtx = StorageExecutionContext::get(opCtx);
+    auto accessMethod = index->accessMethod();
+
+    if (!bsonRecords.front().ts.isNull()) {
+        Status status = opCtx->recoveryUnit()->setTimestamp(bsonRecords.front().ts);
+        if (!status.isOK())
+            return status;
+    }
+
+    // Every key ends with the RecordId of its record, so the keys of different records never
+    // compare equal.
+    std::vector<KeyString::Value> allKeys;
+    std::vector<std::pair<KeyStringSet, MultikeyPaths>> multikeyUpdates;
+    for (const auto& bsonRecord : bsonRecords) {
+        invariant(bsonRecord.id != RecordId());
+
+        auto keys = executionCtx.keys();
+        auto multikeyMetadataKeys = executionCtx.multikeyMetadataKeys();
+        auto multikeyPaths = executionCtx.multikeyPaths();
+
+        accessMethod->getKeys(executionCtx.pooledBufferBuilder(),
+                              *bsonRecord.docPtr,
+                              options.getKeysMode,
+                              IndexAccessMethod::GetKeysContext::kAddingKeys,
+                              keys.get(),
+                              multikeyMetadataKeys.get(),
+                              multikeyPaths.get(),
+                              bsonRecord.id,
+                              IndexAccessMethod::kNoopOnSuppressedErrorFn);
+
+        if (accessMethod->shouldMarkIndexAsMultikey(
+                keys->size(), *multikeyMetadataKeys, *multikeyPaths)) {
+            multikeyUpdates.emplace_back(*multikeyMetadataKeys, *multikeyPaths);
+        }
+
+        auto sequence = keys->extract_sequence();
+        allKeys.insert(allKeys.end(),
+                       std::make_move_iterator(sequence.begin()),
+                       std::make_move_iterator(sequence.end()));
+    }
+
+    std::sort(allKeys.begin(), allKeys.end());
+    KeyStringSet sortedKeys(boost::container::ordered_unique_range,
+                            std::make_move_iterator(allKeys.begin()),
+                            std::make_move_iterator(allKeys.end()));
+
+    int64_t numInserted;
+    Status status = accessMethod->insertSortedKeys(opCtx, sortedKeys, options, &numInserted);
+    if (!status.isOK()) {
+        return status;
+    }
+
+    // As in AbstractIndexAccessMethod::insertKeysAndUpdateMultikeyPaths(), the multikey metadata
+    // keys are added while marking the index as multikey, and are counted as inserted keys.
+    for (const auto& [multikeyMetadataKeys, multikeyPaths] : multikeyUpdates) {
+        index->setMultikey(opCtx, coll, multikeyMetadataKeys, multikeyPaths);
+        numInserted += multikeyMetadataKeys.size();
+    }
+    if (keysInsertedOut) {
+        *keysInsertedOut += numInserted;
+    }
+
+    return Status::OK();
+}
+
 Status IndexCatalogImpl::_indexRecords(OperationContext* opCtx,
                                        const CollectionPtr& coll,
                                        IndexCatalogEntry* index,
@@ -329,6 +329,17 @@ private:
                                  const std::vector<BsonRecord>& bsonRecords,
                                  int64_t* keysInsertedOut);
 
+    /**
+     * Indexes 'bsonRecords', which must share a timestamp, by sorting the keys of all of the
+     * records together and inserting them in a single pass over the index.
+     */
+    Status _indexFilteredRecordsSorted(OperationContext* opCtx,
+                                       const CollectionPtr& coll,
+                                       IndexCatalogEntry* index,
+                                       const std::vector<BsonRecord>& bsonRecords,
+                                       const InsertDeleteOptions& options,
+                                       int64_t* keysInsertedOut);
+
     Status _indexRecords(OperationContext* opCtx,
                          const CollectionPtr& coll,
                          IndexCatalogEntry* index,
@@ -0,0 +1,168 @@
+/**
+ *    Copyright (C) 2021-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#define MONGO_LOGV2_DEFAULT_COMPONENT ::mongo::logv2::LogComponent::kStorage
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/change_stream_images.h"
+
+#include "mongo/base/counter.h"
+#include "mongo/base/data_type_endian.h"
+#include "mongo/base/data_view.h"
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/catalog/collection_catalog.h"
+#include "mongo/db/catalog/collection_options.h"
+#include "mongo/db/catalog/database.h"
+#include "mongo/db/catalog_raii.h"
+#include "mongo/db/change_stream_images_gen.h"
+#include "mongo/db/commands/server_status_metric.h"
+#include "mongo/db/concurrency/write_conflict_exception.h"
+#include "mongo/db/db_raii.h"
+#include "mongo/db/repl/replication_coordinator.h"
+#include "mongo/logv2/log.h"
+#include "mongo/logv2/log_severity_suppressor.h"
+
+namespace mongo {
+namespace change_stream_images {
+namespace {
+
+// Leaves room in the images document for the fields other than the images.
+constexpr int kImagesDocumentOverhead = 128;
+
+Counter64 oversizeImagesSkipped;
+ServerStatusMetricField<Counter64> displayOversizeImagesSkipped(
+    "changeStreamImages.oversizeSkipped", &oversizeImagesSkipped);
+
+}  // namespace
+
+OID imageIdForTimestamp(Timestamp ts) {
+    char id[OID::kOIDSize] = {};
+    DataView(id)
+        .write(tagBigEndian(ts.getSecs()), 0)
+        .write(tagBigEndian(ts.getInc()), sizeof(uint32_t));
+    return OID::from(id);
+}
+
+void createImagesCollectionIfNeeded(OperationContext* opCtx) {
+    const auto& nss = NamespaceString::kChangeStreamImagesNamespace;
+    writeConflictRetry(opCtx, "createChangeStreamImagesCollection", nss.ns(), [&] {
+        AutoGetOrCreateDb autoDb(opCtx, nss.db(), MODE_IX);
+        Lock::CollectionLock collLock(opCtx, nss, MODE_IX);
+        if (CollectionCatalog::get(opCtx)->lookupCollectionByNamespace(opCtx, nss)) {
+            return;
+        }
+
+        uassert(ErrorCodes::NotWritablePrimary,
+                str::stream() << "Not primary while creating collection " << nss,
+                !opCtx->writesAreReplicated() ||
+                    repl::ReplicationCoordinator::get(opCtx)->canAcceptWritesFor(opCtx, nss));
+
+        // The images are expired through the clustered _id, whose leading bytes hold the wall
+        // clock second of the write they were recorded for.
+        ClusteredIndexOptions clusteredOptions;
+        clusteredOptions.setExpireAfterSeconds(gChangeStreamImagesExpireAfterSeconds);
+        CollectionOptions options;
+        options.clusteredIndex = clusteredOptions;
+
+        WriteUnitOfWork wuow(opCtx);
+        const bool createIdIndex = false;
+        invariant(autoDb.getDb()->createCollection(opCtx, nss, options, createIdIndex),
+                  str::stream() << "Failed to create collection " << nss);
+        wuow.commit();
+    });
+}
+
+void writeImages(OperationContext* opCtx,
+                 const UUID& uuid,
+                 Timestamp ts,
+                 const boost::optional<BSONObj>& preImage,
+                 const boost::optional<BSONObj>& postImage) {
+    const auto imagesSize =
+        (preImage ? preImage->objsize() : 0) + (postImage ? postImage->objsize() : 0);
+    if (imagesSize + kImagesDocumentOverhead > BSONObjMaxUserSize) {
+        // Change streams fall back to the oplog and to looking up the current document for these
+        // events, so they no longer see the images they asked for.
+        oversizeImagesSkipped.increment();
+        static auto& bumpedSeverity = *new logv2::SeveritySuppressor{
+            Seconds{1}, logv2::LogSeverity::Info(), logv2::LogSeverity::Debug(2)};
+        LOGV2_DEBUG(5411600,
+                    bumpedSeverity().toInt(),
+                    "Not recording change stream images that do not fit in one document",
+                    "uuid"_attr = uuid,
+                    "ts"_attr = ts,
+                    "imagesSize"_attr = imagesSize);
+        return;
+    }
+
+    AutoGetCollection collection(opCtx, NamespaceString::kChangeStreamImagesNamespace, MODE_IX);
+    if (!collection) {
+        return;
+    }
+
+    BSONObjBuilder builder;
+    builder.append(kIdFieldName, imageIdForTimestamp(ts));
+    builder.append(kTimestampFieldName, ts);
+    uuid.appendToBuilder(&builder, kUuidFieldName);
+    if (preImage) {
+        builder.append(kPreImageFieldName, *preImage);
+    }
+    if (postImage) {
+        builder.append(kPostImageFieldName, *postImage);
+    }
+
+    uassertStatusOK(collection->insertDocument(opCtx, InsertStatement(builder.obj()), nullptr));
+}
+
+std::vector<BSONObj> readImages(OperationContext* opCtx, Timestamp from, size_t limit) {
+    std::vector<BSONObj> images;
+    AutoGetCollectionForRead collection(opCtx, NamespaceString::kChangeStreamImagesNamespace);
+    if (!collection) {
+        return images;
+    }
+
+    const auto startOID = imageIdForTimestamp(from);
+    const RecordId startId(startOID.view().view(), OID::kOIDSize);
+
+    // 'seekNear' positions on the closest record at or before 'startId', which is skipped when it
+    // belongs to an earlier write.
+    auto cursor = collection->getCursor(opCtx);
+    for (auto record = cursor->seekNear(startId); record && images.size() < limit;
+         record = cursor->next()) {
+        if (record->id < startId) {
+            continue;
+        }
+        images.push_back(record->data.toBson().getOwned());
+    }
+    return images;
+}
+
+}  // namespace change_stream_images
+}  // namespace mongo
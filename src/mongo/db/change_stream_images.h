@@ -0,0 +1,97 @@
+/**
+ *    Copyright (C) 2021-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#pragma once
+
+#include <boost/optional.hpp>
+#include <vector>
+
+#include "mongo/bson/bsonobj.h"
+#include "mongo/bson/oid.h"
+#include "mongo/bson/timestamp.h"
+#include "mongo/util/uuid.h"
+
+namespace mongo {
+
+class OperationContext;
+
+/**
+ * Pre- and post-images of the updates and deletes on collections with the
+ * 'recordChangeStreamImages' option are stored in 'config.system.changeStreamImages', a collection
+ * clustered by _id and expired by the TTL monitor. Each document holds the images of one write and
+ * has the form:
+ *
+ *   {_id: <OID derived from 'ts'>, ts: <oplog timestamp>, uuid: <collection UUID>,
+ *    preImage: <document>, postImage: <document>}
+ *
+ * The _id embeds the oplog timestamp of the write in its leading bytes, so the collection is
+ * ordered by timestamp and change streams can fetch the images of a run of events with one range
+ * scan.
+ */
+namespace change_stream_images {
+
+constexpr StringData kIdFieldName = "_id"_sd;
+constexpr StringData kTimestampFieldName = "ts"_sd;
+constexpr StringData kUuidFieldName = "uuid"_sd;
+constexpr StringData kPreImageFieldName = "preImage"_sd;
+constexpr StringData kPostImageFieldName = "postImage"_sd;
+
+/**
+ * Returns the _id of the images recorded for the write logged at 'ts'. Ids compare in the same
+ * order as their timestamps, and the time part of the OID is the wall clock second of 'ts'.
+ */
+OID imageIdForTimestamp(Timestamp ts);
+
+/**
+ * Creates the change stream images collection if it does not exist. Must be called on a primary,
+ * outside of a WriteUnitOfWork and without holding collection locks.
+ */
+void createImagesCollectionIfNeeded(OperationContext* opCtx);
+
+/**
+ * Records the images of the write logged at 'ts' on the collection 'uuid' as part of the current
+ * WriteUnitOfWork. Does nothing if the images collection does not exist. Images which do not fit in
+ * one document are not recorded either, which is logged and counted in the serverStatus metric
+ * 'changeStreamImages.oversizeSkipped'.
+ */
+void writeImages(OperationContext* opCtx,
+                 const UUID& uuid,
+                 Timestamp ts,
+                 const boost::optional<BSONObj>& preImage,
+                 const boost::optional<BSONObj>& postImage);
+
+/**
+ * Returns at most 'limit' image documents recorded at or after 'from', in timestamp order. Returns
+ * an empty vector if the images collection does not exist.
+ */
+std::vector<BSONObj> readImages(OperationContext* opCtx, Timestamp from, size_t limit);
+
+}  // namespace change_stream_images
+}  // namespace mongo
@@ -0,0 +1,127 @@
+/**
+ *    Copyright (C) 2021-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/change_stream_images.h"
+
+#include "mongo/db/catalog/catalog_test_fixture.h"
+#include "mongo/db/storage/write_unit_of_work.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+using ChangeStreamImagesTest = CatalogTestFixture;
+
+void writeImagesInUnitOfWork(OperationContext* opCtx,
+                             Timestamp ts,
+                             const boost::optional<BSONObj>& preImage,
+                             const boost::optional<BSONObj>& postImage) {
+    WriteUnitOfWork wuow(opCtx);
+    change_stream_images::writeImages(opCtx, UUID::gen(), ts, preImage, postImage);
+    wuow.commit();
+}
+
+TEST(ChangeStreamImageIdTest, IdsAreOrderedByTimestamp) {
+    using change_stream_images::imageIdForTimestamp;
+
+    ASSERT_LT(imageIdForTimestamp(Timestamp(1, 2)), imageIdForTimestamp(Timestamp(1, 3)));
+    ASSERT_LT(imageIdForTimestamp(Timestamp(1, 0xFFFFFFFF)), imageIdForTimestamp(Timestamp(2, 0)));
+    ASSERT_LT(imageIdForTimestamp(Timestamp(0x7FFFFFFF, 1)),
+              imageIdForTimestamp(Timestamp(0x80000000, 0)));
+    ASSERT_EQ(imageIdForTimestamp(Timestamp(5, 6)), imageIdForTimestamp(Timestamp(5, 6)));
+}
+
+TEST(ChangeStreamImageIdTest, IdTimeIsTimestampSeconds) {
+    // The TTL monitor expires the images by the time part of their _id.
+    const Timestamp ts(1234567890, 42);
+    ASSERT_EQ(change_stream_images::imageIdForTimestamp(ts).asDateT(),
+              Date_t::fromMillisSinceEpoch(1234567890LL * 1000));
+}
+
+TEST_F(ChangeStreamImagesTest, WriteAndReadWithoutImagesCollection) {
+    auto opCtx = operationContext();
+    writeImagesInUnitOfWork(opCtx, Timestamp(10, 1), BSON("_id" << 1), boost::none);
+    ASSERT(change_stream_images::readImages(opCtx, Timestamp(0, 0), 10).empty());
+}
+
+TEST_F(ChangeStreamImagesTest, ReadsImagesInTimestampOrderFromStart) {
+    auto opCtx = operationContext();
+    change_stream_images::createImagesCollectionIfNeeded(opCtx);
+    // Creating the collection again is a no-op.
+    change_stream_images::createImagesCollectionIfNeeded(opCtx);
+
+    // Written out of order, to check that reads return them ordered by timestamp.
+    writeImagesInUnitOfWork(
+        opCtx, Timestamp(11, 1), BSON("_id" << 3), BSON("_id" << 3 << "a" << 1));
+    writeImagesInUnitOfWork(opCtx, Timestamp(10, 1), BSON("_id" << 1), boost::none);
+    writeImagesInUnitOfWork(opCtx, Timestamp(10, 2), boost::none, BSON("_id" << 2));
+
+    auto images = change_stream_images::readImages(opCtx, Timestamp(10, 2), 10);
+    ASSERT_EQ(images.size(), 2U);
+    ASSERT_EQ(images[0][change_stream_images::kTimestampFieldName].timestamp(), Timestamp(10, 2));
+    ASSERT_FALSE(images[0].hasField(change_stream_images::kPreImageFieldName));
+    ASSERT_BSONOBJ_EQ(images[0][change_stream_images::kPostImageFieldName].Obj(), BSON("_id" << 2));
+    ASSERT_EQ(images[1][change_stream_images::kTimestampFieldName].timestamp(), Timestamp(11, 1));
+    ASSERT_BSONOBJ_EQ(images[1][change_stream_images::kPreImageFieldName].Obj(), BSON("_id" << 3));
+    ASSERT_BSONOBJ_EQ(images[1][change_stream_images::kPostImageFieldName].Obj(),
+                      BSON("_id" << 3 << "a" << 1));
+
+    // A start between two writes begins at the later one.
+    images = change_stream_images::readImages(opCtx, Timestamp(10, 3), 10);
+    ASSERT_EQ(images.size(), 1U);
+    ASSERT_EQ(images[0][change_stream_images::kTimestampFieldName].timestamp(), Timestamp(11, 1));
+
+    images = change_stream_images::readImages(opCtx, Timestamp(0, 0), 2);
+    ASSERT_EQ(images.size(), 2U);
+    ASSERT_EQ(images[0][change_stream_images::kTimestampFieldName].timestamp(), Timestamp(10, 1));
+    ASSERT_EQ(images[1][change_stream_images::kTimestampFieldName].timestamp(), Timestamp(10, 2));
+
+    ASSERT(change_stream_images::readImages(opCtx, Timestamp(11, 2), 10).empty());
+}
+
+TEST_F(ChangeStreamImagesTest, ImagesNotFittingInOneDocumentAreNotRecorded) {
+    auto opCtx = operationContext();
+    change_stream_images::createImagesCollectionIfNeeded(opCtx);
+
+    // Each image fits on its own, but not both together.
+    const std::string largeString(BSONObjMaxUserSize / 2, 'x');
+    const auto largeImage = BSON("_id" << 1 << "s" << largeString);
+    writeImagesInUnitOfWork(opCtx, Timestamp(10, 1), largeImage, largeImage);
+    ASSERT(change_stream_images::readImages(opCtx, Timestamp(0, 0), 10).empty());
+
+    writeImagesInUnitOfWork(opCtx, Timestamp(10, 2), largeImage, boost::none);
+    auto images = change_stream_images::readImages(opCtx, Timestamp(0, 0), 10);
+    ASSERT_EQ(images.size(), 1U);
+    ASSERT_EQ(images[0][change_stream_images::kTimestampFieldName].timestamp(), Timestamp(10, 2));
+}
+
+}  // namespace
+}  // namespace mongo
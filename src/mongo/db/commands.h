@@ -57,6 +57,7 @@
 #include "mongo/transport/service_executor.h"
 #include "mongo/util/fail_point.h"
 #include "mongo/util/future.h"
+#include "mongo/util/latency_histogram.h"
 #include "mongo/util/string_map.h"
 
 namespace mongo {
@@ -547,6 +548,20 @@ public:
         _commandsFailed.increment();
     }
 
+    /**
+     * Records the latency of one completed invocation of this command.
+     */
+    void recordLatency(Microseconds latency) const {
+        _latencyHistogram.record(latency);
+    }
+
+    /**
+     * Latency histogram of every invocation of this command since startup.
+     */
+    const LatencyHistogram& getLatencyHistogram() const {
+        return _latencyHistogram;
+    }
+
     /**
      * Generates a reply from the 'help' information associated with a command. The state of
      * the passed ReplyBuilder will be in kOutputDocs after calling this method.
@@ -587,6 +602,7 @@ private:
     // Counters for how many times this command has been executed and failed
     mutable Counter64 _commandsExecuted;
     mutable Counter64 _commandsFailed;
+    mutable LatencyHistogram _latencyHistogram;
     // Pointers to hold the metrics tree references
     ServerStatusMetricField<Counter64> _commandsExecutedMetric;
     ServerStatusMetricField<Counter64> _commandsFailedMetric;
@@ -50,6 +50,7 @@
 #include "mongo/db/query/find.h"
 #include "mongo/db/query/find_common.h"
 #include "mongo/db/query/get_executor.h"
+#include "mongo/db/query/query_result_cache.h"
 #include "mongo/db/repl/replication_coordinator.h"
 #include "mongo/db/service_context.h"
 #include "mongo/db/stats/counters.h"
@@ -371,6 +372,16 @@ public:
             }
 
 
+            // Capture the write version of the collection before acquiring its snapshot, so that
+            // any write which the snapshot may miss invalidates the results cached by this query.
+            const auto requestedNss = findCommand->getNamespaceOrUUID().nss();
+            boost::optional<QueryResultCache::WriteVersion> resultCacheVersion;
+            if (requestedNss && !findCommand->getTailable() && !term &&
+                QueryResultCache::isEligibleOperation(opCtx) &&
+                QueryResultCache::isOptedInCollection(opCtx, *requestedNss)) {
+                resultCacheVersion = QueryResultCache::get(opCtx).getWriteVersion(*requestedNss);
+            }
+
             // Acquire locks. If the query is on a view, we release our locks and convert the query
             // request into an aggregation command.
             boost::optional<AutoGetCollectionForReadCommandMaybeLockFree> ctx;
@@ -443,6 +454,38 @@ public:
                 opCtx->recoveryUnit()->setReadOnce(true);
             }
 
+            // Serve the query from the result cache if the collection opted in and no write has
+            // committed since the cached results were computed.
+            boost::optional<std::string> resultCacheKey;
+            if (resultCacheVersion && nss == *requestedNss &&
+                QueryResultCache::isEligibleCollection(opCtx, collection)) {
+                const auto& fc = cq->getFindCommand();
+                if (!QueryResultCache::hasNonDeterministicOperators(fc.getFilter()) &&
+                    !QueryResultCache::hasNonDeterministicOperators(fc.getProjection()) &&
+                    !QueryResultCache::hasNonDeterministicOperators(
+                        fc.getLet().value_or(BSONObj()))) {
+                    resultCacheKey = QueryResultCache::makeFindKey(*cq);
+                }
+            }
+            if (resultCacheKey) {
+                if (auto cachedDocs = QueryResultCache::get(opCtx).lookup(
+                        nss, *resultCacheKey, *resultCacheVersion)) {
+                    CursorResponseBuilder::Options options;
+                    options.isInitialResponse = true;
+                    CursorResponseBuilder firstBatch(result, options);
+                    for (auto&& doc : *cachedDocs) {
+                        firstBatch.append(doc);
+                    }
+
+                    auto& debug = CurOp::get(opCtx)->debug();
+                    debug.nreturned = cachedDocs->size();
+                    debug.cursorExhausted = true;
+
+                    firstBatch.done(0, nss.ns());
+                    return;
+                }
+            }
+
             // Get the execution plan for the query.
             bool permitYield = true;
             auto exec =
@@ -480,6 +523,7 @@ public:
             std::uint64_t numResults = 0;
             bool stashedResult = false;
             ResourceConsumption::DocumentUnitCounter docUnitsReturned;
+            std::vector<BSONObj> resultsToCache;
 
             try {
                 while (!FindCommon::enoughForFirstBatch(originalFC, numResults) &&
@@ -499,6 +543,10 @@ public:
                     firstBatch.append(obj);
                     numResults++;
                     docUnitsReturned.observeOne(obj.objsize());
+
+                    if (resultCacheKey) {
+                        resultsToCache.push_back(obj.getOwned());
+                    }
                 }
             } catch (DBException& exception) {
                 firstBatch.abandon();
@@ -561,6 +609,12 @@ public:
                 endQueryOp(opCtx, collection, *cursorExec, numResults, cursorId);
             } else {
                 endQueryOp(opCtx, collection, *exec, numResults, cursorId);
+
+                // The first batch holds the complete result set, so it can be cached.
+                if (resultCacheKey) {
+                    QueryResultCache::get(opCtx).insert(
+                        nss, *resultCacheKey, *resultCacheVersion, std::move(resultsToCache));
+                }
             }
 
             // Generate the response object to send to the client.
@@ -66,6 +66,7 @@
 #include "mongo/db/query/plan_executor_factory.h"
 #include "mongo/db/query/plan_summary_stats.h"
 #include "mongo/db/query/query_planner_common.h"
+#include "mongo/db/query/query_result_cache.h"
 #include "mongo/db/read_concern.h"
 #include "mongo/db/repl/oplog.h"
 #include "mongo/db/repl/read_concern_args.h"
@@ -114,7 +115,8 @@ bool canOptimizeAwayPipeline(const Pipeline* pipeline,
  * Returns true if we need to keep a ClientCursor saved for this pipeline (for future getMore
  * requests). Otherwise, returns false. The passed 'nsForCursor' is only used to determine the
  * namespace used in the returned cursor, which will be registered with the global cursor manager,
- * and thus will be different from that in 'request'.
+ * and thus will be different from that in 'request'. If 'resultsToCache' is non-null, the
+ * documents returned in the first batch are also appended to it.
  */
 bool handleCursorCommand(OperationContext* opCtx,
                          boost::intrusive_ptr<ExpressionContext> expCtx,
@@ -122,7 +124,8 @@ bool handleCursorCommand(OperationContext* opCtx,
                          std::vector<ClientCursor*> cursors,
                          const AggregateCommand& request,
                          const BSONObj& cmdObj,
-                         rpc::ReplyBuilderInterface* result) {
+                         rpc::ReplyBuilderInterface* result,
+                         std::vector<BSONObj>* resultsToCache) {
     invariant(!cursors.empty());
     long long batchSize =
         request.getCursor().getBatchSize().value_or(aggregation_request_helper::kDefaultBatchSize);
@@ -227,6 +230,10 @@ bool handleCursorCommand(OperationContext* opCtx,
         responseBuilder.setPostBatchResumeToken(exec->getPostBatchResumeToken());
         responseBuilder.append(nextDoc);
         docUnitsReturned.observeOne(nextDoc.objsize());
+
+        if (resultsToCache) {
+            resultsToCache->push_back(nextDoc.getOwned());
+        }
     }
 
     if (cursor) {
@@ -568,6 +575,10 @@ Status runAggregate(OperationContext* opCtx,
     // re-running the expanded aggregation.
     boost::optional<AutoGetCollectionForReadCommandMaybeLockFree> ctx;
 
+    // Set if the results of this aggregation may be served from, or stored in, the result cache.
+    boost::optional<QueryResultCache::WriteVersion> resultCacheVersion;
+    boost::optional<std::string> resultCacheKey;
+
     std::vector<unique_ptr<PlanExecutor, PlanExecutor::Deleter>> execs;
     boost::intrusive_ptr<ExpressionContext> expCtx;
     auto curOp = CurOp::get(opCtx);
@@ -637,6 +648,16 @@ Status runAggregate(OperationContext* opCtx,
             collatorToUse.emplace(PipelineD::resolveCollator(
                 opCtx, request.getCollation().get_value_or(BSONObj()), nullptr));
         } else {
+            // Capture the write version of the collection before acquiring its snapshot, so that
+            // any write which the snapshot may miss invalidates the results cached by this query.
+            if (!request.getExplain() && !request.getExchange() &&
+                pipelineInvolvedNamespaces.empty() &&
+                QueryResultCache::isEligibleOperation(opCtx) &&
+                QueryResultCache::isCacheablePipeline(request.getPipeline()) &&
+                QueryResultCache::isOptedInCollection(opCtx, nss)) {
+                resultCacheVersion = QueryResultCache::get(opCtx).getWriteVersion(nss);
+            }
+
             // This is a regular aggregation. Lock the collection or view.
             ctx.emplace(opCtx, nss, AutoGetCollectionViewMode::kViewsPermitted);
             collatorToUse.emplace(PipelineD::resolveCollator(
@@ -707,6 +728,37 @@ Status runAggregate(OperationContext* opCtx,
                     uuid && uuid == *request.getCollectionUUID());
         }
 
+        // Serve the aggregation from the result cache if the collection opted in and no write has
+        // committed since the cached results were computed.
+        if (resultCacheVersion && QueryResultCache::isEligibleCollection(opCtx, collection) &&
+            !QueryResultCache::hasNonDeterministicOperators(request.getLet().value_or(BSONObj()))) {
+            resultCacheKey = QueryResultCache::makeAggregateKey(
+                request.getPipeline(),
+                request.getCollation().value_or(BSONObj()),
+                request.getHint().value_or(BSONObj()),
+                request.getLet().value_or(BSONObj()),
+                request.getCursor().getBatchSize().value_or(
+                    aggregation_request_helper::kDefaultBatchSize));
+
+            if (auto cachedDocs = QueryResultCache::get(opCtx).lookup(
+                    nss, *resultCacheKey, *resultCacheVersion)) {
+                liteParsedPipeline.tickGlobalStageCounters();
+
+                CursorResponseBuilder::Options options;
+                options.isInitialResponse = true;
+                CursorResponseBuilder responseBuilder(result, options);
+                for (auto&& doc : *cachedDocs) {
+                    responseBuilder.append(doc);
+                }
+
+                curOp->debug().nreturned = cachedDocs->size();
+                curOp->debug().cursorExhausted = true;
+
+                responseBuilder.done(0LL, origNss.ns());
+                return Status::OK();
+            }
+        }
+
         invariant(collatorToUse);
         expCtx = makeExpressionContext(opCtx, request, std::move(*collatorToUse), uuid);
 
@@ -855,10 +907,21 @@ Status runAggregate(OperationContext* opCtx,
         }
     } else {
         // Cursor must be specified, if explain is not.
-        const bool keepCursor = handleCursorCommand(
-            opCtx, expCtx, origNss, std::move(cursors), request, cmdObj, result);
+        std::vector<BSONObj> resultsToCache;
+        const bool keepCursor = handleCursorCommand(opCtx,
+                                                    expCtx,
+                                                    origNss,
+                                                    std::move(cursors),
+                                                    request,
+                                                    cmdObj,
+                                                    result,
+                                                    resultCacheKey ? &resultsToCache : nullptr);
         if (keepCursor) {
             cursorFreer.dismiss();
+        } else if (resultCacheKey) {
+            // The first batch holds the complete result set, so it can be cached.
+            QueryResultCache::get(opCtx).insert(
+                nss, *resultCacheKey, *resultCacheVersion, std::move(resultsToCache));
         }
 
         PlanSummaryStats stats;
@@ -81,7 +81,7 @@ public:
 
 private:
     OperationContext* _opCtx;
-    TicketHolder _holder;
+    SemaphoreTicketHolder _holder;
 };
 
 
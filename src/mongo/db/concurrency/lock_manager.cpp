@@ -131,6 +131,80 @@ MONGO_STATIC_ASSERT((sizeof(LockRequestStatusNames) / sizeof(LockRequestStatusNa
 
 }  // namespace
 
+/**
+ * The FastPathEntry allows granting intent mode requests without taking any mutex, which is the
+ * overwhelmingly common case for the global, database and collection resources.
+ *
+ * Each entry counts the requests granted through it for one resource, separately for MODE_IS and
+ * MODE_IX, in a single atomic word together with a 'disabled' bit. Fast path requests are not put
+ * on any list; a request is granted by incrementing its mode's count with a compare-and-swap,
+ * which fails if the entry is disabled, in which case the request goes through the regular path.
+ *
+ * The LockHead of the resource disables the entry, under its bucket mutex, before granting or
+ * queueing a non-intent mode, and from then on counts the modes of the fast path holders as
+ * granted modes. When a fast path holder releases the last request of a mode while the entry is
+ * disabled, it locks the bucket and lets the LockHead grant whichever requests were waiting for
+ * it. Once the LockHead has no non-intent modes left, it enables the entry again.
+ *
+ * Entries start out disabled so that a resource whose LockHead already holds non-intent modes is
+ * not granted through an entry created after the fact.
+ */
+struct alignas(64) FastPathEntry {
+    static constexpr uint64_t kDisabled = 1ULL << 63;
+    static constexpr int kIXShift = 32;
+    static constexpr uint64_t kISMask = (1ULL << 31) - 1;
+    static constexpr uint64_t kIXMask = kISMask << kIXShift;
+
+    static uint64_t unit(LockMode mode) {
+        invariant(mode == MODE_IS || mode == MODE_IX);
+        return mode == MODE_IS ? 1 : (1ULL << kIXShift);
+    }
+
+    static uint32_t modesOf(uint64_t word) {
+        return ((word & kISMask) ? modeMask(MODE_IS) : 0) |
+            ((word & kIXMask) ? modeMask(MODE_IX) : 0);
+    }
+
+    static uint64_t countOf(uint64_t word, LockMode mode) {
+        invariant(mode == MODE_IS || mode == MODE_IX);
+        return mode == MODE_IS ? (word & kISMask) : ((word & kIXMask) >> kIXShift);
+    }
+
+    /**
+     * Grants a request in 'mode', unless the entry is disabled.
+     */
+    bool tryAcquire(LockMode mode) {
+        auto word = state.load();
+        while (!(word & kDisabled)) {
+            if (state.compareAndSwap(&word, word + unit(mode))) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * Releases a request granted in 'mode'. Returns true if requests queued on the LockHead may
+     * have been waiting for it.
+     */
+    bool release(LockMode mode) {
+        const auto previous = state.fetchAndSubtract(unit(mode));
+        const auto current = previous - unit(mode);
+        return (current & kDisabled) && modesOf(current) != modesOf(previous);
+    }
+
+    /**
+     * The mask of modes currently granted through this entry.
+     */
+    uint32_t grantedModes() const {
+        return modesOf(state.load());
+    }
+
+    // The ResourceId of the resource which owns the entry, or 0 if the entry is free. Set once.
+    AtomicWord<uint64_t> resourceId{0};
+    AtomicWord<uint64_t> state{kDisabled};
+};
+
 /**
  * There is one of these objects for each resource that has a lock request. Empty objects (i.e.
  * LockHead with no requests) are allowed to exist on the lock manager's hash table.
@@ -148,6 +222,7 @@ struct LockHead {
      */
     void initNew(ResourceId resId) {
         resourceId = resId;
+        fastPath = nullptr;
 
         grantedList.reset();
         memset(grantedCounts, 0, sizeof(grantedCounts));
@@ -168,6 +243,15 @@ struct LockHead {
         return !partitions.empty();
     }
 
+    /**
+     * The modes granted through the fast path for this resource. These must be checked for
+     * conflicts in addition to 'grantedModes'. The fast path entry must have been looked up with
+     * LockManager::_getFastPathEntry() first.
+     */
+    uint32_t fastPathModes() const {
+        return fastPath ? fastPath->grantedModes() : 0;
+    }
+
     /**
      * Locates the request corresponding to the particular locker or returns nullptr. Must be called
      * with the bucket holding this lock head locked.
@@ -204,7 +288,7 @@ struct LockHead {
 
         // New lock request. Queue after all granted modes and after any already requested
         // conflicting modes
-        if (conflicts(request->mode, grantedModes) ||
+        if (conflicts(request->mode, grantedModes | fastPathModes()) ||
             (!compatibleFirstCount && conflicts(request->mode, conflictModes))) {
             request->status = LockRequest::STATUS_WAITING;
 
@@ -316,6 +400,10 @@ struct LockHead {
     // TODO: Remove this vector and make LockHead a POD
     std::vector<LockManager::Partition*> partitions;
 
+    // The fast path entry of this resource, or null if it has not been looked up or there is none.
+    // Entries are never released, so once set this does not change.
+    FastPathEntry* fastPath;
+
     //
     // Conversion
     //
@@ -417,6 +505,13 @@ const unsigned LockManager::_numLockBuckets(128);
 // The exact value doesn't appear very important, but should be power of two
 const unsigned LockManager::_numPartitions = 32;
 
+// Enough for the global resources and the databases and collections of a typical deployment.
+// Must be a power of two.
+const unsigned LockManager::_numFastPathEntries = 4096;
+
+// How far a lookup probes the fast path table before giving up.
+const unsigned kMaxFastPathProbes = 16;
+
 // static
 std::map<LockerId, BSONObj> LockManager::getLockToClientMap(ServiceContext* serviceContext) {
     std::map<LockerId, BSONObj> lockToClientMap;
@@ -446,6 +541,7 @@ std::map<LockerId, BSONObj> LockManager::getLockToClientMap(ServiceContext* serv
 LockManager::LockManager() {
     _lockBuckets = new LockBucket[_numLockBuckets];
     _partitions = new Partition[_numPartitions];
+    _fastPathEntries = new FastPathEntry[_numFastPathEntries];
 }
 
 LockManager::~LockManager() {
@@ -458,6 +554,7 @@ LockManager::~LockManager() {
 
     delete[] _lockBuckets;
     delete[] _partitions;
+    delete[] _fastPathEntries;
 }
 
 LockResult LockManager::lock(ResourceId resId, LockRequest* request, LockMode mode) {
@@ -467,6 +564,17 @@ LockResult LockManager::lock(ResourceId resId, LockRequest* request, LockMode mo
     request->partitioned = (mode == MODE_IX || mode == MODE_IS);
     request->mode = mode;
 
+    // Lock-free fast path for intent locks
+    if (request->partitioned) {
+        invariant(request->status == LockRequest::STATUS_NEW);
+        FastPathEntry* entry = _findFastPathEntry(resId, true);
+        if (entry && entry->tryAcquire(mode)) {
+            request->fastPathEntry = entry;
+            request->status = LockRequest::STATUS_GRANTED;
+            return LOCK_OK;
+        }
+    }
+
     // For intent modes, try the PartitionedLockHead
     if (request->partitioned) {
         Partition* partition = _getPartition(request);
@@ -491,6 +599,7 @@ LockResult LockManager::lock(ResourceId resId, LockRequest* request, LockMode mo
     invariant(request->status == LockRequest::STATUS_NEW);
 
     LockHead* lock = bucket->findOrInsert(resId);
+    _getFastPathEntry(lock);
 
     // Start a partitioned lock if possible
     if (request->partitioned && !(lock->grantedModes & (~intentModes)) && !lock->conflictModes) {
@@ -500,9 +609,16 @@ LockResult LockManager::lock(ResourceId resId, LockRequest* request, LockMode mo
         invariant(partitionedLock);
         lock->partitions.push_back(partition);
         partitionedLock->newRequest(request);
+
+        // The request may have come here only because the fast path entry was just created.
+        _maybeEnableFastPath(lock);
         return LOCK_OK;
     }
 
+    if (!request->partitioned) {
+        _disableFastPath(lock);
+    }
+
     // For the first lock with a non-intent mode, migrate requests from partitioned lock heads
     if (lock->partitioned()) {
         lock->migratePartitionedLockHeads();
@@ -538,10 +654,36 @@ LockResult LockManager::convert(ResourceId resId, LockRequest* request, LockMode
     stdx::lock_guard<SimpleMutex> scopedLock(bucket->mutex);
     invariant(request->status == LockRequest::STATUS_GRANTED);
 
-    LockBucket::Map::iterator it = bucket->data.find(resId);
-    invariant(it != bucket->data.end());
+    LockHead* const lock = [&] {
+        if (request->fastPathEntry) {
+            // The request was granted through the fast path, so its LockHead may not exist yet.
+            return bucket->findOrInsert(resId);
+        }
 
-    LockHead* const lock = it->second;
+        LockBucket::Map::iterator it = bucket->data.find(resId);
+        invariant(it != bucket->data.end());
+        return it->second;
+    }();
+    _getFastPathEntry(lock);
+
+    if (newMode != MODE_IS && newMode != MODE_IX) {
+        _disableFastPath(lock);
+    }
+
+    if (request->fastPathEntry) {
+        // Conversions are only handled on the LockHead, so move the request there. This does not
+        // change the set of granted modes, so there is nothing to wake up.
+        request->fastPathEntry->release(request->mode);
+        request->fastPathEntry = nullptr;
+        request->partitioned = false;
+        request->lock = lock;
+
+        lock->grantedList.push_back(request);
+        lock->incGrantedModeCount(request->mode);
+        if (request->compatibleFirst) {
+            lock->compatibleFirstCount++;
+        }
+    }
 
     if (lock->partitioned()) {
         lock->migratePartitionedLockHeads();
@@ -560,6 +702,7 @@ LockResult LockManager::convert(ResourceId resId, LockRequest* request, LockMode
             grantedModesWithoutCurrentRequest |= modeMask(static_cast<LockMode>(i));
         }
     }
+    grantedModesWithoutCurrentRequest |= lock->fastPathModes();
 
     // This check favours conversion requests over pending requests. For example:
     //
@@ -590,6 +733,25 @@ bool LockManager::unlock(LockRequest* request) {
     invariant(request->recursiveCount > 0);
     request->recursiveCount--;
 
+    if (FastPathEntry* entry = request->fastPathEntry) {
+        invariant(request->status == LockRequest::STATUS_GRANTED);
+        if (request->recursiveCount > 0)
+            return false;
+
+        request->fastPathEntry = nullptr;
+        if (entry->release(request->mode)) {
+            // A conflicting request may have been waiting for this one.
+            const auto resId = ResourceId::fromFullHash(entry->resourceId.load());
+            LockBucket* bucket = _getBucket(resId);
+            stdx::lock_guard<SimpleMutex> scopedLock(bucket->mutex);
+            LockBucket::Map::iterator it = bucket->data.find(resId);
+            if (it != bucket->data.end()) {
+                _onLockModeChanged(it->second, true);
+            }
+        }
+        return true;
+    }
+
     if (request->partitioned) {
         // Unlocking a lock that was acquired as partitioned. The lock request may since have
         // moved to the lock head, but there is no safe way to find out without synchronizing
@@ -706,7 +868,11 @@ void LockManager::_cleanupUnusedLocksInBucket(LockBucket* bucket) {
             lock->migratePartitionedLockHeads();
         }
 
-        if (lock->grantedModes == 0) {
+        // Requests granted through the fast path are not counted in 'grantedModes', and requests
+        // may be queued behind them, so the head is still in use while any of them is held.
+        _getFastPathEntry(lock);
+        if (lock->grantedModes == 0 && lock->fastPathModes() == 0 &&
+            lock->conflictList._front == nullptr) {
             invariant(lock->grantedModes == 0);
             invariant(lock->grantedList._front == nullptr);
             invariant(lock->grantedList._back == nullptr);
@@ -726,6 +892,10 @@ void LockManager::_cleanupUnusedLocksInBucket(LockBucket* bucket) {
 }
 
 void LockManager::_onLockModeChanged(LockHead* lock, bool checkConflictQueue) {
+    // Requests granted through the fast path only ever leave, so a stale view of them is safe. The
+    // last one to leave calls back in here.
+    const uint32_t fastPathModes = _getFastPathEntry(lock) ? lock->fastPathModes() : 0;
+
     // Unblock any converting requests (because conversions are still counted as granted and
     // are on the granted queue).
     for (LockRequest* iter = lock->grantedList._front;
@@ -755,6 +925,7 @@ void LockManager::_onLockModeChanged(LockHead* lock, bool checkConflictQueue) {
                     grantedModesWithoutCurrentRequest |= modeMask(static_cast<LockMode>(i));
                 }
             }
+            grantedModesWithoutCurrentRequest |= fastPathModes;
 
             if (!conflicts(iter->convertMode, grantedModesWithoutCurrentRequest)) {
                 lock->conversionsCount--;
@@ -795,7 +966,7 @@ void LockManager::_onLockModeChanged(LockHead* lock, bool checkConflictQueue) {
         // the granted queue.
         iterNext = iter->next;
 
-        if (conflicts(iter->mode, lock->grantedModes)) {
+        if (conflicts(iter->mode, lock->grantedModes | fastPathModes)) {
             // If iter doesn't have a previous pointer, this means that it is at the front of the
             // queue. If we continue scanning the queue beyond this point, we will starve it by
             // granting more and more requests. However, if we newly transition to compatibleFirst
@@ -833,6 +1004,8 @@ void LockManager::_onLockModeChanged(LockHead* lock, bool checkConflictQueue) {
     // with the bitmask on the modes.
     invariant((lock->grantedModes == 0) ^ (lock->grantedList._front != nullptr));
     invariant((lock->conflictModes == 0) ^ (lock->conflictList._front != nullptr));
+
+    _maybeEnableFastPath(lock);
 }
 
 LockManager::LockBucket* LockManager::_getBucket(ResourceId resId) const {
@@ -843,6 +1016,66 @@ LockManager::Partition* LockManager::_getPartition(LockRequest* request) const {
     return &_partitions[request->locker->getId() % _numPartitions];
 }
 
+FastPathEntry* LockManager::_findFastPathEntry(ResourceId resId, bool insert) const {
+    switch (resId.getType()) {
+        case RESOURCE_GLOBAL:
+        case RESOURCE_PBWM:
+        case RESOURCE_RSTL:
+        case RESOURCE_DATABASE:
+        case RESOURCE_COLLECTION:
+            break;
+        default:
+            return nullptr;
+    }
+
+    const uint64_t id = resId;
+    for (unsigned i = 0; i < kMaxFastPathProbes; i++) {
+        FastPathEntry* entry = &_fastPathEntries[(id + i) % _numFastPathEntries];
+        uint64_t entryId = entry->resourceId.load();
+        if (entryId == id) {
+            return entry;
+        }
+
+        // Entries are claimed in probe order and never released, so a free entry means that the
+        // resource has none.
+        if (entryId == 0) {
+            if (!insert) {
+                return nullptr;
+            }
+            if (entry->resourceId.compareAndSwap(&entryId, id) || entryId == id) {
+                return entry;
+            }
+        }
+    }
+
+    return nullptr;
+}
+
+FastPathEntry* LockManager::_getFastPathEntry(LockHead* lock) const {
+    if (!lock->fastPath) {
+        lock->fastPath = _findFastPathEntry(lock->resourceId, false);
+    }
+    return lock->fastPath;
+}
+
+void LockManager::_disableFastPath(LockHead* lock) {
+    FastPathEntry* entry = _getFastPathEntry(lock);
+    if (entry && !(entry->state.load() & FastPathEntry::kDisabled)) {
+        entry->state.fetchAndBitOr(FastPathEntry::kDisabled);
+    }
+}
+
+void LockManager::_maybeEnableFastPath(LockHead* lock) {
+    FastPathEntry* entry = _getFastPathEntry(lock);
+    if (!entry || !(entry->state.load() & FastPathEntry::kDisabled)) {
+        return;
+    }
+
+    if (!(lock->grantedModes & ~intentModes) && !lock->conflictModes) {
+        entry->state.fetchAndBitAnd(~FastPathEntry::kDisabled);
+    }
+}
+
 void LockManager::dump() const {
     BSONArrayBuilder locks;
     _buildLocksArray(getLockToClientMap(getGlobalServiceContext()), true, nullptr, &locks);
@@ -863,6 +1096,25 @@ void LockManager::_buildLocksArray(const std::map<LockerId, BSONObj>& lockToClie
                                    bool forLogging,
                                    LockManager* mutableThis,
                                    BSONArrayBuilder* locks) const {
+    // Requests granted through the fast path are not on any list, only counted on their entry, so
+    // they are reported as a count per mode under 'fastPathGranted'. The lockers holding them
+    // still report them among their own locks, as shown by currentOp.
+    std::map<uint64_t, BSONObj> fastPathGranted;
+    for (unsigned i = 0; i < _numFastPathEntries; ++i) {
+        const FastPathEntry& entry = _fastPathEntries[i];
+        const uint64_t resId = entry.resourceId.load();
+        const uint64_t state = entry.state.load();
+        if (!resId || !FastPathEntry::modesOf(state)) {
+            continue;
+        }
+        BSONObjBuilder counts;
+        for (auto mode : {MODE_IS, MODE_IX}) {
+            counts.append(modeName(mode),
+                          static_cast<long long>(FastPathEntry::countOf(state, mode)));
+        }
+        fastPathGranted.emplace(resId, counts.obj());
+    }
+
     for (size_t i = 0; i < _numLockBuckets; ++i) {
         LockBucket& bucket = _lockBuckets[i];
         stdx::lock_guard<SimpleMutex> scopedLock(bucket.mutex);
@@ -873,12 +1125,17 @@ void LockManager::_buildLocksArray(const std::map<LockerId, BSONObj>& lockToClie
         }
         for (auto&& kv : bucket.data) {
             const auto& lock = kv.second;
-            if (lock->grantedList.empty())
+            auto fastPath = fastPathGranted.find(lock->resourceId);
+            if (lock->grantedList.empty() && fastPath == fastPathGranted.end())
                 continue;
             auto o = BSONObjBuilder(locks->subobjStart());
             if (forLogging)
                 o.append("lockAddr", formatPtr(lock));
             o.append("resourceId", lock->resourceId.toString());
+            if (fastPath != fastPathGranted.end()) {
+                o.append("fastPathGranted", fastPath->second);
+                fastPathGranted.erase(fastPath);
+            }
             struct {
                 StringData key;
                 LockRequest* iter;
@@ -908,6 +1165,15 @@ void LockManager::_buildLocksArray(const std::map<LockerId, BSONObj>& lockToClie
             }
         }
     }
+
+    // Resources only locked through the fast path have no LockHead to report them with.
+    for (const auto& [resId, counts] : fastPathGranted) {
+        auto o = BSONObjBuilder(locks->subobjStart());
+        o.append("resourceId", ResourceId::fromFullHash(resId).toString());
+        o.append("fastPathGranted", counts);
+        BSONArrayBuilder(o.subarrayStart("granted"_sd)).doneFast();
+        BSONArrayBuilder(o.subarrayStart("pending"_sd)).doneFast();
+    }
 }
 
 PartitionedLockHead* LockManager::Partition::find(ResourceId resId) {
@@ -981,6 +1247,7 @@ void LockRequest::initNew(Locker* locker, LockGrantNotification* notify) {
 
     lock = nullptr;
     partitionedLock = nullptr;
+    fastPathEntry = nullptr;
     prev = nullptr;
     next = nullptr;
     status = STATUS_NEW;
@@ -142,6 +142,8 @@ public:
      *         // object for each lock in the LockManager (in any bucket),
      *         {
      *             "resourceId": <string>,
+     *             // present if intent locks are held through the fast path, which only counts them
+     *             "fastPathGranted": {"IS": <count>, "IX": <count>},
      *             "granted": [ {...}, ... ],  // array of lock requests
      *             "pending": [ {...}, ... ],  // array of lock requests
      *         },
@@ -175,6 +177,32 @@ private:
         Map data;
     };
 
+    /**
+     * Looks up the FastPathEntry of a resource in the lock-free fast path table. If 'insert' is
+     * true and the resource has no entry yet, claims one for it. Returns nullptr if the resource
+     * type does not use the fast path, or if the resource has no entry and none could be claimed.
+     */
+    FastPathEntry* _findFastPathEntry(ResourceId resId, bool insert) const;
+
+    /**
+     * Returns the FastPathEntry of the resource protected by 'lock', caching it on the LockHead.
+     * MUST be called under the lock bucket's mutex.
+     */
+    FastPathEntry* _getFastPathEntry(LockHead* lock) const;
+
+    /**
+     * Stops granting intent mode requests for the resource protected by 'lock' through the fast
+     * path, so that they are queued on 'lock' instead. Must be called, under the lock bucket's
+     * mutex, before a non-intent mode is granted or queued on 'lock'.
+     */
+    void _disableFastPath(LockHead* lock);
+
+    /**
+     * Re-enables the fast path for the resource protected by 'lock' if it no longer has any
+     * granted or pending non-intent mode requests. MUST be called under the lock bucket's mutex.
+     */
+    void _maybeEnableFastPath(LockHead* lock);
+
     /**
      * Retrieves the bucket in which the particular resource must reside. There is no need to
      * hold a lock when calling this function.
@@ -221,5 +249,11 @@ private:
 
     static const unsigned _numPartitions;
     Partition* _partitions;
+
+    // Open-addressed table of per-resource counters for intent locks acquired without taking any
+    // mutex. Entries are claimed the first time a resource is locked in an intent mode and are
+    // never released, so a resource which finds the table full keeps using the partitions.
+    static const unsigned _numFastPathEntries;
+    FastPathEntry* _fastPathEntries;
 };
 }  // namespace mongo
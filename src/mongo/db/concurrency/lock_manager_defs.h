@@ -48,6 +48,7 @@ class Locker;
 
 struct LockHead;
 struct PartitionedLockHead;
+struct FastPathEntry;
 
 /**
  * LockMode compatibility matrix.
@@ -214,6 +215,15 @@ public:
         : _fullHash(fullHash(type, hashStringData(ns))) {}
     ResourceId(ResourceType type, uint64_t hashId) : _fullHash(fullHash(type, hashId)) {}
 
+    /**
+     * Reconstructs a ResourceId from the value returned by its conversion to uint64_t.
+     */
+    static ResourceId fromFullHash(uint64_t fullHash) {
+        ResourceId resId;
+        resId._fullHash = fullHash;
+        return resId;
+    }
+
     bool isValid() const {
         return getType() != RESOURCE_INVALID;
     }
@@ -426,6 +436,15 @@ struct LockRequest {
     // Protected by LockHead bucket's mutex
     PartitionedLockHead* partitionedLock;
 
+    // Pointer to the fast path counters which account for this request, or null if the request is
+    // not held through the fast path. At most one of 'lock', 'partitionedLock' and 'fastPathEntry'
+    // is non-NULL, and a request can only transition from 'fastPathEntry' to 'lock'.
+    //
+    // Written by LockManager on Locker thread
+    // Read by LockManager on Locker thread
+    // No synchronization
+    FastPathEntry* fastPathEntry;
+
     // The linked list chain on which this request hangs off the owning lock head. The reason
     // intrusive linked list is used instead of the std::list class is to allow for entries to be
     // removed from the middle of the list in O(1) time, if they are known instead of having to
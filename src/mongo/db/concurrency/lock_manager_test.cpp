@@ -913,6 +913,155 @@ TEST(LockManager, CompatibleFirstCancelWaiting) {
     ASSERT(lockMgr.unlock(&requestX));
 }
 
+TEST(LockManager, IntentLocksUseFastPathUntilConflict) {
+    LockManager lockMgr;
+    const ResourceId resId(RESOURCE_COLLECTION, std::string("TestDB.collection"));
+
+    LockerImpl locker1;
+    LockerImpl locker2;
+    LockerImpl locker3;
+    LockerImpl locker4;
+
+    LockRequestCombo request1(&locker1);
+    LockRequestCombo request2(&locker2);
+    LockRequestCombo request3(&locker3);
+    LockRequestCombo request4(&locker4);
+
+    // The first intent request enables the fast path, which the following one uses
+    ASSERT(LOCK_OK == lockMgr.lock(resId, &request1, MODE_IS));
+    ASSERT(LOCK_OK == lockMgr.lock(resId, &request2, MODE_IX));
+    ASSERT(request2.fastPathEntry);
+
+    // A conflicting request must wait for the fast path holders
+    ASSERT(LOCK_WAITING == lockMgr.lock(resId, &request3, MODE_X));
+    lockMgr.unlock(&request1);
+    ASSERT(request3.numNotifies == 0);
+
+    // While it waits, intent requests queue behind it rather than using the fast path
+    ASSERT(LOCK_WAITING == lockMgr.lock(resId, &request4, MODE_IS));
+    ASSERT(!request4.fastPathEntry);
+
+    // Releasing the last fast path holder grants the conflicting request
+    lockMgr.unlock(&request2);
+    ASSERT(request3.numNotifies == 1);
+    ASSERT(request3.lastResult == LOCK_OK);
+    ASSERT(request4.numNotifies == 0);
+
+    lockMgr.unlock(&request3);
+    ASSERT(request4.numNotifies == 1);
+    ASSERT(request4.lastResult == LOCK_OK);
+
+    // Without conflicting modes, the fast path is used again
+    request1.initNew(&locker1, &request1);
+    ASSERT(LOCK_OK == lockMgr.lock(resId, &request1, MODE_IX));
+    ASSERT(request1.fastPathEntry);
+
+    lockMgr.unlock(&request1);
+    lockMgr.unlock(&request4);
+}
+
+TEST(LockManager, FastPathIntentLockConversion) {
+    LockManager lockMgr;
+    const ResourceId resId(RESOURCE_COLLECTION, std::string("TestDB.collection"));
+
+    LockerImpl locker1;
+    LockerImpl locker2;
+    LockerImpl locker3;
+
+    LockRequestCombo request1(&locker1);
+    LockRequestCombo request2(&locker2);
+    LockRequestCombo request3(&locker3);
+
+    ASSERT(LOCK_OK == lockMgr.lock(resId, &request1, MODE_IS));
+    ASSERT(LOCK_OK == lockMgr.lock(resId, &request2, MODE_IS));
+    ASSERT(LOCK_OK == lockMgr.lock(resId, &request3, MODE_IX));
+    ASSERT(request2.fastPathEntry);
+    ASSERT(request3.fastPathEntry);
+
+    // Converting a fast path request waits for the conflicting fast path holders
+    ASSERT(LOCK_WAITING == lockMgr.convert(resId, &request2, MODE_S));
+    ASSERT(!request2.fastPathEntry);
+    ASSERT(request2.mode == MODE_IS);
+    ASSERT(request2.convertMode == MODE_S);
+
+    lockMgr.unlock(&request3);
+    ASSERT(request2.numNotifies == 1);
+    ASSERT(request2.mode == MODE_S);
+
+    // Free the remaining locks so the LockManager destructor does not complain
+    lockMgr.unlock(&request2);
+    lockMgr.unlock(&request2);
+    lockMgr.unlock(&request1);
+}
+
+TEST(LockManager, CleanupKeepsLockWaitingForFastPathHolder) {
+    LockManager lockMgr;
+    const ResourceId resId(RESOURCE_COLLECTION, std::string("TestDB.collection"));
+
+    LockerImpl locker1;
+    LockerImpl locker2;
+    LockerImpl locker3;
+
+    LockRequestCombo request1(&locker1);
+    LockRequestCombo request2(&locker2);
+    LockRequestCombo request3(&locker3);
+
+    ASSERT(LOCK_OK == lockMgr.lock(resId, &request1, MODE_IS));
+    lockMgr.unlock(&request1);
+    ASSERT(LOCK_OK == lockMgr.lock(resId, &request2, MODE_IX));
+    ASSERT(request2.fastPathEntry);
+
+    // The X request waits on the head, which holds no granted mode of its own
+    ASSERT(LOCK_WAITING == lockMgr.lock(resId, &request3, MODE_X));
+    lockMgr.cleanupUnusedLocks();
+
+    // The head survived the cleanup, so releasing the fast path holder still grants the waiter
+    lockMgr.unlock(&request2);
+    ASSERT(request3.numNotifies == 1);
+    ASSERT(request3.lastResult == LOCK_OK);
+
+    lockMgr.unlock(&request3);
+    lockMgr.cleanupUnusedLocks();
+}
+
+TEST(LockManager, LockInfoReportsFastPathHolders) {
+    LockManager lockMgr;
+    // Unlike for a collection, describing the global resource does not need a CollectionCatalog.
+    const ResourceId resId = resourceIdGlobal;
+
+    LockerImpl locker1;
+    LockerImpl locker2;
+    LockerImpl locker3;
+
+    LockRequestCombo request1(&locker1);
+    LockRequestCombo request2(&locker2);
+    LockRequestCombo request3(&locker3);
+
+    ASSERT(LOCK_OK == lockMgr.lock(resId, &request1, MODE_IS));
+    ASSERT(LOCK_OK == lockMgr.lock(resId, &request2, MODE_IS));
+    ASSERT(LOCK_OK == lockMgr.lock(resId, &request3, MODE_IX));
+    ASSERT(request2.fastPathEntry);
+    ASSERT(request3.fastPathEntry);
+
+    BSONObjBuilder builder;
+    lockMgr.getLockInfoBSON({}, &builder);
+    const auto lockInfo = builder.obj();
+
+    boost::optional<BSONObj> resourceInfo;
+    for (auto&& elem : lockInfo["lockInfo"].Obj()) {
+        if (elem.Obj()["resourceId"].String() == resId.toString()) {
+            ASSERT(!resourceInfo);
+            resourceInfo = elem.Obj();
+        }
+    }
+    ASSERT(resourceInfo) << lockInfo;
+    ASSERT_BSONOBJ_EQ((*resourceInfo)["fastPathGranted"].Obj(), BSON("IS" << 1 << "IX" << 1));
+
+    lockMgr.unlock(&request3);
+    lockMgr.unlock(&request2);
+    lockMgr.unlock(&request1);
+}
+
 TEST(LockManager, Fairness) {
     LockManager lockMgr;
     const ResourceId resId(RESOURCE_GLOBAL, 0);
@@ -268,6 +268,17 @@ void CondVarLockGrantNotification::notify(ResourceId resId, LockResult result) {
 
 namespace {
 TicketHolder* ticketHolders[LockModesCount] = {};
+
+/**
+ * Work the server does on its own behalf is admitted ahead of everything else, whatever priority
+ * the operation asked for.
+ */
+AdmissionPriority effectiveAdmissionPriority(OperationContext* opCtx, AdmissionPriority requested) {
+    if (opCtx && opCtx->getClient() && opCtx->getClient()->isFromSystemConnection()) {
+        return AdmissionPriority::kInternal;
+    }
+    return requested;
+}
 }  // namespace
 
 
@@ -360,11 +371,13 @@ bool LockerImpl::_acquireTicket(OperationContext* opCtx, LockMode mode, Date_t d
             invariant(!opCtx->recoveryUnit()->isTimestamped());
 
         OperationContext* interruptible = _uninterruptibleLocksRequested ? nullptr : opCtx;
+        const auto priority = effectiveAdmissionPriority(opCtx, getAdmissionPriority());
         if (deadline == Date_t::max()) {
-            holder->waitForTicket(interruptible);
-        } else if (!holder->waitForTicketUntil(interruptible, deadline)) {
+            holder->waitForTicket(interruptible, priority);
+        } else if (!holder->waitForTicketUntil(interruptible, deadline, priority)) {
             return false;
         }
+        _priorityForTicket = priority;
         restoreStateOnErrorGuard.dismiss();
     }
     _clientState.store(reader ? kActiveReader : kActiveWriter);
@@ -1036,7 +1049,7 @@ void LockerImpl::releaseTicket() {
 void LockerImpl::_releaseTicket() {
     auto holder = shouldAcquireTicket() ? ticketHolders[_modeForTicket] : nullptr;
     if (holder) {
-        holder->release();
+        holder->release(_priorityForTicket);
     }
     _clientState.store(kInactive);
 }
@@ -346,6 +346,9 @@ private:
     // Mode for which the Locker acquired a ticket, or MODE_NONE if no ticket was acquired.
     LockMode _modeForTicket = MODE_NONE;
 
+    // Priority with which the ticket was acquired. Tickets must be released with the same one.
+    AdmissionPriority _priorityForTicket = AdmissionPriority::kInteractive;
+
     // Indicates whether the client is active reader/writer or is queued.
     AtomicWord<ClientState> _clientState{kInactive};
 
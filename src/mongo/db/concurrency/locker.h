@@ -37,6 +37,7 @@
 #include "mongo/db/concurrency/lock_stats.h"
 #include "mongo/db/operation_context.h"
 #include "mongo/stdx/thread.h"
+#include "mongo/util/concurrency/admission_priority.h"
 
 namespace mongo {
 
@@ -491,6 +492,19 @@ public:
         return _shouldAcquireTicket;
     }
 
+    /**
+     * The class of work used when queueing for a ticket. Only has an effect on ticket holders which
+     * prioritize admission. Operations on system connections are always admitted as internal
+     * work, and commands that other cluster members run on their own behalf are set to it when
+     * they are dispatched.
+     */
+    void setAdmissionPriority(AdmissionPriority priority) {
+        _admissionPriority = priority;
+    }
+    AdmissionPriority getAdmissionPriority() const {
+        return _admissionPriority;
+    }
+
     /**
      * Acquire a flow control admission ticket into the system. Flow control is used as a
      * backpressure mechanism to limit replication majority point lag.
@@ -539,6 +553,7 @@ protected:
 private:
     bool _shouldConflictWithSecondaryBatchApplication = true;
     bool _shouldAcquireTicket = true;
+    AdmissionPriority _admissionPriority = AdmissionPriority::kInteractive;
     std::string _debugInfo;  // Extra info about this locker for debugging purpose
 };
 
@@ -600,4 +615,27 @@ private:
     const bool _originalShouldConflict;
 };
 
+/**
+ * RAII-style class to set the admission priority of the operation using 'lockState' for the
+ * lifetime of this object.
+ */
+class ScopedAdmissionPriority {
+    ScopedAdmissionPriority(const ScopedAdmissionPriority&) = delete;
+    ScopedAdmissionPriority& operator=(const ScopedAdmissionPriority&) = delete;
+
+public:
+    ScopedAdmissionPriority(Locker* lockState, AdmissionPriority priority)
+        : _lockState(lockState), _originalPriority(_lockState->getAdmissionPriority()) {
+        _lockState->setAdmissionPriority(priority);
+    }
+
+    ~ScopedAdmissionPriority() {
+        _lockState->setAdmissionPriority(_originalPriority);
+    }
+
+private:
+    Locker* const _lockState;
+    const AdmissionPriority _originalPriority;
+};
+
 }  // namespace mongo
@@ -0,0 +1,258 @@
+/**
+ *    Copyright (C) 2021-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#define MONGO_LOGV2_DEFAULT_COMPONENT ::mongo::logv2::LogComponent::kWrite
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/exec/batched_delete_stage.h"
+
+#include "mongo/db/batched_write_context.h"
+#include "mongo/db/catalog/collection.h"
+#include "mongo/db/concurrency/write_conflict_exception.h"
+#include "mongo/db/exec/write_stage_common.h"
+#include "mongo/db/op_observer.h"
+#include "mongo/db/repl/replication_coordinator.h"
+#include "mongo/db/service_context.h"
+#include "mongo/util/scopeguard.h"
+
+namespace mongo {
+
+bool BatchedDeleteStage::canBatchDeletes(const CollectionPtr& collection) {
+    return !collection->ns().isOnInternalDb() && !collection->getRecordPreImages() &&
+        !collection->getRecordChangeStreamImages();
+}
+
+BatchedDeleteStage::BatchedDeleteStage(
+    ExpressionContext* expCtx,
+    std::unique_ptr<DeleteStageParams> params,
+    std::unique_ptr<BatchedDeleteStageParams> batchedDeleteParams,
+    WorkingSet* ws,
+    const CollectionPtr& collection,
+    PlanStage* child)
+    : RequiresMutableCollectionStage(kStageType.rawData(), expCtx, collection),
+      _params(std::move(params)),
+      _batchedDeleteParams(std::move(batchedDeleteParams)),
+      _ws(ws) {
+    invariant(_params->isMulti);
+    invariant(!_params->isExplain);
+    invariant(!_params->returnDeleted);
+    invariant(!expCtx->opCtx->getTxnNumber());
+    invariant(canBatchDeletes(collection));
+    invariant(_batchedDeleteParams->targetBatchDocs > 0);
+    _children.emplace_back(child);
+}
+
+bool BatchedDeleteStage::isEOF() {
+    if (_batchedDeleteParams->targetPassDocs &&
+        _specificStats.docsDeleted >= _batchedDeleteParams->targetPassDocs) {
+        return true;
+    }
+    return _stagedDeletes.empty() && child()->isEOF();
+}
+
+bool BatchedDeleteStage::_batchIsFull() const {
+    const long long numStaged = _stagedDeletes.size();
+    if (numStaged >= _batchedDeleteParams->targetBatchDocs ||
+        _stagedBytes >= _batchedDeleteParams->targetBatchBytes) {
+        return true;
+    }
+
+    // Don't buffer more documents than are left to delete in this pass.
+    return _batchedDeleteParams->targetPassDocs &&
+        _specificStats.docsDeleted + numStaged >= _batchedDeleteParams->targetPassDocs;
+}
+
+PlanStage::StageState BatchedDeleteStage::doWork(WorkingSetID* out) {
+    if (isEOF()) {
+        return PlanStage::IS_EOF;
+    }
+
+    if (!_batchIsFull() && !child()->isEOF()) {
+        WorkingSetID id;
+        auto status = child()->work(&id);
+
+        switch (status) {
+            case PlanStage::ADVANCED:
+                break;
+
+            case PlanStage::NEED_TIME:
+                return status;
+
+            case PlanStage::NEED_YIELD:
+                // The buffered members own their documents, which are checked again before they
+                // are deleted, so they can be kept across the yield.
+                *out = id;
+                return status;
+
+            case PlanStage::IS_EOF:
+                if (_stagedDeletes.empty()) {
+                    return status;
+                }
+                return _deleteBatch(out);
+
+            default:
+                MONGO_UNREACHABLE;
+        }
+
+        WorkingSetMember* member = _ws->get(id);
+        invariant(member->hasRecordId());
+        // Deletes can't have projections. This means that covering analysis will always add
+        // a fetch. We should always get fetched data, and never just key data.
+        invariant(member->hasObj());
+
+        // The document has to outlive the state of the child stage, which may be saved and
+        // restored several times before the batch is deleted.
+        member->makeObjOwnedIfNeeded();
+        _stagedBytes += member->getMemUsage();
+        _stagedDeletes.push_back(id);
+
+        if (!_batchIsFull() && !child()->isEOF()) {
+            return PlanStage::NEED_TIME;
+        }
+    }
+
+    return _deleteBatch(out);
+}
+
+PlanStage::StageState BatchedDeleteStage::_deleteBatch(WorkingSetID* out) {
+    invariant(!_stagedDeletes.empty());
+
+    try {
+        child()->saveState();
+    } catch (const WriteConflictException&) {
+        std::terminate();
+    }
+
+    long long docsDeleted = 0;
+    size_t numProcessed = 0;
+    try {
+        WriteUnitOfWork wunit(opCtx());
+        auto opObserver = opCtx()->getServiceContext()->getOpObserver();
+        opObserver->onBatchedWriteStart(opCtx());
+        auto abortBatch = makeGuard([&] { opObserver->onBatchedWriteAbort(opCtx()); });
+        const auto& batchedWriteContext = BatchedWriteContext::get(opCtx());
+
+        for (; numProcessed < _stagedDeletes.size(); ++numProcessed) {
+            auto id = _stagedDeletes[numProcessed];
+            // Ensure the document still exists and matches the predicate. Documents which no
+            // longer do are skipped.
+            if (!write_stage_common::ensureStillMatches(
+                    collection(), opCtx(), _ws, id, _params->canonicalQuery)) {
+                continue;
+            }
+
+            WorkingSetMember* member = _ws->get(id);
+            member->makeObjOwnedIfNeeded();
+            Snapshotted<Document> memberDoc = member->doc;
+            BSONObj bsonObjDoc = memberDoc.value().toBson();
+
+            // All the writes of the WriteUnitOfWork commit at the timestamp of its oplog entry, so
+            // the batch must fit in a single 'applyOps' entry. The entry of a delete holds a subset
+            // of the fields of the document, so stop before a document which might not fit, and
+            // leave it and the rest of the buffer to the next batch.
+            if (docsDeleted > 0 &&
+                batchedWriteContext.getBatchedOperationsSizeBytes() +
+                        sizeof(repl::ReplOperation) + collection()->ns().size() +
+                        bsonObjDoc.objsize() >
+                    static_cast<size_t>(BSONObjMaxUserSize)) {
+                break;
+            }
+
+            if (_params->removeSaver) {
+                uassertStatusOK(_params->removeSaver->goingToDelete(bsonObjDoc));
+            }
+
+            collection()->deleteDocument(opCtx(),
+                                         Snapshotted(memberDoc.snapshotId(), bsonObjDoc),
+                                         _params->stmtId,
+                                         member->recordId,
+                                         _params->opDebug,
+                                         _params->fromMigrate,
+                                         false,
+                                         Collection::StoreDeletedDoc::Off);
+            ++docsDeleted;
+        }
+
+        opObserver->onBatchedWriteCommit(opCtx());
+        abortBatch.dismiss();
+        wunit.commit();
+    } catch (const WriteConflictException&) {
+        // None of the batch was deleted. Keep the buffered members around to retry the whole
+        // batch after yielding.
+        *out = WorkingSet::INVALID_ID;
+        return NEED_YIELD;
+    }
+
+    _specificStats.docsDeleted += docsDeleted;
+    for (size_t i = 0; i < numProcessed; ++i) {
+        _ws->free(_stagedDeletes[i]);
+    }
+    _stagedDeletes.erase(_stagedDeletes.begin(), _stagedDeletes.begin() + numProcessed);
+    _stagedBytes = 0;
+    for (auto id : _stagedDeletes) {
+        _stagedBytes += _ws->get(id)->getMemUsage();
+    }
+
+    // As restoreState may restore (recreate) cursors, cursors are tied to the transaction in which
+    // they are created, and a WriteUnitOfWork is a transaction, make sure to restore the state
+    // outside of the WriteUnitOfWork.
+    try {
+        child()->restoreState(&collection());
+    } catch (const WriteConflictException&) {
+        // The batch was already committed, so there is nothing to retry.
+        *out = WorkingSet::INVALID_ID;
+        return NEED_YIELD;
+    }
+
+    return PlanStage::NEED_TIME;
+}
+
+void BatchedDeleteStage::doRestoreStateRequiresCollection() {
+    const NamespaceString& ns = collection()->ns();
+    uassert(ErrorCodes::PrimarySteppedDown,
+            str::stream() << "Demoted from primary while removing from " << ns.ns(),
+            !opCtx()->writesAreReplicated() ||
+                repl::ReplicationCoordinator::get(opCtx())->canAcceptWritesFor(opCtx(), ns));
+}
+
+std::unique_ptr<PlanStageStats> BatchedDeleteStage::getStats() {
+    _commonStats.isEOF = isEOF();
+    auto ret = std::make_unique<PlanStageStats>(_commonStats, STAGE_BATCHED_DELETE);
+    ret->specific = std::make_unique<DeleteStats>(_specificStats);
+    ret->children.emplace_back(child()->getStats());
+    return ret;
+}
+
+const SpecificStats* BatchedDeleteStage::getSpecificStats() const {
+    return &_specificStats;
+}
+
+}  // namespace mongo
@@ -0,0 +1,134 @@
+/**
+ *    Copyright (C) 2021-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#pragma once
+
+#include <vector>
+
+#include "mongo/db/exec/delete.h"
+#include "mongo/db/exec/requires_collection_stage.h"
+#include "mongo/db/query/query_knobs_gen.h"
+
+namespace mongo {
+
+struct BatchedDeleteStageParams {
+    BatchedDeleteStageParams()
+        : targetBatchDocs(gBatchedDeletesTargetBatchDocs.load()),
+          targetBatchBytes(gBatchedDeletesTargetBatchBytes.load()) {}
+
+    // Number of documents deleted in each storage transaction.
+    long long targetBatchDocs;
+
+    // A batch is deleted as soon as its documents add up to this many bytes, even if it holds fewer
+    // than 'targetBatchDocs' documents.
+    long long targetBatchBytes;
+
+    // If not 0, the stage reports EOF once it has deleted this many documents.
+    long long targetPassDocs = 0;
+};
+
+/**
+ * This stage deletes the documents returned by its child like the DeleteStage, but rather than
+ * deleting each document in a WriteUnitOfWork of its own, it buffers them and deletes them in
+ * batches. The deletes of a batch are committed in one storage transaction and logged as a single
+ * 'applyOps' oplog entry, so a batch is cut short rather than grow past the maximum size of one.
+ *
+ * Only multi-deletes outside of multi-document transactions and retryable writes can be batched,
+ * and the stage cannot return the deleted documents. A write conflict retries the whole batch.
+ *
+ * Callers of work() must be holding a write lock (and, for replicated deletes, callers must have
+ * had the replication coordinator approve the write).
+ */
+class BatchedDeleteStage final : public RequiresMutableCollectionStage {
+    BatchedDeleteStage(const BatchedDeleteStage&) = delete;
+    BatchedDeleteStage& operator=(const BatchedDeleteStage&) = delete;
+
+public:
+    static constexpr StringData kStageType = "BATCHED_DELETE"_sd;
+
+    /**
+     * Returns true if multi-deletes from 'collection' may be batched. Writes to the internal
+     * databases have side effects which depend on being logged individually, and the pre-images
+     * of a collection which records them are written to the oplog entry of each delete, so
+     * neither are batched.
+     */
+    static bool canBatchDeletes(const CollectionPtr& collection);
+
+    BatchedDeleteStage(ExpressionContext* expCtx,
+                       std::unique_ptr<DeleteStageParams> params,
+                       std::unique_ptr<BatchedDeleteStageParams> batchedDeleteParams,
+                       WorkingSet* ws,
+                       const CollectionPtr& collection,
+                       PlanStage* child);
+
+    bool isEOF() final;
+    StageState doWork(WorkingSetID* out) final;
+
+    StageType stageType() const final {
+        return STAGE_BATCHED_DELETE;
+    }
+
+    std::unique_ptr<PlanStageStats> getStats() final;
+
+    const SpecificStats* getSpecificStats() const final;
+
+protected:
+    void doSaveStateRequiresCollection() final {}
+
+    void doRestoreStateRequiresCollection() final;
+
+private:
+    /**
+     * Returns true once enough documents are buffered to delete them.
+     */
+    bool _batchIsFull() const;
+
+    /**
+     * Deletes the buffered documents that still match the predicate in a single WriteUnitOfWork,
+     * up to as many as fit in one 'applyOps' oplog entry. The others stay buffered for the next
+     * batch. On a write conflict, keeps the buffer to retry the batch and returns NEED_YIELD.
+     */
+    StageState _deleteBatch(WorkingSetID* out);
+
+    std::unique_ptr<DeleteStageParams> _params;
+    std::unique_ptr<BatchedDeleteStageParams> _batchedDeleteParams;
+
+    // Not owned by us.
+    WorkingSet* _ws;
+
+    // The documents waiting to be deleted with the next batch.
+    std::vector<WorkingSetID> _stagedDeletes;
+    long long _stagedBytes = 0;
+
+    // Stats
+    DeleteStats _specificStats;
+};
+
+}  // namespace mongo
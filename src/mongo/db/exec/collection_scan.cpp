@@ -42,6 +42,7 @@
 #include "mongo/db/exec/working_set.h"
 #include "mongo/db/exec/working_set_common.h"
 #include "mongo/db/repl/optime.h"
+#include "mongo/db/repl/read_concern_args.h"
 #include "mongo/logv2/log.h"
 #include "mongo/util/fail_point.h"
 
@@ -94,6 +95,11 @@ CollectionScan::CollectionScan(ExpressionContext* expCtx,
         // only support in the forward direction.
         invariant(params.direction == CollectionScanParams::FORWARD);
     }
+
+    if (params.shareOplogScan) {
+        invariant(params.tailable && params.direction == CollectionScanParams::FORWARD);
+        invariant(collection->ns().isOplog());
+    }
 }
 
 PlanStage::StageState CollectionScan::doWork(WorkingSetID* out) {
@@ -101,6 +107,10 @@ PlanStage::StageState CollectionScan::doWork(WorkingSetID* out) {
         return PlanStage::IS_EOF;
     }
 
+    if (_sharedOplogScan) {
+        return workSharedOplogScan(out);
+    }
+
     boost::optional<Record> record;
     const bool needToMakeCursor = !_cursor;
     try {
@@ -193,6 +203,7 @@ PlanStage::StageState CollectionScan::doWork(WorkingSetID* out) {
         // where we left off on the next call to work(). Otherwise, the EOF is permanent.
         if (_params.tailable && !_lastSeenId.isNull()) {
             _cursor.reset();
+            tryJoinSharedOplogScan();
         } else {
             _commonStats.isEOF = true;
         }
@@ -226,6 +237,66 @@ void CollectionScan::setLatestOplogEntryTimestamp(const Record& record) {
     _latestOplogEntryTimestamp = std::max(_latestOplogEntryTimestamp, tsElem.timestamp());
 }
 
+void CollectionScan::tryJoinSharedOplogScan() {
+    if (!_params.shareOplogScan || _params.maxRecord ||
+        _params.stopApplyingFilterAfterFirstMatch) {
+        return;
+    }
+
+    // Entries read by another change stream are handed to us, so they must have been read from a
+    // snapshot at least as durable as ours. All change streams sharing the scan read majority
+    // committed data, see SharedOplogScan.
+    const auto& readConcernArgs = repl::ReadConcernArgs::get(opCtx());
+    if (readConcernArgs.getLevel() != repl::ReadConcernLevel::kMajorityReadConcern ||
+        readConcernArgs.getMajorityReadMechanism() !=
+            repl::ReadConcernArgs::MajorityReadMechanism::kMajoritySnapshot) {
+        return;
+    }
+
+    _sharedOplogScan = SharedOplogScan::get(opCtx()->getServiceContext())
+                           .join(boost::intrusive_ptr<ExpressionContext>(expCtx()),
+                                 expCtx()->ns,
+                                 _filter,
+                                 _lastSeenId);
+}
+
+PlanStage::StageState CollectionScan::workSharedOplogScan(WorkingSetID* out) {
+    SharedOplogScan::NextResult next;
+    try {
+        next = _sharedOplogScan->next(opCtx(), collection());
+    } catch (const WriteConflictException&) {
+        *out = WorkingSet::INVALID_ID;
+        return PlanStage::NEED_YIELD;
+    }
+
+    if (next.detached) {
+        // Go back to scanning the oplog ourselves, from the last entry we returned.
+        _sharedOplogScan.reset();
+        return PlanStage::NEED_TIME;
+    }
+
+    if (!next.entry) {
+        // Every entry up to 'scannedThrough' which matches our filter has been returned.
+        _latestOplogEntryTimestamp = std::max(_latestOplogEntryTimestamp, next.scannedThrough);
+        return PlanStage::IS_EOF;
+    }
+
+    Record record{next.entry->id, RecordData(next.entry->obj.objdata(), next.entry->obj.objsize())};
+    _lastSeenId = record.id;
+    setLatestOplogEntryTimestamp(record);
+
+    // The shared scan already applied our filter.
+    ++_specificStats.docsTested;
+    WorkingSetID id = _workingSet->allocate();
+    WorkingSetMember* member = _workingSet->get(id);
+    member->recordId = record.id;
+    member->resetDocument(opCtx()->recoveryUnit()->getSnapshotId(), next.entry->obj);
+    _workingSet->transitionToRecordIdAndObj(id);
+
+    *out = id;
+    return PlanStage::ADVANCED;
+}
+
 void CollectionScan::assertTsHasNotFallenOffOplog(const Record& record) {
     // If the first entry we see in the oplog is the replset initialization, then it doesn't matter
     // if its timestamp is later than the timestamp that should not have fallen off the oplog; no
@@ -33,6 +33,7 @@
 
 #include "mongo/db/exec/collection_scan_common.h"
 #include "mongo/db/exec/requires_collection_stage.h"
+#include "mongo/db/exec/shared_oplog_scan.h"
 #include "mongo/db/matcher/expression_leaf.h"
 #include "mongo/db/record_id.h"
 #include "mongo/s/resharding/resume_token_gen.h"
@@ -113,6 +114,17 @@ private:
      */
     void setLatestOplogEntryTimestamp(const Record& record);
 
+    /**
+     * Joins the oplog scan shared by change streams if this scan is allowed to. Called when this
+     * tailable scan of the oplog has caught up with its end.
+     */
+    void tryJoinSharedOplogScan();
+
+    /**
+     * Returns the next document matched for us by the shared oplog scan, if any.
+     */
+    StageState workSharedOplogScan(WorkingSetID* out);
+
     /**
      * Asserts that the minimum timestamp in the query filter has not already fallen off the oplog.
      */
@@ -126,6 +138,9 @@ private:
 
     std::unique_ptr<SeekableRecordCursor> _cursor;
 
+    // Set while this scan of the oplog reads it through the SharedOplogScan instead of '_cursor'.
+    std::unique_ptr<SharedOplogScan::Subscription> _sharedOplogScan;
+
     CollectionScanParams _params;
 
     RecordId _lastSeenId;  // Null if nothing has been returned from _cursor yet.
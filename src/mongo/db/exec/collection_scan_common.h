@@ -85,6 +85,10 @@ struct CollectionScanParams {
 
     // Whether or not to wait for oplog visibility on oplog collection scans.
     bool shouldWaitForOplogVisibility = false;
+
+    // Whether a tailable scan of the oplog for a change stream may join the SharedOplogScan once
+    // it has caught up with the end of the oplog.
+    bool shareOplogScan = false;
 };
 
 }  // namespace mongo
@@ -104,8 +104,9 @@ bool DocumentStorageIterator::shouldSkipDeleted() {
         if (auto pos = _storage->findFieldInCache(fieldName); pos.found()) {
             _it = _first->plusBytes(pos.index);
             if (_it->kind == ValueElement::Kind::kMaybeInserted) {
-                // We have found the value in the BSON so it was not in fact inserted.
-                const_cast<ValueElement*>(_it)->kind = ValueElement::Kind::kCached;
+                // We have found the value in the BSON so it was not in fact inserted. It was set
+                // without looking at the BSON, though, so the BSON image is stale.
+                const_cast<ValueElement*>(_it)->kind = ValueElement::Kind::kModified;
             }
             if (_it->val.missing()) {
                 return true;
@@ -119,7 +120,8 @@ bool DocumentStorageIterator::shouldSkipDeleted() {
             _it = nullptr;
         }
     } else if (!atEnd()) {
-        if (_it->val.missing() || _it->kind == ValueElement::Kind::kCached) {
+        if (_it->val.missing() || _it->kind == ValueElement::Kind::kCached ||
+            _it->kind == ValueElement::Kind::kModified) {
             return true;
         }
     }
@@ -445,13 +447,34 @@ void Document::toBson(BSONObjBuilder* builder, size_t recursionLevel) const {
                           << BSONDepth::getMaxAllowableDepth() << " levels of nesting",
             recursionLevel <= BSONDepth::getMaxAllowableDepth());
 
+    // Fields which still match their image in the backing BSON are copied as raw bytes, and runs
+    // of adjacent ones with a single copy. Only modified and inserted fields are serialized from
+    // their Value.
+    const char* runStart = nullptr;
+    const char* runEnd = nullptr;
+    auto flushRun = [&] {
+        if (runStart != runEnd) {
+            builder->bb().appendBuf(runStart, runEnd - runStart);
+        }
+        runStart = runEnd = nullptr;
+    };
+
     for (DocumentStorageIterator it = storage().iterator(); !it.atEnd(); it.advance()) {
-        if (auto cached = it.cachedValue()) {
-            cached->val.addToBsonObj(builder, cached->nameSD(), recursionLevel);
-        } else {
-            builder->append(*it.bsonIter());
+        auto cached = it.cachedValue();
+        if (it.bsonIter().more() && (!cached || cached->kind == ValueElement::Kind::kCached)) {
+            BSONElement elem = *it.bsonIter();
+            if (elem.rawdata() != runEnd) {
+                flushRun();
+                runStart = elem.rawdata();
+            }
+            runEnd = elem.rawdata() + elem.size();
+            continue;
         }
+
+        flushRun();
+        cached->val.addToBsonObj(builder, cached->nameSD(), recursionLevel);
     }
+    flushRun();
 }
 
 BSONObj Document::toBson() const {
@@ -90,7 +90,9 @@ public:
         // The value has the image in the underlying BSON.
         kCached,
         // The value has been opportunistically inserted into the cache without checking the BSON.
-        kMaybeInserted
+        kMaybeInserted,
+        // The value has the image in the underlying BSON, but may have been changed since.
+        kModified
     };
 
     Value val;
@@ -343,7 +345,13 @@ public:
     ValueElement& getField(Position pos) {
         _modified = true;
         verify(pos.found());
-        return *(_firstElement->plusBytes(pos.index));
+        auto& elem = *(_firstElement->plusBytes(pos.index));
+        // The caller may write through the returned reference, so the BSON image can no longer be
+        // trusted for this field.
+        if (elem.kind == ValueElement::Kind::kCached) {
+            elem.kind = ValueElement::Kind::kModified;
+        }
+        return elem;
     }
     Value& getField(StringData name, LookupPolicy policy) {
         _modified = true;
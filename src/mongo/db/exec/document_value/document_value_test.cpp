@@ -176,6 +176,33 @@ TEST(DocumentSerialization, CannotSerializeDocumentThatExceedsDepthLimit) {
     throwaway.abandon();
 }
 
+TEST(DocumentSerialization, ModifiedFieldsOverrideBackingBson) {
+    BSONObj bson = BSON("a" << 1 << "b" << BSON("x" << 1 << "y" << 2) << "c" << 3 << "d" << 4
+                            << "e" << 5 << "f" << 6);
+    Document original = fromBson(bson);
+
+    // Read some fields, which caches them without modifying them.
+    ASSERT_VALUE_EQ(original["a"], Value(1));
+    ASSERT_VALUE_EQ(original["e"], Value(5));
+
+    MutableDocument md(original);
+    // Set without looking at the BSON first, written through a lookup, and written through a
+    // nested lookup respectively.
+    md.setField("c", Value(30));
+    md.getField("d") = Value(40);
+    md.setNestedField(FieldPath("b.y"), Value(20));
+    md.remove("f");
+    md.addField("g", Value(7));
+    Document modified = md.freeze();
+
+    ASSERT_BSONOBJ_EQ(modified.toBson(),
+                      BSON("a" << 1 << "b" << BSON("x" << 1 << "y" << 20) << "c" << 30 << "d" << 40
+                               << "e" << 5 << "g" << 7));
+
+    // The original document still serializes to its unmodified backing BSON.
+    ASSERT_BSONOBJ_EQ(original.toBson(), bson);
+}
+
 TEST(DocumentGetFieldNonCaching, UncachedTopLevelFields) {
     BSONObj bson = BSON("scalar" << 1 << "array" << BSON_ARRAY(1 << 2 << 3) << "scalar2" << true);
     Document document = fromBson(bson);
@@ -0,0 +1,290 @@
+/**
+ *    Copyright (C) 2021-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/exec/shared_oplog_scan.h"
+
+#include <algorithm>
+
+#include "mongo/db/catalog/collection.h"
+#include "mongo/db/operation_context.h"
+#include "mongo/db/query/query_knobs_gen.h"
+#include "mongo/db/repl/oplog_entry.h"
+#include "mongo/db/service_context.h"
+#include "mongo/util/scopeguard.h"
+
+namespace mongo {
+namespace {
+
+const auto getSharedOplogScan = ServiceContext::declareDecoration<SharedOplogScan>();
+
+// Upper bound on the number of oplog entries read at once on behalf of all subscribers, so that
+// the subscriber doing so returns to its own client in a timely manner.
+constexpr size_t kMaxEntriesPerRead = 1000;
+
+bool isCrudOpType(StringData opType) {
+    return opType == "i"_sd || opType == "u"_sd || opType == "d"_sd;
+}
+
+}  // namespace
+
+SharedOplogScan& SharedOplogScan::get(ServiceContext* serviceContext) {
+    return getSharedOplogScan(serviceContext);
+}
+
+std::unique_ptr<SharedOplogScan::Subscription> SharedOplogScan::join(
+    const boost::intrusive_ptr<ExpressionContext>& expCtx,
+    const NamespaceString& nss,
+    const MatchExpression* filter,
+    const RecordId& lastSeenId) {
+    invariant(!lastSeenId.isNull());
+
+    stdx::lock_guard<Latch> lk(_mutex);
+    const bool idle = !_pumping && std::all_of(_subscribers.begin(),
+                                               _subscribers.end(),
+                                               [](const auto& s) { return s->detached; });
+    if (idle) {
+        // Nobody depends on the current position of the scan, so it can start over from the
+        // position of the new subscriber.
+        _lastScannedId = lastSeenId;
+        _lastScannedTs = Timestamp();
+    } else if (_lastScannedId > lastSeenId) {
+        return nullptr;
+    }
+
+    auto subscriber = std::make_shared<Subscriber>();
+    subscriber->expCtx = expCtx;
+    subscriber->filter = filter ? filter->shallowClone() : nullptr;
+    subscriber->nss = nss;
+    subscriber->startAfter = lastSeenId;
+
+    if (nss.isAdminDB()) {
+        _index.wholeCluster.push_back(subscriber);
+    } else if (nss.isCollectionlessAggregateNS()) {
+        _index.byDatabase[nss.db().toString()].push_back(subscriber);
+    } else {
+        _index.byCollection[nss.ns()].push_back(subscriber);
+    }
+    _index.all.push_back(subscriber);
+
+    auto it = _subscribers.insert(_subscribers.end(), std::move(subscriber));
+    return std::unique_ptr<Subscription>(new Subscription(this, it));
+}
+
+size_t SharedOplogScan::numSubscribers() const {
+    stdx::lock_guard<Latch> lk(_mutex);
+    return _subscribers.size();
+}
+
+void SharedOplogScan::_leave(SubscriberList::iterator it) {
+    // The subscriber may outlive its subscription in a copy of the index, so it is only destroyed
+    // once '_mutex' is released.
+    std::shared_ptr<Subscriber> subscriber = *it;
+
+    stdx::lock_guard<Latch> lk(_mutex);
+    auto erase = [&subscriber](SubscriberIndex::Subscribers* subscribers) {
+        subscribers->erase(std::remove(subscribers->begin(), subscribers->end(), subscriber),
+                           subscribers->end());
+        return subscribers->empty();
+    };
+
+    const auto& nss = subscriber->nss;
+    if (nss.isAdminDB()) {
+        erase(&_index.wholeCluster);
+    } else if (nss.isCollectionlessAggregateNS()) {
+        auto byDatabase = _index.byDatabase.find(nss.db().toString());
+        if (erase(&byDatabase->second)) {
+            _index.byDatabase.erase(byDatabase);
+        }
+    } else {
+        auto byCollection = _index.byCollection.find(nss.ns());
+        if (erase(&byCollection->second)) {
+            _index.byCollection.erase(byCollection);
+        }
+    }
+    erase(&_index.all);
+    _subscribers.erase(it);
+}
+
+void SharedOplogScan::_pump(OperationContext* opCtx, const CollectionPtr& collection) {
+    // '_lastScannedId' only changes while some subscriber is pumping, which is us.
+    const RecordId lastScannedId = [&] {
+        stdx::lock_guard<Latch> lk(_mutex);
+        return _lastScannedId;
+    }();
+
+    auto cursor = collection->getCursor(opCtx);
+    if (!cursor->seekExact(lastScannedId)) {
+        // The last entry we read is gone, for instance because the oplog was truncated after a
+        // rollback. Let each subscriber report the lost position from its own scan.
+        stdx::lock_guard<Latch> lk(_mutex);
+        _detachAll(lk);
+        return;
+    }
+
+    std::vector<Entry> batch;
+    while (batch.size() < kMaxEntriesPerRead) {
+        auto record = cursor->next();
+        if (!record) {
+            break;
+        }
+        batch.push_back({record->id, record->data.toBson().getOwned()});
+    }
+    if (batch.empty()) {
+        return;
+    }
+
+    // Subscribers which join from now on start after this batch, so the copy of the index covers
+    // every subscriber which may be given one of its entries.
+    SubscriberIndex index;
+    {
+        stdx::lock_guard<Latch> lk(_mutex);
+        index = _index;
+        _lastScannedId = batch.back().id;
+        for (auto it = batch.rbegin(); it != batch.rend(); ++it) {
+            auto tsElem = it->obj[repl::OpTime::kTimestampFieldName];
+            if (tsElem.type() == BSONType::bsonTimestamp) {
+                _lastScannedTs = tsElem.timestamp();
+                break;
+            }
+        }
+    }
+
+    std::vector<std::vector<Subscriber*>> matches(batch.size());
+    for (size_t i = 0; i < batch.size(); ++i) {
+        _match(index, batch[i], &matches[i]);
+    }
+
+    stdx::lock_guard<Latch> lk(_mutex);
+    for (size_t i = 0; i < batch.size(); ++i) {
+        for (auto subscriber : matches[i]) {
+            _dispatchTo(lk, subscriber, batch[i]);
+        }
+    }
+}
+
+void SharedOplogScan::_match(const SubscriberIndex& index,
+                             const Entry& entry,
+                             std::vector<Subscriber*>* matches) {
+    auto matchAll = [&](const SubscriberIndex::Subscribers& subscribers) {
+        for (const auto& subscriber : subscribers) {
+            if (entry.id <= subscriber->startAfter) {
+                continue;
+            }
+            if (subscriber->filter && !subscriber->filter->matchesBSON(entry.obj)) {
+                continue;
+            }
+            matches->push_back(subscriber.get());
+        }
+    };
+
+    const auto opType = entry.obj[repl::OplogEntry::kOpTypeFieldName].valueStringDataSafe();
+    if (!isCrudOpType(opType)) {
+        matchAll(index.all);
+        return;
+    }
+
+    // A CRUD entry can only be of interest to the change streams watching its collection, its
+    // database or the whole cluster.
+    const NamespaceString nss(entry.obj[repl::OplogEntry::kNssFieldName].valueStringDataSafe());
+    if (auto byCollection = index.byCollection.find(nss.ns());
+        byCollection != index.byCollection.end()) {
+        matchAll(byCollection->second);
+    }
+    if (auto byDatabase = index.byDatabase.find(nss.db().toString());
+        byDatabase != index.byDatabase.end()) {
+        matchAll(byDatabase->second);
+    }
+    matchAll(index.wholeCluster);
+}
+
+void SharedOplogScan::_dispatchTo(WithLock, Subscriber* subscriber, const Entry& entry) {
+    if (subscriber->detached) {
+        return;
+    }
+
+    const auto maxBufferedEntries = gChangeStreamSharedOplogScanMaxBufferedEntries.load();
+    if (subscriber->buffer.size() >= static_cast<size_t>(maxBufferedEntries)) {
+        // The subscriber is not keeping up. Rather than holding on to an ever growing buffer,
+        // let it read the oplog at its own pace.
+        subscriber->detached = true;
+        subscriber->buffer.clear();
+        return;
+    }
+    subscriber->buffer.push_back(entry);
+}
+
+void SharedOplogScan::_detachAll(WithLock) {
+    for (const auto& subscriber : _subscribers) {
+        subscriber->detached = true;
+        subscriber->buffer.clear();
+    }
+    _lastScannedId = RecordId();
+    _lastScannedTs = Timestamp();
+}
+
+SharedOplogScan::Subscription::~Subscription() {
+    _scan->_leave(_it);
+}
+
+SharedOplogScan::NextResult SharedOplogScan::Subscription::next(OperationContext* opCtx,
+                                                                const CollectionPtr& collection) {
+    auto& scan = *_scan;
+    auto subscriber = _it->get();
+
+    stdx::unique_lock<Latch> lk(scan._mutex);
+    if (subscriber->buffer.empty() && !subscriber->detached) {
+        if (scan._pumping) {
+            opCtx->waitForConditionOrInterrupt(
+                scan._pumpDone, lk, [&] { return !scan._pumping; });
+        } else {
+            scan._pumping = true;
+            lk.unlock();
+            ON_BLOCK_EXIT([&] {
+                lk.lock();
+                scan._pumping = false;
+                scan._pumpDone.notify_all();
+            });
+            scan._pump(opCtx, collection);
+        }
+    }
+
+    NextResult result;
+    result.detached = subscriber->detached;
+    if (!subscriber->buffer.empty()) {
+        result.entry = std::move(subscriber->buffer.front());
+        subscriber->buffer.pop_front();
+    } else {
+        result.scannedThrough = scan._lastScannedTs;
+    }
+    return result;
+}
+
+}  // namespace mongo
@@ -0,0 +1,219 @@
+/**
+ *    Copyright (C) 2021-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <deque>
+#include <list>
+#include <memory>
+
+#include "mongo/bson/bsonobj.h"
+#include "mongo/bson/timestamp.h"
+#include "mongo/db/matcher/expression.h"
+#include "mongo/db/namespace_string.h"
+#include "mongo/db/pipeline/expression_context.h"
+#include "mongo/db/record_id.h"
+#include "mongo/platform/mutex.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/unordered_map.h"
+#include "mongo/util/concurrency/with_lock.h"
+
+namespace mongo {
+
+class CollectionPtr;
+class OperationContext;
+class ServiceContext;
+
+/**
+ * Tails the oplog once on behalf of all the change streams which have caught up with its end.
+ *
+ * Without it, every change stream cursor scans the oplog with its own tailable collection scan and
+ * evaluates its own filter against every new entry. Once a cursor has reached the end of the
+ * oplog, its CollectionScan can instead join the shared scan: whichever subscriber next runs out
+ * of buffered entries reads the new oplog entries on behalf of everyone, evaluates each entry
+ * against the filters of the subscribers which might be interested in it, and appends it to the
+ * buffers of those it matches. The filters are evaluated without holding the mutex of the scan, so
+ * that the other subscribers can keep consuming their buffers and joining or leaving meanwhile.
+ *
+ * To avoid evaluating every filter against every entry, subscribers are indexed by the namespace
+ * they watch: CRUD entries are only matched against the change streams on their collection, on its
+ * database and on the whole cluster. Every other entry (commands, transactions and no-ops) is
+ * matched against all subscribers.
+ *
+ * A subscriber whose buffer grows beyond 'changeStreamSharedOplogScanMaxBufferedEntries' is
+ * detached from the shared scan. It must then go back to scanning the oplog itself from the last
+ * entry it returned, and may rejoin once it catches up again.
+ */
+class SharedOplogScan {
+    SharedOplogScan(const SharedOplogScan&) = delete;
+    SharedOplogScan& operator=(const SharedOplogScan&) = delete;
+
+    struct Subscriber;
+    using SubscriberList = std::list<std::shared_ptr<Subscriber>>;
+
+public:
+    /**
+     * An oplog entry matched by the filter of a subscriber.
+     */
+    struct Entry {
+        RecordId id;
+        BSONObj obj;
+    };
+
+    /**
+     * The result of asking a subscription for its next entry. If 'entry' is not set, the
+     * subscriber has been given every entry matching its filter up to and including
+     * 'scannedThrough'. If 'detached' is set, the subscriber must resume scanning the oplog on
+     * its own.
+     */
+    struct NextResult {
+        boost::optional<Entry> entry;
+        Timestamp scannedThrough;
+        bool detached = false;
+    };
+
+    /**
+     * A handle on the shared scan held by a single change stream. Destroying it leaves the scan.
+     */
+    class Subscription {
+        Subscription(const Subscription&) = delete;
+        Subscription& operator=(const Subscription&) = delete;
+
+    public:
+        ~Subscription();
+
+        /**
+         * Returns the next buffered entry of this subscriber. If there is none, reads the entries
+         * added to the oplog since the last read on behalf of all subscribers first, or waits for
+         * the subscriber currently doing so. 'collection' is the oplog, locked by the caller.
+         *
+         * May throw WriteConflictException, in which case it may be retried after yielding.
+         */
+        NextResult next(OperationContext* opCtx, const CollectionPtr& collection);
+
+    private:
+        friend class SharedOplogScan;
+
+        Subscription(SharedOplogScan* scan, SubscriberList::iterator it) : _scan(scan), _it(it) {}
+
+        SharedOplogScan* const _scan;
+        const SubscriberList::iterator _it;
+    };
+
+    SharedOplogScan() = default;
+
+    static SharedOplogScan& get(ServiceContext* serviceContext);
+
+    /**
+     * Joins the shared scan with the given filter, for a change stream watching 'nss', to be given
+     * the matching entries after the one at 'lastSeenId'. Returns nullptr if the shared scan is
+     * already past 'lastSeenId', in which case the caller should keep scanning the oplog on its
+     * own and try again later.
+     *
+     * The filter is cloned. 'expCtx' is kept alive for as long as the subscription, since the
+     * filter may refer to it.
+     */
+    std::unique_ptr<Subscription> join(const boost::intrusive_ptr<ExpressionContext>& expCtx,
+                                       const NamespaceString& nss,
+                                       const MatchExpression* filter,
+                                       const RecordId& lastSeenId);
+
+    /**
+     * Returns the number of change streams currently subscribed to the shared scan.
+     */
+    size_t numSubscribers() const;
+
+private:
+    struct Subscriber {
+        boost::intrusive_ptr<ExpressionContext> expCtx;
+        std::unique_ptr<MatchExpression> filter;
+        NamespaceString nss;
+
+        // Entries up to and including this one were not requested by the subscriber.
+        RecordId startAfter;
+
+        std::deque<Entry> buffer;
+        bool detached = false;
+    };
+
+    /**
+     * Subscribers indexed by what they watch, see the class comment. The subscriber reading the
+     * oplog copies it, which keeps the subscribers alive while it matches entries against their
+     * filters without holding '_mutex', even if they leave the scan meanwhile.
+     */
+    struct SubscriberIndex {
+        using Subscribers = std::vector<std::shared_ptr<Subscriber>>;
+
+        stdx::unordered_map<std::string, Subscribers> byCollection;
+        stdx::unordered_map<std::string, Subscribers> byDatabase;
+        Subscribers wholeCluster;
+        Subscribers all;
+    };
+
+    void _leave(SubscriberList::iterator it);
+
+    /**
+     * Reads a batch of oplog entries after '_lastScannedId' and appends them to the buffers of the
+     * subscribers they match. Must be called with '_pumping' set by the caller, and without holding
+     * '_mutex'.
+     */
+    void _pump(OperationContext* opCtx, const CollectionPtr& collection);
+
+    /**
+     * Appends to 'matches' the subscribers in 'index' whose filter matches 'entry'. Only reads the
+     * parts of the subscribers which do not change after they join, so '_mutex' need not be held.
+     */
+    static void _match(const SubscriberIndex& index,
+                       const Entry& entry,
+                       std::vector<Subscriber*>* matches);
+
+    /**
+     * Appends 'entry' to the buffer of 'subscriber', which it matches, unless the subscriber was
+     * detached.
+     */
+    void _dispatchTo(WithLock, Subscriber* subscriber, const Entry& entry);
+
+    void _detachAll(WithLock);
+
+    mutable Mutex _mutex = MONGO_MAKE_LATCH("SharedOplogScan::_mutex");
+
+    // Signalled when the subscriber reading the oplog on behalf of the others is done.
+    stdx::condition_variable _pumpDone;
+    bool _pumping = false;
+
+    SubscriberList _subscribers;
+    SubscriberIndex _index;
+
+    // The last entry read from the oplog by the shared scan, and its timestamp. Subscribers which
+    // join while the entries read are being dispatched start after them.
+    RecordId _lastScannedId;
+    Timestamp _lastScannedTs;
+};
+
+}  // namespace mongo
@@ -110,6 +110,13 @@ public:
      */
     std::tuple<BSONObj, Date_t> collect(Client* client);
 
+    /**
+     * Returns true if no collectors have been added.
+     */
+    bool empty() const {
+        return _collectors.empty();
+    }
+
 private:
     // collection of collectors
     std::vector<std::unique_ptr<FTDCCollectorInterface>> _collectors;
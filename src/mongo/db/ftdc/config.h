@@ -47,7 +47,9 @@ struct FTDCConfig {
           maxFileSizeBytes(kMaxFileSizeBytesDefault),
           period(kPeriodMillisDefault),
           maxSamplesPerArchiveMetricChunk(kMaxSamplesPerArchiveMetricChunkDefault),
-          maxSamplesPerInterimMetricChunk(kMaxSamplesPerInterimMetricChunkDefault) {}
+          maxSamplesPerInterimMetricChunk(kMaxSamplesPerInterimMetricChunkDefault),
+          highFrequencyEnabled(kHighFrequencyEnabledDefault),
+          highFrequencyPeriod(kHighFrequencyPeriodMillisDefault) {}
 
     /**
      * True if FTDC is collecting data. False otherwise
@@ -56,7 +58,8 @@ struct FTDCConfig {
 
     /**
      * Max Size of all FTDC files. If the total file size is > maxDirectorySizeBytes by summing up
-     * all files in the FTDC directory, the extra files are removed.
+     * all files in the FTDC directory, the extra files are removed. The files of the high-frequency
+     * stream count against this limit as well.
      */
     std::uint64_t maxDirectorySizeBytes;
 
@@ -84,9 +87,23 @@ struct FTDCConfig {
      */
     std::uint32_t maxSamplesPerInterimMetricChunk;
 
+    /**
+     * True if the high-frequency collectors are sampled, in addition to the regular periodic
+     * collectors. Has no effect unless 'enabled' is also true.
+     */
+    bool highFrequencyEnabled;
+
+    /**
+     * Period at which the high-frequency collectors are sampled. Samples are written to their own
+     * set of files so that they do not disturb the compression of the regular stream.
+     */
+    Milliseconds highFrequencyPeriod;
+
     static const bool kEnabledDefault = true;
+    static const bool kHighFrequencyEnabledDefault = false;
 
     static const std::int64_t kPeriodMillisDefault;
+    static const std::int64_t kHighFrequencyPeriodMillisDefault;
     static const std::uint64_t kMaxDirectorySizeBytesDefault = 200 * 1024 * 1024;
     static const std::uint64_t kMaxFileSizeBytesDefault = 10 * 1024 * 1024;
 
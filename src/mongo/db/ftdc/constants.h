@@ -50,4 +50,7 @@ extern const char kFTDCCollectEndField[];
 
 constexpr StringData kFTDCDefaultDirectory = "diagnostic.data"_sd;
 
+// Subdirectory of the FTDC directory which holds the high-frequency metric stream.
+constexpr StringData kFTDCHighFrequencyDirectory = "highfrequency"_sd;
+
 }  // namespace mongo
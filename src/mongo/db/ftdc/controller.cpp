@@ -37,6 +37,7 @@
 
 #include "mongo/db/client.h"
 #include "mongo/db/ftdc/collector.h"
+#include "mongo/db/ftdc/constants.h"
 #include "mongo/db/ftdc/util.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/logv2/log.h"
@@ -48,6 +49,27 @@
 #include "mongo/util/time_support.h"
 
 namespace mongo {
+namespace {
+
+// The high-frequency files are kept in a subdirectory of the FTDC directory and count against the
+// same 'maxDirectorySizeBytes'. The high-frequency stream may use this fraction of it, and while it
+// is enabled, the regular stream keeps the rest.
+constexpr std::uint64_t kHighFrequencyDirectorySizeDivisor = 4;
+
+FTDCConfig regularStreamConfig(FTDCConfig config) {
+    if (config.highFrequencyEnabled) {
+        config.maxDirectorySizeBytes -=
+            config.maxDirectorySizeBytes / kHighFrequencyDirectorySizeDivisor;
+    }
+    return config;
+}
+
+FTDCConfig highFrequencyStreamConfig(FTDCConfig config) {
+    config.maxDirectorySizeBytes /= kHighFrequencyDirectorySizeDivisor;
+    return config;
+}
+
+}  // namespace
 
 Status FTDCController::setEnabled(bool enabled) {
     stdx::lock_guard<Latch> lock(_mutex);
@@ -59,7 +81,7 @@ Status FTDCController::setEnabled(bool enabled) {
     }
 
     _configTemp.enabled = enabled;
-    _condvar.notify_one();
+    _condvar.notify_all();
 
     return Status::OK();
 }
@@ -67,31 +89,43 @@ Status FTDCController::setEnabled(bool enabled) {
 void FTDCController::setPeriod(Milliseconds millis) {
     stdx::lock_guard<Latch> lock(_mutex);
     _configTemp.period = millis;
-    _condvar.notify_one();
+    _condvar.notify_all();
 }
 
 void FTDCController::setMaxDirectorySizeBytes(std::uint64_t size) {
     stdx::lock_guard<Latch> lock(_mutex);
     _configTemp.maxDirectorySizeBytes = size;
-    _condvar.notify_one();
+    _condvar.notify_all();
 }
 
 void FTDCController::setMaxFileSizeBytes(std::uint64_t size) {
     stdx::lock_guard<Latch> lock(_mutex);
     _configTemp.maxFileSizeBytes = size;
-    _condvar.notify_one();
+    _condvar.notify_all();
 }
 
 void FTDCController::setMaxSamplesPerArchiveMetricChunk(size_t size) {
     stdx::lock_guard<Latch> lock(_mutex);
     _configTemp.maxSamplesPerArchiveMetricChunk = size;
-    _condvar.notify_one();
+    _condvar.notify_all();
 }
 
 void FTDCController::setMaxSamplesPerInterimMetricChunk(size_t size) {
     stdx::lock_guard<Latch> lock(_mutex);
     _configTemp.maxSamplesPerInterimMetricChunk = size;
-    _condvar.notify_one();
+    _condvar.notify_all();
+}
+
+void FTDCController::setHighFrequencyEnabled(bool enabled) {
+    stdx::lock_guard<Latch> lock(_mutex);
+    _configTemp.highFrequencyEnabled = enabled;
+    _condvar.notify_all();
+}
+
+void FTDCController::setHighFrequencyPeriod(Milliseconds millis) {
+    stdx::lock_guard<Latch> lock(_mutex);
+    _configTemp.highFrequencyPeriod = millis;
+    _condvar.notify_all();
 }
 
 Status FTDCController::setDirectory(const boost::filesystem::path& path) {
@@ -129,6 +163,15 @@ void FTDCController::addOnRotateCollector(std::unique_ptr<FTDCCollectorInterface
     }
 }
 
+void FTDCController::addHighFrequencyCollector(std::unique_ptr<FTDCCollectorInterface> collector) {
+    {
+        stdx::lock_guard<Latch> lock(_mutex);
+        invariant(_state == State::kNotStarted);
+
+        _highFrequencyCollectors.add(std::move(collector));
+    }
+}
+
 BSONObj FTDCController::getMostRecentPeriodicDocument() {
     {
         stdx::lock_guard<Latch> lock(_mutex);
@@ -144,6 +187,11 @@ void FTDCController::start() {
     // Start the thread
     _thread = stdx::thread([this] { doLoop(); });
 
+    // The collectors are fixed once started, so there is no need for an idle thread without them
+    if (!_highFrequencyCollectors.empty()) {
+        _highFrequencyThread = stdx::thread([this] { doHighFrequencyLoop(); });
+    }
+
     {
         stdx::lock_guard<Latch> lock(_mutex);
 
@@ -171,11 +219,15 @@ void FTDCController::stop() {
         _state = State::kStopRequested;
 
         // Wake up the thread if sleeping so that it will check if we are done
-        _condvar.notify_one();
+        _condvar.notify_all();
     }
 
     _thread.join();
 
+    if (_highFrequencyThread.joinable()) {
+        _highFrequencyThread.join();
+    }
+
     _state = State::kDone;
 
     if (_mgr) {
@@ -186,6 +238,15 @@ void FTDCController::stop() {
                   "error"_attr = s);
         }
     }
+
+    if (_highFrequencyMgr) {
+        auto s = _highFrequencyMgr->close();
+        if (!s.isOK()) {
+            LOGV2(5400600,
+                  "Failed to close high-frequency diagnostic data capture file manager",
+                  "error"_attr = s);
+        }
+    }
 }
 
 void FTDCController::doLoop() noexcept {
@@ -197,7 +258,7 @@ void FTDCController::doLoop() noexcept {
     // Update config
     {
         stdx::lock_guard<Latch> lock(_mutex);
-        _config = _configTemp;
+        _config = regularStreamConfig(_configTemp);
     }
 
     while (true) {
@@ -226,7 +287,7 @@ void FTDCController::doLoop() noexcept {
             // MSVC 2013 converts wait_until(now() + 1ms) into ~ wait_for(0) which means it will
             // not wait for the condition variable to be signaled because it uses
             // GetFileSystemTime for now which has ~10 ms granularity.
-            _config = _configTemp;
+            _config = regularStreamConfig(_configTemp);
 
             // if we hit a timeout on the condvar, we need to do another collection
             // if we were signalled, then we have a config update only or were asked to stop
@@ -262,4 +323,65 @@ void FTDCController::doLoop() noexcept {
     }
 }
 
+void FTDCController::doHighFrequencyLoop() noexcept {
+    // Note: As in doLoop, all exceptions thrown in this loop are considered process fatal.
+    Client::initThread(kFTDCHighFrequencyThreadName);
+    Client* client = &cc();
+
+    {
+        stdx::lock_guard<Latch> lock(_mutex);
+        _highFrequencyConfig = highFrequencyStreamConfig(_configTemp);
+    }
+
+    auto isActive = [this] {
+        return _highFrequencyConfig.enabled && _highFrequencyConfig.highFrequencyEnabled;
+    };
+
+    while (true) {
+        {
+            stdx::unique_lock<Latch> lock(_mutex);
+            MONGO_IDLE_THREAD_BLOCK;
+
+            // While inactive there is nothing to do until a setter or stop() signals us. The
+            // predicate is checked under the mutex, so neither signal can be missed.
+            _condvar.wait(lock, [&] {
+                _highFrequencyConfig = highFrequencyStreamConfig(_configTemp);
+                return _state == State::kStopRequested || isActive();
+            });
+
+            if (_state == State::kStopRequested) {
+                break;
+            }
+
+            auto now = getGlobalServiceContext()->getPreciseClockSource()->now();
+            auto next_time = FTDCUtil::roundTime(now, _highFrequencyConfig.highFrequencyPeriod);
+            auto status = _condvar.wait_until(lock, next_time.toSystemTimePoint());
+
+            if (_state == State::kStopRequested) {
+                break;
+            }
+
+            _highFrequencyConfig = highFrequencyStreamConfig(_configTemp);
+
+            if (status == stdx::cv_status::no_timeout || !isActive()) {
+                continue;
+            }
+        }
+
+        if (!_highFrequencyMgr) {
+            auto swMgr = FTDCFileManager::create(&_highFrequencyConfig,
+                                                 _path / kFTDCHighFrequencyDirectory.toString(),
+                                                 &_highFrequencyRotateCollectors,
+                                                 client);
+
+            _highFrequencyMgr = uassertStatusOK(std::move(swMgr));
+        }
+
+        auto collectSample = _highFrequencyCollectors.collect(client);
+
+        uassertStatusOK(_highFrequencyMgr->writeSampleAndRotateIfNeeded(
+            client, std::get<0>(collectSample), std::get<1>(collectSample)));
+    }
+}
+
 }  // namespace mongo
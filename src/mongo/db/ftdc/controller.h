@@ -57,7 +57,10 @@ class FTDCController {
 
 public:
     FTDCController(const boost::filesystem::path path, FTDCConfig config)
-        : _path(path), _config(std::move(config)), _configTemp(_config) {}
+        : _path(path),
+          _config(std::move(config)),
+          _configTemp(_config),
+          _highFrequencyConfig(_config) {}
 
     ~FTDCController() = default;
 
@@ -99,6 +102,16 @@ public:
      */
     void setMaxSamplesPerInterimMetricChunk(size_t size);
 
+    /**
+     * Set whether the high-frequency collectors are sampled.
+     */
+    void setHighFrequencyEnabled(bool enabled);
+
+    /**
+     * Set the period for high-frequency data collection.
+     */
+    void setHighFrequencyPeriod(Milliseconds millis);
+
     /*
      * Set the path to store FTDC files if not already set.
      *
@@ -118,10 +131,18 @@ public:
      */
     void addOnRotateCollector(std::unique_ptr<FTDCCollectorInterface> collector);
 
+    /**
+     * Add a metric collector to collect on the high-frequency period. i.e., latency histograms
+     *
+     * These must be cheap enough to run many times a second: they are sampled on their own thread
+     * and written to their own files under the "highfrequency" subdirectory.
+     */
+    void addHighFrequencyCollector(std::unique_ptr<FTDCCollectorInterface> collector);
+
     /**
      * Start the controller.
      *
-     * Spawns a new thread.
+     * Spawns a new thread, plus a second one if any high-frequency collectors were added.
      */
     void start();
 
@@ -148,6 +169,11 @@ private:
      */
     void doLoop() noexcept;
 
+    /**
+     * Do high-frequency statistics collection and writing on its own background thread.
+     */
+    void doHighFrequencyLoop() noexcept;
+
 private:
     /**
      * Private enum to track state.
@@ -212,6 +238,21 @@ private:
 
     // Background collection and writing thread
     stdx::thread _thread;
+
+    // Snapshot of _configTemp owned by the high-frequency thread, refreshed like _config.
+    FTDCConfig _highFrequencyConfig;
+
+    // Set of high-frequency collectors
+    FTDCCollectorCollection _highFrequencyCollectors;
+
+    // Always empty: host information is already recorded by the regular stream
+    FTDCCollectorCollection _highFrequencyRotateCollectors;
+
+    // File manager for the high-frequency stream
+    std::unique_ptr<FTDCFileManager> _highFrequencyMgr;
+
+    // Background high-frequency collection and writing thread
+    stdx::thread _highFrequencyThread;
 };
 
 }  // namespace mongo
@@ -283,4 +283,57 @@ TEST_F(FTDCControllerTest, TestStartAsDisabled) {
     ValidateDocumentList(alog, allDocs, FTDCValidationMode::kStrict);
 }
 
+// Test the high-frequency collectors are sampled on their own period, and written to their own
+// files under the high-frequency subdirectory, only once enabled
+TEST_F(FTDCControllerTest, TestHighFrequency) {
+    unittest::TempDir tempdir("metrics_testpath");
+    boost::filesystem::path dir(tempdir.path());
+
+    createDirectoryClean(dir);
+
+    FTDCConfig config;
+    config.enabled = true;
+    config.period = Hours(1);
+    config.highFrequencyEnabled = false;
+    config.highFrequencyPeriod = Milliseconds(1);
+    config.maxFileSizeBytes = FTDCConfig::kMaxFileSizeBytesDefault;
+    config.maxDirectorySizeBytes = FTDCConfig::kMaxDirectorySizeBytesDefault;
+
+    auto c1 = std::make_unique<FTDCMetricsCollectorMock2>();
+
+    auto c1Ptr = c1.get();
+
+    FTDCController c(dir, config);
+
+    c.addHighFrequencyCollector(std::move(c1));
+
+    c.start();
+
+    auto highFrequencyDir = dir / kFTDCHighFrequencyDirectory.toString();
+    ASSERT_FALSE(boost::filesystem::exists(highFrequencyDir));
+
+    c.setHighFrequencyEnabled(true);
+
+    c1Ptr->setSignalOnCount(50);
+
+    // Wait for 50 samples to have occured
+    c1Ptr->wait();
+
+    c.stop();
+
+    auto docsHighFrequency = c1Ptr->getDocs();
+    ASSERT_GREATER_THAN_OR_EQUALS(docsHighFrequency.size(), 50UL);
+
+    // The regular stream never reached its first period, so only the subdirectory exists
+    auto regularFiles = scanDirectory(dir);
+    ASSERT_EQUALS(regularFiles.size(), 1UL);
+    ASSERT_EQUALS(regularFiles[0], highFrequencyDir);
+
+    auto files = scanDirectory(highFrequencyDir);
+
+    ASSERT_EQUALS(files.size(), 1UL);
+
+    ValidateDocumentList(files[0], docsHighFrequency, FTDCValidationMode::kStrict);
+}
+
 }  // namespace mongo
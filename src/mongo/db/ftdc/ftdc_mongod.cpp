@@ -37,12 +37,36 @@
 #include "mongo/db/ftdc/controller.h"
 #include "mongo/db/ftdc/ftdc_server.h"
 #include "mongo/db/repl/replication_coordinator.h"
+#include "mongo/db/stats/top.h"
 #include "mongo/db/storage/storage_options.h"
 
 namespace mongo {
 
 namespace {
+
+// Bounds the size of each sample, which would otherwise grow with the number of collections and
+// could exceed the maximum BSON size.
+constexpr size_t kMaxCollectionLatencyNamespaces = 100;
+
+/**
+ * A high-frequency FTDC collector for the latency histograms of the collections which have served
+ * the most user operations.
+ */
+class FTDCCollectionLatencyCollector : public FTDCCollectorInterface {
+public:
+    void collect(OperationContext* opCtx, BSONObjBuilder& builder) final {
+        Top::get(opCtx->getServiceContext())
+            .appendLatencyHistograms(kMaxCollectionLatencyNamespaces, &builder);
+    }
+
+    std::string name() const final {
+        return "collectionLatencies";
+    }
+};
+
 void registerMongoDCollectors(FTDCController* controller) {
+    controller->addHighFrequencyCollector(std::make_unique<FTDCCollectionLatencyCollector>());
+
     // These metrics are only collected if replication is enabled
     if (repl::ReplicationCoordinator::get(getGlobalServiceContext())->getReplicationMode() !=
         repl::ReplicationCoordinator::modeNone) {
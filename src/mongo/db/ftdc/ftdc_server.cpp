@@ -31,6 +31,7 @@
 
 #include "mongo/db/ftdc/ftdc_server.h"
 
+#include <algorithm>
 #include <boost/filesystem.hpp>
 #include <fstream>
 #include <memory>
@@ -46,6 +47,7 @@
 #include "mongo/db/jsobj.h"
 #include "mongo/db/mirror_maestro.h"
 #include "mongo/db/service_context.h"
+#include "mongo/db/stats/counters.h"
 #include "mongo/util/synchronized_value.h"
 
 namespace mongo {
@@ -170,6 +172,24 @@ Status onUpdateFTDCPerInterimUpdate(const std::int32_t potentialNewValue) {
     return Status::OK();
 }
 
+Status onUpdateFTDCHighFrequencyEnabled(const bool value) {
+    auto controller = getGlobalFTDCController();
+    if (controller) {
+        controller->setHighFrequencyEnabled(value);
+    }
+
+    return Status::OK();
+}
+
+Status onUpdateFTDCHighFrequencyPeriod(const std::int32_t potentialNewValue) {
+    auto controller = getGlobalFTDCController();
+    if (controller) {
+        controller->setHighFrequencyPeriod(Milliseconds(potentialNewValue));
+    }
+
+    return Status::OK();
+}
+
 FTDCSimpleInternalCommandCollector::FTDCSimpleInternalCommandCollector(StringData command,
                                                                        StringData name,
                                                                        StringData ns,
@@ -247,6 +267,42 @@ public:
     }
 };
 
+/**
+ * A high-frequency FTDC collector for the operation counters and the latency histogram of every
+ * command which has run at least once.
+ *
+ * Reads the counters directly rather than running serverStatus, which is far too expensive to
+ * run ten times a second.
+ */
+class FTDCCommandLatencyCollector : public FTDCCollectorInterface {
+public:
+    void collect(OperationContext* opCtx, BSONObjBuilder& builder) final {
+        builder.append("opcounters", globalOpCounters.getObj());
+
+        // The command map is unordered and also holds every alias, so sort the distinct commands
+        // by name to keep the schema stable between samples.
+        std::vector<const Command*> commands;
+        for (const auto& [name, command] : globalCommandRegistry()->allCommands()) {
+            if (name == command->getName() && command->getLatencyHistogram().count() > 0) {
+                commands.push_back(command);
+            }
+        }
+        std::sort(commands.begin(), commands.end(), [](const Command* lhs, const Command* rhs) {
+            return lhs->getName() < rhs->getName();
+        });
+
+        BSONObjBuilder commandsBuilder(builder.subobjStart("commands"));
+        for (auto command : commands) {
+            BSONObjBuilder commandBuilder(commandsBuilder.subobjStart(command->getName()));
+            command->getLatencyHistogram().append(&commandBuilder);
+        }
+    }
+
+    std::string name() const final {
+        return "commandLatencies";
+    }
+};
+
 // Register the FTDC system
 // Note: This must be run before the server parameters are parsed during startup
 // so that the FTDCController is initialized.
@@ -267,6 +323,8 @@ void startFTDC(boost::filesystem::path& path,
         ftdcStartupParams.maxSamplesPerArchiveMetricChunk.load();
     config.maxSamplesPerInterimMetricChunk =
         ftdcStartupParams.maxSamplesPerInterimMetricChunk.load();
+    config.highFrequencyEnabled = ftdcStartupParams.highFrequencyEnabled.load();
+    config.highFrequencyPeriod = Milliseconds(ftdcStartupParams.highFrequencyPeriodMillis.load());
 
     ftdcDirectoryPathParameter = path;
 
@@ -278,6 +336,10 @@ void startFTDC(boost::filesystem::path& path,
     // GetDiagnosticDataCommand
     controller->addPeriodicCollector(std::make_unique<FTDCServerStatusCommandCollector>());
 
+    // Install high-frequency collectors
+    // These are collected on the high-frequency interval in FTDCConfig, when it is enabled.
+    controller->addHighFrequencyCollector(std::make_unique<FTDCCommandLatencyCollector>());
+
     registerCollectors(controller.get());
 
     // Install System Metric Collector as a periodic collector
@@ -112,6 +112,9 @@ struct FTDCStartupParams {
     AtomicWord<int> maxSamplesPerArchiveMetricChunk;
     AtomicWord<int> maxSamplesPerInterimMetricChunk;
 
+    AtomicWord<bool> highFrequencyEnabled;
+    AtomicWord<int> highFrequencyPeriodMillis;
+
     FTDCStartupParams()
         : enabled(FTDCConfig::kEnabledDefault),
           periodMillis(FTDCConfig::kPeriodMillisDefault),
@@ -119,7 +122,9 @@ struct FTDCStartupParams {
           maxDirectorySizeMB(FTDCConfig::kMaxDirectorySizeBytesDefault / (1024 * 1024)),
           maxFileSizeMB(FTDCConfig::kMaxFileSizeBytesDefault / (1024 * 1024)),
           maxSamplesPerArchiveMetricChunk(FTDCConfig::kMaxSamplesPerArchiveMetricChunkDefault),
-          maxSamplesPerInterimMetricChunk(FTDCConfig::kMaxSamplesPerInterimMetricChunkDefault) {}
+          maxSamplesPerInterimMetricChunk(FTDCConfig::kMaxSamplesPerInterimMetricChunkDefault),
+          highFrequencyEnabled(FTDCConfig::kHighFrequencyEnabledDefault),
+          highFrequencyPeriodMillis(FTDCConfig::kHighFrequencyPeriodMillisDefault) {}
 };
 
 extern FTDCStartupParams ftdcStartupParams;
@@ -133,6 +138,8 @@ Status onUpdateFTDCDirectorySize(const std::int32_t value);
 Status onUpdateFTDCFileSize(const std::int32_t value);
 Status onUpdateFTDCSamplesPerChunk(const std::int32_t value);
 Status onUpdateFTDCPerInterimUpdate(const std::int32_t value);
+Status onUpdateFTDCHighFrequencyEnabled(const bool value);
+Status onUpdateFTDCHighFrequencyPeriod(const std::int32_t value);
 
 /**
  * Server Parameter accessors
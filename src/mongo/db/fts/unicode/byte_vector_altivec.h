@@ -129,6 +129,9 @@ public:
     ByteVector compareEQ(Scalar val) const {
         return (Native)vec_cmpeq(_data, ByteVector(val)._data);
     }
+    ByteVector compareEQ(ByteVector other) const {
+        return (Native)vec_cmpeq(_data, other._data);
+    }
     ByteVector compareLT(Scalar val) const {
         return (Native)vec_cmplt(_data, ByteVector(val)._data);
     }
@@ -152,6 +155,14 @@ public:
         return (*this = (*this & other));
     }
 
+    ByteVector operator^(ByteVector other) const {
+        return (Native)vec_xor(_data, other._data);
+    }
+
+    ByteVector& operator^=(ByteVector other) {
+        return (*this = (*this ^ other));
+    }
+
 private:
     ByteVector(Native data) : _data(data) {}
 
@@ -125,6 +125,9 @@ public:
     ByteVector compareEQ(Scalar val) const {
         return vceqq_u8(_data, ByteVector(val)._data);
     }
+    ByteVector compareEQ(ByteVector other) const {
+        return vceqq_u8(_data, other._data);
+    }
     ByteVector compareLT(Scalar val) const {
         return vcltq_u8(_data, ByteVector(val)._data);
     }
@@ -148,6 +151,14 @@ public:
         return (*this = (*this & other));
     }
 
+    ByteVector operator^(ByteVector other) const {
+        return veorq_u8(_data, other._data);
+    }
+
+    ByteVector& operator^=(ByteVector other) {
+        return (*this = (*this ^ other));
+    }
+
 private:
     ByteVector(Native data) : _data(data) {}
 
@@ -111,6 +111,9 @@ public:
     ByteVector compareEQ(Scalar val) const {
         return _mm_cmpeq_epi8(_data, ByteVector(val)._data);
     }
+    ByteVector compareEQ(ByteVector other) const {
+        return _mm_cmpeq_epi8(_data, other._data);
+    }
     ByteVector compareLT(Scalar val) const {
         return _mm_cmplt_epi8(_data, ByteVector(val)._data);
     }
@@ -134,6 +137,14 @@ public:
         return (*this = (*this & other));
     }
 
+    ByteVector operator^(ByteVector other) const {
+        return _mm_xor_si128(_data, other._data);
+    }
+
+    ByteVector& operator^=(ByteVector other) {
+        return (*this = (*this ^ other));
+    }
+
 private:
     ByteVector(Native data) : _data(data) {}
 
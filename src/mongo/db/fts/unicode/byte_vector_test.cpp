@@ -175,6 +175,32 @@ TEST(ByteVector, BitAndAssign) {
     }
 }
 
+TEST(ByteVector, BitXor) {
+    uint8_t inputBuf[ByteVector::size];
+    uint8_t outputBuf[ByteVector::size] = {};
+    std::iota(std::begin(inputBuf), std::end(inputBuf), 0);
+
+    (ByteVector::load(inputBuf) ^ ByteVector(-1)).store(outputBuf);
+
+    for (size_t i = 0; i < ByteVector::size; i++) {
+        ASSERT_EQ(outputBuf[i], uint8_t(~inputBuf[i]));
+    }
+}
+
+TEST(ByteVector, BitXorAssign) {
+    uint8_t inputBuf[ByteVector::size];
+    uint8_t outputBuf[ByteVector::size] = {};
+    std::iota(std::begin(inputBuf), std::end(inputBuf), 0);
+
+    auto vec = ByteVector::load(inputBuf);
+    vec ^= ByteVector(2);
+    vec.store(outputBuf);
+
+    for (size_t i = 0; i < ByteVector::size; i++) {
+        ASSERT_EQ(outputBuf[i], inputBuf[i] ^ 2);
+    }
+}
+
 }  // namespace unicode
 }  // namespace mongo
 #else
@@ -33,6 +33,7 @@
 
 #include "mongo/db/index/btree_access_method.h"
 
+#include <cstring>
 #include <utility>
 #include <vector>
 
@@ -215,6 +216,47 @@ Status AbstractIndexAccessMethod::insertKeys(OperationContext* opCtx,
     return Status::OK();
 }
 
+Status AbstractIndexAccessMethod::insertSortedKeys(OperationContext* opCtx,
+                                                   const KeyStringSet& keys,
+                                                   const InsertDeleteOptions& options,
+                                                   int64_t* numInserted) {
+    if (numInserted) {
+        *numInserted = 0;
+    }
+
+    const bool dupsAllowed = !_descriptor->unique() || options.dupsAllowed;
+    if (!dupsAllowed) {
+        // The keys are sorted, so two of them that differ only by RecordId are adjacent. Comparing
+        // each key with the previous one rejects a batch that collides with itself before any of
+        // it is written.
+        const char* prevBuffer = nullptr;
+        size_t prevSize = 0;
+        for (const auto& keyString : keys) {
+            const size_t size =
+                KeyString::sizeWithoutRecordIdAtEnd(keyString.getBuffer(), keyString.getSize());
+            if (size == prevSize && std::memcmp(prevBuffer, keyString.getBuffer(), size) == 0) {
+                auto key = KeyString::toBson(keyString.getBuffer(),
+                                             size,
+                                             _newInterface->getOrdering(),
+                                             keyString.getTypeBits());
+                return buildDupKeyErrorStatus(opCtx, key, _descriptor);
+            }
+            prevBuffer = keyString.getBuffer();
+            prevSize = size;
+        }
+    }
+
+    size_t inserted;
+    Status status = _newInterface->insertSorted(opCtx, keys, dupsAllowed, &inserted);
+    if (!status.isOK()) {
+        return status;
+    }
+    if (numInserted) {
+        *numInserted = inserted;
+    }
+    return Status::OK();
+}
+
 void AbstractIndexAccessMethod::removeOneKey(OperationContext* opCtx,
                                              const KeyString::Value& keyString,
                                              const RecordId& loc,
@@ -123,6 +123,19 @@ public:
                               KeyHandlerFn&& onDuplicateKey,
                               int64_t* numInserted) = 0;
 
+    /**
+     * Inserts 'keys', which may have been generated from several records and are sorted together,
+     * in a single pass over the index. Unless 'options' allows duplicates, two of the 'keys' that
+     * collide in a unique index are rejected before anything is inserted. Does not attempt to
+     * determine whether the index should become multikey. The 'numInserted' output parameter, if
+     * non-nullptr, will be reset to the number of keys inserted, or to zero in the case of a non-OK
+     * return Status.
+     */
+    virtual Status insertSortedKeys(OperationContext* opCtx,
+                                    const KeyStringSet& keys,
+                                    const InsertDeleteOptions& options,
+                                    int64_t* numInserted) = 0;
+
     /**
      * Analogous to insertKeys above, but remove the keys instead of inserting them.
      * 'numDeleted' will be set to the number of keys removed from the index for the provided keys.
@@ -473,6 +486,11 @@ public:
                       KeyHandlerFn&& onDuplicateKey,
                       int64_t* numInserted) final;
 
+    Status insertSortedKeys(OperationContext* opCtx,
+                            const KeyStringSet& keys,
+                            const InsertDeleteOptions& options,
+                            int64_t* numInserted) final;
+
     Status insertKeysAndUpdateMultikeyPaths(OperationContext* opCtx,
                                             const CollectionPtr& coll,
                                             const KeyStringSet& keys,
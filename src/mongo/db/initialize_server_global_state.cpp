@@ -357,6 +357,11 @@ MONGO_INITIALIZER_GENERAL(ServerLogRedirection,
         lv2Config.fileOpenMode = serverGlobalParams.logAppend
             ? logv2::LogDomainGlobal::ConfigurationOptions::OpenMode::kAppend
             : logv2::LogDomainGlobal::ConfigurationOptions::OpenMode::kTruncate;
+        lv2Config.fileAsync = gLogAsyncFileWrites;
+        lv2Config.fileAsyncQueueSize = gLogAsyncQueueSize;
+        lv2Config.fileAsyncOverflowPolicy = gLogAsyncDropOnOverflow
+            ? logv2::LogOverflowPolicy::kDrop
+            : logv2::LogOverflowPolicy::kBlock;
 
         if (serverGlobalParams.logAppend && exists) {
             writeServerRestartedAfterLogConfig = true;
@@ -320,8 +320,16 @@ void LogicalSessionCacheImpl::_refresh(Client* client) {
         activeSessionRecords.insert(it.second);
     }
 
-    // Refresh the active sessions in the sessions collection.
-    _sessionsColl->refreshSessions(opCtx, activeSessionRecords);
+    // Refresh the active sessions in the sessions collection, in bounded partitions which are
+    // written in parallel.
+    const auto activeSessionPartitions = SessionsCollection::makePartitions(activeSessionRecords);
+    SessionsCollection::runPartitioned(
+        opCtx,
+        activeSessionPartitions.size(),
+        [&](OperationContext* partitionOpCtx, size_t partition) {
+            ON_BLOCK_EXIT([&] { clearShardingOperationFailedStatus(partitionOpCtx); });
+            _sessionsColl->refreshSessions(partitionOpCtx, activeSessionPartitions[partition]);
+        });
     activeSessionsBackSwapper.dismiss();
     {
         stdx::lock_guard<Latch> lk(_mutex);
@@ -329,7 +337,15 @@ void LogicalSessionCacheImpl::_refresh(Client* client) {
     }
 
     // Remove the ending sessions from the sessions collection.
-    _sessionsColl->removeRecords(opCtx, explicitlyEndingSessions);
+    const auto endingSessionPartitions =
+        SessionsCollection::makePartitions(explicitlyEndingSessions);
+    SessionsCollection::runPartitioned(
+        opCtx,
+        endingSessionPartitions.size(),
+        [&](OperationContext* partitionOpCtx, size_t partition) {
+            ON_BLOCK_EXIT([&] { clearShardingOperationFailedStatus(partitionOpCtx); });
+            _sessionsColl->removeRecords(partitionOpCtx, endingSessionPartitions[partition]);
+        });
     explicitlyEndingBackSwaper.dismiss();
     {
         stdx::lock_guard<Latch> lk(_mutex);
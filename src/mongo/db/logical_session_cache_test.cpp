@@ -40,6 +40,7 @@
 #include "mongo/db/auth/authz_session_external_state_mock.h"
 #include "mongo/db/auth/user_name.h"
 #include "mongo/db/logical_session_cache.h"
+#include "mongo/db/logical_session_cache_gen.h"
 #include "mongo/db/logical_session_id.h"
 #include "mongo/db/logical_session_id_helpers.h"
 #include "mongo/db/operation_context.h"
@@ -50,6 +51,7 @@
 #include "mongo/stdx/future.h"
 #include "mongo/unittest/ensure_fcv.h"
 #include "mongo/unittest/unittest.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 namespace {
@@ -216,6 +218,43 @@ TEST_F(LogicalSessionCacheTest, ManySignedLsidsInCacheRefresh) {
     ASSERT_OK(cache()->refreshNow(opCtx()));
 }
 
+// Test that a refresh larger than the partition size is split into bounded partitions, which are
+// all written to the sessions collection
+TEST_F(LogicalSessionCacheTest, RefreshIsSplitIntoBoundedPartitions) {
+    const auto originalBatchSize = gLogicalSessionRefreshBatchSize.load();
+    const auto originalConcurrency = gLogicalSessionRefreshConcurrency.load();
+    ON_BLOCK_EXIT([&] {
+        gLogicalSessionRefreshBatchSize.store(originalBatchSize);
+        gLogicalSessionRefreshConcurrency.store(originalConcurrency);
+    });
+    gLogicalSessionRefreshBatchSize.store(100);
+    gLogicalSessionRefreshConcurrency.store(4);
+
+    const int count = 1050;
+    for (int i = 0; i < count; i++) {
+        ASSERT_OK(cache()->startSession(opCtx(), makeLogicalSessionRecordForTest()));
+    }
+
+    Mutex mutex = MONGO_MAKE_LATCH();
+    size_t numPartitions = 0;
+    size_t numRefreshed = 0;
+    size_t maxPartitionSize = 0;
+    sessions()->setRefreshHook([&](const LogicalSessionRecordSet& sessions) {
+        stdx::lock_guard<Latch> lk(mutex);
+        ++numPartitions;
+        numRefreshed += sessions.size();
+        maxPartitionSize = std::max(maxPartitionSize, sessions.size());
+    });
+
+    service()->fastForward(kForceRefresh);
+    ASSERT_OK(cache()->refreshNow(opCtx()));
+
+    ASSERT_EQ(11UL, numPartitions);
+    ASSERT_EQ(100UL, maxPartitionSize);
+    ASSERT_EQ(size_t(count), numRefreshed);
+    ASSERT_EQ(count, cache()->getStats().getLastSessionsCollectionJobEntriesRefreshed());
+}
+
 //
 TEST_F(LogicalSessionCacheTest, RefreshMatrixSessionState) {
     const std::vector<std::vector<std::string>> stateNames = {
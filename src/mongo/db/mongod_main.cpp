@@ -1215,7 +1215,8 @@ void shutdownTask(const ShutdownTaskArgs& shutdownArgs) {
         // marked as killed and will not be usable other than to kill all transactions directly
         // below.
         LOGV2_OPTIONS(4784912, {LogComponent::kDefault}, "Killing all operations for shutdown");
-        const std::set<std::string> excludedClients = {std::string(kFTDCThreadName)};
+        const std::set<std::string> excludedClients = {
+            std::string(kFTDCThreadName), std::string(kFTDCHighFrequencyThreadName)};
         serviceContext->setKillAllOperations(excludedClients);
 
         if (MONGO_unlikely(pauseWhileKillingOperationsAtShutdown.shouldFail())) {
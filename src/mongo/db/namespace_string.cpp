@@ -116,6 +116,9 @@ const NamespaceString NamespaceString::kReshardingApplierProgressNamespace(
 const NamespaceString NamespaceString::kReshardingTxnClonerProgressNamespace(
     NamespaceString::kConfigDb, "localReshardingOperations.recipient.progress_txn_cloner");
 
+const NamespaceString NamespaceString::kChangeStreamImagesNamespace(NamespaceString::kConfigDb,
+                                                                   "system.changeStreamImages");
+
 bool NamespaceString::isListCollectionsCursorNS() const {
     return coll() == listCollectionsCursorCol;
 }
@@ -143,6 +146,8 @@ bool NamespaceString::isLegalClientSystemNS() const {
             return true;
         if (coll() == kShardingDDLCoordinatorsNamespace.coll())
             return true;
+        if (coll() == kChangeStreamImagesNamespace.coll())
+            return true;
     } else if (db() == kLocalDb) {
         if (coll() == kSystemReplSetNamespace.coll())
             return true;
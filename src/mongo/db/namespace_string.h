@@ -165,6 +165,9 @@ public:
     // Namespace for storing config.transactions cloner progress for resharding.
     static const NamespaceString kReshardingTxnClonerProgressNamespace;
 
+    // Namespace for the pre- and post-images recorded for change streams.
+    static const NamespaceString kChangeStreamImagesNamespace;
+
     /**
      * Constructs an empty NamespaceString.
      */
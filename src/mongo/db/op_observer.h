@@ -310,6 +310,19 @@ public:
                                const NamespaceString& collectionName,
                                OptionalCollectionUUID uuid) = 0;
 
+    /**
+     * The onBatchedWrite* methods bracket a batch of writes performed in a single
+     * WriteUnitOfWork. Between onBatchedWriteStart() and onBatchedWriteCommit() the replicated
+     * operations of the writes are buffered instead of being logged one at a time, and
+     * onBatchedWriteCommit() logs them as a single 'applyOps' oplog entry. It must be called inside
+     * the WriteUnitOfWork, before it commits. onBatchedWriteAbort() discards the buffered
+     * operations of a batch that is not going to be committed. Only deletes may currently be
+     * batched.
+     */
+    virtual void onBatchedWriteStart(OperationContext* opCtx) = 0;
+    virtual void onBatchedWriteCommit(OperationContext* opCtx) = 0;
+    virtual void onBatchedWriteAbort(OperationContext* opCtx) = 0;
+
     /**
      * The onUnpreparedTransactionCommit method is called on the commit of an unprepared
      * transaction, before the RecoveryUnit onCommit() is called.  It must not be called when no
@@ -36,11 +36,14 @@
 #include <limits>
 
 #include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/batched_write_context.h"
 #include "mongo/db/bson/dotted_path_support.h"
+#include "mongo/db/catalog/collection_catalog.h"
 #include "mongo/db/catalog/collection_options.h"
 #include "mongo/db/catalog/database.h"
 #include "mongo/db/catalog/database_holder.h"
 #include "mongo/db/catalog/import_collection_oplog_entry_gen.h"
+#include "mongo/db/change_stream_images.h"
 #include "mongo/db/commands/txn_cmds_gen.h"
 #include "mongo/db/concurrency/d_concurrency.h"
 #include "mongo/db/concurrency/write_conflict_exception.h"
@@ -50,6 +53,7 @@
 #include "mongo/db/namespace_string.h"
 #include "mongo/db/op_observer_util.h"
 #include "mongo/db/operation_context.h"
+#include "mongo/db/query/query_result_cache.h"
 #include "mongo/db/read_write_concern_defaults.h"
 #include "mongo/db/repl/oplog.h"
 #include "mongo/db/repl/oplog_entry_gen.h"
@@ -251,6 +255,45 @@ OpTimeBundle replLogDelete(OperationContext* opCtx,
     return opTimes;
 }
 
+/**
+ * Returns true if the images of a write logged at 'opTimes' should be recorded in the change
+ * stream images collection. The images are recorded by the primary and replicated as regular
+ * inserts. They are not recorded for retryable writes, whose session bookkeeping would otherwise
+ * pick up the insert of the images.
+ */
+bool shouldRecordChangeStreamImages(OperationContext* opCtx, const OpTimeBundle& opTimes) {
+    return !opTimes.writeOpTime.isNull() && !opCtx->getTxnNumber();
+}
+
+/**
+ * Makes the query results cached for 'nss' unreachable once the current storage transaction
+ * commits. Doing it on commit, rather than now, keeps a concurrent reader from caching results
+ * read before the write became visible.
+ */
+void invalidateCachedQueryResultsOnCommit(OperationContext* opCtx, const NamespaceString& nss) {
+    opCtx->recoveryUnit()->onCommit(
+        [service = opCtx->getServiceContext(), nss](boost::optional<Timestamp>) {
+            QueryResultCache::get(service).bumpWriteVersion(nss);
+        });
+}
+
+/**
+ * Like invalidateCachedQueryResultsOnCommit(), for the document writes of inserts, updates and
+ * deletes. Only collections with the 'cacheQueryResults' option can have cached results, so the
+ * commit handler is left off the write path of every other collection. The option only changes
+ * under an exclusive collection lock, so no write in flight can miss it being turned on, and
+ * turning it on is itself observed as a collMod, which invalidates.
+ */
+void invalidateCachedQueryResultsForWriteOnCommit(OperationContext* opCtx,
+                                                  const NamespaceString& nss) {
+    const CollectionPtr& coll =
+        CollectionCatalog::get(opCtx)->lookupCollectionByNamespace(opCtx, nss);
+    if (!coll || !coll->getCacheQueryResults()) {
+        return;
+    }
+    invalidateCachedQueryResultsOnCommit(opCtx, nss);
+}
+
 }  // namespace
 
 BSONObj OpObserverImpl::DocumentKey::getId() const {
@@ -294,6 +337,7 @@ void OpObserverImpl::onCreateIndex(OperationContext* opCtx,
                                    CollectionUUID uuid,
                                    BSONObj indexDoc,
                                    bool fromMigrate) {
+    invalidateCachedQueryResultsOnCommit(opCtx, nss);
     auto txnParticipant = TransactionParticipant::get(opCtx);
     const bool inMultiDocumentTransaction =
         txnParticipant && opCtx->writesAreReplicated() && txnParticipant.transactionIsOpen();
@@ -383,6 +427,7 @@ void OpObserverImpl::onCommitIndexBuild(OperationContext* opCtx,
                                         const UUID& indexBuildUUID,
                                         const std::vector<BSONObj>& indexes,
                                         bool fromMigrate) {
+    invalidateCachedQueryResultsOnCommit(opCtx, nss);
     BSONObjBuilder oplogEntryBuilder;
     oplogEntryBuilder.append("commitIndexBuild", nss.coll());
 
@@ -443,6 +488,7 @@ void OpObserverImpl::onInserts(OperationContext* opCtx,
                                std::vector<InsertStatement>::const_iterator first,
                                std::vector<InsertStatement>::const_iterator last,
                                bool fromMigrate) {
+    invalidateCachedQueryResultsForWriteOnCommit(opCtx, nss);
     auto txnParticipant = TransactionParticipant::get(opCtx);
     const bool inMultiDocumentTransaction =
         txnParticipant && opCtx->writesAreReplicated() && txnParticipant.transactionIsOpen();
@@ -531,6 +577,7 @@ void OpObserverImpl::onInserts(OperationContext* opCtx,
 }
 
 void OpObserverImpl::onUpdate(OperationContext* opCtx, const OplogUpdateEntryArgs& args) {
+    invalidateCachedQueryResultsForWriteOnCommit(opCtx, args.nss);
     failCollectionUpdates.executeIf(
         [&](const BSONObj&) {
             uasserted(40654,
@@ -576,6 +623,15 @@ void OpObserverImpl::onUpdate(OperationContext* opCtx, const OplogUpdateEntryArg
         sessionTxnRecord.setLastWriteOpTime(opTime.writeOpTime);
         sessionTxnRecord.setLastWriteDate(opTime.wallClockTime);
         onWriteOpCompleted(opCtx, std::vector<StmtId>{args.updateArgs.stmtId}, sessionTxnRecord);
+
+        if (args.updateArgs.changeStreamImagesRecordingEnabledForCollection &&
+            shouldRecordChangeStreamImages(opCtx, opTime)) {
+            change_stream_images::writeImages(opCtx,
+                                              args.uuid,
+                                              opTime.writeOpTime.getTimestamp(),
+                                              args.updateArgs.preImageDoc,
+                                              args.updateArgs.updatedDoc);
+        }
     }
 
     if (args.nss != NamespaceString::kSessionTransactionsTableNamespace) {
@@ -622,6 +678,7 @@ void OpObserverImpl::onDelete(OperationContext* opCtx,
                               StmtId stmtId,
                               bool fromMigrate,
                               const boost::optional<BSONObj>& deletedDoc) {
+    invalidateCachedQueryResultsForWriteOnCommit(opCtx, nss);
     auto optDocKey = documentKeyDecoration(opCtx);
     invariant(optDocKey, nss.ns());
     auto& documentKey = optDocKey.get();
@@ -630,8 +687,19 @@ void OpObserverImpl::onDelete(OperationContext* opCtx,
     const bool inMultiDocumentTransaction =
         txnParticipant && opCtx->writesAreReplicated() && txnParticipant.transactionIsOpen();
 
+    auto& batchedWriteContext = BatchedWriteContext::get(opCtx);
+
     OpTimeBundle opTime;
-    if (inMultiDocumentTransaction) {
+    if (batchedWriteContext.writesAreBatched()) {
+        // The delete is logged as part of an 'applyOps' entry when the batch commits.
+        invariant(!inMultiDocumentTransaction);
+        if (!repl::ReplicationCoordinator::get(opCtx)->isOplogDisabledFor(opCtx, nss)) {
+            auto operation = MutableOplogEntry::makeDeleteOperation(
+                nss, uuid.get(), documentKey.getShardKeyAndId());
+            operation.setDestinedRecipient(destinedRecipientDecoration(opCtx));
+            batchedWriteContext.addBatchedOperation(operation, fromMigrate);
+        }
+    } else if (inMultiDocumentTransaction) {
         auto operation =
             MutableOplogEntry::makeDeleteOperation(nss, uuid.get(), documentKey.getShardKeyAndId());
         if (deletedDoc) {
@@ -642,11 +710,26 @@ void OpObserverImpl::onDelete(OperationContext* opCtx,
 
         txnParticipant.addTransactionOperation(opCtx, operation);
     } else {
-        opTime = replLogDelete(opCtx, nss, uuid, stmtId, fromMigrate, deletedDoc);
+        // A deleted document that is only kept for the change stream images collection is not
+        // logged to the oplog as a pre-image.
+        auto collection = CollectionCatalog::get(opCtx)->lookupCollectionByUUID(opCtx, *uuid);
+        const bool recordChangeStreamImages =
+            deletedDoc && collection && collection->getRecordChangeStreamImages();
+        const bool logPreImage = deletedDoc &&
+            (!recordChangeStreamImages || opCtx->getTxnNumber() ||
+             collection->getRecordPreImages());
+
+        opTime = replLogDelete(
+            opCtx, nss, uuid, stmtId, fromMigrate, logPreImage ? deletedDoc : boost::none);
         SessionTxnRecord sessionTxnRecord;
         sessionTxnRecord.setLastWriteOpTime(opTime.writeOpTime);
         sessionTxnRecord.setLastWriteDate(opTime.wallClockTime);
         onWriteOpCompleted(opCtx, std::vector<StmtId>{stmtId}, sessionTxnRecord);
+
+        if (recordChangeStreamImages && shouldRecordChangeStreamImages(opCtx, opTime)) {
+            change_stream_images::writeImages(
+                opCtx, *uuid, opTime.writeOpTime.getTimestamp(), deletedDoc, boost::none);
+        }
     }
 
     if (nss != NamespaceString::kSessionTransactionsTableNamespace) {
@@ -734,6 +817,7 @@ void OpObserverImpl::onCollMod(OperationContext* opCtx,
                                const BSONObj& collModCmd,
                                const CollectionOptions& oldCollOptions,
                                boost::optional<IndexCollModInfo> indexInfo) {
+    invalidateCachedQueryResultsOnCommit(opCtx, nss);
 
     if (!nss.isSystemDotProfile()) {
         // do not replicate system.profile modifications
@@ -791,6 +875,11 @@ void OpObserverImpl::onDropDatabase(OperationContext* opCtx, const std::string&
     if (dbName == NamespaceString::kSessionTransactionsTableNamespace.db()) {
         MongoDSessionCatalog::invalidateAllSessions(opCtx);
     }
+
+    opCtx->recoveryUnit()->onCommit(
+        [service = opCtx->getServiceContext(), dbName](boost::optional<Timestamp>) {
+            QueryResultCache::get(service).bumpWriteVersionsForDatabase(dbName);
+        });
 }
 
 repl::OpTime OpObserverImpl::onDropCollection(OperationContext* opCtx,
@@ -798,6 +887,7 @@ repl::OpTime OpObserverImpl::onDropCollection(OperationContext* opCtx,
                                               OptionalCollectionUUID uuid,
                                               std::uint64_t numRecords,
                                               const CollectionDropType dropType) {
+    invalidateCachedQueryResultsOnCommit(opCtx, collectionName);
     if (!collectionName.isSystemDotProfile()) {
         // Do not replicate system.profile modifications.
         MutableOplogEntry oplogEntry;
@@ -845,6 +935,7 @@ void OpObserverImpl::onDropIndex(OperationContext* opCtx,
                                  OptionalCollectionUUID uuid,
                                  const std::string& indexName,
                                  const BSONObj& indexInfo) {
+    invalidateCachedQueryResultsOnCommit(opCtx, nss);
     MutableOplogEntry oplogEntry;
     oplogEntry.setOpType(repl::OpTypeEnum::kCommand);
     oplogEntry.setNss(nss.getCommandNS());
@@ -888,6 +979,8 @@ void OpObserverImpl::postRenameCollection(OperationContext* const opCtx,
                                           OptionalCollectionUUID uuid,
                                           OptionalCollectionUUID dropTargetUUID,
                                           bool stayTemp) {
+    invalidateCachedQueryResultsOnCommit(opCtx, fromCollection);
+    invalidateCachedQueryResultsOnCommit(opCtx, toCollection);
     if (fromCollection.isSystemDotViews())
         DurableViewCatalog::onExternalChange(opCtx, fromCollection);
     if (toCollection.isSystemDotViews())
@@ -914,6 +1007,7 @@ void OpObserverImpl::onImportCollection(OperationContext* opCtx,
                                         const BSONObj& catalogEntry,
                                         const BSONObj& storageMetadata,
                                         bool isDryRun) {
+    invalidateCachedQueryResultsOnCommit(opCtx, nss);
     ImportCollectionOplogEntry importCollection(
         nss, importUUID, numRecords, dataSize, catalogEntry, storageMetadata, isDryRun);
 
@@ -937,6 +1031,7 @@ void OpObserverImpl::onApplyOps(OperationContext* opCtx,
 void OpObserverImpl::onEmptyCapped(OperationContext* opCtx,
                                    const NamespaceString& collectionName,
                                    OptionalCollectionUUID uuid) {
+    invalidateCachedQueryResultsOnCommit(opCtx, collectionName);
     if (!collectionName.isSystemDotProfile()) {
         // Do not replicate system.profile modifications
         MutableOplogEntry oplogEntry;
@@ -948,6 +1043,58 @@ void OpObserverImpl::onEmptyCapped(OperationContext* opCtx,
     }
 }
 
+void OpObserverImpl::onBatchedWriteStart(OperationContext* opCtx) {
+    auto& batchedWriteContext = BatchedWriteContext::get(opCtx);
+    invariant(!batchedWriteContext.writesAreBatched());
+    batchedWriteContext.setWritesAreBatched(true);
+}
+
+void OpObserverImpl::onBatchedWriteCommit(OperationContext* opCtx) {
+    invariant(opCtx->lockState()->inAWriteUnitOfWork());
+
+    auto& batchedWriteContext = BatchedWriteContext::get(opCtx);
+    invariant(batchedWriteContext.writesAreBatched());
+    ON_BLOCK_EXIT([&] { onBatchedWriteAbort(opCtx); });
+
+    const auto& operations = batchedWriteContext.getBatchedOperations();
+    if (operations.empty() || !opCtx->writesAreReplicated()) {
+        return;
+    }
+
+    // Unlike the 'applyOps' entries of a transaction, the batch has no session information. The
+    // writes of the WriteUnitOfWork all commit at the timestamp of its first oplog entry, so the
+    // whole batch must be logged as one entry: callers keep a batch within BSONObjMaxUserSize (see
+    // BatchedDeleteStage). As for transactions, we rely on the head room between BSONObjMaxUserSize
+    // and BSONObjMaxInternalSize to cover the BSON overhead and the other fields of the entry.
+    BSONObjBuilder applyOpsBuilder;
+    {
+        BSONArrayBuilder opsArray(applyOpsBuilder.subarrayStart("applyOps"_sd));
+        for (const auto& operation : operations) {
+            opsArray.append(operation.toBSON());
+        }
+        uassert(ErrorCodes::BSONObjectTooLarge,
+                str::stream() << "Batched writes do not fit in a single 'applyOps' oplog entry: "
+                              << operations.size() << " operations, " << opsArray.len()
+                              << " bytes",
+                operations.size() == 1 || opsArray.len() <= BSONObjMaxUserSize);
+    }
+
+    MutableOplogEntry oplogEntry;
+    oplogEntry.setOpType(repl::OpTypeEnum::kCommand);
+    oplogEntry.setNss({"admin", "$cmd"});
+    oplogEntry.setObject(applyOpsBuilder.done());
+    if (batchedWriteContext.isFromMigrate()) {
+        oplogEntry.setFromMigrate(true);
+    }
+    logOperation(opCtx, &oplogEntry);
+}
+
+void OpObserverImpl::onBatchedWriteAbort(OperationContext* opCtx) {
+    auto& batchedWriteContext = BatchedWriteContext::get(opCtx);
+    batchedWriteContext.clearBatchedOperations();
+    batchedWriteContext.setWritesAreBatched(false);
+}
+
 namespace {
 // Accepts an empty BSON builder and appends the given transaction statements to an 'applyOps' array
 // field. Appends as many operations as possible until either the constructed object exceeds the
@@ -1401,6 +1548,10 @@ void OpObserverImpl::onReplicationRollback(OperationContext* opCtx,
     // Force the default read/write concern cache to reload on next access in case the defaults
     // document was rolled back.
     ReadWriteConcernDefaults::get(opCtx).invalidate();
+
+    // Rollback rewrites collection contents without going through the write observers, so none of
+    // the cached query results can be trusted any more.
+    QueryResultCache::get(opCtx).clear();
 }
 
 }  // namespace mongo
@@ -173,6 +173,9 @@ public:
     void onEmptyCapped(OperationContext* opCtx,
                        const NamespaceString& collectionName,
                        OptionalCollectionUUID uuid);
+    void onBatchedWriteStart(OperationContext* opCtx) final;
+    void onBatchedWriteCommit(OperationContext* opCtx) final;
+    void onBatchedWriteAbort(OperationContext* opCtx) final;
     void onUnpreparedTransactionCommit(OperationContext* opCtx,
                                        std::vector<repl::ReplOperation>* statements,
                                        size_t numberOfPreImagesToWrite) final;
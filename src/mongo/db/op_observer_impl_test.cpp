@@ -29,6 +29,7 @@
 
 #include "mongo/platform/basic.h"
 
+#include "mongo/db/batched_write_context.h"
 #include "mongo/db/catalog/import_collection_oplog_entry_gen.h"
 #include "mongo/db/client.h"
 #include "mongo/db/concurrency/locker_noop.h"
@@ -595,6 +596,40 @@ TEST_F(OpObserverTest, MultipleAboutToDeleteAndOnDelete) {
     opObserver.onDelete(opCtx.get(), nss, uuid, kUninitializedStmtId, false, boost::none);
 }
 
+TEST_F(OpObserverTest, BatchedDeletesAreLoggedAsSingleApplyOps) {
+    auto uuid = UUID::gen();
+    OpObserverImpl opObserver;
+    auto opCtx = cc().makeOperationContext();
+    NamespaceString nss = {"test", "coll"};
+    AutoGetDb autoDb(opCtx.get(), nss.db(), MODE_X);
+    {
+        WriteUnitOfWork wunit(opCtx.get());
+        opObserver.onBatchedWriteStart(opCtx.get());
+        for (int i = 0; i < 3; ++i) {
+            opObserver.aboutToDelete(opCtx.get(), nss, BSON("_id" << i));
+            opObserver.onDelete(opCtx.get(), nss, uuid, kUninitializedStmtId, false, boost::none);
+        }
+        opObserver.onBatchedWriteCommit(opCtx.get());
+        wunit.commit();
+    }
+    ASSERT_FALSE(BatchedWriteContext::get(opCtx.get()).writesAreBatched());
+
+    auto oplogEntry = assertGet(OplogEntry::parse(getSingleOplogEntry(opCtx.get())));
+    ASSERT(oplogEntry.getOpType() == repl::OpTypeEnum::kCommand);
+    ASSERT_EQ(NamespaceString("admin", "$cmd"), oplogEntry.getNss());
+    ASSERT_FALSE(oplogEntry.getSessionId());
+    ASSERT_FALSE(oplogEntry.getFromMigrate());
+
+    auto applyOps = oplogEntry.getObject()["applyOps"].Array();
+    ASSERT_EQ(3U, applyOps.size());
+    for (int i = 0; i < 3; ++i) {
+        auto operation = applyOps[i].Obj();
+        ASSERT_EQ("d", operation["op"].str());
+        ASSERT_EQ(nss.ns(), operation["ns"].str());
+        ASSERT_BSONOBJ_EQ(BSON("_id" << i), operation["o"].Obj());
+    }
+}
+
 DEATH_TEST_F(OpObserverTest, AboutToDeleteMustPreceedOnDelete, "invariant") {
     OpObserverImpl opObserver;
     auto opCtx = cc().makeOperationContext();
@@ -300,6 +300,24 @@ public:
             o->onEmptyCapped(opCtx, collectionName, uuid);
     }
 
+    void onBatchedWriteStart(OperationContext* opCtx) override {
+        ReservedTimes times{opCtx};
+        for (auto& o : _observers)
+            o->onBatchedWriteStart(opCtx);
+    }
+
+    void onBatchedWriteCommit(OperationContext* opCtx) override {
+        ReservedTimes times{opCtx};
+        for (auto& o : _observers)
+            o->onBatchedWriteCommit(opCtx);
+    }
+
+    void onBatchedWriteAbort(OperationContext* opCtx) override {
+        ReservedTimes times{opCtx};
+        for (auto& o : _observers)
+            o->onBatchedWriteAbort(opCtx);
+    }
+
     void onUnpreparedTransactionCommit(OperationContext* opCtx,
                                        std::vector<repl::ReplOperation>* statements,
                                        size_t numberOfPreImagesToWrite) override {
@@ -73,6 +73,7 @@
 #include "mongo/db/stats/top.h"
 #include "mongo/db/storage/duplicate_key_error_info.h"
 #include "mongo/db/transaction_participant.h"
+#include "mongo/db/transaction_participant_gen.h"
 #include "mongo/db/update/path_support.h"
 #include "mongo/db/write_concern.h"
 #include "mongo/logv2/log.h"
@@ -104,6 +105,10 @@ MONGO_FAIL_POINT_DEFINE(hangWithLockDuringBatchInsert);
 MONGO_FAIL_POINT_DEFINE(hangWithLockDuringBatchUpdate);
 MONGO_FAIL_POINT_DEFINE(hangWithLockDuringBatchRemove);
 
+// When inserting a batch of documents as a group fails, halves of the batch with at most this many
+// documents are retried one at a time rather than as a group.
+constexpr std::ptrdiff_t kMaxDocsRetriedOneAtATime = 4;
+
 void updateRetryStats(OperationContext* opCtx, bool containsRetry) {
     if (containsRetry) {
         RetryableWritesStats::get(opCtx)->incrementRetriedCommandsCount();
@@ -368,6 +373,24 @@ Status checkIfTransactionOnCappedColl(OperationContext* opCtx, const CollectionP
     return Status::OK();
 }
 
+/**
+ * Returns true if the inserts of 'wholeOp' into 'collection', which run in a multi-document
+ * transaction, should be buffered in the transaction's write set rather than applied right away.
+ * Only top-level user inserts into existing, uncapped, non-system collections are buffered, and not
+ * those that bypass document validation, as that setting does not outlive the insert command.
+ */
+bool shouldBufferTransactionInserts(OperationContext* opCtx,
+                                    const write_ops::Insert& wholeOp,
+                                    const CollectionPtr& collection) {
+    if (!gTransactionWriteBufferingEnabled.load() || opCtx->getClient()->isInDirectClient()) {
+        return false;
+    }
+
+    const auto& nss = collection->ns();
+    return !collection->isCapped() && !nss.isSystem() && !nss.isOnInternalDb() &&
+        !wholeOp.getWriteCommandBase().getBypassDocumentValidation();
+}
+
 /**
  * Returns true if caller should try to insert more documents. Does nothing else if batch is empty.
  */
@@ -447,35 +470,75 @@ bool insertBatchAndHandleErrors(OperationContext* opCtx,
         shouldProceedWithBatchInsert = false;
     }
 
-    if (shouldProceedWithBatchInsert) {
+    // Buffered inserts are applied by flushBufferedTransactionWrites() before the next statement
+    // of the transaction other than an insert runs, before the next insert which is not buffered,
+    // or here once the write set grows too large. Any error they hit is reported by that statement
+    // and aborts the transaction, as it would have if it had been reported by this insert.
+    if (inTxn && shouldBufferTransactionInserts(opCtx, wholeOp, collection->getCollection())) {
+        const size_t numInserted = batch.size();
+        const size_t bufferedBytes =
+            txnParticipant.bufferInserts(wholeOp.getNamespace(), std::move(batch));
+
+        globalOpCounters.gotInserts(numInserted);
+        ServerWriteConcernMetrics::get(opCtx)->recordWriteConcernForInserts(
+            opCtx->getWriteConcern(), numInserted);
+        SingleWriteResult result;
+        result.setN(1);
+        std::fill_n(std::back_inserter(out->results), numInserted, std::move(result));
+        curOp.debug().additiveMetrics.incrementNinserted(numInserted);
+
+        if (bufferedBytes > static_cast<size_t>(gTransactionWriteBufferMaxSizeBytes.load())) {
+            flushBufferedTransactionWrites(opCtx);
+        }
+        return true;
+    }
+
+    if (inTxn) {
         try {
-            if (!collection->getCollection()->isCapped() && !inTxn && batch.size() > 1) {
-                // First try doing it all together. If all goes well, this is all we need to do.
-                // See Collection::_insertDocuments for why we do all capped inserts one-at-a-time.
-                lastOpFixer->startingOp();
-                insertDocuments(
-                    opCtx, collection->getCollection(), batch.begin(), batch.end(), fromMigrate);
-                lastOpFixer->finishedOpSuccessfully();
-                globalOpCounters.gotInserts(batch.size());
-                ServerWriteConcernMetrics::get(opCtx)->recordWriteConcernForInserts(
-                    opCtx->getWriteConcern(), batch.size());
-                SingleWriteResult result;
-                result.setN(1);
-
-                std::fill_n(std::back_inserter(out->results), batch.size(), std::move(result));
-                curOp.debug().additiveMetrics.incrementNinserted(batch.size());
-                return true;
-            }
+            flushBufferedTransactionWrites(opCtx);
+        } catch (const DBException& ex) {
+            auto canContinue = handleError(opCtx,
+                                           ex,
+                                           wholeOp.getNamespace(),
+                                           wholeOp.getWriteCommandBase(),
+                                           false /* multiUpdate */,
+                                           out);
+            invariant(!canContinue);
+            return false;
+        }
+    }
+
+    // Inserts the documents in [begin, end) in a single WriteUnitOfWork. Returns false, having
+    // inserted nothing, if that fails.
+    auto insertGroup = [&](auto begin, auto end) {
+        try {
+            if (!collection)
+                acquireCollection();
+            lastOpFixer->startingOp();
+            insertDocuments(opCtx, collection->getCollection(), begin, end, fromMigrate);
+            lastOpFixer->finishedOpSuccessfully();
+            const size_t numInserted = end - begin;
+            globalOpCounters.gotInserts(numInserted);
+            ServerWriteConcernMetrics::get(opCtx)->recordWriteConcernForInserts(
+                opCtx->getWriteConcern(), numInserted);
+            SingleWriteResult result;
+            result.setN(1);
+
+            std::fill_n(std::back_inserter(out->results), numInserted, std::move(result));
+            curOp.debug().additiveMetrics.incrementNinserted(numInserted);
+            return true;
         } catch (const DBException&) {
-            // Ignore this failure and behave as if we never tried to do the combined batch
-            // insert. The loop below will handle reporting any non-transient errors.
+            // Ignore this failure and behave as if we never tried to do the combined insert. The
+            // callers fall back to smaller groups, and eventually to inserting one document at a
+            // time, which reports any non-transient errors.
             collection.reset();
+            return false;
         }
-    }
+    };
 
-    // Try to insert the batch one-at-a-time. This path is executed for singular batches,
-    // multi-statement transactions, capped collections, and if we failed all-at-once inserting.
-    for (auto it = batch.begin(); it != batch.end(); ++it) {
+    // Inserts the document at 'it' on its own, handling any error. Returns false if the caller
+    // should not try to insert more documents.
+    auto insertOne = [&](auto it) {
         globalOpCounters.gotInsert();
         ServerWriteConcernMetrics::get(opCtx)->recordWriteConcernForInsert(
             opCtx->getWriteConcern());
@@ -517,9 +580,47 @@ bool insertBatchAndHandleErrors(OperationContext* opCtx,
                 return false;
             }
         }
+        return true;
+    };
+
+    using InsertIterator = std::vector<InsertStatement>::iterator;
+    auto insertOneAtATime = [&](InsertIterator begin, InsertIterator end) {
+        for (auto it = begin; it != end; ++it) {
+            if (!insertOne(it)) {
+                return false;
+            }
+        }
+        return true;
+    };
+
+    // Retries one half of a batch that failed to insert as a group. The half gets one more try as
+    // a group, so that a failing document only costs the batching of its own half, and is then
+    // inserted one document at a time, which reports the errors. Splitting further would make a
+    // batch with many failing documents pay for a failed group insert at every level.
+    auto insertHalf = [&](InsertIterator begin, InsertIterator end) {
+        if (end - begin > kMaxDocsRetriedOneAtATime && insertGroup(begin, end)) {
+            return true;
+        }
+        return insertOneAtATime(begin, end);
+    };
+
+    // Batches are inserted in groups unless they hold a single document, are part of a
+    // multi-statement transaction, or target a capped collection. See
+    // Collection::_insertDocuments for why we do all capped inserts one-at-a-time.
+    if (shouldProceedWithBatchInsert && !collection->getCollection()->isCapped() && !inTxn &&
+        batch.size() > 1) {
+        // First try doing it all together. If all goes well, this is all we need to do.
+        if (insertGroup(batch.begin(), batch.end())) {
+            return true;
+        }
+        auto middle = batch.begin() + batch.size() / 2;
+        return insertHalf(batch.begin(), middle) && insertHalf(middle, batch.end());
     }
 
-    return true;
+    // Try to insert the batch one-at-a-time. This path is executed for singular batches,
+    // multi-statement transactions, capped collections, and if we failed to acquire the
+    // collection.
+    return insertOneAtATime(batch.begin(), batch.end());
 }
 
 template <typename T>
@@ -537,6 +638,33 @@ SingleWriteResult makeWriteResultForInsertOrDeleteRetry() {
 
 }  // namespace
 
+void flushBufferedTransactionWrites(OperationContext* opCtx) {
+    auto txnParticipant = TransactionParticipant::get(opCtx);
+    if (!txnParticipant || !opCtx->inMultiDocumentTransaction() ||
+        !txnParticipant.hasBufferedInserts()) {
+        return;
+    }
+
+    // Apply the inserts in the order in which the statements ran, so that the transaction's oplog
+    // entries and any duplicate key error come out as they would have without buffering.
+    for (auto& [nss, stmts] : txnParticipant.takeBufferedInserts()) {
+        writeConflictRetry(opCtx, "insert", nss.ns(), [&] {
+            AutoGetCollection collection(opCtx, nss, MODE_IX);
+            uassert(ErrorCodes::NamespaceNotFound,
+                    str::stream() << "Collection " << nss
+                                  << " targeted by buffered transaction writes no longer exists",
+                    collection.getCollection());
+            assertCanWrite_inlock(opCtx, nss);
+
+            insertDocuments(opCtx,
+                            collection.getCollection(),
+                            stmts.begin(),
+                            stmts.end(),
+                            false /* fromMigrate */);
+        });
+    }
+}
+
 WriteResult performInserts(OperationContext* opCtx,
                            const write_ops::Insert& wholeOp,
                            bool fromMigrate) {
@@ -570,6 +698,14 @@ WriteResult performInserts(OperationContext* opCtx,
 
     uassertStatusOK(userAllowedWriteNS(wholeOp.getNamespace()));
 
+    // A batch of several statements is throughput rather than latency sensitive, so let it queue
+    // for tickets behind interactive operations. Internal work keeps its priority.
+    boost::optional<ScopedAdmissionPriority> admissionPriority;
+    if (wholeOp.getDocuments().size() > 1 &&
+        opCtx->lockState()->getAdmissionPriority() == AdmissionPriority::kInteractive) {
+        admissionPriority.emplace(opCtx->lockState(), AdmissionPriority::kBatch);
+    }
+
     DisableDocumentSchemaValidationIfTrue docSchemaValidationDisabler(
         opCtx, wholeOp.getWriteCommandBase().getBypassDocumentValidation());
     LastOpFixer lastOpFixer(opCtx, wholeOp.getNamespace());
@@ -826,6 +962,13 @@ WriteResult performUpdates(OperationContext* opCtx, const write_ops::Update& who
               (txnParticipant && opCtx->inMultiDocumentTransaction()));
     uassertStatusOK(userAllowedWriteNS(wholeOp.getNamespace()));
 
+    // See performInserts().
+    boost::optional<ScopedAdmissionPriority> admissionPriority;
+    if (wholeOp.getUpdates().size() > 1 &&
+        opCtx->lockState()->getAdmissionPriority() == AdmissionPriority::kInteractive) {
+        admissionPriority.emplace(opCtx->lockState(), AdmissionPriority::kBatch);
+    }
+
     DisableDocumentSchemaValidationIfTrue docSchemaValidationDisabler(
         opCtx, wholeOp.getWriteCommandBase().getBypassDocumentValidation());
     LastOpFixer lastOpFixer(opCtx, wholeOp.getNamespace());
@@ -988,6 +1131,13 @@ WriteResult performDeletes(OperationContext* opCtx, const write_ops::Delete& who
               (txnParticipant && opCtx->inMultiDocumentTransaction()));
     uassertStatusOK(userAllowedWriteNS(wholeOp.getNamespace()));
 
+    // See performInserts().
+    boost::optional<ScopedAdmissionPriority> admissionPriority;
+    if (wholeOp.getDeletes().size() > 1 &&
+        opCtx->lockState()->getAdmissionPriority() == AdmissionPriority::kInteractive) {
+        admissionPriority.emplace(opCtx->lockState(), AdmissionPriority::kBatch);
+    }
+
     DisableDocumentSchemaValidationIfTrue docSchemaValidationDisabler(
         opCtx, wholeOp.getWriteCommandBase().getBypassDocumentValidation());
     LastOpFixer lastOpFixer(opCtx, wholeOp.getNamespace());
@@ -79,6 +79,16 @@ WriteResult performInserts(OperationContext* opCtx,
 WriteResult performUpdates(OperationContext* opCtx, const write_ops::Update& op);
 WriteResult performDeletes(OperationContext* opCtx, const write_ops::Delete& op);
 
+/**
+ * Applies the inserts which earlier statements of the multi-document transaction on 'opCtx' have
+ * buffered in the transaction's write set (see 'transactionWriteBufferingEnabled'). Consecutive
+ * inserts into the same collection are applied as one batch, in statement order. Does nothing if
+ * 'opCtx' is not in a multi-document transaction or the transaction has no buffered inserts.
+ *
+ * Throws if any of the inserts fails, in which case the transaction must be aborted.
+ */
+void flushBufferedTransactionWrites(OperationContext* opCtx);
+
 /**
  * Populate 'opDebug' with stats describing the execution of an update operation. Illegal to call
  * with a null OpDebug pointer.
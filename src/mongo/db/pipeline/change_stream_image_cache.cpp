@@ -0,0 +1,102 @@
+/**
+ *    Copyright (C) 2021-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/pipeline/change_stream_image_cache.h"
+
+#include "mongo/db/change_stream_images.h"
+#include "mongo/db/pipeline/document_source_change_stream.h"
+#include "mongo/db/pipeline/resume_token.h"
+#include "mongo/db/server_options.h"
+
+namespace mongo {
+
+boost::optional<BSONObj> ChangeStreamImageCache::lookup(
+    const boost::intrusive_ptr<ExpressionContext>& expCtx, const Document& event) {
+    // Change stream images are not recorded in sharded clusters.
+    if (expCtx->inMongos || serverGlobalParams.clusterRole != ClusterRole::None) {
+        return boost::none;
+    }
+
+    auto nsField = event[DocumentSourceChangeStream::kNamespaceField];
+    if (nsField.getType() != BSONType::Object) {
+        return boost::none;
+    }
+    auto nsDoc = nsField.getDocument();
+    NamespaceString nss(nsDoc["db"_sd].coerceToString(), nsDoc["coll"_sd].coerceToString());
+
+    auto options = expCtx->mongoProcessInterface->getCollectionOptions(expCtx->opCtx, nss);
+    if (!options["recordChangeStreamImages"].trueValue()) {
+        return boost::none;
+    }
+
+    auto tokenData =
+        ResumeToken::parse(event[DocumentSourceChangeStream::kIdField].getDocument()).getData();
+    if (!tokenData.uuid) {
+        return boost::none;
+    }
+
+    const auto ts = tokenData.clusterTime;
+    if (_fetchedFrom.isNull() || ts < _fetchedFrom || ts > _fetchedThrough) {
+        _fetch(expCtx, ts);
+    }
+
+    auto it = _images.find(ts);
+    if (it == _images.end()) {
+        return boost::none;
+    }
+
+    // Only single writes record images, so the write logged at 'ts' is the one of the event, but
+    // the collection may have been dropped and recreated since the option was read.
+    auto imagesUuid = UUID::parse(it->second[change_stream_images::kUuidFieldName]);
+    if (!imagesUuid.isOK() || imagesUuid.getValue() != *tokenData.uuid) {
+        return boost::none;
+    }
+    return it->second;
+}
+
+void ChangeStreamImageCache::_fetch(const boost::intrusive_ptr<ExpressionContext>& expCtx,
+                                    Timestamp from) {
+    auto images =
+        expCtx->mongoProcessInterface->lookupChangeStreamImages(expCtx->opCtx, from, kBatchSize);
+
+    _images.clear();
+    for (auto&& image : images) {
+        _images.emplace(image[change_stream_images::kTimestampFieldName].timestamp(), image);
+    }
+
+    // Writes after the last fetched image may not have been recorded yet, so only the range up to
+    // it is known to be complete.
+    _fetchedFrom = from;
+    _fetchedThrough = _images.empty() ? from : _images.rbegin()->first;
+}
+
+}  // namespace mongo
@@ -0,0 +1,72 @@
+/**
+ *    Copyright (C) 2021-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#pragma once
+
+#include <boost/optional.hpp>
+#include <map>
+
+#include "mongo/bson/bsonobj.h"
+#include "mongo/bson/timestamp.h"
+#include "mongo/db/exec/document_value/document.h"
+#include "mongo/db/pipeline/expression_context.h"
+
+namespace mongo {
+
+/**
+ * Serves the pre- and post-images of change stream events on collections with the
+ * 'recordChangeStreamImages' option from the change stream images collection. The images are
+ * fetched with range scans starting at the first event whose images are not cached, so a stream
+ * reading consecutive events scans the images collection once per batch of writes rather than
+ * looking up every event on its own.
+ */
+class ChangeStreamImageCache {
+public:
+    static constexpr size_t kBatchSize = 128;
+
+    /**
+     * Returns the images document recorded for the write that produced the change stream event
+     * 'event', or boost::none if the event's collection does not record change stream images or no
+     * images were recorded for the write.
+     */
+    boost::optional<BSONObj> lookup(const boost::intrusive_ptr<ExpressionContext>& expCtx,
+                                    const Document& event);
+
+private:
+    void _fetch(const boost::intrusive_ptr<ExpressionContext>& expCtx, Timestamp from);
+
+    // The images recorded for the writes logged in [_fetchedFrom, _fetchedThrough], keyed by the
+    // timestamp of the write.
+    std::map<Timestamp, BSONObj> _images;
+    Timestamp _fetchedFrom;
+    Timestamp _fetchedThrough;
+};
+
+}  // namespace mongo
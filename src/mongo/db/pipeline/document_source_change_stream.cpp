@@ -199,6 +199,23 @@ BSONObj getTxnApplyOpsFilter(BSONElement nsMatch, const NamespaceString& nss) {
     }
     return applyOpsBuilder.obj();
 }
+
+/**
+ * Constructs the filter which will match 'applyOps' oplog entries that batch deletes outside of a
+ * transaction. Such an entry has no session and holds nothing but deletes.
+ */
+BSONObj getBatchedDeletesApplyOpsFilter(BSONElement nsMatch) {
+    BSONObjBuilder applyOpsBuilder;
+    applyOpsBuilder.append("op", "c");
+    applyOpsBuilder.append("o.applyOps",
+                           BSON("$type"
+                                << "array"));
+    applyOpsBuilder.append("lsid", BSON("$exists" << false));
+    applyOpsBuilder.appendAs(nsMatch, "o.applyOps.ns"_sd);
+    applyOpsBuilder.append(
+        "$nor", BSON_ARRAY(BSON("o.applyOps" << BSON("$elemMatch" << BSON("op" << NE << "d")))));
+    return applyOpsBuilder.obj();
+}
 }  // namespace
 
 DocumentSourceChangeStream::ChangeStreamType DocumentSourceChangeStream::getChangeStreamType(
@@ -322,9 +339,13 @@ BSONObj DocumentSourceChangeStream::buildMatchFilter(
     // 3) Look for 'applyOps' which were created as part of a transaction.
     BSONObj applyOps = getTxnApplyOpsFilter(opNsMatch["ns"], nss);
 
-    // Either (1) or (3), excluding those resulting from chunk migration.
-    BSONObj commandAndApplyOpsMatch =
-        BSON("$and" << BSON_ARRAY(BSON(OR(commandMatch, applyOps)) << notFromMigrateFilter));
+    // 4) Look for 'applyOps' which batch deletes outside of a transaction.
+    BSONObj batchedDeletesApplyOps = getBatchedDeletesApplyOpsFilter(opNsMatch["ns"]);
+
+    // Either (1), (3) or (4), excluding those resulting from chunk migration.
+    BSONObj commandAndApplyOpsMatch = BSON(
+        "$and" << BSON_ARRAY(BSON(OR(commandMatch, applyOps, batchedDeletesApplyOps))
+                             << notFromMigrateFilter));
 
     // Match oplog entries after "start" that are either supported (1) commands or (2) operations.
     // Only include CRUD operations tagged "fromMigrate" when the "showMigrationEvents" option is
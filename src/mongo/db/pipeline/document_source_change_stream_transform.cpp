@@ -341,10 +341,10 @@ Document DocumentSourceChangeStreamTransform::applyTransformation(const Document
     auto resumeToken = ResumeToken(resumeTokenData).toDocument();
 
     // Add some additional fields only relevant to transactions.
-    if (_txnIterator) {
+    if (_txnIterator && _txnIterator->lsid()) {
         doc.addField(DocumentSourceChangeStream::kTxnNumberField,
-                     Value(static_cast<long long>(_txnIterator->txnNumber())));
-        doc.addField(DocumentSourceChangeStream::kLsidField, Value(_txnIterator->lsid()));
+                     Value(static_cast<long long>(*_txnIterator->txnNumber())));
+        doc.addField(DocumentSourceChangeStream::kLsidField, Value(*_txnIterator->lsid()));
     }
 
     doc.addField(DocumentSourceChangeStream::kIdField, Value(resumeToken));
@@ -485,13 +485,16 @@ DocumentSourceChangeStreamTransform::TransactionOpIterator::TransactionOpIterato
     const Document& input,
     const pcrecpp::RE& nsRegex)
     : _mongoProcessInterface(mongoProcessInterface), _nsRegex(nsRegex) {
+    // An 'applyOps' of batched writes is not part of a transaction, so has no session.
     Value lsidValue = input["lsid"];
-    checkValueType(lsidValue, "lsid", BSONType::Object);
-    _lsid = lsidValue.getDocument();
+    if (!lsidValue.missing()) {
+        checkValueType(lsidValue, "lsid", BSONType::Object);
+        _lsid = lsidValue.getDocument();
 
-    Value txnNumberValue = input["txnNumber"];
-    checkValueType(txnNumberValue, "txnNumber", BSONType::NumberLong);
-    _txnNumber = txnNumberValue.getLong();
+        Value txnNumberValue = input["txnNumber"];
+        checkValueType(txnNumberValue, "txnNumber", BSONType::NumberLong);
+        _txnNumber = txnNumberValue.getLong();
+    }
 
     // We want to parse the OpTime out of this document using the BSON OpTime parser. Instead of
     // converting the entire Document back to BSON, we convert only the fields we need.
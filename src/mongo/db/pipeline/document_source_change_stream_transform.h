@@ -129,11 +129,13 @@ private:
             return _clusterTime;
         }
 
-        Document lsid() const {
+        // The session and transaction number are missing for an 'applyOps' that batches writes
+        // outside of a transaction.
+        const boost::optional<Document>& lsid() const {
             return _lsid;
         }
 
-        TxnNumber txnNumber() const {
+        boost::optional<TxnNumber> txnNumber() const {
             return _txnNumber;
         }
 
@@ -185,8 +187,8 @@ private:
         Timestamp _clusterTime;
 
         // Fields that were taken from the '_applyOps' oplog entry.
-        Document _lsid;
-        TxnNumber _txnNumber;
+        boost::optional<Document> _lsid;
+        boost::optional<TxnNumber> _txnNumber;
 
         // Used for traversing the oplog with TransactionHistoryInterface.
         std::shared_ptr<MongoProcessInterface> _mongoProcessInterface;
@@ -32,6 +32,7 @@
 #include "mongo/db/pipeline/document_source_lookup_change_post_image.h"
 
 #include "mongo/bson/simple_bsonelement_comparator.h"
+#include "mongo/db/change_stream_images.h"
 
 namespace mongo {
 
@@ -63,6 +64,18 @@ DocumentSource::GetNextResult DocumentSourceLookupChangePostImage::doGetNext() {
     }
 
     MutableDocument output(input.releaseDocument());
+
+    // Collections with the 'recordChangeStreamImages' option have the document as of the update in
+    // the change stream images collection, which saves looking up its current version.
+    if (auto images = _imageCache.lookup(pExpCtx, output.peek())) {
+        auto postImage = (*images)[change_stream_images::kPostImageFieldName];
+        if (postImage.type() == BSONType::Object) {
+            assertValidNamespace(output.peek());
+            output[kFullDocumentFieldName] = Value(postImage.Obj().getOwned());
+            return output.freeze();
+        }
+    }
+
     output[kFullDocumentFieldName] = lookupPostImage(output.peek());
     return output.freeze();
 }
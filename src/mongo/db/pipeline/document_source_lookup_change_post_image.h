@@ -29,6 +29,7 @@
 
 #pragma once
 
+#include "mongo/db/pipeline/change_stream_image_cache.h"
 #include "mongo/db/pipeline/document_source.h"
 #include "mongo/db/pipeline/document_source_change_stream.h"
 
@@ -126,6 +127,9 @@ private:
      * function verifies that the only the database names match.
      */
     NamespaceString assertValidNamespace(const Document& inputDoc) const;
+
+    // Post-images of collections recording them in the change stream images collection.
+    ChangeStreamImageCache _imageCache;
 };
 
 }  // namespace mongo
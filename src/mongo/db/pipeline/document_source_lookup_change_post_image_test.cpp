@@ -334,5 +334,52 @@ TEST_F(DocumentSourceLookupChangePostImageTest, ShouldPropagatePauses) {
     ASSERT_TRUE(lookupChangeStage->getNext().isEOF());
 }
 
+TEST_F(DocumentSourceLookupChangePostImageTest, ShouldUseRecordedChangeStreamImages) {
+    auto expCtx = getExpCtx();
+    auto lookupChangeStage = DocumentSourceLookupChangePostImage::create(expCtx);
+
+    auto makeUpdate = [&](int id) {
+        ResumeTokenData tokenData(
+            Timestamp(100, id), 0, 0, testUuid(), Value(Document{{"_id", id}}));
+        return Document{{"_id", ResumeToken(tokenData).toDocument()},
+                        {"documentKey", Document{{"_id", id}}},
+                        {"operationType", "update"_sd},
+                        {"ns", Document{{"db", expCtx->ns.db()}, {"coll", expCtx->ns.coll()}}}};
+    };
+    auto mockLocalSource =
+        DocumentSourceMock::createForTest({makeUpdate(1), makeUpdate(2), makeUpdate(3)}, expCtx);
+    lookupChangeStage->setSource(mockLocalSource.get());
+
+    // Images were recorded for the first and last updates only, so the second one falls back to
+    // looking up the current version of the document.
+    auto mockInterface = std::make_unique<MockMongoInterface>(
+        deque<DocumentSource::GetNextResult>{Document{{"_id", 2}, {"current", true}}});
+    mockInterface->setChangeStreamImages(
+        BSON("recordChangeStreamImages" << true),
+        {BSON("_id" << OID() << "ts" << Timestamp(100, 1) << "uuid" << testUuid() << "postImage"
+                    << BSON("_id" << 1 << "x" << 1)),
+         BSON("_id" << OID() << "ts" << Timestamp(100, 3) << "uuid" << testUuid() << "postImage"
+                    << BSON("_id" << 3 << "x" << 3))});
+    auto mockInterfacePtr = mockInterface.get();
+    expCtx->mongoProcessInterface = std::move(mockInterface);
+
+    auto next = lookupChangeStage->getNext();
+    ASSERT_TRUE(next.isAdvanced());
+    ASSERT_VALUE_EQ(next.getDocument()["fullDocument"], Value(Document{{"_id", 1}, {"x", 1}}));
+
+    next = lookupChangeStage->getNext();
+    ASSERT_TRUE(next.isAdvanced());
+    ASSERT_VALUE_EQ(next.getDocument()["fullDocument"],
+                    Value(Document{{"_id", 2}, {"current", true}}));
+
+    next = lookupChangeStage->getNext();
+    ASSERT_TRUE(next.isAdvanced());
+    ASSERT_VALUE_EQ(next.getDocument()["fullDocument"], Value(Document{{"_id", 3}, {"x", 3}}));
+
+    // All three events were served from the one range scan made for the first of them.
+    ASSERT_EQ(mockInterfacePtr->changeStreamImagesLookups, 1);
+    ASSERT_TRUE(lookupChangeStage->getNext().isEOF());
+}
+
 }  // namespace
 }  // namespace mongo
@@ -34,6 +34,7 @@
 #include "mongo/db/pipeline/document_source_lookup_change_pre_image.h"
 
 #include "mongo/bson/simple_bsonelement_comparator.h"
+#include "mongo/db/change_stream_images.h"
 #include "mongo/db/repl/local_oplog_info.h"
 #include "mongo/db/transaction_history_iterator.h"
 #include "mongo/util/intrusive_counter.h"
@@ -67,6 +68,17 @@ DocumentSource::GetNextResult DocumentSourceLookupChangePreImage::doGetNext() {
         return input;
     }
 
+    // Collections with the 'recordChangeStreamImages' option keep their pre-images in the change
+    // stream images collection rather than in the oplog.
+    if (auto images = _imageCache.lookup(pExpCtx, input.getDocument())) {
+        auto preImage = (*images)[change_stream_images::kPreImageFieldName];
+        if (preImage.type() == BSONType::Object) {
+            MutableDocument outputDoc(input.releaseDocument());
+            outputDoc[kFullDocumentBeforeChangeFieldName] = Value(preImage.Obj().getOwned());
+            return outputDoc.freeze();
+        }
+    }
+
     // If a pre-image is available, the transform stage will have populated it in the event's
     // 'fullDocumentBeforeChange' field. If this field is missing and the pre-imaging mode is
     // 'required', we throw an exception. Otherwise, we pass along the document unmodified.
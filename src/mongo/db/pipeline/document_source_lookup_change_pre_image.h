@@ -29,6 +29,7 @@
 
 #pragma once
 
+#include "mongo/db/pipeline/change_stream_image_cache.h"
 #include "mongo/db/pipeline/document_source.h"
 #include "mongo/db/pipeline/document_source_change_stream.h"
 
@@ -125,6 +126,9 @@ private:
     // Determines whether pre-images are strictly required or may be included only when available.
     FullDocumentBeforeChangeModeEnum _fullDocumentBeforeChangeMode =
         FullDocumentBeforeChangeModeEnum::kOff;
+
+    // Pre-images of collections recording them in the change stream images collection.
+    ChangeStreamImageCache _imageCache;
 };
 
 }  // namespace mongo
@@ -546,13 +546,14 @@ std::pair<DocumentSourceMerge::BatchObject, int> DocumentSourceMerge::makeBatchO
     return {{std::move(mergeOnFields), std::move(mod), std::move(vars)}, modSize};
 }
 
-void DocumentSourceMerge::spill(BatchedObjects&& batch) try {
-    DocumentSourceWriteBlock writeBlock(pExpCtx->opCtx);
+void DocumentSourceMerge::spill(const boost::intrusive_ptr<ExpressionContext>& expCtx,
+                                BatchedObjects&& batch) try {
+    DocumentSourceWriteBlock writeBlock(expCtx->opCtx);
     auto targetEpoch = _targetCollectionVersion
         ? boost::optional<OID>(_targetCollectionVersion->epoch())
         : boost::none;
 
-    _descriptor.strategy(pExpCtx, _outputNs, _writeConcern, targetEpoch, std::move(batch));
+    _descriptor.strategy(expCtx, _outputNs, _writeConcern, targetEpoch, std::move(batch));
 } catch (const ExceptionFor<ErrorCodes::ImmutableField>& ex) {
     uassertStatusOKWithContext(ex.toStatus(),
                                "$merge failed to update the matching document, did you "
@@ -182,7 +182,8 @@ private:
         return bob.obj();
     }
 
-    void spill(BatchedObjects&& batch) override;
+    void spill(const boost::intrusive_ptr<ExpressionContext>& expCtx,
+               BatchedObjects&& batch) override;
 
     void waitWhileFailPointEnabled() override;
 
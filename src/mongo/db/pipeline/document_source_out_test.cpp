@@ -35,6 +35,8 @@
 #include "mongo/db/exec/document_value/document_value_test_util.h"
 #include "mongo/db/pipeline/aggregation_context_fixture.h"
 #include "mongo/db/pipeline/document_source_out.h"
+#include "mongo/db/pipeline/document_source_writer.h"
+#include "mongo/db/repl/replication_coordinator_mock.h"
 
 namespace mongo {
 namespace {
@@ -114,5 +116,34 @@ TEST_F(DocumentSourceOutTest, SerializeToString) {
     ASSERT_EQ(reSerialized["$out"]["coll"].getStringData(), "some_collection");
 }
 
+TEST_F(DocumentSourceOutTest, FlusherWritesBatchesInOrderOnItsOwnOperationContext) {
+    repl::ReplicationCoordinator::set(
+        getServiceContext(),
+        std::make_unique<repl::ReplicationCoordinatorMock>(getServiceContext()));
+
+    auto expCtx = getExpCtx();
+    DocumentSourceWriterFlusher flusher(expCtx);
+
+    // Batches run on the writer thread, so record what they observe rather than asserting there.
+    std::vector<int> written;
+    bool usedPipelineOpCtx = false;
+    for (int i = 0; i < 3; ++i) {
+        flusher.schedule([&, i](const boost::intrusive_ptr<ExpressionContext>& writeExpCtx) {
+            usedPipelineOpCtx |= writeExpCtx->opCtx == expCtx->opCtx;
+            written.push_back(i);
+        });
+    }
+    flusher.waitForPendingWrite();
+    ASSERT(written == std::vector<int>({0, 1, 2}));
+    ASSERT_FALSE(usedPipelineOpCtx);
+
+    // A failed batch is reported to the pipeline exactly once.
+    flusher.schedule([](const boost::intrusive_ptr<ExpressionContext>&) {
+        uasserted(ErrorCodes::DuplicateKey, "duplicate key");
+    });
+    ASSERT_THROWS_CODE(flusher.waitForPendingWrite(), AssertionException, ErrorCodes::DuplicateKey);
+    flusher.waitForPendingWrite();
+}
+
 }  // namespace
 }  // namespace mongo
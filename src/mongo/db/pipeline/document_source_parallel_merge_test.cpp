@@ -0,0 +1,144 @@
+/**
+ *    Copyright (C) 2021-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/s/query/document_source_parallel_merge.h"
+
+#include <map>
+
+#include "mongo/db/pipeline/aggregation_context_fixture.h"
+#include "mongo/db/pipeline/document_source_exchange.h"
+#include "mongo/db/pipeline/document_source_group.h"
+#include "mongo/db/pipeline/document_source_mock.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+using DocumentSourceParallelMergeTest = AggregationContextFixture;
+
+/**
+ * Builds a $_internalParallelMerge stage which hash-partitions the partial groups in 'input' on
+ * their _id across 'numPartitions' partitions, each running a merging $group which sums 'count'.
+ */
+boost::intrusive_ptr<DocumentSourceParallelMerge> makeParallelMerge(
+    const boost::intrusive_ptr<ExpressionContext>& expCtx,
+    const std::deque<DocumentSource::GetNextResult>& input,
+    int numPartitions) {
+    auto inputExpCtx = expCtx->copyWith(expCtx->ns);
+    auto inputPipeline = Pipeline::create({DocumentSourceMock::createForTest(input, inputExpCtx)},
+                                          inputExpCtx);
+
+    std::vector<BSONObj> boundaries{BSON("" << MINKEY)};
+    for (int partition = 1; partition < numPartitions; ++partition) {
+        boundaries.push_back(BSON("" << static_cast<long long>(
+                                      std::numeric_limits<long long>::min() +
+                                      (std::numeric_limits<uint64_t>::max() / numPartitions) *
+                                          partition)));
+    }
+    boundaries.push_back(BSON("" << MAXKEY));
+
+    ExchangeSpec spec;
+    spec.setPolicy(ExchangePolicyEnum::kKeyRange);
+    spec.setConsumers(numPartitions);
+    spec.setKey(BSON("_id"
+                     << "hashed"));
+    spec.setBoundaries(std::move(boundaries));
+    boost::intrusive_ptr<Exchange> exchange =
+        new Exchange(std::move(spec), std::move(inputPipeline));
+
+    const auto groupSpec =
+        BSON("$group" << BSON("_id"
+                              << "$_id"
+                              << "count" << BSON("$sum"
+                                                 << "$count")
+                              << "$doingMerge" << true));
+    std::vector<std::unique_ptr<Pipeline, PipelineDeleter>> partitionPipelines;
+    for (int partition = 0; partition < numPartitions; ++partition) {
+        auto partitionExpCtx = expCtx->copyWith(expCtx->ns);
+        boost::intrusive_ptr<DocumentSource> consumer =
+            new DocumentSourceExchange(partitionExpCtx, exchange, partition, nullptr);
+        auto group = DocumentSourceGroup::createFromBson(groupSpec.firstElement(), partitionExpCtx);
+        auto pipeline = Pipeline::create({consumer, group}, partitionExpCtx);
+        pipeline->detachFromOperationContext();
+        partitionPipelines.push_back(std::move(pipeline));
+    }
+
+    return DocumentSourceParallelMerge::create(expCtx, exchange, std::move(partitionPipelines));
+}
+
+std::deque<DocumentSource::GetNextResult> makePartialGroups(int numGroups, int numShards) {
+    std::deque<DocumentSource::GetNextResult> input;
+    for (int shard = 0; shard < numShards; ++shard) {
+        for (int group = 0; group < numGroups; ++group) {
+            // Mix numeric types, which the merging $group treats as equal group keys.
+            input.emplace_back(Document{
+                {"_id", shard % 2 ? Value(group) : Value(static_cast<double>(group))},
+                {"count", 1}});
+        }
+    }
+    return input;
+}
+
+TEST_F(DocumentSourceParallelMergeTest, MergesEveryGroupExactlyOnce) {
+    const int kNumGroups = 1000;
+    const int kNumShards = 4;
+    auto parallelMerge =
+        makeParallelMerge(getExpCtx(), makePartialGroups(kNumGroups, kNumShards), 4);
+
+    std::map<int, int> counts;
+    for (auto next = parallelMerge->getNext(); next.isAdvanced(); next = parallelMerge->getNext()) {
+        auto doc = next.releaseDocument();
+        auto inserted = counts.emplace(doc["_id"].coerceToInt(), doc["count"].getInt()).second;
+        ASSERT_TRUE(inserted);
+    }
+    ASSERT_TRUE(parallelMerge->getNext().isEOF());
+    parallelMerge->dispose();
+
+    ASSERT_EQ(counts.size(), static_cast<size_t>(kNumGroups));
+    for (auto&& [group, count] : counts) {
+        ASSERT_EQ(count, kNumShards);
+    }
+}
+
+TEST_F(DocumentSourceParallelMergeTest, CanBeDisposedBeforeExhausted) {
+    auto parallelMerge = makeParallelMerge(getExpCtx(), makePartialGroups(1000, 2), 3);
+    ASSERT_TRUE(parallelMerge->getNext().isAdvanced());
+    parallelMerge->dispose();
+}
+
+TEST_F(DocumentSourceParallelMergeTest, CanBeDisposedBeforeIterated) {
+    auto parallelMerge = makeParallelMerge(getExpCtx(), makePartialGroups(10, 2), 2);
+    parallelMerge->dispose();
+}
+
+}  // namespace
+}  // namespace mongo
@@ -0,0 +1,177 @@
+/**
+ *    Copyright (C) 2021-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/pipeline/document_source_writer.h"
+
+#include <utility>
+
+#include "mongo/db/auth/authorization_session.h"
+#include "mongo/db/client.h"
+#include "mongo/db/repl/repl_client_info.h"
+#include "mongo/util/scopeguard.h"
+
+namespace mongo {
+namespace {
+
+ThreadPool::Options makeFlusherThreadPoolOptions(OperationContext* opCtx) {
+    // The batches are written on behalf of the users running the aggregation, so that the writes
+    // are attributed to them, as they would be had the pipeline thread written them itself.
+    auto authSession = AuthorizationSession::get(opCtx->getClient());
+    auto userNames = authSession->getImpersonatedUserNames();
+    auto roleNames = authSession->getImpersonatedRoleNames();
+    if (!userNames.more() && !roleNames.more()) {
+        userNames = authSession->getAuthenticatedUserNames();
+        roleNames = authSession->getAuthenticatedRoleNames();
+    }
+
+    ThreadPool::Options options;
+    options.poolName = "DocumentSourceWriterFlusher";
+    options.threadNamePrefix = "DocumentSourceWriterFlusher-";
+    options.minThreads = 0;
+    options.maxThreads = 1;
+    options.onCreateThread =
+        [service = opCtx->getServiceContext(),
+         userNames = userNameIteratorToContainer<std::vector<UserName>>(userNames),
+         roleNames = roleNameIteratorToContainer<std::vector<RoleName>>(roleNames)](
+            const std::string& name) {
+            Client::initThread(name, service, nullptr);
+            if (!userNames.empty() || !roleNames.empty()) {
+                AuthorizationSession::get(cc())->setImpersonatedUserData(userNames, roleNames);
+            }
+        };
+    return options;
+}
+
+}  // namespace
+
+DocumentSourceWriterFlusher::DocumentSourceWriterFlusher(
+    const boost::intrusive_ptr<ExpressionContext>& expCtx)
+    : _expCtx(expCtx), _pool(makeFlusherThreadPoolOptions(expCtx->opCtx)) {
+    _pool.startup();
+}
+
+DocumentSourceWriterFlusher::~DocumentSourceWriterFlusher() {
+    {
+        stdx::unique_lock<Latch> lk(_mutex);
+        // A batch is only still in flight here if the aggregation failed, in which case there is no
+        // point in finishing it.
+        if (_writeInFlight) {
+            _killWriter(lk, ErrorCodes::Interrupted);
+        }
+        _writeDone.wait(lk, [&] { return !_writeInFlight; });
+    }
+    _pool.shutdown();
+    _pool.join();
+
+    if (_wroteAnyBatch) {
+        repl::ReplClientInfo::forClient(_expCtx->opCtx->getClient())
+            .setLastOpToSystemLastOpTimeIgnoringInterrupt(_expCtx->opCtx);
+    }
+}
+
+void DocumentSourceWriterFlusher::schedule(WriteFn write) {
+    waitForPendingWrite();
+
+    // The copy is made here, on the thread running the pipeline, since the pipeline may modify
+    // its ExpressionContext while the batch is being written.
+    auto writeExpCtx = _expCtx->copyWith(_expCtx->ns);
+    const auto deadline = _expCtx->opCtx->getDeadline();
+    const auto timeoutError = _expCtx->opCtx->getTimeoutError();
+
+    {
+        stdx::lock_guard<Latch> lk(_mutex);
+        _writeInFlight = true;
+    }
+    _wroteAnyBatch = true;
+    _pool.schedule([this,
+                    write = std::move(write),
+                    writeExpCtx = std::move(writeExpCtx),
+                    deadline,
+                    timeoutError](Status status) mutable {
+        Status writeStatus = Status::OK();
+        try {
+            uassertStatusOK(status);
+
+            auto uniqueOpCtx = cc().makeOperationContext();
+            uniqueOpCtx->setDeadlineByDate(deadline, timeoutError);
+            {
+                stdx::lock_guard<Latch> lk(_mutex);
+                _writerOpCtx = uniqueOpCtx.get();
+                if (_killCode) {
+                    // The aggregation was interrupted before this batch started.
+                    _killWriter(lk, *_killCode);
+                }
+            }
+            ON_BLOCK_EXIT([&] {
+                stdx::lock_guard<Latch> lk(_mutex);
+                _writerOpCtx = nullptr;
+            });
+            writeExpCtx->opCtx = uniqueOpCtx.get();
+
+            write(writeExpCtx);
+        } catch (const DBException& ex) {
+            writeStatus = ex.toStatus();
+        }
+
+        stdx::lock_guard<Latch> lk(_mutex);
+        if (!writeStatus.isOK()) {
+            _writeStatus = std::move(writeStatus);
+        }
+        _writeInFlight = false;
+        _writeDone.notify_all();
+    });
+}
+
+void DocumentSourceWriterFlusher::waitForPendingWrite() {
+    stdx::unique_lock<Latch> lk(_mutex);
+    try {
+        _expCtx->opCtx->waitForConditionOrInterrupt(
+            _writeDone, lk, [&] { return !_writeInFlight; });
+    } catch (const DBException& ex) {
+        _killWriter(lk, ex.code());
+        throw;
+    }
+    uassertStatusOK(std::exchange(_writeStatus, Status::OK()));
+}
+
+void DocumentSourceWriterFlusher::_killWriter(WithLock, ErrorCodes::Error killCode) {
+    _killCode = killCode;
+    if (!_writerOpCtx) {
+        return;
+    }
+
+    auto client = _writerOpCtx->getClient();
+    stdx::lock_guard<Client> clientLock(*client);
+    client->getServiceContext()->killOperation(clientLock, _writerOpCtx, killCode);
+}
+
+}  // namespace mongo
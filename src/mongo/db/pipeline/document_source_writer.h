@@ -36,8 +36,14 @@
 #include "mongo/db/db_raii.h"
 #include "mongo/db/operation_context.h"
 #include "mongo/db/pipeline/document_source.h"
+#include "mongo/db/query/query_knobs_gen.h"
 #include "mongo/db/read_concern.h"
 #include "mongo/db/storage/recovery_unit.h"
+#include "mongo/platform/mutex.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/util/concurrency/thread_pool.h"
+#include "mongo/util/concurrency/with_lock.h"
+#include "mongo/util/functional.h"
 
 namespace mongo {
 using namespace fmt::literals;
@@ -80,6 +86,62 @@ public:
     }
 };
 
+/**
+ * Writes the batches of a DocumentSourceWriter on a dedicated thread, so that the pipeline can
+ * produce the next batch while the previous one is being written. Each batch is written under its
+ * own OperationContext, on behalf of the users running the aggregation, and inherits its deadline.
+ * At most one batch is in flight at a time, so batches are still applied in the order in which they
+ * were produced. Waiting for a batch is interruptible; if the aggregation is interrupted meanwhile,
+ * the batch in flight is killed with the same error.
+ */
+class DocumentSourceWriterFlusher {
+    DocumentSourceWriterFlusher(const DocumentSourceWriterFlusher&) = delete;
+    DocumentSourceWriterFlusher& operator=(const DocumentSourceWriterFlusher&) = delete;
+
+public:
+    using WriteFn = unique_function<void(const boost::intrusive_ptr<ExpressionContext>&)>;
+
+    explicit DocumentSourceWriterFlusher(const boost::intrusive_ptr<ExpressionContext>& expCtx);
+
+    /**
+     * Kills the batch in flight, if any, waits for it, ignoring its outcome, and stops the writer
+     * thread. Advances the last optime of the aggregation's client past the background writes, so
+     * that its write concern also covers them.
+     */
+    ~DocumentSourceWriterFlusher();
+
+    /**
+     * Waits for the previous batch to be written, throwing its error if it failed, then starts
+     * writing the next batch with 'write'.
+     */
+    void schedule(WriteFn write);
+
+    /**
+     * Waits for the batch in flight to be written, throwing its error if it failed. If the
+     * aggregation is interrupted while waiting, kills the batch in flight and throws.
+     */
+    void waitForPendingWrite();
+
+private:
+    /**
+     * Kills the batch in flight, if any, with 'killCode', as well as any batch which has been
+     * scheduled but not yet started.
+     */
+    void _killWriter(WithLock, ErrorCodes::Error killCode);
+
+    const boost::intrusive_ptr<ExpressionContext> _expCtx;
+
+    ThreadPool _pool;
+
+    Mutex _mutex = MONGO_MAKE_LATCH("DocumentSourceWriterFlusher::_mutex");
+    stdx::condition_variable _writeDone;
+    bool _writeInFlight = false;
+    OperationContext* _writerOpCtx = nullptr;
+    boost::optional<ErrorCodes::Error> _killCode;
+    Status _writeStatus = Status::OK();
+    bool _wroteAnyBatch = false;
+};
+
 /**
  * This is a base abstract class for all stages performing a write operation into an output
  * collection. The writes are organized in batches in which elements are objects of the templated
@@ -87,7 +149,9 @@ public:
  *
  *    1. 'makeBatchObject()' - to create an object of type 'B' from the given 'Document', which is,
  *       essentially, a result of the input source's 'getNext()' .
- *    2. 'spill()' - to write the batch into the output collection.
+ *    2. 'spill()' - to write the batch into the output collection, using the given
+ *       'ExpressionContext', whose OperationContext may differ from that of the pipeline when the
+ *       batch is written in the background.
  *
  * Two other virtual methods exist which a subclass may override: 'initialize()' and 'finalize()',
  * which are called before the first element is read from the input source, and after the last one
@@ -143,9 +207,11 @@ protected:
     virtual void finalize() {}
 
     /**
-     * Writes the documents in 'batch' to the output namespace.
+     * Writes the documents in 'batch' to the output namespace. May be called on a thread other
+     * than the one running the pipeline, concurrently with 'makeBatchObject()'.
      */
-    virtual void spill(BatchedObjects&& batch) = 0;
+    virtual void spill(const boost::intrusive_ptr<ExpressionContext>& expCtx,
+                       BatchedObjects&& batch) = 0;
 
     /**
      * Creates a batch object from the given document and returns it to the caller along with the
@@ -198,6 +264,23 @@ DocumentSource::GetNextResult DocumentSourceWriter<B>::doGetNext() {
             _initialized = true;
         }
 
+        // Declared after the guard above, so that any background write has completed and been
+        // accounted to the client before its operation time is updated.
+        boost::optional<DocumentSourceWriterFlusher> flusher;
+        if (internalDocumentSourceWriterBackgroundFlush.load()) {
+            flusher.emplace(pExpCtx);
+        }
+        auto flush = [&](BatchedObjects&& batch) {
+            if (!flusher) {
+                spill(pExpCtx, std::move(batch));
+                return;
+            }
+            flusher->schedule([this, batch = std::move(batch)](
+                                  const boost::intrusive_ptr<ExpressionContext>& expCtx) mutable {
+                spill(expCtx, std::move(batch));
+            });
+        };
+
         BatchedObjects batch;
         int bufferedBytes = 0;
 
@@ -212,16 +295,19 @@ DocumentSource::GetNextResult DocumentSourceWriter<B>::doGetNext() {
             if (!batch.empty() &&
                 (bufferedBytes > BSONObjMaxUserSize ||
                  batch.size() >= write_ops::kMaxWriteBatchSize)) {
-                spill(std::move(batch));
+                flush(std::move(batch));
                 batch.clear();
                 bufferedBytes = objSize;
             }
             batch.push_back(obj);
         }
         if (!batch.empty()) {
-            spill(std::move(batch));
+            flush(std::move(batch));
             batch.clear();
         }
+        if (flusher) {
+            flusher->waitForPendingWrite();
+        }
 
         switch (nextInput.getStatus()) {
             case GetNextResult::ReturnStatus::kAdvanced: {
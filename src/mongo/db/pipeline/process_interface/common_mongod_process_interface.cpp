@@ -43,6 +43,7 @@
 #include "mongo/db/catalog/index_catalog_entry.h"
 #include "mongo/db/catalog/list_indexes.h"
 #include "mongo/db/catalog/rename_collection.h"
+#include "mongo/db/change_stream_images.h"
 #include "mongo/db/concurrency/d_concurrency.h"
 #include "mongo/db/concurrency/write_conflict_exception.h"
 #include "mongo/db/curop.h"
@@ -375,6 +376,11 @@ boost::optional<Document> CommonMongodProcessInterface::lookupSingleDocument(
     return lookedUpDocument;
 }
 
+std::vector<BSONObj> CommonMongodProcessInterface::lookupChangeStreamImages(
+    OperationContext* opCtx, Timestamp from, size_t limit) {
+    return change_stream_images::readImages(opCtx, from, limit);
+}
+
 BackupCursorState CommonMongodProcessInterface::openBackupCursor(
     OperationContext* opCtx, const StorageEngine::BackupOptions& options) {
     auto backupCursorHooks = BackupCursorHooks::get(opCtx->getServiceContext());
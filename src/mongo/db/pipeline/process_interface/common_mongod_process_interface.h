@@ -83,6 +83,9 @@ public:
         const Document& documentKey,
         boost::optional<BSONObj> readConcern,
         bool allowSpeculativeMajorityRead = false) final;
+    std::vector<BSONObj> lookupChangeStreamImages(OperationContext* opCtx,
+                                                  Timestamp from,
+                                                  size_t limit) final;
     std::vector<GenericCursor> getIdleCursors(const boost::intrusive_ptr<ExpressionContext>& expCtx,
                                               CurrentOpUserMode userMode) const final;
     BackupCursorState openBackupCursor(OperationContext* opCtx,
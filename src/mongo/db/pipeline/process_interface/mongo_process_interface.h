@@ -357,6 +357,14 @@ public:
         boost::optional<BSONObj> readConcern,
         bool allowSpeculativeMajorityRead = false) = 0;
 
+    /**
+     * Returns at most 'limit' documents from the change stream images collection recorded at or
+     * after 'from', in timestamp order. Returns an empty vector if the collection does not exist.
+     */
+    virtual std::vector<BSONObj> lookupChangeStreamImages(OperationContext* opCtx,
+                                                          Timestamp from,
+                                                          size_t limit) = 0;
+
     /**
      * Returns a vector of all idle (non-pinned) local cursors.
      */
@@ -124,6 +124,12 @@ public:
         MONGO_UNREACHABLE;
     }
 
+    std::vector<BSONObj> lookupChangeStreamImages(OperationContext* opCtx,
+                                                  Timestamp from,
+                                                  size_t limit) final {
+        MONGO_UNREACHABLE;
+    }
+
     void renameIfOptionsAndIndexesHaveNotChanged(OperationContext* opCtx,
                                                  const BSONObj& renameCommandObj,
                                                  const NamespaceString& targetNs,
@@ -82,4 +82,19 @@ boost::optional<Document> StubLookupSingleDocumentProcessInterface::lookupSingle
     return lookedUpDocument;
 }
 
+std::vector<BSONObj> StubLookupSingleDocumentProcessInterface::lookupChangeStreamImages(
+    OperationContext* opCtx, Timestamp from, size_t limit) {
+    ++changeStreamImagesLookups;
+    std::vector<BSONObj> images;
+    for (auto&& image : _changeStreamImages) {
+        if (images.size() == limit) {
+            break;
+        }
+        if (image["ts"].timestamp() >= from) {
+            images.push_back(image);
+        }
+    }
+    return images;
+}
+
 }  // namespace mongo
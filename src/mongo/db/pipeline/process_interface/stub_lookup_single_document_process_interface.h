@@ -85,6 +85,26 @@ public:
         boost::optional<BSONObj> readConcern,
         bool allowSpeculativeMajorityRead);
 
+    BSONObj getCollectionOptions(OperationContext* opCtx, const NamespaceString& nss) final {
+        return _collectionOptions;
+    }
+
+    std::vector<BSONObj> lookupChangeStreamImages(OperationContext* opCtx,
+                                                  Timestamp from,
+                                                  size_t limit) final;
+
+    /**
+     * Makes every collection report 'collectionOptions' and serves 'images', which must be sorted
+     * by their "ts" field, as the contents of the change stream images collection.
+     */
+    void setChangeStreamImages(BSONObj collectionOptions, std::vector<BSONObj> images) {
+        _collectionOptions = std::move(collectionOptions);
+        _changeStreamImages = std::move(images);
+    }
+
+    // The number of range scans of the change stream images collection.
+    int changeStreamImagesLookups = 0;
+
     std::unique_ptr<ShardFilterer> getShardFilterer(
         const boost::intrusive_ptr<ExpressionContext>& expCtx) const override {
         // Try to emulate the behavior mongos and mongod would each follow.
@@ -97,5 +117,7 @@ public:
 
 private:
     std::deque<DocumentSource::GetNextResult> _mockResults;
+    BSONObj _collectionOptions;
+    std::vector<BSONObj> _changeStreamImages;
 };
 }  // namespace mongo
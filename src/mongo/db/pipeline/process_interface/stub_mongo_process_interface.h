@@ -202,6 +202,12 @@ public:
         MONGO_UNREACHABLE;
     }
 
+    std::vector<BSONObj> lookupChangeStreamImages(OperationContext* opCtx,
+                                                  Timestamp from,
+                                                  size_t limit) override {
+        MONGO_UNREACHABLE;
+    }
+
     std::vector<GenericCursor> getIdleCursors(const boost::intrusive_ptr<ExpressionContext>& expCtx,
                                               CurrentOpUserMode userMode) const {
         MONGO_UNREACHABLE;
@@ -40,6 +40,7 @@
 #include "mongo/base/error_codes.h"
 #include "mongo/base/parse_number.h"
 #include "mongo/db/catalog/index_catalog.h"
+#include "mongo/db/exec/batched_delete_stage.h"
 #include "mongo/db/exec/cached_plan.h"
 #include "mongo/db/exec/collection_scan.h"
 #include "mongo/db/exec/count.h"
@@ -1377,9 +1378,24 @@ StatusWith<std::unique_ptr<PlanExecutor, PlanExecutor::Deleter>> getExecutorDele
 
     deleteStageParams->canonicalQuery = cq.get();
 
+    // Multi-deletes may delete their documents in batches. Deletes in transactions or retryable
+    // writes need an oplog entry per statement, so they are not batched.
+    const bool batchDeletes = gBatchUserMultiDeletes.load() && deleteStageParams->isMulti &&
+        !deleteStageParams->isExplain && !deleteStageParams->returnDeleted &&
+        !opCtx->getTxnNumber() && BatchedDeleteStage::canBatchDeletes(collection);
+
     invariant(root);
-    root = std::make_unique<DeleteStage>(
-        cq->getExpCtxRaw(), std::move(deleteStageParams), ws.get(), collection, root.release());
+    if (batchDeletes) {
+        root = std::make_unique<BatchedDeleteStage>(cq->getExpCtxRaw(),
+                                                    std::move(deleteStageParams),
+                                                    std::make_unique<BatchedDeleteStageParams>(),
+                                                    ws.get(),
+                                                    collection,
+                                                    root.release());
+    } else {
+        root = std::make_unique<DeleteStage>(
+            cq->getExpCtxRaw(), std::move(deleteStageParams), ws.get(), collection, root.release());
+    }
 
     if (projection) {
         root = std::make_unique<ProjectionStageDefault>(
@@ -35,6 +35,7 @@
 
 #include "mongo/db/catalog/database.h"
 #include "mongo/db/client.h"
+#include "mongo/db/exec/batched_delete_stage.h"
 #include "mongo/db/exec/collection_scan.h"
 #include "mongo/db/exec/delete.h"
 #include "mongo/db/exec/eof.h"
@@ -100,7 +101,8 @@ std::unique_ptr<PlanExecutor, PlanExecutor::Deleter> InternalPlanner::deleteWith
     PlanYieldPolicy::YieldPolicy yieldPolicy,
     Direction direction,
     boost::optional<RecordId> minRecord,
-    boost::optional<RecordId> maxRecord) {
+    boost::optional<RecordId> maxRecord,
+    std::unique_ptr<BatchedDeleteStageParams> batchedDeleteParams) {
     const auto& collection = *coll;
     invariant(collection);
     auto ws = std::make_unique<WorkingSet>();
@@ -111,8 +113,17 @@ std::unique_ptr<PlanExecutor, PlanExecutor::Deleter> InternalPlanner::deleteWith
     auto root = _collectionScan(
         expCtx, ws.get(), &collection, direction, boost::none, minRecord, maxRecord);
 
-    root = std::make_unique<DeleteStage>(
-        expCtx.get(), std::move(params), ws.get(), collection, root.release());
+    if (batchedDeleteParams) {
+        root = std::make_unique<BatchedDeleteStage>(expCtx.get(),
+                                                    std::move(params),
+                                                    std::move(batchedDeleteParams),
+                                                    ws.get(),
+                                                    collection,
+                                                    root.release());
+    } else {
+        root = std::make_unique<DeleteStage>(
+            expCtx.get(), std::move(params), ws.get(), collection, root.release());
+    }
 
     auto executor = plan_executor_factory::make(expCtx,
                                                 std::move(ws),
@@ -171,7 +182,8 @@ std::unique_ptr<PlanExecutor, PlanExecutor::Deleter> InternalPlanner::deleteWith
     const BSONObj& endKey,
     BoundInclusion boundInclusion,
     PlanYieldPolicy::YieldPolicy yieldPolicy,
-    Direction direction) {
+    Direction direction,
+    std::unique_ptr<BatchedDeleteStageParams> batchedDeleteParams) {
     const auto& collection = *coll;
     invariant(collection);
     auto ws = std::make_unique<WorkingSet>();
@@ -189,8 +201,17 @@ std::unique_ptr<PlanExecutor, PlanExecutor::Deleter> InternalPlanner::deleteWith
                                                  direction,
                                                  InternalPlanner::IXSCAN_FETCH);
 
-    root = std::make_unique<DeleteStage>(
-        expCtx.get(), std::move(params), ws.get(), collection, root.release());
+    if (batchedDeleteParams) {
+        root = std::make_unique<BatchedDeleteStage>(expCtx.get(),
+                                                    std::move(params),
+                                                    std::move(batchedDeleteParams),
+                                                    ws.get(),
+                                                    collection,
+                                                    root.release());
+    } else {
+        root = std::make_unique<DeleteStage>(
+            expCtx.get(), std::move(params), ws.get(), collection, root.release());
+    }
 
     auto executor = plan_executor_factory::make(expCtx,
                                                 std::move(ws),
@@ -30,6 +30,7 @@
 #pragma once
 
 #include "mongo/base/string_data.h"
+#include "mongo/db/exec/batched_delete_stage.h"
 #include "mongo/db/exec/delete.h"
 #include "mongo/db/query/index_bounds.h"
 #include "mongo/db/query/plan_executor.h"
@@ -79,7 +80,8 @@ public:
         boost::optional<RecordId> resumeAfterRecordId = boost::none);
 
     /**
-     * Returns a FETCH => DELETE plan.
+     * Returns a FETCH => DELETE plan, or a FETCH => BATCHED_DELETE plan if 'batchedDeleteParams'
+     * is given.
      */
     static std::unique_ptr<PlanExecutor, PlanExecutor::Deleter> deleteWithCollectionScan(
         OperationContext* opCtx,
@@ -88,7 +90,8 @@ public:
         PlanYieldPolicy::YieldPolicy yieldPolicy,
         Direction direction = FORWARD,
         boost::optional<RecordId> minRecord = boost::none,
-        boost::optional<RecordId> maxRecord = boost::none);
+        boost::optional<RecordId> maxRecord = boost::none,
+        std::unique_ptr<BatchedDeleteStageParams> batchedDeleteParams = nullptr);
 
     /**
      * Returns an index scan.  Caller owns returned pointer.
@@ -105,7 +108,8 @@ public:
         int options = IXSCAN_DEFAULT);
 
     /**
-     * Returns an IXSCAN => FETCH => DELETE plan.
+     * Returns an IXSCAN => FETCH => DELETE plan, or an IXSCAN => FETCH => BATCHED_DELETE plan if
+     * 'batchedDeleteParams' is given.
      */
     static std::unique_ptr<PlanExecutor, PlanExecutor::Deleter> deleteWithIndexScan(
         OperationContext* opCtx,
@@ -116,7 +120,8 @@ public:
         const BSONObj& endKey,
         BoundInclusion boundInclusion,
         PlanYieldPolicy::YieldPolicy yieldPolicy,
-        Direction direction = FORWARD);
+        Direction direction = FORWARD,
+        std::unique_ptr<BatchedDeleteStageParams> batchedDeleteParams = nullptr);
 
     /**
      * Returns an IDHACK => UPDATE plan.
@@ -564,12 +564,14 @@ long long PlanExecutorImpl::executeDelete() {
         case StageType::STAGE_PROJECTION_COVERED:
         case StageType::STAGE_PROJECTION_SIMPLE: {
             invariant(_root->getChildren().size() == 1U);
-            invariant(StageType::STAGE_DELETE == _root->child()->stageType());
+            invariant(StageType::STAGE_DELETE == _root->child()->stageType() ||
+                      StageType::STAGE_BATCHED_DELETE == _root->child()->stageType());
             const SpecificStats* stats = _root->child()->getSpecificStats();
             return static_cast<const DeleteStats*>(stats)->docsDeleted;
         }
         default: {
-            invariant(StageType::STAGE_DELETE == _root->stageType());
+            invariant(StageType::STAGE_DELETE == _root->stageType() ||
+                      StageType::STAGE_BATCHED_DELETE == _root->stageType());
             const auto* deleteStats = static_cast<const DeleteStats*>(_root->getSpecificStats());
             return deleteStats->docsDeleted;
         }
@@ -304,7 +304,7 @@ void statsToBSON(const PlanStageStats& stats,
         indexBoundsBob.append("endKey", spec->endKey);
         indexBoundsBob.append("endKeyInclusive", spec->endKeyInclusive);
         bob->append("indexBounds", indexBoundsBob.obj());
-    } else if (STAGE_DELETE == stats.stageType) {
+    } else if (STAGE_DELETE == stats.stageType || STAGE_BATCHED_DELETE == stats.stageType) {
         DeleteStats* spec = static_cast<DeleteStats*>(stats.specific.get());
 
         if (verbosity >= ExplainOptions::Verbosity::kExecStats) {
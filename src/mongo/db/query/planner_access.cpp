@@ -220,6 +220,8 @@ std::unique_ptr<QuerySolutionNode> QueryPlannerAccess::makeCollectionScan(
         params.options & QueryPlannerParams::TRACK_LATEST_OPLOG_TS;
     csn->shouldWaitForOplogVisibility =
         params.options & QueryPlannerParams::OPLOG_SCAN_WAIT_FOR_VISIBLE;
+    csn->shareOplogScan = tailable && query.nss().isOplog() &&
+        (params.options & QueryPlannerParams::SHARE_OPLOG_SCAN);
 
     // If the hint is {$natural: +-1} this changes the direction of the collection scan.
     const BSONObj& hint = query.getFindCommand().getHint();
@@ -129,6 +129,10 @@ struct QueryPlannerParams {
         // Ensure that any plan generated returns data that is "owned." That is, all BSONObjs are
         // in an "owned" state and are not pointing to data that belongs to the storage engine.
         RETURN_OWNED_DATA = 1 << 14,
+
+        // Set this on a tailable oplog scan for a change stream to let it read new entries through
+        // the scan shared by all change streams, once it has caught up with the end of the oplog.
+        SHARE_OPLOG_SCAN = 1 << 15,
     };
 
     // See Options enum above.
@@ -0,0 +1,372 @@
+/**
+ *    Copyright (C) 2021-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/query/query_result_cache.h"
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/catalog/collection.h"
+#include "mongo/db/catalog/collection_catalog.h"
+#include "mongo/db/commands/server_status.h"
+#include "mongo/db/operation_context.h"
+#include "mongo/db/query/canonical_query.h"
+#include "mongo/db/query/canonical_query_encoder.h"
+#include "mongo/db/query/query_knobs_gen.h"
+#include "mongo/db/repl/read_concern_args.h"
+#include "mongo/db/server_options.h"
+#include "mongo/db/service_context.h"
+#include "mongo/util/string_map.h"
+
+namespace mongo {
+namespace {
+
+const auto getQueryResultCache = ServiceContext::declareDecoration<QueryResultCache>();
+
+// Operators whose results may change from one execution to the next over the same data.
+const StringDataSet kNonDeterministicOperators = {
+    "$accumulator", "$function", "$rand", "$sampleRate", "$where"};
+
+// System variables whose values change from one execution to the next.
+const std::vector<StringData> kNonDeterministicVariables = {"$$NOW", "$$CLUSTER_TIME"};
+
+// Aggregation stages whose output depends only on their input documents and arguments.
+const StringDataSet kCacheableStages = {"$addFields",
+                                        "$bucket",
+                                        "$bucketAuto",
+                                        "$count",
+                                        "$group",
+                                        "$limit",
+                                        "$match",
+                                        "$project",
+                                        "$replaceRoot",
+                                        "$replaceWith",
+                                        "$set",
+                                        "$skip",
+                                        "$sort",
+                                        "$sortByCount",
+                                        "$unset",
+                                        "$unwind"};
+
+void appendKeyBytes(const BSONObj& obj, std::string* key) {
+    key->push_back('\0');
+    key->append(obj.objdata(), obj.objsize());
+}
+
+class QueryResultCacheServerStatus final : public ServerStatusSection {
+public:
+    QueryResultCacheServerStatus() : ServerStatusSection("queryResultCache") {}
+
+    bool includeByDefault() const override {
+        return true;
+    }
+
+    BSONObj generateSection(OperationContext* opCtx,
+                            const BSONElement& configElement) const override {
+        BSONObjBuilder builder;
+        QueryResultCache::get(opCtx).appendStats(&builder);
+        return builder.obj();
+    }
+} queryResultCacheServerStatus;
+
+}  // namespace
+
+QueryResultCache& QueryResultCache::get(ServiceContext* service) {
+    return getQueryResultCache(service);
+}
+
+QueryResultCache& QueryResultCache::get(OperationContext* opCtx) {
+    return get(opCtx->getServiceContext());
+}
+
+bool QueryResultCache::isEligibleOperation(OperationContext* opCtx) {
+    if (internalQueryResultCacheMaxSizeBytes.load() <= 0) {
+        return false;
+    }
+
+    if (opCtx->inMultiDocumentTransaction() ||
+        serverGlobalParams.clusterRole != ClusterRole::None) {
+        return false;
+    }
+
+    const auto& readConcernArgs = repl::ReadConcernArgs::get(opCtx);
+    if (readConcernArgs.getArgsAfterClusterTime() || readConcernArgs.getArgsAtClusterTime() ||
+        readConcernArgs.getArgsOpTime()) {
+        return false;
+    }
+
+    const auto level = readConcernArgs.getLevel();
+    return level == repl::ReadConcernLevel::kLocalReadConcern ||
+        level == repl::ReadConcernLevel::kAvailableReadConcern;
+}
+
+bool QueryResultCache::isEligibleCollection(OperationContext* opCtx,
+                                            const CollectionPtr& collection) {
+    return collection && collection->getCacheQueryResults() && !collection->isCapped() &&
+        opCtx->recoveryUnit()->getTimestampReadSource() ==
+        RecoveryUnit::ReadSource::kNoTimestamp;
+}
+
+bool QueryResultCache::isOptedInCollection(OperationContext* opCtx, const NamespaceString& nss) {
+    auto collection = CollectionCatalog::get(opCtx)->lookupCollectionByNamespaceForRead(opCtx, nss);
+    return collection && collection->getCacheQueryResults();
+}
+
+bool QueryResultCache::hasNonDeterministicOperators(const BSONObj& obj) {
+    for (auto&& elem : obj) {
+        if (kNonDeterministicOperators.count(elem.fieldNameStringData())) {
+            return true;
+        }
+
+        if (elem.type() == BSONType::String) {
+            auto value = elem.valueStringData();
+            for (auto&& variable : kNonDeterministicVariables) {
+                if (value.startsWith(variable)) {
+                    return true;
+                }
+            }
+        } else if (elem.isABSONObj() && hasNonDeterministicOperators(elem.Obj())) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool QueryResultCache::isCacheablePipeline(const std::vector<BSONObj>& pipeline) {
+    for (auto&& stage : pipeline) {
+        if (stage.nFields() != 1 ||
+            !kCacheableStages.count(stage.firstElementFieldNameStringData())) {
+            return false;
+        }
+
+        if (hasNonDeterministicOperators(stage)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+std::string QueryResultCache::makeFindKey(const CanonicalQuery& cq) {
+    const auto& findCommand = cq.getFindCommand();
+
+    // The query shape captures the structure of the filter, projection, sort and collation, but
+    // not their constant values, so the parameters that determine the results are appended as-is.
+    BSONObjBuilder params;
+    params.append("filter", findCommand.getFilter());
+    params.append("projection", findCommand.getProjection());
+    params.append("sort", findCommand.getSort());
+    params.append("hint", findCommand.getHint());
+    params.append("collation", findCommand.getCollation());
+    params.append("min", findCommand.getMin());
+    params.append("max", findCommand.getMax());
+    params.append("skip", findCommand.getSkip().value_or(0));
+    params.append("limit", findCommand.getLimit().value_or(0));
+    params.append("batchSize", findCommand.getBatchSize().value_or(-1));
+    params.append("ntoreturn", findCommand.getNtoreturn().value_or(-1));
+    params.append("singleBatch", static_cast<bool>(findCommand.getSingleBatch()));
+    params.append("returnKey", static_cast<bool>(findCommand.getReturnKey()));
+    params.append("showRecordId", static_cast<bool>(findCommand.getShowRecordId()));
+    params.append("let", findCommand.getLet().value_or(BSONObj()));
+
+    std::string key = canonical_query_encoder::encode(cq);
+    appendKeyBytes(params.done(), &key);
+    return key;
+}
+
+std::string QueryResultCache::makeAggregateKey(const std::vector<BSONObj>& pipeline,
+                                               const BSONObj& collation,
+                                               const BSONObj& hint,
+                                               const BSONObj& let,
+                                               long long batchSize) {
+    BSONObjBuilder params;
+    params.append("pipeline", pipeline);
+    params.append("collation", collation);
+    params.append("hint", hint);
+    params.append("let", let);
+    params.append("batchSize", batchSize);
+
+    std::string key = "aggregate";
+    appendKeyBytes(params.done(), &key);
+    return key;
+}
+
+QueryResultCache::VersionPartition& QueryResultCache::_getVersionPartition(
+    const NamespaceString& nss) {
+    return _versionPartitions[absl::Hash<NamespaceString>{}(nss) % kNumVersionPartitions];
+}
+
+QueryResultCache::WriteVersion QueryResultCache::getWriteVersion(const NamespaceString& nss) {
+    auto& partition = _getVersionPartition(nss);
+    stdx::lock_guard<Latch> lk(partition.mutex);
+    auto it = partition.versions.find(nss);
+    if (it == partition.versions.end()) {
+        it = partition.versions.emplace(nss, _nextVersion.fetchAndAdd(1)).first;
+    }
+    return it->second;
+}
+
+void QueryResultCache::bumpWriteVersion(const NamespaceString& nss) {
+    auto& partition = _getVersionPartition(nss);
+    stdx::lock_guard<Latch> lk(partition.mutex);
+    auto it = partition.versions.find(nss);
+    if (it != partition.versions.end()) {
+        // Forgetting the namespace is enough: the next reader registers a version which no
+        // existing entry can carry. Stale entries are evicted as the cache fills up.
+        partition.versions.erase(it);
+    }
+}
+
+void QueryResultCache::bumpWriteVersionsForDatabase(StringData dbName) {
+    for (auto&& partition : _versionPartitions) {
+        stdx::lock_guard<Latch> lk(partition.mutex);
+        for (auto it = partition.versions.begin(); it != partition.versions.end();) {
+            if (it->first.db() == dbName) {
+                partition.versions.erase(it++);
+            } else {
+                ++it;
+            }
+        }
+    }
+}
+
+void QueryResultCache::clear() {
+    for (auto&& partition : _versionPartitions) {
+        stdx::lock_guard<Latch> lk(partition.mutex);
+        partition.versions.clear();
+    }
+
+    stdx::lock_guard<Latch> lk(_mutex);
+    _entries.clear();
+    _index.clear();
+    _stats.entries = 0;
+    _stats.sizeBytes = 0;
+}
+
+std::string QueryResultCache::_makeEntryKey(const NamespaceString& nss, StringData key) {
+    std::string entryKey = nss.ns();
+    entryKey.push_back('\0');
+    entryKey.append(key.rawData(), key.size());
+    return entryKey;
+}
+
+boost::optional<std::vector<BSONObj>> QueryResultCache::lookup(const NamespaceString& nss,
+                                                               StringData key,
+                                                               WriteVersion version) {
+    const auto entryKey = _makeEntryKey(nss, key);
+
+    stdx::lock_guard<Latch> lk(_mutex);
+    auto indexIt = _index.find(entryKey);
+    if (indexIt == _index.end()) {
+        ++_stats.misses;
+        return boost::none;
+    }
+
+    auto entryIt = indexIt->second;
+    if (entryIt->version != version) {
+        // A write has committed since this entry was computed, so it can never be served again.
+        _stats.sizeBytes -= entryIt->sizeBytes;
+        --_stats.entries;
+        _entries.erase(entryIt);
+        _index.erase(indexIt);
+        ++_stats.misses;
+        return boost::none;
+    }
+
+    _entries.splice(_entries.begin(), _entries, entryIt);
+    ++_stats.hits;
+    return entryIt->docs;
+}
+
+void QueryResultCache::insert(const NamespaceString& nss,
+                              StringData key,
+                              WriteVersion version,
+                              std::vector<BSONObj> docs) {
+    auto entryKey = _makeEntryKey(nss, key);
+
+    long long sizeBytes = entryKey.size();
+    for (auto&& doc : docs) {
+        sizeBytes += doc.objsize();
+    }
+
+    const long long budgetBytes = internalQueryResultCacheMaxSizeBytes.load();
+    if (sizeBytes > internalQueryResultCacheMaxEntrySizeBytes.load() || sizeBytes > budgetBytes) {
+        return;
+    }
+
+    // Don't bother caching results which no reader could be served.
+    if (getWriteVersion(nss) != version) {
+        return;
+    }
+
+    stdx::lock_guard<Latch> lk(_mutex);
+    auto indexIt = _index.find(entryKey);
+    if (indexIt != _index.end()) {
+        _stats.sizeBytes -= indexIt->second->sizeBytes;
+        --_stats.entries;
+        _entries.erase(indexIt->second);
+        _index.erase(indexIt);
+    }
+
+    _entries.push_front({entryKey, version, std::move(docs), sizeBytes});
+    _index.emplace(std::move(entryKey), _entries.begin());
+    _stats.sizeBytes += sizeBytes;
+    ++_stats.entries;
+    ++_stats.inserts;
+
+    _evictUntilWithinBudget(lk, budgetBytes);
+}
+
+void QueryResultCache::_evictUntilWithinBudget(WithLock, long long budgetBytes) {
+    while (_stats.sizeBytes > budgetBytes && !_entries.empty()) {
+        auto& victim = _entries.back();
+        _stats.sizeBytes -= victim.sizeBytes;
+        --_stats.entries;
+        ++_stats.evictions;
+        _index.erase(victim.key);
+        _entries.pop_back();
+    }
+}
+
+QueryResultCache::Stats QueryResultCache::getStats() const {
+    stdx::lock_guard<Latch> lk(_mutex);
+    return _stats;
+}
+
+void QueryResultCache::appendStats(BSONObjBuilder* builder) const {
+    const auto stats = getStats();
+    builder->append("hits", stats.hits);
+    builder->append("misses", stats.misses);
+    builder->append("inserts", stats.inserts);
+    builder->append("evictions", stats.evictions);
+    builder->append("entries", stats.entries);
+    builder->append("sizeBytes", stats.sizeBytes);
+}
+
+}  // namespace mongo
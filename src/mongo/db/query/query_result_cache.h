@@ -0,0 +1,216 @@
+/**
+ *    Copyright (C) 2021-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#pragma once
+
+#include <array>
+#include <list>
+#include <string>
+#include <boost/optional.hpp>
+#include <vector>
+
+#include "mongo/bson/bsonobj.h"
+#include "mongo/db/namespace_string.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/platform/mutex.h"
+#include "mongo/stdx/unordered_map.h"
+#include "mongo/util/concurrency/with_lock.h"
+
+namespace mongo {
+
+class BSONObjBuilder;
+class CanonicalQuery;
+class CollectionPtr;
+class OperationContext;
+class ServiceContext;
+
+/**
+ * Caches the complete results of repeated read-only find and aggregate commands against collections
+ * which have opted in through the 'cacheQueryResults' collection option.
+ *
+ * Each cached entry is tagged with the write version of its collection at the time the query was
+ * run. The write version of a namespace is bumped by the OpObserver whenever a write to that
+ * namespace commits, so an entry can only be served while no write has committed since it was
+ * computed. Callers must capture the write version *before* acquiring the snapshot the query reads
+ * from; a write which races with the query then makes the entry unreachable rather than stale.
+ *
+ * Entries are evicted in least-recently-used order once the cache exceeds its byte budget.
+ */
+class QueryResultCache {
+    QueryResultCache(const QueryResultCache&) = delete;
+    QueryResultCache& operator=(const QueryResultCache&) = delete;
+
+public:
+    using WriteVersion = unsigned long long;
+
+    struct Stats {
+        long long hits = 0;
+        long long misses = 0;
+        long long inserts = 0;
+        long long evictions = 0;
+        long long entries = 0;
+        long long sizeBytes = 0;
+    };
+
+    QueryResultCache() = default;
+
+    static QueryResultCache& get(ServiceContext* service);
+    static QueryResultCache& get(OperationContext* opCtx);
+
+    /**
+     * Returns true if the operation is allowed to read from or populate the cache at all: it must
+     * not be part of a multi-document transaction, must read the latest local data without any
+     * causal or point-in-time constraints, and the node must not be part of a sharded cluster.
+     */
+    static bool isEligibleOperation(OperationContext* opCtx);
+
+    /**
+     * Returns true if results read from 'collection' by the operation may be cached: the
+     * collection must have opted in, must not be capped and the operation must be reading the
+     * latest untimestamped data, so that every committed write is visible to it.
+     */
+    static bool isEligibleCollection(OperationContext* opCtx, const CollectionPtr& collection);
+
+    /**
+     * Returns true if the collection 'nss' has currently opted in to caching, looking it up without
+     * locks. Readers only capture the write version of such collections, so that the cache does not
+     * track the versions of namespaces whose results it never holds. The opt-in is checked again
+     * with isEligibleCollection() under the snapshot of the query.
+     */
+    static bool isOptedInCollection(OperationContext* opCtx, const NamespaceString& nss);
+
+    /**
+     * Returns true if 'obj' references an operator or system variable whose result may differ
+     * between two executions over the same data, such as $rand or $$NOW.
+     */
+    static bool hasNonDeterministicOperators(const BSONObj& obj);
+
+    /**
+     * Returns true if every stage of 'pipeline' is known to produce a result which depends only on
+     * the contents of the collection it reads from.
+     */
+    static bool isCacheablePipeline(const std::vector<BSONObj>& pipeline);
+
+    /**
+     * Builds the cache key for a find command from the shape of 'cq' and the parameters of its
+     * find command.
+     */
+    static std::string makeFindKey(const CanonicalQuery& cq);
+
+    /**
+     * Builds the cache key for an aggregation from its pipeline and the request options which can
+     * affect its results.
+     */
+    static std::string makeAggregateKey(const std::vector<BSONObj>& pipeline,
+                                        const BSONObj& collation,
+                                        const BSONObj& hint,
+                                        const BSONObj& let,
+                                        long long batchSize);
+
+    /**
+     * Returns the current write version of 'nss', starting to track writes to it if needed.
+     */
+    WriteVersion getWriteVersion(const NamespaceString& nss);
+
+    /**
+     * Invalidates all entries for 'nss'. Must be called after a write to 'nss' commits.
+     */
+    void bumpWriteVersion(const NamespaceString& nss);
+
+    /**
+     * Invalidates all entries for every collection in database 'dbName'.
+     */
+    void bumpWriteVersionsForDatabase(StringData dbName);
+
+    /**
+     * Drops every entry and write version, for example after replication rollback.
+     */
+    void clear();
+
+    /**
+     * Returns the cached results for 'key' on 'nss' if they were computed at 'version'.
+     */
+    boost::optional<std::vector<BSONObj>> lookup(const NamespaceString& nss,
+                                                 StringData key,
+                                                 WriteVersion version);
+
+    /**
+     * Caches 'docs' as the results of 'key' on 'nss', computed at 'version'. Results which are too
+     * large, or whose version has already been superseded, are not cached.
+     */
+    void insert(const NamespaceString& nss,
+                StringData key,
+                WriteVersion version,
+                std::vector<BSONObj> docs);
+
+    Stats getStats() const;
+
+    void appendStats(BSONObjBuilder* builder) const;
+
+private:
+    static constexpr size_t kNumVersionPartitions = 16;
+
+    struct VersionPartition {
+        mutable Mutex mutex = MONGO_MAKE_LATCH("QueryResultCache::VersionPartition::mutex");
+        stdx::unordered_map<NamespaceString, WriteVersion> versions;
+    };
+
+    struct Entry {
+        std::string key;
+        WriteVersion version;
+        std::vector<BSONObj> docs;
+        long long sizeBytes;
+    };
+
+    using EntryList = std::list<Entry>;
+
+    VersionPartition& _getVersionPartition(const NamespaceString& nss);
+
+    static std::string _makeEntryKey(const NamespaceString& nss, StringData key);
+
+    // Must be called with '_mutex' held.
+    void _evictUntilWithinBudget(WithLock, long long budgetBytes);
+
+    // Source of all write versions. Versions are never reused, so an entry computed against a
+    // dropped collection cannot match a collection later created with the same name.
+    AtomicWord<WriteVersion> _nextVersion{1};
+
+    std::array<VersionPartition, kNumVersionPartitions> _versionPartitions;
+
+    mutable Mutex _mutex = MONGO_MAKE_LATCH("QueryResultCache::_mutex");
+
+    // Entries ordered from most to least recently used, indexed by their key.
+    EntryList _entries;
+    stdx::unordered_map<std::string, EntryList::iterator> _index;
+
+    Stats _stats;
+};
+
+}  // namespace mongo
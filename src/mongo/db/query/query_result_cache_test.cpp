@@ -0,0 +1,172 @@
+/**
+ *    Copyright (C) 2021-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/query/query_result_cache.h"
+
+#include "mongo/bson/json.h"
+#include "mongo/db/query/query_knobs_gen.h"
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/scopeguard.h"
+
+namespace mongo {
+namespace {
+
+const NamespaceString kNss("test.coll");
+const NamespaceString kOtherNss("test.other");
+
+std::vector<BSONObj> makeDocs(int count, int paddingBytes = 0) {
+    std::vector<BSONObj> docs;
+    for (int i = 0; i < count; ++i) {
+        docs.push_back(BSON("_id" << i << "padding" << std::string(paddingBytes, 'x')));
+    }
+    return docs;
+}
+
+TEST(QueryResultCacheTest, EntriesAreOnlyServedAtTheVersionTheyWereComputedAt) {
+    QueryResultCache cache;
+
+    auto version = cache.getWriteVersion(kNss);
+    ASSERT_FALSE(cache.lookup(kNss, "key", version));
+
+    cache.insert(kNss, "key", version, makeDocs(3));
+    auto cached = cache.lookup(kNss, "key", cache.getWriteVersion(kNss));
+    ASSERT(cached);
+    ASSERT_EQ(cached->size(), 3U);
+    ASSERT_BSONOBJ_EQ(cached->front(), BSON("_id" << 0 << "padding" << ""));
+
+    // A write to another namespace does not invalidate the entry.
+    cache.bumpWriteVersion(kOtherNss);
+    ASSERT(cache.lookup(kNss, "key", cache.getWriteVersion(kNss)));
+
+    // A committed write to the namespace makes the entry unreachable.
+    cache.bumpWriteVersion(kNss);
+    auto newVersion = cache.getWriteVersion(kNss);
+    ASSERT_NE(version, newVersion);
+    ASSERT_FALSE(cache.lookup(kNss, "key", newVersion));
+
+    // Results computed at a version which has since been superseded are not cached.
+    cache.bumpWriteVersion(kNss);
+    cache.insert(kNss, "key", newVersion, makeDocs(1));
+    ASSERT_FALSE(cache.lookup(kNss, "key", cache.getWriteVersion(kNss)));
+
+    auto stats = cache.getStats();
+    ASSERT_EQ(stats.hits, 2);
+    ASSERT_EQ(stats.misses, 3);
+    ASSERT_EQ(stats.inserts, 1);
+    ASSERT_EQ(stats.entries, 0);
+    ASSERT_EQ(stats.sizeBytes, 0);
+}
+
+TEST(QueryResultCacheTest, DroppingADatabaseInvalidatesAllOfItsCollections) {
+    QueryResultCache cache;
+    const NamespaceString otherDbNss("other.coll");
+
+    cache.insert(kNss, "key", cache.getWriteVersion(kNss), makeDocs(1));
+    cache.insert(kOtherNss, "key", cache.getWriteVersion(kOtherNss), makeDocs(1));
+    cache.insert(otherDbNss, "key", cache.getWriteVersion(otherDbNss), makeDocs(1));
+
+    cache.bumpWriteVersionsForDatabase("test");
+    ASSERT_FALSE(cache.lookup(kNss, "key", cache.getWriteVersion(kNss)));
+    ASSERT_FALSE(cache.lookup(kOtherNss, "key", cache.getWriteVersion(kOtherNss)));
+    ASSERT(cache.lookup(otherDbNss, "key", cache.getWriteVersion(otherDbNss)));
+
+    cache.clear();
+    ASSERT_FALSE(cache.lookup(otherDbNss, "key", cache.getWriteVersion(otherDbNss)));
+    ASSERT_EQ(cache.getStats().entries, 0);
+}
+
+TEST(QueryResultCacheTest, EvictsLeastRecentlyUsedEntriesToStayWithinByteBudget) {
+    const auto originalMaxSize = internalQueryResultCacheMaxSizeBytes.load();
+    const auto originalMaxEntrySize = internalQueryResultCacheMaxEntrySizeBytes.load();
+    ON_BLOCK_EXIT([&] {
+        internalQueryResultCacheMaxSizeBytes.store(originalMaxSize);
+        internalQueryResultCacheMaxEntrySizeBytes.store(originalMaxEntrySize);
+    });
+
+    // Each entry holds roughly 1KB, so the budget fits two of them but not three.
+    internalQueryResultCacheMaxSizeBytes.store(2500);
+    internalQueryResultCacheMaxEntrySizeBytes.store(1500);
+
+    QueryResultCache cache;
+    auto version = cache.getWriteVersion(kNss);
+    cache.insert(kNss, "a", version, makeDocs(1, 1000));
+    cache.insert(kNss, "b", version, makeDocs(1, 1000));
+
+    // Touch "a" so that "b" becomes the least recently used entry.
+    ASSERT(cache.lookup(kNss, "a", version));
+    cache.insert(kNss, "c", version, makeDocs(1, 1000));
+
+    ASSERT(cache.lookup(kNss, "a", version));
+    ASSERT_FALSE(cache.lookup(kNss, "b", version));
+    ASSERT(cache.lookup(kNss, "c", version));
+
+    // Results larger than the per-entry limit are never cached.
+    cache.insert(kNss, "d", version, makeDocs(2, 1000));
+    ASSERT_FALSE(cache.lookup(kNss, "d", version));
+
+    auto stats = cache.getStats();
+    ASSERT_EQ(stats.entries, 2);
+    ASSERT_EQ(stats.evictions, 1);
+    ASSERT_LTE(stats.sizeBytes, 2500);
+}
+
+TEST(QueryResultCacheTest, RejectsNonDeterministicQueries) {
+    ASSERT_FALSE(QueryResultCache::hasNonDeterministicOperators(fromjson("{a: {$gt: 1}}")));
+    ASSERT_TRUE(QueryResultCache::hasNonDeterministicOperators(
+        fromjson("{$expr: {$lt: [{$rand: {}}, 0.5]}}")));
+    ASSERT_TRUE(QueryResultCache::hasNonDeterministicOperators(
+        fromjson("{$expr: {$lt: ['$date', '$$NOW']}}")));
+    ASSERT_TRUE(QueryResultCache::hasNonDeterministicOperators(fromjson("{$where: 'true'}")));
+
+    ASSERT_TRUE(QueryResultCache::isCacheablePipeline(
+        {fromjson("{$match: {a: 1}}"), fromjson("{$group: {_id: '$b', n: {$sum: 1}}}")}));
+    ASSERT_FALSE(QueryResultCache::isCacheablePipeline({fromjson("{$sample: {size: 1}}")}));
+    ASSERT_FALSE(QueryResultCache::isCacheablePipeline(
+        {fromjson("{$lookup: {from: 'b', localField: 'x', foreignField: 'y', as: 'z'}}")}));
+    ASSERT_FALSE(QueryResultCache::isCacheablePipeline(
+        {fromjson("{$addFields: {now: '$$CLUSTER_TIME'}}")}));
+}
+
+TEST(QueryResultCacheTest, AggregateKeyDependsOnHint) {
+    const std::vector<BSONObj> pipeline = {fromjson("{$match: {a: 1}}")};
+    const auto makeKey = [&](const BSONObj& hint) {
+        return QueryResultCache::makeAggregateKey(pipeline, BSONObj(), hint, BSONObj(), 101);
+    };
+
+    // A hint can change the order in which documents are returned, or whether the query fails.
+    ASSERT_EQ(makeKey(BSONObj()), makeKey(BSONObj()));
+    ASSERT_NE(makeKey(BSONObj()), makeKey(BSON("a" << 1)));
+    ASSERT_NE(makeKey(BSON("a" << 1)), makeKey(BSON("$natural" << -1)));
+}
+
+}  // namespace
+}  // namespace mongo
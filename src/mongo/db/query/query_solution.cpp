@@ -233,6 +233,7 @@ QuerySolutionNode* CollectionScanNode::clone() const {
     copy->shouldTrackLatestOplogTimestamp = this->shouldTrackLatestOplogTimestamp;
     copy->assertTsHasNotFallenOffOplog = this->assertTsHasNotFallenOffOplog;
     copy->shouldWaitForOplogVisibility = this->shouldWaitForOplogVisibility;
+    copy->shareOplogScan = this->shareOplogScan;
 
     return copy;
 }
@@ -504,6 +504,9 @@ struct CollectionScanNode : public QuerySolutionNodeWithSortSet {
 
     // Once the first matching document is found, assume that all documents after it must match.
     bool stopApplyingFilterAfterFirstMatch = false;
+
+    // Whether a tailable oplog scan may join the oplog scan shared by change streams.
+    bool shareOplogScan = false;
 };
 
 /**
@@ -49,6 +49,10 @@ static constexpr PlanNodeId kEmptyPlanNodeId = 0u;
 enum StageType {
     STAGE_AND_HASH,
     STAGE_AND_SORTED,
+
+    // Deletes the documents returned by its child in batches, each in a single storage transaction.
+    STAGE_BATCHED_DELETE,
+
     STAGE_CACHED_PLAN,
     STAGE_COLLSCAN,
 
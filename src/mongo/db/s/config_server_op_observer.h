@@ -174,6 +174,10 @@ public:
                        const NamespaceString& collectionName,
                        OptionalCollectionUUID uuid) override {}
 
+    void onBatchedWriteStart(OperationContext* opCtx) override {}
+    void onBatchedWriteCommit(OperationContext* opCtx) override {}
+    void onBatchedWriteAbort(OperationContext* opCtx) override {}
+
     void onUnpreparedTransactionCommit(OperationContext* opCtx,
                                        std::vector<repl::ReplOperation>* statements,
                                        size_t numberOfPreImagesToWrite) override {}
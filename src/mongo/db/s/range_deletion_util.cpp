@@ -43,6 +43,7 @@
 #include "mongo/db/client.h"
 #include "mongo/db/concurrency/write_conflict_exception.h"
 #include "mongo/db/dbhelpers.h"
+#include "mongo/db/exec/batched_delete_stage.h"
 #include "mongo/db/exec/delete.h"
 #include "mongo/db/exec/working_set_common.h"
 #include "mongo/db/index/index_descriptor.h"
@@ -175,13 +176,23 @@ StatusWith<int> deleteNextBatch(OperationContext* opCtx,
     auto deleteStageParams = std::make_unique<DeleteStageParams>();
     deleteStageParams->fromMigrate = true;
     deleteStageParams->isMulti = true;
-    deleteStageParams->returnDeleted = true;
 
     if (serverGlobalParams.moveParanoia) {
         deleteStageParams->removeSaver =
             std::make_unique<RemoveSaver>("moveChunk", nss.ns(), "cleaning");
     }
 
+    // Delete the range in batches of documents, each committed and logged to the oplog at once,
+    // unless the collection requires its deletes to be logged individually.
+    std::unique_ptr<BatchedDeleteStageParams> batchedDeleteParams;
+    if (BatchedDeleteStage::canBatchDeletes(collection)) {
+        batchedDeleteParams = std::make_unique<BatchedDeleteStageParams>();
+        batchedDeleteParams->targetPassDocs = numDocsToRemovePerBatch;
+    } else {
+        deleteStageParams->returnDeleted = true;
+    }
+    const bool batched = bool(batchedDeleteParams);
+
     auto exec = InternalPlanner::deleteWithIndexScan(opCtx,
                                                      &collection,
                                                      std::move(deleteStageParams),
@@ -190,7 +201,8 @@ StatusWith<int> deleteNextBatch(OperationContext* opCtx,
                                                      max,
                                                      BoundInclusion::kIncludeStartKeyOnly,
                                                      PlanYieldPolicy::YieldPolicy::YIELD_MANUAL,
-                                                     InternalPlanner::FORWARD);
+                                                     InternalPlanner::FORWARD,
+                                                     std::move(batchedDeleteParams));
 
     if (MONGO_unlikely(hangBeforeDoingDeletion.shouldFail())) {
         LOGV2(23768, "Hit hangBeforeDoingDeletion failpoint");
@@ -211,6 +223,12 @@ StatusWith<int> deleteNextBatch(OperationContext* opCtx,
 
         PlanExecutor::ExecState state;
         try {
+            if (batched) {
+                // The batched delete stage stops after deleting numDocsToRemovePerBatch documents.
+                numDeleted = exec->executeDelete();
+                ShardingStatistics::get(opCtx).countDocsDeletedOnDonor.addAndFetch(numDeleted);
+                break;
+            }
             state = exec->getNext(&deletedObj, nullptr);
         } catch (const DBException& ex) {
             auto&& explainer = exec->getPlanExplainer();
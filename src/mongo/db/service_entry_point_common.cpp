@@ -41,6 +41,7 @@
 #include "mongo/client/server_discovery_monitor.h"
 #include "mongo/db/audit.h"
 #include "mongo/db/auth/authorization_checks.h"
+#include "mongo/db/auth/authorization_manager.h"
 #include "mongo/db/auth/authorization_session.h"
 #include "mongo/db/auth/impersonation_session.h"
 #include "mongo/db/client.h"
@@ -942,7 +943,15 @@ void CheckoutSessionAndInvokeCommand::_checkOutSession() {
             }
         });
 
-        _txnParticipant->unstashTransactionResources(opCtx, invocation->definition()->getName());
+        const auto cmdName = invocation->definition()->getName();
+        _txnParticipant->unstashTransactionResources(opCtx, cmdName);
+
+        // Apply the inserts that earlier statements of the transaction buffered before any other
+        // command observes, prepares or commits the transaction. A failure to apply them aborts
+        // the transaction.
+        if (cmdName != "insert"_sd && cmdName != "abortTransaction"_sd) {
+            write_ops_exec::flushBufferedTransactionWrites(opCtx);
+        }
 
         // Unstash success.
         abortOnError.dismiss();
@@ -1399,6 +1408,20 @@ void ExecCommandDatabase::_initiateCommand() {
     _impersonationSessionGuard.emplace(opCtx);
     _invocation->checkAuthorization(opCtx, request);
 
+    // Work that another member of the cluster runs on its own behalf is admitted to the storage
+    // engine ahead of user operations. A member running a command for a user impersonates that
+    // user, and the command is classified like the user's own. Without authentication members can
+    // not be told apart from users, so nothing is promoted.
+    {
+        auto authSession = AuthorizationSession::get(opCtx->getClient());
+        if (AuthorizationManager::get(opCtx->getServiceContext())->isAuthEnabled() &&
+            !authSession->isImpersonating() &&
+            authSession->isAuthorizedForActionsOnResource(ResourcePattern::forClusterResource(),
+                                                          ActionType::internal)) {
+            opCtx->lockState()->setAdmissionPriority(AdmissionPriority::kInternal);
+        }
+    }
+
     const bool iAmPrimary = replCoord->canAcceptWritesForDatabase_UNSAFE(opCtx, dbname);
 
     if (!opCtx->getClient()->isInDirectClient() &&
@@ -2309,6 +2332,10 @@ Future<void> HandleRequest::completeOperation() try {
             durationCount<Microseconds>(currentOp.elapsedTimeExcludingPauses()),
             currentOp.getReadWriteType());
 
+    if (auto command = currentOp.getCommand(); command && opCtx->shouldIncrementLatencyStats()) {
+        command->recordLatency(currentOp.elapsedTimeExcludingPauses());
+    }
+
     if (shouldProfile) {
         // Performance profiling is on
         if (opCtx->lockState()->isReadLocked()) {
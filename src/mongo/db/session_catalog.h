@@ -29,6 +29,7 @@
 
 #pragma once
 
+#include <array>
 #include <boost/optional.hpp>
 #include <vector>
 
@@ -37,6 +38,7 @@
 #include "mongo/db/operation_context.h"
 #include "mongo/db/session.h"
 #include "mongo/db/session_killer.h"
+#include "mongo/platform/atomic_word.h"
 #include "mongo/platform/mutex.h"
 #include "mongo/stdx/condition_variable.h"
 #include "mongo/stdx/unordered_map.h"
@@ -92,13 +94,12 @@ public:
     SessionToKill checkOutSessionForKill(OperationContext* opCtx, KillToken killToken);
 
     /**
-     * Iterates through the SessionCatalog under the SessionCatalog mutex and applies 'workerFn' to
-     * each Session which matches the specified 'matcher'.
+     * Iterates through the SessionCatalog and applies 'workerFn' to each Session which matches the
+     * specified 'matcher'. The catalog is partitioned and each partition is visited under its own
+     * mutex, so the sessions are not observed as of a single point in time.
      *
-     * NOTE: Since this method runs with the session catalog mutex, the work done by 'workerFn' is
-     * not allowed to block, perform I/O or acquire any lock manager locks.
-     * Iterates through the SessionCatalog and applies 'workerFn' to each Session. This locks the
-     * SessionCatalog.
+     * NOTE: Since this method runs with a session catalog partition mutex, the work done by
+     * 'workerFn' is not allowed to block, perform I/O or acquire any lock manager locks.
      */
     using ScanSessionsCallbackFn = std::function<void(ObservableSession&)>;
     void scanSession(const LogicalSessionId& lsid, const ScanSessionsCallbackFn& workerFn);
@@ -106,7 +107,7 @@ public:
                       const ScanSessionsCallbackFn& workerFn);
 
     /**
-     * Shortcut to invoke 'kill' on the specified session under the SessionCatalog mutex. Throws a
+     * Shortcut to invoke 'kill' on the specified session under its partition's mutex. Throws a
      * NoSuchSession exception if the session doesn't exist.
      */
     KillToken killSession(const LogicalSessionId& lsid);
@@ -131,22 +132,42 @@ private:
         // sessions entries from the map.
         int numWaitingToCheckOut{0};
 
-        // Signaled when the state becomes available. Uses the transaction table's mutex to protect
-        // the state transitions.
+        // Signaled when the state becomes available. Uses the mutex of the partition which owns
+        // the session to protect the state transitions.
         stdx::condition_variable availableCondVar;
     };
     using SessionRuntimeInfoMap = LogicalSessionIdMap<std::unique_ptr<SessionRuntimeInfo>>;
 
+    // Number of independently locked partitions the sessions are spread across, so that operations
+    // checking out different sessions do not contend on a single mutex.
+    static constexpr size_t kNumPartitions = 16;
+
+    struct Partition {
+        // Protects the sessions map of this partition and the runtime state of its sessions
+        mutable Mutex mutex =
+            MONGO_MAKE_LATCH(HierarchicalAcquisitionLevel(0), "SessionCatalog::Partition::mutex");
+
+        // Owns the Session objects for the sessions which hash to this partition
+        SessionRuntimeInfoMap sessions;
+    };
+
+    /**
+     * Returns the partition which owns the session with the specified 'lsid'.
+     */
+    Partition& _getPartition(const LogicalSessionId& lsid);
+
     /**
      * Blocking method, which checks-out the session set on 'opCtx'.
      */
     ScopedCheckedOutSession _checkOutSession(OperationContext* opCtx);
 
     /**
-     * Creates or returns the session runtime info for 'lsid' from the '_sessions' map. The returned
-     * pointer is guaranteed to be linked on the map for as long as the mutex is held.
+     * Creates or returns the session runtime info for 'lsid' from the sessions map of 'partition'.
+     * The returned pointer is guaranteed to be linked on the map for as long as the partition's
+     * mutex is held.
      */
     SessionRuntimeInfo* _getOrCreateSessionRuntimeInfo(WithLock,
+                                                       Partition& partition,
                                                        OperationContext* opCtx,
                                                        const LogicalSessionId& lsid);
 
@@ -165,17 +186,14 @@ private:
      */
     void _allowCheckouts();
 
-    // Protects the state below
-    mutable Mutex _mutex =
-        MONGO_MAKE_LATCH(HierarchicalAcquisitionLevel(0), "SessionCatalog::_mutex");
-
-    // Owns the Session objects for all current Sessions.
-    SessionRuntimeInfoMap _sessions;
+    // Owns the Session objects for all current Sessions, spread across partitions by session id.
+    std::array<Partition, kNumPartitions> _partitions;
 
     // If false no new sessions can be checked out. Reasons why this could be true is because step
     // down is in progress and we should not allow new sessions to get checked out in order to
-    // prevent deadlocks.
-    bool _checkoutAllowed{true};
+    // prevent deadlocks. Only read while holding a partition mutex, so that any scan started after
+    // checkouts are disallowed observes every checkout which raced with the change.
+    AtomicWord<bool> _checkoutAllowed{true};
 };
 
 /**
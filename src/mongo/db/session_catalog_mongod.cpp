@@ -37,6 +37,7 @@
 #include "mongo/db/catalog_raii.h"
 #include "mongo/db/client.h"
 #include "mongo/db/dbdirectclient.h"
+#include "mongo/db/logical_session_cache_gen.h"
 #include "mongo/db/namespace_string.h"
 #include "mongo/db/operation_context.h"
 #include "mongo/db/ops/write_ops.h"
@@ -46,6 +47,7 @@
 #include "mongo/db/sessions_collection.h"
 #include "mongo/db/transaction_participant.h"
 #include "mongo/logv2/log.h"
+#include "mongo/platform/atomic_word.h"
 #include "mongo/rpc/get_status_from_command_result.h"
 #include "mongo/s/write_ops/batched_command_response.h"
 #include "mongo/util/concurrency/thread_pool.h"
@@ -354,16 +356,24 @@ int MongoDSessionCatalog::reapSessionsOlderThan(OperationContext* opCtx,
                               });
 
         // From the passed-in sessions, find the ones which are actually expired/removed
-        auto expiredSessionIds = sessionsCollection.findRemovedSessions(opCtx, lsids);
+        const auto lsidPartitions = SessionsCollection::makePartitions(lsids);
+        std::vector<LogicalSessionIdSet> expiredSessionIds(lsidPartitions.size());
+        SessionsCollection::runPartitioned(
+            opCtx, lsidPartitions.size(), [&](OperationContext* partitionOpCtx, size_t partition) {
+                expiredSessionIds[partition] = sessionsCollection.findRemovedSessions(
+                    partitionOpCtx, lsidPartitions[partition]);
+            });
 
         // Remove the session ids from the in-memory catalog
-        for (const auto& lsid : expiredSessionIds) {
-            catalog->scanSession(lsid, [](ObservableSession& session) {
-                const auto participant = TransactionParticipant::get(session);
-                if (!participant.transactionIsOpen()) {
-                    session.markForReap();
-                }
-            });
+        for (const auto& partitionExpiredSessionIds : expiredSessionIds) {
+            for (const auto& lsid : partitionExpiredSessionIds) {
+                catalog->scanSession(lsid, [](ObservableSession& session) {
+                    const auto participant = TransactionParticipant::get(session);
+                    if (!participant.transactionIsOpen()) {
+                        session.markForReap();
+                    }
+                });
+            }
         }
     }
 
@@ -384,26 +394,40 @@ int MongoDSessionCatalog::reapSessionsOlderThan(OperationContext* opCtx,
                      0,
                      &kIdProjection);
 
-    // The max batch size is chosen so that a single batch won't exceed the 16MB BSON object size
-    // limit
-    const int kMaxBatchSize = 10'000;
+    // The max batch size is bounded so that a single batch won't exceed the 16MB BSON object size
+    // limit. Up to 'logicalSessionRefreshConcurrency' batches are accumulated from the cursor and
+    // then removed in parallel.
+    const size_t maxBatchSize = SessionsCollection::getPartitionSize();
+    const size_t maxBatches = gLogicalSessionRefreshConcurrency.load();
+
+    std::vector<LogicalSessionIdSet> batches;
+    AtomicWord<int> numReaped{0};
+
+    auto removeBatches = [&] {
+        SessionsCollection::runPartitioned(
+            opCtx, batches.size(), [&](OperationContext* partitionOpCtx, size_t partition) {
+                numReaped.fetchAndAdd(removeSessionsTransactionRecords(
+                    partitionOpCtx, sessionsCollection, batches[partition]));
+            });
+        batches.clear();
+    };
 
-    LogicalSessionIdSet lsids;
-    int numReaped = 0;
     while (cursor->more()) {
         auto transactionSession = SessionsCollectionFetchResultIndividualResult::parse(
             "TransactionSession"_sd, cursor->next());
 
-        lsids.insert(transactionSession.get_id());
-        if (lsids.size() > kMaxBatchSize) {
-            numReaped += removeSessionsTransactionRecords(opCtx, sessionsCollection, lsids);
-            lsids.clear();
+        if (batches.empty() || batches.back().size() >= maxBatchSize) {
+            if (batches.size() >= maxBatches) {
+                removeBatches();
+            }
+            batches.emplace_back();
         }
+        batches.back().insert(transactionSession.get_id());
     }
 
-    numReaped += removeSessionsTransactionRecords(opCtx, sessionsCollection, lsids);
+    removeBatches();
 
-    return numReaped;
+    return numReaped.load();
 }
 
 MongoDOperationContextSession::MongoDOperationContextSession(OperationContext* opCtx)
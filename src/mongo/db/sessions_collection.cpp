@@ -37,12 +37,22 @@
 
 #include "mongo/bson/bsonobjbuilder.h"
 #include "mongo/client/dbclient_base.h"
+#include "mongo/db/client.h"
 #include "mongo/db/create_indexes_gen.h"
+#include "mongo/db/logical_session_cache_gen.h"
 #include "mongo/db/logical_session_id.h"
+#include "mongo/db/operation_context.h"
 #include "mongo/db/ops/write_ops.h"
 #include "mongo/db/repl/read_concern_args.h"
+#include "mongo/db/service_context.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/platform/mutex.h"
 #include "mongo/rpc/get_status_from_command_result.h"
 #include "mongo/s/write_ops/batched_command_response.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/unordered_set.h"
+#include "mongo/util/concurrency/thread_pool.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 namespace {
@@ -61,6 +71,66 @@ const WriteConcernOptions kMajorityWriteConcern{WriteConcernOptions::kMajority,
                                                 WriteConcernOptions::SyncMode::UNSET,
                                                 WriteConcernOptions::kWriteConcernTimeoutSystem};
 
+// The upper bound of 'logicalSessionRefreshConcurrency'.
+constexpr size_t kMaxPartitionConcurrency = 64;
+
+/**
+ * The threads running the partitions of refresh and reap passes, shared by all the passes of a
+ * service. The pool is started on first use and its threads exit when they have been idle for a
+ * while, so it costs nothing between passes. It is shut down along with the service, since its
+ * threads hold Clients of the service.
+ */
+class PartitionPool {
+public:
+    ThreadPool& get(ServiceContext* service) {
+        stdx::lock_guard<Latch> lk(_mutex);
+        uassert(ErrorCodes::ShutdownInProgress,
+                "The logical sessions partition pool is shut down",
+                !_inShutdown);
+        if (!_pool) {
+            ThreadPool::Options options;
+            options.poolName = "LogicalSessionsPartitionPool";
+            options.threadNamePrefix = "LogicalSessionsPartition-";
+            options.minThreads = 0;
+            options.maxThreads = kMaxPartitionConcurrency;
+            options.onCreateThread = [service](const std::string& name) {
+                Client::initThread(name, service, nullptr);
+            };
+            _pool = std::make_unique<ThreadPool>(std::move(options));
+            _pool->startup();
+        }
+        return *_pool;
+    }
+
+    void shutdown() {
+        ThreadPool* pool;
+        {
+            stdx::lock_guard<Latch> lk(_mutex);
+            _inShutdown = true;
+            pool = _pool.get();
+        }
+
+        if (pool) {
+            pool->shutdown();
+            pool->join();
+        }
+    }
+
+private:
+    Mutex _mutex = MONGO_MAKE_LATCH("PartitionPool::_mutex");
+    bool _inShutdown = false;
+    std::unique_ptr<ThreadPool> _pool;
+};
+
+const auto getPartitionPool = ServiceContext::declareDecoration<PartitionPool>();
+
+// The ServiceContext must not have any Clients left when it is destroyed, so the threads of the
+// pool are joined before then.
+const auto partitionPoolRegisterer = ServiceContext::ConstructorActionRegisterer{
+    "LogicalSessionsPartitionPool",
+    [](ServiceContext*) {},
+    [](ServiceContext* service) { getPartitionPool(service).shutdown(); }};
+
 
 BSONObj lsidQuery(const LogicalSessionId& lsid) {
     return BSON(LogicalSessionRecord::kIdFieldName << lsid.toBSON());
@@ -300,4 +370,102 @@ BSONObj SessionsCollection::generateCollModCmd() {
     return collModCmdBuilder.obj();
 }
 
+size_t SessionsCollection::getPartitionSize() {
+    return gLogicalSessionRefreshBatchSize.load();
+}
+
+void SessionsCollection::runPartitioned(OperationContext* opCtx,
+                                        size_t numPartitions,
+                                        const PartitionFn& fn) {
+    const size_t concurrency =
+        std::min(numPartitions, size_t(gLogicalSessionRefreshConcurrency.load()));
+    if (concurrency <= 1) {
+        for (size_t partition = 0; partition < numPartitions; ++partition) {
+            fn(opCtx, partition);
+        }
+        return;
+    }
+
+    auto service = opCtx->getServiceContext();
+    auto& pool = getPartitionPool(service).get(service);
+    const auto deadline = opCtx->getDeadline();
+    const auto timeoutError = opCtx->getTimeoutError();
+
+    Mutex mutex = MONGO_MAKE_LATCH("SessionsCollection::runPartitioned::mutex");
+    stdx::condition_variable workersDone;
+    size_t workersRunning = concurrency;
+    Status firstError = Status::OK();
+
+    // The operations of the partitions being run, which are killed along with the caller's.
+    stdx::unordered_set<OperationContext*> partitionOpCtxs;
+    boost::optional<ErrorCodes::Error> killCode;
+
+    auto recordError = [&](Status status) {
+        stdx::lock_guard<Latch> lk(mutex);
+        if (firstError.isOK()) {
+            firstError = std::move(status);
+        }
+    };
+
+    // The pool is shared with the other passes, so rather than scheduling every partition, which
+    // would let this pass use as many threads as the pool has, 'concurrency' workers each take
+    // partitions until there are none left.
+    AtomicWord<size_t> nextPartition{0};
+    for (size_t worker = 0; worker < concurrency; ++worker) {
+        pool.schedule([&](Status status) {
+            if (!status.isOK()) {
+                recordError(std::move(status));
+            } else {
+                for (auto partition = nextPartition.fetchAndAdd(1); partition < numPartitions;
+                     partition = nextPartition.fetchAndAdd(1)) {
+                    try {
+                        auto uniqueOpCtx = cc().makeOperationContext();
+                        auto partitionOpCtx = uniqueOpCtx.get();
+                        if (deadline != Date_t::max()) {
+                            partitionOpCtx->setDeadlineByDate(deadline, timeoutError);
+                        }
+
+                        {
+                            stdx::lock_guard<Latch> lk(mutex);
+                            if (killCode) {
+                                break;
+                            }
+                            partitionOpCtxs.insert(partitionOpCtx);
+                        }
+                        ON_BLOCK_EXIT([&] {
+                            stdx::lock_guard<Latch> lk(mutex);
+                            partitionOpCtxs.erase(partitionOpCtx);
+                        });
+
+                        fn(partitionOpCtx, partition);
+                    } catch (const DBException& ex) {
+                        recordError(ex.toStatus());
+                    }
+                }
+            }
+
+            stdx::lock_guard<Latch> lk(mutex);
+            if (--workersRunning == 0) {
+                workersDone.notify_all();
+            }
+        });
+    }
+
+    stdx::unique_lock<Latch> lk(mutex);
+    try {
+        opCtx->waitForConditionOrInterrupt(workersDone, lk, [&] { return workersRunning == 0; });
+    } catch (const DBException& ex) {
+        // The workers refer to this frame, so they must be done before the error is rethrown.
+        killCode = ex.code();
+        for (auto partitionOpCtx : partitionOpCtxs) {
+            auto client = partitionOpCtx->getClient();
+            stdx::lock_guard<Client> clientLock(*client);
+            service->killOperation(clientLock, partitionOpCtx, ex.code());
+        }
+        workersDone.wait(lk, [&] { return workersRunning == 0; });
+        throw;
+    }
+    uassertStatusOK(firstError);
+}
+
 }  // namespace mongo
@@ -30,6 +30,7 @@
 #pragma once
 
 #include <functional>
+#include <vector>
 
 #include "mongo/db/logical_session_id.h"
 
@@ -96,6 +97,43 @@ public:
      */
     static BSONObj generateCollModCmd();
 
+    /**
+     * Splits 'items' into partitions of at most 'logicalSessionRefreshBatchSize' entries each, so
+     * that the work of a refresh or reap pass can be spread with 'runPartitioned'.
+     */
+    template <typename Container>
+    static std::vector<Container> makePartitions(const Container& items) {
+        const size_t partitionSize = getPartitionSize();
+
+        std::vector<Container> partitions;
+        for (const auto& item : items) {
+            if (partitions.empty() || partitions.back().size() >= partitionSize) {
+                partitions.emplace_back();
+            }
+            partitions.back().insert(item);
+        }
+        return partitions;
+    }
+
+    /**
+     * Returns the current value of the 'logicalSessionRefreshBatchSize' server parameter.
+     */
+    static size_t getPartitionSize();
+
+    /**
+     * Invokes 'fn' once for each partition in [0, numPartitions), on up to
+     * 'logicalSessionRefreshConcurrency' threads at a time, taken from a pool shared by all the
+     * passes of the service. Each partition run on a pool thread gets its own OperationContext; if
+     * only one partition can run at a time, they all run serially on 'opCtx'.
+     *
+     * Waits for all the partitions to be processed and then throws the first error any of them
+     * failed with.
+     */
+    using PartitionFn = std::function<void(OperationContext* opCtx, size_t partition)>;
+    static void runPartitioned(OperationContext* opCtx,
+                               size_t numPartitions,
+                               const PartitionFn& fn);
+
 protected:
     SessionsCollection();
 
@@ -84,10 +84,9 @@ const MockSessionsCollectionImpl::SessionMap& MockSessionsCollectionImpl::sessio
 }
 
 void MockSessionsCollectionImpl::_refreshSessions(const LogicalSessionRecordSet& sessions) {
+    stdx::unique_lock<Latch> lk(_mutex);
     for (auto& record : sessions) {
-        if (!has(record.getId())) {
-            _sessions.insert({record.getId(), record});
-        }
+        _sessions.insert({record.getId(), record});
     }
 }
 
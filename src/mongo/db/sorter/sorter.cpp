@@ -49,13 +49,13 @@
 #include "mongo/db/sorter/sorter.h"
 
 #include <boost/filesystem/operations.hpp>
-#include <snappy.h>
 #include <vector>
 
 #include "mongo/base/string_data.h"
 #include "mongo/config.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/db/service_context.h"
+#include "mongo/db/sorter/sorter_spill.h"
 #include "mongo/db/storage/encryption_hooks.h"
 #include "mongo/db/storage/storage_options.h"
 #include "mongo/platform/atomic_word.h"
@@ -63,8 +63,9 @@
 #include "mongo/s/is_mongos.h"
 #include "mongo/util/assert_util.h"
 #include "mongo/util/destructor_guard.h"
+#include "mongo/util/future.h"
+#include "mongo/util/loser_tree.h"
 #include "mongo/util/str.h"
-#include "mongo/util/unowned_ptr.h"
 
 namespace mongo {
 
@@ -184,6 +185,11 @@ private:
  * closeSource() functions to ensure the FileIterator is not holding the file open when the file is
  * deleted. Since it is one among many FileIterators, it cannot close a file that may still be in
  * use elsewhere.
+ *
+ * While the source is open and a read-ahead executor is available, the next block is read,
+ * decrypted and decompressed on that executor while the current block is being consumed. At most
+ * one such read is in flight, and it is the only thing that touches '_file' until it has been
+ * waited for.
  */
 template <typename Key, typename Value>
 class FileIterator : public SortIteratorInterface<Key, Value> {
@@ -198,19 +204,26 @@ public:
                  std::streampos fileEndOffset,
                  const Settings& settings,
                  const boost::optional<std::string>& dbName,
-                 const uint32_t checksum)
+                 const uint32_t checksum,
+                 SorterCompressorEnum compressor)
         : _settings(settings),
           _done(false),
           _fileFullPath(fileFullPath),
           _fileStartOffset(fileStartOffset),
           _fileEndOffset(fileEndOffset),
           _dbName(dbName),
+          _compressor(compressor),
           _originalChecksum(checksum) {
         uassert(16815,
                 str::stream() << "unexpected empty file: " << _fileFullPath,
                 boost::filesystem::file_size(_fileFullPath) != 0);
     }
 
+    ~FileIterator() {
+        // A pending read-ahead refers to this object, so it must finish before we go away.
+        DESTRUCTOR_GUARD(waitForReadAhead();)
+    }
+
     void openSource() {
         _file.open(_fileFullPath.c_str(), std::ios::in | std::ios::binary);
         uassert(16814,
@@ -223,9 +236,14 @@ public:
                               << "' in file \"" << _fileFullPath
                               << "\": " << myErrnoWithDescription(),
                 _file.good());
+
+        // Start fetching the first block right away, so that a merge which opens all of its
+        // inputs before reading from any of them loads their first blocks concurrently.
+        startReadAhead();
     }
 
     void closeSource() {
+        waitForReadAhead();
         _file.close();
         uassert(50969,
                 str::stream() << "error closing file \"" << _fileFullPath
@@ -275,7 +293,13 @@ public:
     }
 
     SorterRange getRange() const {
-        return {_fileStartOffset, _fileEndOffset, _originalChecksum};
+        SorterRange range{_fileStartOffset, _fileEndOffset, _originalChecksum};
+        if (_compressor != SorterCompressorEnum::kSnappy) {
+            // Leave the field out for snappy so that the range can still be read by versions that
+            // predate it.
+            range.setCompressor(_compressor);
+        }
+        return range;
     }
 
 private:
@@ -290,28 +314,55 @@ private:
     }
 
     /**
-     * Tries to read from disk and places any results in _bufferReader. If there is no more data to
-     * read, then _done is set to true and the function returns immediately.
+     * Places the next block in _bufferReader, either by waiting for the read-ahead of it or by
+     * reading it from disk. If there is no more data to read, then _done is set to true and the
+     * function returns immediately.
      */
     void fillBufferFromDisk() {
-        int32_t rawSize;
-        read(&rawSize, sizeof(rawSize));
-        if (_done)
+        SpillBlock block;
+        if (_readAhead) {
+            auto readAhead = std::move(*_readAhead);
+            _readAhead.reset();
+            block = std::move(readAhead).get();
+        } else {
+            block = readBlock();
+        }
+
+        if (!block.data) {
+            _done = true;
             return;
+        }
+
+        _buffer = std::move(block.data);
+        _bufferReader.reset(new BufReader(_buffer.get(), block.size));
+
+        startReadAhead();
+    }
+
+    /**
+     * Reads, decrypts and decompresses the next block from _file. Returns an empty block once the
+     * end of the range has been reached.
+     *
+     * This may run on the read-ahead executor, so it must not touch anything but _file and the
+     * members which never change after construction.
+     */
+    SpillBlock readBlock() {
+        int32_t rawSize;
+        if (!read(&rawSize, sizeof(rawSize)))
+            return {};
 
         // negative size means compressed
         const bool compressed = rawSize < 0;
         int32_t blockSize = std::abs(rawSize);
 
-        _buffer.reset(new char[blockSize]);
-        read(_buffer.get(), blockSize);
-        uassert(16816, "file too short?", !_done);
+        std::unique_ptr<char[]> buffer(new char[blockSize]);
+        uassert(16816, "file too short?", read(buffer.get(), blockSize));
 
         if (auto encryptionHooks = getEncryptionHooksIfEnabled()) {
             std::unique_ptr<char[]> out(new char[blockSize]);
             size_t outLen;
             Status status =
-                encryptionHooks->unprotectTmpData(reinterpret_cast<const uint8_t*>(_buffer.get()),
+                encryptionHooks->unprotectTmpData(reinterpret_cast<const uint8_t*>(buffer.get()),
                                                   blockSize,
                                                   reinterpret_cast<uint8_t*>(out.get()),
                                                   blockSize,
@@ -321,37 +372,49 @@ private:
                     str::stream() << "Failed to unprotect data: " << status.toString(),
                     status.isOK());
             blockSize = outLen;
-            _buffer.swap(out);
+            buffer.swap(out);
         }
 
         if (!compressed) {
-            _bufferReader.reset(new BufReader(_buffer.get(), blockSize));
-            return;
+            return {std::move(buffer), size_t(blockSize)};
         }
 
-        dassert(snappy::IsValidCompressedBuffer(_buffer.get(), blockSize));
+        // hold on to decompressed data and throw out compressed data at block exit
+        return decompressSpillBlock(_compressor, buffer.get(), blockSize);
+    }
 
-        size_t uncompressedSize;
-        uassert(17061,
-                "couldn't get uncompressed length",
-                snappy::GetUncompressedLength(_buffer.get(), blockSize, &uncompressedSize));
+    /**
+     * Schedules a read of the next block on the read-ahead executor, if there is one.
+     */
+    void startReadAhead() {
+        invariant(!_readAhead);
 
-        std::unique_ptr<char[]> decompressionBuffer(new char[uncompressedSize]);
-        uassert(17062,
-                "decompression failed",
-                snappy::RawUncompress(_buffer.get(), blockSize, decompressionBuffer.get()));
+        auto executor = getReadAheadExecutor();
+        if (!executor) {
+            return;
+        }
 
-        // hold on to decompressed data and throw out compressed data at block exit
-        _buffer.swap(decompressionBuffer);
-        _bufferReader.reset(new BufReader(_buffer.get(), uncompressedSize));
+        _readAhead.emplace(
+            ExecutorFuture<void>(std::move(executor)).then([this] { return readBlock(); }).semi());
     }
 
     /**
-     * Attempts to read data from disk. Sets _done to true when file offset reaches _fileEndOffset.
+     * Waits for any in-flight read-ahead to finish and discards its result.
+     */
+    void waitForReadAhead() {
+        if (_readAhead) {
+            _readAhead->wait();
+            _readAhead.reset();
+        }
+    }
+
+    /**
+     * Attempts to read data from disk. Returns false without reading anything once the file offset
+     * reaches _fileEndOffset.
      *
      * Masserts on any file errors
      */
-    void read(void* out, size_t size) {
+    bool read(void* out, size_t size) {
         invariant(_file.is_open());
 
         const std::streampos offset = _file.tellg();
@@ -362,8 +425,7 @@ private:
 
         if (offset >= _fileEndOffset) {
             invariant(offset == _fileEndOffset);
-            _done = true;
-            return;
+            return false;
         }
 
         _file.read(reinterpret_cast<char*>(out), size);
@@ -372,6 +434,7 @@ private:
                               << "\": " << myErrnoWithDescription(),
                 _file.good());
         verify(_file.gcount() == static_cast<std::streamsize>(size));
+        return true;
     }
 
     const Settings _settings;
@@ -384,6 +447,10 @@ private:
     std::streampos _fileEndOffset;    // File offset at which the sorted data range ends.
     std::ifstream _file;
     boost::optional<std::string> _dbName;
+    const SorterCompressorEnum _compressor;
+
+    // The read of the block following the one in _bufferReader, if it has been started.
+    boost::optional<SemiFuture<SpillBlock>> _readAhead;
 
     // Checksum value that is updated with each read of a data object from disk. We can compare
     // this value with _originalChecksum to check for data corruption if and only if the
@@ -412,40 +479,38 @@ public:
                   const Comparator& comp)
         : _opts(opts),
           _remaining(opts.limit ? opts.limit : std::numeric_limits<unsigned long long>::max()),
-          _first(true),
-          _greater(comp) {
-        for (size_t i = 0; i < iters.size(); i++) {
-            iters[i]->openSource();
-            if (iters[i]->more()) {
-                _heap.push_back(std::make_shared<Stream>(i, iters[i]->next(), iters[i]));
+          _tree(StreamComparator(comp, &_streams)) {
+        // Open every input before reading from any of them so that inputs which read ahead can
+        // load their first blocks concurrently.
+        for (auto&& iter : iters) {
+            iter->openSource();
+        }
+
+        for (auto&& iter : iters) {
+            if (iter->more()) {
+                _streams.push_back(std::make_shared<Stream>(iter->next(), iter));
             } else {
-                iters[i]->closeSource();
+                iter->closeSource();
             }
         }
 
-        if (_heap.empty()) {
-            _remaining = 0;
-            return;
+        _tree.resize(_streams.size());
+        for (size_t i = 0; i < _streams.size(); i++) {
+            _tree.activate(i);
         }
-
-        std::make_heap(_heap.begin(), _heap.end(), _greater);
-        std::pop_heap(_heap.begin(), _heap.end(), _greater);
-        _current = _heap.back();
-        _heap.pop_back();
     }
 
     ~MergeIterator() {
         // Clear the remaining Stream objects to close the file handles. Some systems will error
         // closing the file if any file handles are still open.
-        _current.reset();
-        _heap.clear();
+        _streams.clear();
     }
 
     void openSource() {}
     void closeSource() {}
 
     bool more() {
-        if (_remaining > 0 && (_first || !_heap.empty() || _current->more()))
+        if (_remaining > 0 && !_tree.empty())
             return true;
 
         _remaining = 0;
@@ -457,23 +522,18 @@ public:
 
         _remaining--;
 
-        if (_first) {
-            _first = false;
-            return _current->current();
-        }
+        const size_t winner = _tree.top();
+        auto& stream = _streams[winner];
+        Data out = stream->takeCurrent();
 
-        if (!_current->advance()) {
-            verify(!_heap.empty());
-            std::pop_heap(_heap.begin(), _heap.end(), _greater);
-            _current = _heap.back();
-            _heap.pop_back();
-        } else if (!_heap.empty() && _greater(_current, _heap.front())) {
-            std::pop_heap(_heap.begin(), _heap.end(), _greater);
-            std::swap(_current, _heap.back());
-            std::push_heap(_heap.begin(), _heap.end(), _greater);
+        const bool stillActive = stream->advance();
+        if (!stillActive) {
+            // Close the input as soon as it is exhausted rather than when the merge is destroyed.
+            stream.reset();
         }
+        _tree.replayTop(stillActive);
 
-        return _current->current();
+        return out;
     }
 
 
@@ -487,8 +547,8 @@ private:
      */
     class Stream {
     public:
-        Stream(size_t fileNum, const Data& first, std::shared_ptr<Input> rest)
-            : fileNum(fileNum), _current(first), _rest(rest) {}
+        Stream(const Data& first, std::shared_ptr<Input> rest)
+            : _current(first), _rest(rest) {}
 
         ~Stream() {
             _rest->closeSource();
@@ -497,8 +557,8 @@ private:
         const Data& current() const {
             return _current;
         }
-        bool more() {
-            return _rest->more();
+        Data takeCurrent() {
+            return std::move(_current);
         }
         bool advance() {
             if (!_rest->more())
@@ -508,37 +568,36 @@ private:
             return true;
         }
 
-        const size_t fileNum;
-
     private:
         Data _current;
         std::shared_ptr<Input> _rest;
     };
 
-    class STLComparator {  // uses greater rather than less-than to maintain a MinHeap
+    /**
+     * Compares the current elements of two streams, identified by their position in '_streams'.
+     * The LoserTree breaks ties in favour of the lower position, which keeps the merge stable.
+     */
+    class StreamComparator {
     public:
-        explicit STLComparator(const Comparator& comp) : _comp(comp) {}
-        bool operator()(unowned_ptr<const Stream> lhs, unowned_ptr<const Stream> rhs) const {
-            // first compare data
-            dassertCompIsSane(_comp, lhs->current(), rhs->current());
-            int ret = _comp(lhs->current(), rhs->current());
-            if (ret)
-                return ret > 0;
-
-            // then compare fileNums to ensure stability
-            return lhs->fileNum > rhs->fileNum;
+        StreamComparator(const Comparator& comp,
+                         const std::vector<std::shared_ptr<Stream>>* streams)
+            : _comp(comp), _streams(streams) {}
+        int operator()(size_t lhs, size_t rhs) const {
+            const Data& lhsData = (*_streams)[lhs]->current();
+            const Data& rhsData = (*_streams)[rhs]->current();
+            dassertCompIsSane(_comp, lhsData, rhsData);
+            return _comp(lhsData, rhsData);
         }
 
     private:
         const Comparator _comp;
+        const std::vector<std::shared_ptr<Stream>>* _streams;
     };
 
     SortOptions _opts;
     unsigned long long _remaining;
-    bool _first;
-    std::shared_ptr<Stream> _current;
-    std::vector<std::shared_ptr<Stream>> _heap;  // MinHeap
-    STLComparator _greater;                      // named so calls make sense
+    std::vector<std::shared_ptr<Stream>> _streams;  // Null once exhausted.
+    LoserTree<StreamComparator> _tree;
 };
 
 template <typename Key, typename Value, typename Comparator>
@@ -579,7 +638,8 @@ public:
                                range.getEndOffset(),
                                this->_settings,
                                this->_opts.dbName,
-                               range.getChecksum());
+                               range.getChecksum(),
+                               range.getCompressor().value_or(SorterCompressorEnum::kSnappy));
                        });
     }
 
@@ -1035,7 +1095,8 @@ SortedFileWriter<Key, Value>::SortedFileWriter(const SortOptions& opts,
       // _file.tellp() is not initialized on all systems to reflect this. Therefore, we must also
       // pass in the expected offset to this constructor.
       _fileStartOffset(fileStartOffset),
-      _dbName(opts.dbName) {
+      _dbName(opts.dbName),
+      _compressor(sorter::getSpillCompressor()) {
 
     // This should be checked by consumers, but if we get here don't allow writes.
     uassert(
@@ -1088,7 +1149,7 @@ void SortedFileWriter<Key, Value>::spill() {
         return;
 
     std::string compressed;
-    snappy::Compress(outBuffer, size, &compressed);
+    sorter::compressSpillBlock(_compressor, outBuffer, size, &compressed);
     verify(compressed.size() <= size_t(std::numeric_limits<int32_t>::max()));
 
     const bool shouldCompress = compressed.size() < size_t(_buffer.len() / 10 * 9);
@@ -1143,8 +1204,13 @@ SortIteratorInterface<Key, Value>* SortedFileWriter<Key, Value>::done() {
     _fileEndOffset = currentFileOffset < _fileStartOffset ? _fileStartOffset : currentFileOffset;
     _file.close();
 
-    return new sorter::FileIterator<Key, Value>(
-        _fileFullPath, _fileStartOffset, _fileEndOffset, _settings, _dbName, _checksum);
+    return new sorter::FileIterator<Key, Value>(_fileFullPath,
+                                                _fileStartOffset,
+                                                _fileEndOffset,
+                                                _settings,
+                                                _dbName,
+                                                _checksum,
+                                                _compressor);
 }
 
 //
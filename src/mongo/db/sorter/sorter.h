@@ -363,6 +363,9 @@ private:
     std::streampos _fileEndOffset;
 
     boost::optional<std::string> _dbName;
+
+    // The algorithm used to compress each block written to the file.
+    const SorterCompressorEnum _compressor;
 };
 }  // namespace mongo
 
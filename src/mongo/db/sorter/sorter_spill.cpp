@@ -0,0 +1,173 @@
+/**
+ *    Copyright (C) 2021-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/sorter/sorter_spill.h"
+
+#include <snappy.h>
+#include <zstd.h>
+
+#include "mongo/db/client.h"
+#include "mongo/db/service_context.h"
+#include "mongo/db/sorter/sorter_spill_gen.h"
+#include "mongo/idl/idl_parser.h"
+#include "mongo/platform/mutex.h"
+#include "mongo/util/assert_util.h"
+#include "mongo/util/concurrency/thread_pool.h"
+#include "mongo/util/str.h"
+
+namespace mongo {
+namespace sorter {
+namespace {
+
+// Reads are mostly waiting on the disk, so a few threads are enough to keep one read in flight for
+// every range of several concurrent merges.
+constexpr size_t kMaxReadAheadThreads = 4;
+
+class ReadAheadExecutor {
+public:
+    ~ReadAheadExecutor() {
+        if (_pool) {
+            _pool->shutdown();
+            _pool->join();
+        }
+    }
+
+    std::shared_ptr<ThreadPool> get() {
+        stdx::lock_guard lk(_mutex);
+        if (!_pool) {
+            ThreadPool::Options options;
+            options.poolName = "SorterReadAhead";
+            options.threadNamePrefix = "SorterReadAhead-";
+            options.minThreads = 0;
+            options.maxThreads = kMaxReadAheadThreads;
+            options.onCreateThread = [](const std::string& threadName) {
+                Client::initThread(threadName);
+            };
+            _pool = std::make_shared<ThreadPool>(std::move(options));
+            _pool->startup();
+        }
+        return _pool;
+    }
+
+private:
+    Mutex _mutex = MONGO_MAKE_LATCH("ReadAheadExecutor::_mutex");
+    std::shared_ptr<ThreadPool> _pool;
+};
+
+const auto getReadAheadExecutorDecoration = ServiceContext::declareDecoration<ReadAheadExecutor>();
+
+}  // namespace
+
+Status validateSpillCompressor(const std::string& compressor) {
+    try {
+        SorterCompressor_parse(IDLParserErrorContext("sorterSpillCompressor"), compressor);
+    } catch (const DBException& ex) {
+        return ex.toStatus();
+    }
+    return Status::OK();
+}
+
+SorterCompressorEnum getSpillCompressor() {
+    return SorterCompressor_parse(IDLParserErrorContext("sorterSpillCompressor"),
+                                  gSorterSpillCompressor);
+}
+
+void compressSpillBlock(SorterCompressorEnum compressor,
+                        const char* data,
+                        size_t size,
+                        std::string* out) {
+    switch (compressor) {
+        case SorterCompressorEnum::kSnappy:
+            out->clear();
+            snappy::Compress(data, size, out);
+            return;
+        case SorterCompressorEnum::kZstd: {
+            out->resize(ZSTD_compressBound(size));
+            size_t compressedSize =
+                ZSTD_compress(&(*out)[0], out->size(), data, size, ZSTD_CLEVEL_DEFAULT);
+            uassert(5400400,
+                    str::stream() << "Failed to compress spilled data: "
+                                  << ZSTD_getErrorName(compressedSize),
+                    !ZSTD_isError(compressedSize));
+            out->resize(compressedSize);
+            return;
+        }
+    }
+    MONGO_UNREACHABLE;
+}
+
+SpillBlock decompressSpillBlock(SorterCompressorEnum compressor, const char* data, size_t size) {
+    SpillBlock block;
+    switch (compressor) {
+        case SorterCompressorEnum::kSnappy: {
+            dassert(snappy::IsValidCompressedBuffer(data, size));
+
+            uassert(17061,
+                    "couldn't get uncompressed length",
+                    snappy::GetUncompressedLength(data, size, &block.size));
+
+            block.data.reset(new char[block.size]);
+            uassert(17062,
+                    "decompression failed",
+                    snappy::RawUncompress(data, size, block.data.get()));
+            return block;
+        }
+        case SorterCompressorEnum::kZstd: {
+            // ZSTD_compress() always records the uncompressed size in the frame header.
+            auto contentSize = ZSTD_getFrameContentSize(data, size);
+            uassert(5400401,
+                    "couldn't get uncompressed length",
+                    contentSize != ZSTD_CONTENTSIZE_UNKNOWN &&
+                        contentSize != ZSTD_CONTENTSIZE_ERROR);
+
+            block.size = contentSize;
+            block.data.reset(new char[block.size]);
+            size_t decompressedSize = ZSTD_decompress(block.data.get(), block.size, data, size);
+            uassert(5400402,
+                    str::stream() << "decompression failed: "
+                                  << ZSTD_getErrorName(decompressedSize),
+                    !ZSTD_isError(decompressedSize) && decompressedSize == block.size);
+            return block;
+        }
+    }
+    MONGO_UNREACHABLE;
+}
+
+std::shared_ptr<OutOfLineExecutor> getReadAheadExecutor() {
+    // Some tests may not run with a global service context.
+    if (!gSorterSpillReadAhead.load() || !hasGlobalServiceContext()) {
+        return nullptr;
+    }
+    return getReadAheadExecutorDecoration(getGlobalServiceContext()).get();
+}
+
+}  // namespace sorter
+}  // namespace mongo
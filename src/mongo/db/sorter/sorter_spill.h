@@ -0,0 +1,80 @@
+/**
+ *    Copyright (C) 2021-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <memory>
+#include <string>
+
+#include "mongo/base/status.h"
+#include "mongo/db/sorter/sorter_gen.h"
+#include "mongo/util/out_of_line_executor.h"
+
+namespace mongo {
+namespace sorter {
+
+/**
+ * An owned buffer holding one block of a spilled range.
+ */
+struct SpillBlock {
+    std::unique_ptr<char[]> data;
+    size_t size = 0;
+};
+
+/**
+ * Validator for the 'sorterSpillCompressor' server parameter.
+ */
+Status validateSpillCompressor(const std::string& compressor);
+
+/**
+ * Returns the compressor that newly spilled ranges should use.
+ */
+SorterCompressorEnum getSpillCompressor();
+
+/**
+ * Compresses 'size' bytes starting at 'data' with 'compressor', replacing the contents of 'out'.
+ */
+void compressSpillBlock(SorterCompressorEnum compressor,
+                        const char* data,
+                        size_t size,
+                        std::string* out);
+
+/**
+ * Reverses compressSpillBlock(). Throws if the block cannot be decompressed.
+ */
+SpillBlock decompressSpillBlock(SorterCompressorEnum compressor, const char* data, size_t size);
+
+/**
+ * Returns the executor on which spilled ranges read their next block ahead of time, or nullptr if
+ * read-ahead is disabled or there is no global ServiceContext to own the executor.
+ */
+std::shared_ptr<OutOfLineExecutor> getReadAheadExecutor();
+
+}  // namespace sorter
+}  // namespace mongo
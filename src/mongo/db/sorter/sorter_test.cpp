@@ -39,12 +39,15 @@
 #include "mongo/base/static_assert.h"
 #include "mongo/config.h"
 #include "mongo/db/sorter/sorter.h"
+#include "mongo/db/sorter/sorter_spill_gen.h"
 #include "mongo/logv2/log.h"
 #include "mongo/platform/random.h"
 #include "mongo/stdx/thread.h"
 #include "mongo/unittest/death_test.h"
 #include "mongo/unittest/temp_dir.h"
 #include "mongo/unittest/unittest.h"
+#include "mongo/util/scopeguard.h"
+#include "mongo/util/unowned_ptr.h"
 
 
 namespace mongo {
@@ -305,6 +308,21 @@ public:
 
             ASSERT_TRUE(boost::filesystem::remove(fileName));
         }
+        {  // big, zstd
+            const auto originalCompressor = gSorterSpillCompressor;
+            gSorterSpillCompressor = "zstd";
+            ON_BLOCK_EXIT([&] { gSorterSpillCompressor = originalCompressor; });
+
+            std::string fileName = opts.tempDir + "/" + nextFileName();
+            SortedFileWriter<IntWrapper, IntWrapper> sorter(opts, fileName, 0);
+            for (int i = 0; i < 10 * 1000 * 1000; i++)
+                sorter.addAlreadySorted(i, -i);
+
+            ASSERT_ITERATORS_EQUIVALENT(std::shared_ptr<IWIterator>(sorter.done()),
+                                        std::make_shared<IntIterator>(0, 10 * 1000 * 1000));
+
+            ASSERT_TRUE(boost::filesystem::remove(fileName));
+        }
 
         ASSERT(boost::filesystem::is_empty(tempDir.path()));
     }
@@ -864,6 +882,40 @@ TEST_F(SorterMakeFromExistingRangesTest, RoundTrip) {
     }
 }
 
+TEST_F(SorterMakeFromExistingRangesTest, RoundTripZstd) {
+    unittest::TempDir tempDir(_agent.getSuiteName() + "_" + _agent.getTestName());
+
+    const auto originalCompressor = gSorterSpillCompressor;
+    gSorterSpillCompressor = "zstd";
+    ON_BLOCK_EXIT([&] { gSorterSpillCompressor = originalCompressor; });
+
+    auto opts = SortOptions()
+                    .ExtSortAllowed()
+                    .TempDir(tempDir.path())
+                    .MaxMemoryUsageBytes(sizeof(IWSorter::Data));
+
+    IWSorter::PersistedState state;
+    {
+        auto sorterBeforeShutdown =
+            std::unique_ptr<IWSorter>(IWSorter::make(opts, IWComparator(ASC)));
+        sorterBeforeShutdown->add(1, -1);
+        state = sorterBeforeShutdown->persistDataForShutdown();
+        ASSERT_EQUALS(1U, state.ranges.size()) << state.ranges.size();
+    }
+
+    // The compressor is persisted with the range, so the range stays readable after the
+    // parameter changes.
+    ASSERT(state.ranges[0].getCompressor() == SorterCompressorEnum::kZstd);
+    gSorterSpillCompressor = "snappy";
+
+    auto sorter = std::unique_ptr<IWSorter>(
+        IWSorter::makeFromExistingRanges(state.fileName, state.ranges, opts, IWComparator(ASC)));
+    sorter->add(2, -2);
+
+    ASSERT_ITERATORS_EQUIVALENT(std::shared_ptr<IWIterator>(sorter->done()),
+                                std::make_shared<IntIterator>(1, 3));
+}
+
 }  // namespace
 }  // namespace sorter
 }  // namespace mongo
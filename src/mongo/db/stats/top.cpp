@@ -33,6 +33,8 @@
 
 #include "mongo/db/stats/top.h"
 
+#include <algorithm>
+
 #include "mongo/db/jsobj.h"
 #include "mongo/db/service_context.h"
 
@@ -97,6 +99,11 @@ void Top::_record(OperationContext* opCtx,
 
     _incrementHistogram(opCtx, micros, &c.opLatencyHistogram, readWriteType);
 
+    Client* client = opCtx->getClient();
+    if (client->isFromUserConnection() && !client->isInDirectClient()) {
+        c.latencyHistogram.record(Microseconds(micros));
+    }
+
     c.total.inc(micros);
 
     if (lockType == LockType::WriteLocked)
@@ -214,6 +221,41 @@ void Top::appendGlobalLatencyStats(bool includeHistograms,
     _globalHistogramStats.append(includeHistograms, slowMSBucketsOnly, builder);
 }
 
+void Top::appendLatencyHistograms(size_t maxNamespaces, BSONObjBuilder* builder) const {
+    // Only copy the histograms while holding the lock, which every operation takes on completion,
+    // and leave sorting and building the BSON until after it is released.
+    std::vector<std::pair<std::string, LatencyHistogram>> histograms;
+    {
+        stdx::lock_guard<SimpleMutex> guard(_lock);
+        for (const auto& [ns, coll] : _usage) {
+            if (coll.latencyHistogram.count() > 0) {
+                histograms.emplace_back(ns, coll.latencyHistogram);
+            }
+        }
+    }
+
+    // Every histogram adds over a kilobyte to the sample, so only the busiest namespaces are kept.
+    if (histograms.size() > maxNamespaces) {
+        std::nth_element(histograms.begin(),
+                         histograms.begin() + maxNamespaces,
+                         histograms.end(),
+                         [](const auto& lhs, const auto& rhs) {
+                             return lhs.second.count() > rhs.second.count();
+                         });
+        histograms.resize(maxNamespaces);
+    }
+
+    // Emit namespaces in a fixed order so that FTDC sees the same schema from sample to sample.
+    std::sort(histograms.begin(), histograms.end(), [](const auto& lhs, const auto& rhs) {
+        return lhs.first < rhs.first;
+    });
+
+    for (const auto& [ns, histogram] : histograms) {
+        BSONObjBuilder nsBuilder(builder->subobjStart(ns));
+        histogram.append(&nsBuilder);
+    }
+}
+
 void Top::incrementGlobalTransactionLatencyStats(uint64_t latency) {
     stdx::lock_guard<SimpleMutex> guard(_lock);
     _globalHistogramStats.increment(latency, Command::ReadWriteType::kTransaction);
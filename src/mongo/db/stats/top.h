@@ -39,6 +39,7 @@
 #include "mongo/db/operation_context.h"
 #include "mongo/db/stats/operation_latency_histogram.h"
 #include "mongo/util/concurrency/mutex.h"
+#include "mongo/util/latency_histogram.h"
 #include "mongo/util/string_map.h"
 
 namespace mongo {
@@ -85,6 +86,9 @@ public:
         UsageData remove;
         UsageData commands;
         OperationLatencyHistogram opLatencyHistogram;
+
+        // Fine-grained latencies of user operations, sampled by high-frequency FTDC.
+        LatencyHistogram latencyHistogram;
     };
 
     enum class LockType {
@@ -136,6 +140,12 @@ public:
                                   bool slowMSBucketsOnly,
                                   BSONObjBuilder* builder);
 
+    /**
+     * Appends the fine-grained latency histograms of the 'maxNamespaces' namespaces which have
+     * recorded the most user operations, keyed by namespace.
+     */
+    void appendLatencyHistograms(size_t maxNamespaces, BSONObjBuilder* builder) const;
+
 private:
     void _appendToUsageMap(BSONObjBuilder& b, const UsageMap& map) const;
 
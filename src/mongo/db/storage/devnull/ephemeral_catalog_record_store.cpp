@@ -493,28 +493,26 @@ StatusWith<RecordData> EphemeralForTestRecordStore::updateWithDamages(
     stdx::lock_guard<stdx::recursive_mutex> lock(_data->recordsMutex);
 
     EphemeralForTestRecord* oldRecord = recordFor(lock, loc);
-    const int len = oldRecord->size;
 
-    EphemeralForTestRecord newRecord(len);
-    memcpy(newRecord.data.get(), oldRecord->data.get(), len);
+    // Apply the damages to a copy of the record, in order, as they may change its size.
+    std::string data(oldRecord->data.get(), oldRecord->size);
+    for (const auto& damage : damages) {
+        data.replace(damage.targetOffset,
+                     damage.targetSize,
+                     damageSource + damage.sourceOffset,
+                     damage.size);
+    }
+
+    EphemeralForTestRecord newRecord(data.size());
+    memcpy(newRecord.data.get(), data.data(), data.size());
 
     opCtx->recoveryUnit()->registerChange(
         std::make_unique<RemoveChange>(opCtx, _data, loc, *oldRecord));
+    _data->dataSize += newRecord.size - oldRecord->size;
     *oldRecord = newRecord;
 
     cappedDeleteAsNeeded(lock, opCtx);
 
-    char* root = newRecord.data.get();
-    mutablebson::DamageVector::const_iterator where = damages.begin();
-    const mutablebson::DamageVector::const_iterator end = damages.end();
-    for (; where != end; ++where) {
-        const char* sourcePtr = damageSource + where->sourceOffset;
-        char* targetPtr = root + where->targetOffset;
-        std::memcpy(targetPtr, sourcePtr, where->size);
-    }
-
-    *oldRecord = newRecord;
-
     return newRecord.toRecordData();
 }
 
@@ -235,6 +235,19 @@ public:
      */
     virtual void setRecordPreImages(OperationContext* opCtx, RecordId catalogId, bool val) = 0;
 
+    /**
+     * Updates whether updates/deletes should store their pre- and post-images in the change stream
+     * images collection.
+     */
+    virtual void setRecordChangeStreamImages(OperationContext* opCtx,
+                                             RecordId catalogId,
+                                             bool val) = 0;
+
+    /**
+     * Updates whether eligible query results on this collection may be cached.
+     */
+    virtual void setCacheQueryResults(OperationContext* opCtx, RecordId catalogId, bool val) = 0;
+
     /**
      * Updates the validator for this collection.
      *
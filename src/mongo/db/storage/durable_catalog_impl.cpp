@@ -1083,6 +1083,22 @@ void DurableCatalogImpl::setRecordPreImages(OperationContext* opCtx, RecordId ca
     putMetaData(opCtx, catalogId, md);
 }
 
+void DurableCatalogImpl::setRecordChangeStreamImages(OperationContext* opCtx,
+                                                     RecordId catalogId,
+                                                     bool val) {
+    BSONCollectionCatalogEntry::MetaData md = getMetaData(opCtx, catalogId);
+    md.options.recordChangeStreamImages = val;
+    putMetaData(opCtx, catalogId, md);
+}
+
+void DurableCatalogImpl::setCacheQueryResults(OperationContext* opCtx,
+                                              RecordId catalogId,
+                                              bool val) {
+    BSONCollectionCatalogEntry::MetaData md = getMetaData(opCtx, catalogId);
+    md.options.cacheQueryResults = val;
+    putMetaData(opCtx, catalogId, md);
+}
+
 void DurableCatalogImpl::updateValidator(OperationContext* opCtx,
                                          RecordId catalogId,
                                          const BSONObj& validator,
@@ -156,6 +156,12 @@ public:
 
     void setRecordPreImages(OperationContext* opCtx, RecordId catalogId, bool val) override;
 
+    void setRecordChangeStreamImages(OperationContext* opCtx,
+                                     RecordId catalogId,
+                                     bool val) override;
+
+    void setCacheQueryResults(OperationContext* opCtx, RecordId catalogId, bool val) override;
+
     void updateValidator(OperationContext* opCtx,
                          RecordId catalogId,
                          const BSONObj& validator,
@@ -40,6 +40,7 @@
 #include "mongo/base/data_view.h"
 #include "mongo/bson/bson_depth.h"
 #include "mongo/db/exec/sbe/values/value_builder.h"
+#include "mongo/db/fts/unicode/byte_vector.h"
 #include "mongo/platform/bits.h"
 #include "mongo/platform/strnlen.h"
 #include "mongo/util/decimal_counter.h"
@@ -241,10 +242,23 @@ const uint8_t kGreater = 254;
 // some utility functions
 namespace {
 
+/**
+ * Copies 'bytes' bytes from 'src' to 'dst', inverting every bit. Descending index fields store all
+ * of their bytes this way. 'dst' may equal 'src' to flip a buffer in place.
+ */
 void memcpy_flipBits(void* dst, const void* src, size_t bytes) {
     const char* input = static_cast<const char*>(src);
     char* output = static_cast<char*>(dst);
     const char* const end = input + bytes;
+#ifdef MONGO_HAVE_FAST_BYTE_VECTOR
+    using unicode::ByteVector;
+    const ByteVector allOnes(ByteVector::Scalar(-1));
+    while (end - input >= ByteVector::size) {
+        (ByteVector::load(input) ^ allOnes).store(output);
+        input += ByteVector::size;
+        output += ByteVector::size;
+    }
+#endif
     while (input != end) {
         *output++ = ~(*input++);
     }
@@ -296,10 +310,8 @@ string readInvertedCString(BufReader* reader) {
     const char* end = static_cast<const char*>(memchr(start, 0xFF, reader->remaining()));
     keyStringAssert(50817, "Failed to find '0xFF' in inverted string.", end);
     size_t actualBytes = end - start;
-    string s(start, actualBytes);
-    for (size_t i = 0; i < s.size(); i++) {
-        s[i] = ~s[i];
-    }
+    string s(actualBytes, '\0');
+    memcpy_flipBits(&s[0], start, actualBytes);
     reader->skip(1 + actualBytes);
     return s;
 }
@@ -326,9 +338,7 @@ string readInvertedCStringWithNuls(BufReader* reader) {
         reader->skip(1 + actualBytes);
     } while (reader->peek<unsigned char>() == 0x00);
 
-    for (size_t i = 0; i < out.size(); i++) {
-        out[i] = ~out[i];
-    }
+    memcpy_flipBits(&out[0], out.data(), out.size());
 
     return out;
 }
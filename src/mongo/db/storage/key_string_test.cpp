@@ -577,6 +577,21 @@ TEST_F(KeyStringBuilderTest, DecimalNumbers) {
     ROUNDTRIP(V1, BSON("" << BSONNULL << "" << BSON("a" << Decimal128::kPositiveInfinity)));
 }
 
+TEST_F(KeyStringBuilderTest, LongStringsWithNuls) {
+    // Descending keys flip their bytes in vector-sized blocks followed by a scalar tail, so cover
+    // lengths on both sides of a block boundary with NUL bytes at the start, middle and end.
+    for (size_t len = 1; len <= 70; len++) {
+        for (size_t nulPos : {size_t(0), len / 2, len - 1}) {
+            std::string str(len, 'x');
+            str[nulPos] = '\0';
+
+            ROUNDTRIP(version, BSON("" << str));
+            ROUNDTRIP(version, BSON("" << BSONSymbol(str)));
+            ROUNDTRIP(version, BSON("" << BSONCode(str)));
+        }
+    }
+}
+
 TEST_F(KeyStringBuilderTest, KeyStringValue) {
     // Test that KeyStringBuilder is releasable into a Value type that is comparable. Once
     // released, it is reusable once reset.
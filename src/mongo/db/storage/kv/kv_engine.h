@@ -361,6 +361,13 @@ public:
      */
     virtual Timestamp getAllDurableTimestamp() const = 0;
 
+    /**
+     * See `StorageEngine::isCacheUnderPressure`
+     */
+    virtual bool isCacheUnderPressure() const {
+        return false;
+    }
+
     /**
      * See `StorageEngine::getOplogNeededForCrashRecovery`
      */
@@ -84,12 +84,15 @@ TEST(RecordStoreTestHarness, UpdateWithDamages) {
             dv[0].sourceOffset = 5;
             dv[0].targetOffset = 0;
             dv[0].size = 2;
+            dv[0].targetSize = 2;
             dv[1].sourceOffset = 3;
             dv[1].targetOffset = 2;
             dv[1].size = 3;
+            dv[1].targetSize = 3;
             dv[2].sourceOffset = 0;
             dv[2].targetOffset = 5;
             dv[2].size = 3;
+            dv[2].targetSize = 3;
 
             WriteUnitOfWork uow(opCtx.get());
             auto newRecStatus = rs->updateWithDamages(opCtx.get(), loc, rec, data.c_str(), dv);
@@ -150,9 +153,11 @@ TEST(RecordStoreTestHarness, UpdateWithOverlappingDamageEvents) {
             dv[0].sourceOffset = 3;
             dv[0].targetOffset = 0;
             dv[0].size = 5;
+            dv[0].targetSize = 5;
             dv[1].sourceOffset = 0;
             dv[1].targetOffset = 3;
             dv[1].size = 5;
+            dv[1].targetSize = 5;
 
             WriteUnitOfWork uow(opCtx.get());
             auto newRecStatus = rs->updateWithDamages(opCtx.get(), loc, rec, data.c_str(), dv);
@@ -214,9 +219,11 @@ TEST(RecordStoreTestHarness, UpdateWithOverlappingDamageEventsReversed) {
             dv[0].sourceOffset = 0;
             dv[0].targetOffset = 3;
             dv[0].size = 5;
+            dv[0].targetSize = 5;
             dv[1].sourceOffset = 3;
             dv[1].targetOffset = 0;
             dv[1].size = 5;
+            dv[1].targetSize = 5;
 
             WriteUnitOfWork uow(opCtx.get());
             auto newRecStatus = rs->updateWithDamages(opCtx.get(), loc, rec, data.c_str(), dv);
@@ -290,5 +297,67 @@ TEST(RecordStoreTestHarness, UpdateWithNoDamages) {
     }
 }
 
+// Insert a record and try to perform an update that grows one part of it and shrinks another.
+TEST(RecordStoreTestHarness, UpdateWithDamagesChangingSize) {
+    const auto harnessHelper(newRecordStoreHarnessHelper());
+    unique_ptr<RecordStore> rs(harnessHelper->newNonCappedRecordStore());
+
+    if (!rs->updateWithDamagesSupported())
+        return;
+
+    string data = "00010111";
+    RecordId loc;
+    const RecordData rec(data.c_str(), data.size() + 1);
+    {
+        ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+        {
+            WriteUnitOfWork uow(opCtx.get());
+            StatusWith<RecordId> res =
+                rs->insertRecord(opCtx.get(), rec.data(), rec.size(), Timestamp());
+            ASSERT_OK(res.getStatus());
+            loc = res.getValue();
+            uow.commit();
+        }
+    }
+
+    string modifiedData = "101abc";
+    {
+        ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+        {
+            // Replace the trailing "11" with "abc", then remove the leading "000".
+            mutablebson::DamageVector dv(2);
+            dv[0].sourceOffset = 0;
+            dv[0].targetOffset = 6;
+            dv[0].size = 3;
+            dv[0].targetSize = 2;
+            dv[1].sourceOffset = 3;
+            dv[1].targetOffset = 0;
+            dv[1].size = 0;
+            dv[1].targetSize = 3;
+
+            const auto oldDataSize = rs->dataSize(opCtx.get());
+            WriteUnitOfWork uow(opCtx.get());
+            auto newRecStatus = rs->updateWithDamages(opCtx.get(), loc, rec, "abc", dv);
+            ASSERT_OK(newRecStatus.getStatus());
+            ASSERT_EQUALS(modifiedData, newRecStatus.getValue().data());
+            ASSERT_EQUALS(static_cast<int>(modifiedData.size() + 1),
+                          newRecStatus.getValue().size());
+            uow.commit();
+
+            // The size of the record store follows the size of the record.
+            ASSERT_EQUALS(oldDataSize + newRecStatus.getValue().size() - rec.size(),
+                          rs->dataSize(opCtx.get()));
+        }
+    }
+
+    {
+        ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+        {
+            RecordData record = rs->dataFor(opCtx.get(), loc);
+            ASSERT_EQUALS(modifiedData, record.data());
+        }
+    }
+}
+
 }  // namespace
 }  // namespace mongo
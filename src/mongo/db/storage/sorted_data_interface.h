@@ -93,6 +93,31 @@ public:
                           const KeyString::Value& keyString,
                           bool dupsAllowed) = 0;
 
+    /**
+     * Insert the entries of 'keyStrings', each of which must have a RecordId appended to the end,
+     * in ascending order. Equivalent to calling insert() for every entry, but implementations may
+     * reuse the same cursor and the locality of the sorted entries for the whole batch.
+     *
+     * @param numInserted set to the number of entries inserted before any failure
+     *
+     * @return Status::OK() if every insert succeeded, otherwise the error of the first one that
+     *         failed. The entries following it are not inserted.
+     */
+    virtual Status insertSorted(OperationContext* opCtx,
+                                const KeyStringSet& keyStrings,
+                                bool dupsAllowed,
+                                size_t* numInserted) {
+        *numInserted = 0;
+        for (const auto& keyString : keyStrings) {
+            Status status = insert(opCtx, keyString, dupsAllowed);
+            if (!status.isOK()) {
+                return status;
+            }
+            ++*numInserted;
+        }
+        return Status::OK();
+    }
+
     /**
      * Remove the entry from the index with the specified KeyString, which must have a RecordId
      * appended to the end.
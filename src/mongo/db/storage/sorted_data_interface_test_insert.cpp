@@ -717,5 +717,75 @@ TEST(SortedDataInterface, InsertReservedRecordId) {
     ASSERT_EQUALS(1, sorted->numEntries(opCtx.get()));
 }
 
+// Insert a sorted batch of keys and verify that they are all present in the index.
+TEST(SortedDataInterface, InsertSorted) {
+    const auto harnessHelper(newSortedDataInterfaceHarnessHelper());
+    const std::unique_ptr<SortedDataInterface> sorted(
+        harnessHelper->newSortedDataInterface(/*unique=*/false, /*partial=*/false));
+
+    KeyStringSet keyStrings{makeKeyString(sorted.get(), key1, loc1),
+                            makeKeyString(sorted.get(), key1, loc2),
+                            makeKeyString(sorted.get(), key2, loc3)};
+
+    {
+        const ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+        {
+            WriteUnitOfWork uow(opCtx.get());
+            size_t numInserted;
+            ASSERT_OK(sorted->insertSorted(opCtx.get(), keyStrings, true, &numInserted));
+            ASSERT_EQUALS(3U, numInserted);
+            uow.commit();
+        }
+    }
+
+    {
+        const ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+        ASSERT_EQUALS(3, sorted->numEntries(opCtx.get()));
+
+        const std::unique_ptr<SortedDataInterface::Cursor> cursor(sorted->newCursor(opCtx.get()));
+        ASSERT_EQ(cursor->seek(makeKeyStringForSeek(sorted.get(), key1, true, true)),
+                  IndexKeyEntry(key1, loc1));
+        ASSERT_EQ(cursor->next(), IndexKeyEntry(key1, loc2));
+        ASSERT_EQ(cursor->next(), IndexKeyEntry(key2, loc3));
+    }
+}
+
+// Insert a sorted batch of keys into a unique index that already holds one of them, and verify
+// that the batch stops at the duplicate.
+TEST(SortedDataInterface, InsertSortedStopsAtDuplicateKey) {
+    const auto harnessHelper(newSortedDataInterfaceHarnessHelper());
+    const std::unique_ptr<SortedDataInterface> sorted(
+        harnessHelper->newSortedDataInterface(/*unique=*/true, /*partial=*/false));
+
+    {
+        const ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+        {
+            WriteUnitOfWork uow(opCtx.get());
+            ASSERT_OK(sorted->insert(opCtx.get(), makeKeyString(sorted.get(), key2, loc1), false));
+            uow.commit();
+        }
+    }
+
+    KeyStringSet keyStrings{makeKeyString(sorted.get(), key1, loc2),
+                            makeKeyString(sorted.get(), key2, loc3),
+                            makeKeyString(sorted.get(), key3, loc4)};
+
+    {
+        const ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+        {
+            WriteUnitOfWork uow(opCtx.get());
+            size_t numInserted;
+            ASSERT_EQUALS(ErrorCodes::DuplicateKey,
+                          sorted->insertSorted(opCtx.get(), keyStrings, false, &numInserted));
+            ASSERT_EQUALS(1U, numInserted);
+        }
+    }
+
+    {
+        const ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+        ASSERT_EQUALS(1, sorted->numEntries(opCtx.get()));
+    }
+}
+
 }  // namespace
 }  // namespace mongo
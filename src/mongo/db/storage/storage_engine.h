@@ -635,6 +635,14 @@ public:
      */
     virtual Timestamp getAllDurableTimestamp() const = 0;
 
+    /**
+     * Returns true if the storage engine's cache is under enough pressure that optional background
+     * work, such as TTL deletion, should back off. Engines without a cache never are.
+     */
+    virtual bool isCacheUnderPressure() const {
+        return false;
+    }
+
     /**
      * Returns the minimum possible Timestamp value in the oplog that replication may need for
      * recovery in the event of a crash.
@@ -1054,6 +1054,10 @@ Timestamp StorageEngineImpl::getAllDurableTimestamp() const {
     return _engine->getAllDurableTimestamp();
 }
 
+bool StorageEngineImpl::isCacheUnderPressure() const {
+    return _engine->isCacheUnderPressure();
+}
+
 boost::optional<Timestamp> StorageEngineImpl::getOplogNeededForCrashRecovery() const {
     return _engine->getOplogNeededForCrashRecovery();
 }
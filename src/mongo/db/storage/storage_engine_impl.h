@@ -151,6 +151,8 @@ public:
 
     virtual Timestamp getAllDurableTimestamp() const override;
 
+    bool isCacheUnderPressure() const final;
+
     boost::optional<Timestamp> getOplogNeededForCrashRecovery() const final;
 
     bool supportsClusteredIdIndex() const final;
@@ -0,0 +1,135 @@
+/**
+ *    Copyright (C) 2021-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#define MONGO_LOGV2_DEFAULT_COMPONENT ::mongo::logv2::LogComponent::kStorage
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/storage/ticket_concurrency_controller.h"
+
+#include <algorithm>
+
+#include "mongo/logv2/log.h"
+
+namespace mongo {
+
+TicketConcurrencyController::TicketConcurrencyController(TicketHolder* holder)
+    : _holder(holder), _lastNumReleased(holder->numReleased()) {}
+
+void TicketConcurrencyController::sample() {
+    const int used = _holder->used();
+    const bool saturated = _holder->available() == 0;
+
+    stdx::lock_guard<Latch> lk(_mutex);
+    ++_numSamples;
+    _sumUsed += used;
+    if (saturated) {
+        ++_numSaturatedSamples;
+    }
+}
+
+int TicketConcurrencyController::adjust(const Options& options, Milliseconds elapsed) {
+    stdx::lock_guard<Latch> lk(_mutex);
+
+    const int current = _holder->outof();
+    int target = current;
+
+    const long long numReleased = _holder->numReleased();
+    const long long released = numReleased - _lastNumReleased;
+    _lastNumReleased = numReleased;
+
+    if (_numSamples > 0 && elapsed > Milliseconds(0)) {
+        const double throughput = released * 1000.0 / durationCount<Milliseconds>(elapsed);
+        const double avgUsed = static_cast<double>(_sumUsed) / _numSamples;
+        const bool saturated = _numSaturatedSamples >= options.saturatedFraction * _numSamples;
+
+        if (saturated && _lastChange > 0 &&
+            throughput < _lastThroughput * (1 + options.minThroughputGain)) {
+            target = static_cast<int>(current * options.decreaseFactor);
+        } else if (saturated) {
+            target = current + options.increment;
+        }
+
+        _lastThroughput = throughput;
+        _lastLatencyMicros = throughput > 0 ? avgUsed / throughput * 1000 * 1000 : 0;
+    }
+
+    // The bounds may have changed, so apply them even when there was nothing to learn.
+    target = std::max(options.minTickets, std::min(options.maxTickets, target));
+    _numSamples = 0;
+    _numSaturatedSamples = 0;
+    _sumUsed = 0;
+    _lastChange = 0;
+
+    if (target == current) {
+        return current;
+    }
+
+    // Resizing does not wait for tickets in use to be returned, so it can be done while holding
+    // the mutex, which keeps concurrent adjustments from interleaving.
+    auto status = _holder->resize(target);
+    if (!status.isOK()) {
+        LOGV2_WARNING(5400302,
+                      "Failed to adjust the number of tickets",
+                      "from"_attr = current,
+                      "to"_attr = target,
+                      "error"_attr = status);
+        return current;
+    }
+
+    _lastChange = target - current;
+    if (_lastChange > 0) {
+        ++_numIncreases;
+    } else {
+        ++_numDecreases;
+    }
+    return target;
+}
+
+void TicketConcurrencyController::reset() {
+    stdx::lock_guard<Latch> lk(_mutex);
+    _numSamples = 0;
+    _numSaturatedSamples = 0;
+    _sumUsed = 0;
+    _lastNumReleased = _holder->numReleased();
+    _lastThroughput = 0;
+    _lastLatencyMicros = 0;
+    _lastChange = 0;
+}
+
+void TicketConcurrencyController::appendStats(BSONObjBuilder& b) const {
+    stdx::lock_guard<Latch> lk(_mutex);
+    b.append("throughputPerSec", _lastThroughput);
+    b.append("avgTicketHeldMicros", _lastLatencyMicros);
+    b.append("lastChange", _lastChange);
+    b.append("increases", _numIncreases);
+    b.append("decreases", _numDecreases);
+}
+
+}  // namespace mongo
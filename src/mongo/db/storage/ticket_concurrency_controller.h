@@ -0,0 +1,117 @@
+/**
+ *    Copyright (C) 2021-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/platform/mutex.h"
+#include "mongo/util/concurrency/ticketholder.h"
+#include "mongo/util/duration.h"
+
+namespace mongo {
+
+/**
+ * Searches for the number of tickets of a TicketHolder at which the operations it admits achieve
+ * the most throughput, instead of relying on a hand-tuned static size.
+ *
+ * Between adjustments the controller periodically samples how many tickets are in use. At each
+ * adjustment it derives the throughput from the number of tickets released and, using Little's
+ * law, the average time a ticket is held. If the holder ran out of tickets for most of the
+ * interval, more concurrency might help, and the controller probes with an additive increase.
+ * When an increase did not buy a meaningful gain in throughput, the extra concurrency only added
+ * contention and the size is cut multiplicatively. An interval in which the holder was not
+ * saturated gives no signal and leaves the size alone.
+ *
+ * The holder may still be resized by others; the controller continues from whatever size it
+ * finds.
+ */
+class TicketConcurrencyController {
+    TicketConcurrencyController(const TicketConcurrencyController&) = delete;
+    TicketConcurrencyController& operator=(const TicketConcurrencyController&) = delete;
+
+public:
+    struct Options {
+        int minTickets = 16;
+        int maxTickets = 512;
+
+        // Tickets added when probing for more throughput.
+        int increment = 8;
+
+        // Factor applied to the number of tickets when an increase did not pay off.
+        double decreaseFactor = 0.9;
+
+        // Relative throughput gain below which an increase is considered not to have paid off.
+        double minThroughputGain = 0.02;
+
+        // Fraction of the samples which must have found no ticket available for the holder to be
+        // considered saturated.
+        double saturatedFraction = 0.5;
+    };
+
+    explicit TicketConcurrencyController(TicketHolder* holder);
+
+    /**
+     * Records how many tickets are in use right now.
+     */
+    void sample();
+
+    /**
+     * Resizes the holder based on the samples taken since the previous adjustment. 'elapsed' is the
+     * time since the previous adjustment. Returns the new number of tickets.
+     */
+    int adjust(const Options& options, Milliseconds elapsed);
+
+    /**
+     * Forgets the samples and the outcome of the previous adjustment, for instance after the
+     * controller has been disabled for a while.
+     */
+    void reset();
+
+    void appendStats(BSONObjBuilder& b) const;
+
+private:
+    TicketHolder* const _holder;
+
+    mutable Mutex _mutex = MONGO_MAKE_LATCH("TicketConcurrencyController::_mutex");
+
+    // Samples since the previous adjustment.
+    int _numSamples = 0;
+    int _numSaturatedSamples = 0;
+    long long _sumUsed = 0;
+
+    long long _lastNumReleased = 0;
+    double _lastThroughput = 0;
+    double _lastLatencyMicros = 0;
+    int _lastChange = 0;
+
+    long long _numIncreases = 0;
+    long long _numDecreases = 0;
+};
+
+}  // namespace mongo
@@ -0,0 +1,129 @@
+/**
+ *    Copyright (C) 2021-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/storage/ticket_concurrency_controller.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+class TicketConcurrencyControllerTest : public unittest::Test {
+public:
+    TicketConcurrencyControllerTest() : _holder(32), _controller(&_holder) {
+        _options.minTickets = 8;
+        _options.maxTickets = 64;
+        _options.increment = 8;
+        _options.decreaseFactor = 0.5;
+    }
+
+    /**
+     * Simulates an interval in which 'numCompleted' operations returned their tickets and, if
+     * 'saturated', all tickets were in use whenever the controller looked. Returns the new number
+     * of tickets.
+     */
+    int runInterval(int numCompleted, bool saturated) {
+        if (saturated) {
+            while (_holder.tryAcquire()) {
+                ++_numHeld;
+            }
+        } else {
+            for (; _numHeld > 0; --_numHeld) {
+                _holder.release();
+            }
+        }
+
+        for (int i = 0; i < numCompleted; ++i) {
+            if (saturated) {
+                // Hand the ticket straight to the next operation, unless the holder shrank.
+                _holder.release();
+                --_numHeld;
+                if (_holder.tryAcquire()) {
+                    ++_numHeld;
+                }
+            } else {
+                ASSERT(_holder.tryAcquire());
+                _holder.release();
+            }
+        }
+
+        for (int i = 0; i < 10; ++i) {
+            _controller.sample();
+        }
+        return _controller.adjust(_options, Seconds(1));
+    }
+
+protected:
+    PriorityTicketHolder _holder;
+    TicketConcurrencyController _controller;
+    TicketConcurrencyController::Options _options;
+    int _numHeld = 0;
+};
+
+TEST_F(TicketConcurrencyControllerTest, LeavesUnsaturatedHolderAlone) {
+    ASSERT_EQ(runInterval(1000, false), 32);
+    ASSERT_EQ(runInterval(2000, false), 32);
+    ASSERT_EQ(_holder.outof(), 32);
+}
+
+TEST_F(TicketConcurrencyControllerTest, KeepsIncreasingWhileThroughputImproves) {
+    ASSERT_EQ(runInterval(1000, true), 40);
+    ASSERT_EQ(runInterval(1500, true), 48);
+    ASSERT_EQ(runInterval(2000, true), 56);
+    ASSERT_EQ(_holder.outof(), 56);
+}
+
+TEST_F(TicketConcurrencyControllerTest, BacksOffWhenIncreaseDoesNotPayOff) {
+    ASSERT_EQ(runInterval(1000, true), 40);
+    ASSERT_EQ(runInterval(1000, true), 20);
+
+    // After backing off the controller probes upwards again.
+    ASSERT_EQ(runInterval(1000, true), 28);
+
+    BSONObjBuilder b;
+    _controller.appendStats(b);
+    auto stats = b.obj();
+    ASSERT_EQ(stats["increases"].numberLong(), 2);
+    ASSERT_EQ(stats["decreases"].numberLong(), 1);
+    ASSERT_EQ(stats["throughputPerSec"].numberDouble(), 1000.0);
+}
+
+TEST_F(TicketConcurrencyControllerTest, StaysWithinBounds) {
+    _options.maxTickets = 36;
+    ASSERT_EQ(runInterval(1000, true), 36);
+    ASSERT_EQ(runInterval(2000, true), 36);
+
+    _options.minTickets = 48;
+    _options.maxTickets = 64;
+    ASSERT_EQ(runInterval(0, false), 48);
+}
+
+}  // namespace
+}  // namespace mongo
@@ -287,6 +287,31 @@ Status WiredTigerIndex::insert(OperationContext* opCtx,
     return _insert(opCtx, c, keyString, dupsAllowed);
 }
 
+Status WiredTigerIndex::insertSorted(OperationContext* opCtx,
+                                     const KeyStringSet& keyStrings,
+                                     bool dupsAllowed,
+                                     size_t* numInserted) {
+    dassert(opCtx->lockState()->isWriteLocked());
+    *numInserted = 0;
+
+    // Insert the whole batch through one cursor rather than opening a cursor per key.
+    WiredTigerCursor curwrap(_uri, _tableId, false, opCtx);
+    curwrap.assertInActiveTxn();
+    WT_CURSOR* c = curwrap.get();
+
+    for (const auto& keyString : keyStrings) {
+        dassertRecordIdAtEnd(keyString, _rsKeyFormat);
+        LOGV2_TRACE_INDEX(5411300, "KeyString: {keyString}", "keyString"_attr = keyString);
+
+        Status status = _insert(opCtx, c, keyString, dupsAllowed);
+        if (!status.isOK()) {
+            return status;
+        }
+        ++*numInserted;
+    }
+    return Status::OK();
+}
+
 void WiredTigerIndex::unindex(OperationContext* opCtx,
                               const KeyString::Value& keyString,
                               bool dupsAllowed) {
@@ -103,6 +103,11 @@ public:
                           const KeyString::Value& keyString,
                           bool dupsAllowed);
 
+    virtual Status insertSorted(OperationContext* opCtx,
+                                const KeyStringSet& keyStrings,
+                                bool dupsAllowed,
+                                size_t* numInserted);
+
     virtual void unindex(OperationContext* opCtx,
                          const KeyString::Value& keyString,
                          bool dupsAllowed);
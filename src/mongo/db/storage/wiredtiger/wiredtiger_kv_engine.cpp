@@ -76,6 +76,7 @@
 #include "mongo/db/storage/storage_options.h"
 #include "mongo/db/storage/storage_parameters_gen.h"
 #include "mongo/db/storage/storage_repair_observer.h"
+#include "mongo/db/storage/ticket_concurrency_controller.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_cursor.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_customization_hooks.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_extensions.h"
@@ -257,17 +258,54 @@ std::string toString(const StorageEngine::OldestActiveTransactionTimestampResult
 }
 
 namespace {
-TicketHolder openWriteTransaction(128);
-TicketHolder openReadTransaction(128);
+SemaphoreTicketHolder openWriteTransaction(128);
+SemaphoreTicketHolder openReadTransaction(128);
+
+// Used instead of the holders above when wiredTigerPrioritizedTicketAdmission is set. That is only
+// known once startup parameters have been parsed, so both kinds are kept the same size.
+PriorityTicketHolder prioritizedOpenWriteTransaction(128);
+PriorityTicketHolder prioritizedOpenReadTransaction(128);
+
+// Adaptive sizing of the holders in use, set up once the engine knows which ones those are.
+std::unique_ptr<TicketConcurrencyController> readTicketController;
+std::unique_ptr<TicketConcurrencyController> writeTicketController;
+
+TicketHolder* writeTickets() {
+    return gWiredTigerPrioritizedTicketAdmission
+        ? static_cast<TicketHolder*>(&prioritizedOpenWriteTransaction)
+        : &openWriteTransaction;
+}
+
+TicketHolder* readTickets() {
+    return gWiredTigerPrioritizedTicketAdmission
+        ? static_cast<TicketHolder*>(&prioritizedOpenReadTransaction)
+        : &openReadTransaction;
+}
+
+Status setTicketBudgetPercent(AdmissionPriority priority, int percent) {
+    auto status = prioritizedOpenWriteTransaction.setBudgetPercent(priority, percent);
+    if (!status.isOK()) {
+        return status;
+    }
+    return prioritizedOpenReadTransaction.setBudgetPercent(priority, percent);
+}
 }  // namespace
 
+Status onUpdateInteractiveTicketBudgetPercent(const int& percent) {
+    return setTicketBudgetPercent(AdmissionPriority::kInteractive, percent);
+}
+
+Status onUpdateBatchTicketBudgetPercent(const int& percent) {
+    return setTicketBudgetPercent(AdmissionPriority::kBatch, percent);
+}
+
 OpenWriteTransactionParam::OpenWriteTransactionParam(StringData name, ServerParameterType spt)
     : ServerParameter(name, spt), _data(&openWriteTransaction) {}
 
 void OpenWriteTransactionParam::append(OperationContext* opCtx,
                                        BSONObjBuilder& b,
                                        const std::string& name) {
-    b.append(name, _data->outof());
+    b.append(name, writeTickets()->outof());
 }
 
 Status OpenWriteTransactionParam::setFromString(const std::string& str) {
@@ -279,7 +317,11 @@ Status OpenWriteTransactionParam::setFromString(const std::string& str) {
     if (num <= 0) {
         return {ErrorCodes::BadValue, str::stream() << name() << " has to be > 0"};
     }
-    return _data->resize(num);
+    status = _data->resize(num);
+    if (!status.isOK()) {
+        return status;
+    }
+    return prioritizedOpenWriteTransaction.resize(num);
 }
 
 OpenReadTransactionParam::OpenReadTransactionParam(StringData name, ServerParameterType spt)
@@ -288,7 +330,7 @@ OpenReadTransactionParam::OpenReadTransactionParam(StringData name, ServerParame
 void OpenReadTransactionParam::append(OperationContext* opCtx,
                                       BSONObjBuilder& b,
                                       const std::string& name) {
-    b.append(name, _data->outof());
+    b.append(name, readTickets()->outof());
 }
 
 Status OpenReadTransactionParam::setFromString(const std::string& str) {
@@ -300,7 +342,11 @@ Status OpenReadTransactionParam::setFromString(const std::string& str) {
     if (num <= 0) {
         return {ErrorCodes::BadValue, str::stream() << name() << " has to be > 0"};
     }
-    return _data->resize(num);
+    status = _data->resize(num);
+    if (!status.isOK()) {
+        return status;
+    }
+    return prioritizedOpenReadTransaction.resize(num);
 }
 
 StringData WiredTigerKVEngine::kTableUriPrefix = "table:"_sd;
@@ -569,7 +615,18 @@ WiredTigerKVEngine::WiredTigerKVEngine(const std::string& canonicalName,
 
     _sizeStorer = std::make_unique<WiredTigerSizeStorer>(_conn, _sizeStorerUri, _readOnly);
 
-    Locker::setGlobalThrottling(&openReadTransaction, &openWriteTransaction);
+    if (gWiredTigerPrioritizedTicketAdmission) {
+        // Budgets set at startup were already applied, but defaults never go through on_update.
+        fassert(5400300,
+                setTicketBudgetPercent(AdmissionPriority::kInteractive,
+                                       gWiredTigerInteractiveTicketBudgetPercent.load()));
+        fassert(5400301,
+                setTicketBudgetPercent(AdmissionPriority::kBatch,
+                                       gWiredTigerBatchTicketBudgetPercent.load()));
+    }
+    Locker::setGlobalThrottling(readTickets(), writeTickets());
+    readTicketController = std::make_unique<TicketConcurrencyController>(readTickets());
+    writeTicketController = std::make_unique<TicketConcurrencyController>(writeTickets());
 
     _runTimeConfigParam.reset(new WiredTigerEngineRuntimeConfigParameter(
         "wiredTigerEngineRuntimeConfig", ServerParameterType::kRuntimeOnly));
@@ -589,22 +646,73 @@ WiredTigerKVEngine::~WiredTigerKVEngine() {
 void WiredTigerKVEngine::notifyStartupComplete() {
     unpinOldestTimestamp(kPinOldestTimestampAtStartupName);
     WiredTigerUtil::notifyStartupComplete();
+
+    // Not every process that runs the storage engine, such as some unit tests, has a periodic
+    // runner.
+    if (auto periodicRunner = getGlobalServiceContext()->getPeriodicRunner()) {
+        _ticketControllerJob = periodicRunner->makeJob(
+            {"WTTicketConcurrencyController",
+             [this](Client*) { _adjustTicketConcurrency(); },
+             Milliseconds(100)});
+        _ticketControllerJob.start();
+    }
+}
+
+void WiredTigerKVEngine::_adjustTicketConcurrency() {
+    if (!gWiredTigerAdaptiveTicketConcurrency.load()) {
+        _ticketControllersActive = false;
+        return;
+    }
+
+    const auto now = Date_t::now();
+    if (!_ticketControllersActive) {
+        // Whatever happened while disabled says nothing about the current ticket sizes.
+        readTicketController->reset();
+        writeTicketController->reset();
+        _lastTicketAdjustment = now;
+        _ticketControllersActive = true;
+    }
+
+    readTicketController->sample();
+    writeTicketController->sample();
+
+    const auto elapsed = now - _lastTicketAdjustment;
+    if (elapsed < Milliseconds(gWiredTigerAdaptiveTicketIntervalMillis.load())) {
+        return;
+    }
+
+    TicketConcurrencyController::Options options;
+    options.minTickets = gWiredTigerAdaptiveTicketMinimum.load();
+    options.maxTickets = std::max(options.minTickets, gWiredTigerAdaptiveTicketMaximum.load());
+    readTicketController->adjust(options, elapsed);
+    writeTicketController->adjust(options, elapsed);
+    _lastTicketAdjustment = now;
 }
 
 void WiredTigerKVEngine::appendGlobalStats(BSONObjBuilder& b) {
     BSONObjBuilder bb(b.subobjStart("concurrentTransactions"));
     {
         BSONObjBuilder bbb(bb.subobjStart("write"));
-        bbb.append("out", openWriteTransaction.used());
-        bbb.append("available", openWriteTransaction.available());
-        bbb.append("totalTickets", openWriteTransaction.outof());
+        bbb.append("out", writeTickets()->used());
+        bbb.append("available", writeTickets()->available());
+        bbb.append("totalTickets", writeTickets()->outof());
+        writeTickets()->appendStats(bbb);
+        if (gWiredTigerAdaptiveTicketConcurrency.load() && writeTicketController) {
+            BSONObjBuilder adaptive(bbb.subobjStart("adaptive"));
+            writeTicketController->appendStats(adaptive);
+        }
         bbb.done();
     }
     {
         BSONObjBuilder bbb(bb.subobjStart("read"));
-        bbb.append("out", openReadTransaction.used());
-        bbb.append("available", openReadTransaction.available());
-        bbb.append("totalTickets", openReadTransaction.outof());
+        bbb.append("out", readTickets()->used());
+        bbb.append("available", readTickets()->available());
+        bbb.append("totalTickets", readTickets()->outof());
+        readTickets()->appendStats(bbb);
+        if (gWiredTigerAdaptiveTicketConcurrency.load() && readTicketController) {
+            BSONObjBuilder adaptive(bbb.subobjStart("adaptive"));
+            readTicketController->appendStats(adaptive);
+        }
         bbb.done();
     }
     bb.done();
@@ -702,6 +810,9 @@ void WiredTigerKVEngine::_openWiredTiger(const std::string& path, const std::str
 
 void WiredTigerKVEngine::cleanShutdown() {
     LOGV2(22317, "WiredTigerKVEngine shutting down");
+    if (_ticketControllerJob) {
+        _ticketControllerJob.stop();
+    }
     WiredTigerUtil::resetTableLoggingInfo();
 
     if (!_readOnly)
@@ -2244,6 +2355,26 @@ Timestamp WiredTigerKVEngine::getAllDurableTimestamp() const {
     return Timestamp(ret);
 }
 
+bool WiredTigerKVEngine::isCacheUnderPressure() const {
+    WiredTigerSession session(_conn);
+    auto getStat = [&](int key) -> int64_t {
+        auto swValue = WiredTigerUtil::getStatisticsValue(
+            session.getSession(), "statistics:", "statistics=(fast)", key);
+        return swValue.isOK() ? swValue.getValue() : 0;
+    };
+
+    const auto maxBytes = getStat(WT_STAT_CONN_CACHE_BYTES_MAX);
+    if (maxBytes <= 0) {
+        return false;
+    }
+
+    // Halfway between WiredTiger's default eviction targets, where background eviction starts,
+    // and its eviction triggers, where application threads are pulled into eviction.
+    const auto dirtyBytes = getStat(WT_STAT_CONN_CACHE_BYTES_DIRTY);
+    const auto usedBytes = getStat(WT_STAT_CONN_CACHE_BYTES_INUSE);
+    return dirtyBytes * 8 >= maxBytes || usedBytes * 8 >= maxBytes * 7;
+}
+
 boost::optional<Timestamp> WiredTigerKVEngine::getRecoveryTimestamp() const {
     if (!supportsRecoveryTimestamp()) {
         LOGV2_FATAL(50745,
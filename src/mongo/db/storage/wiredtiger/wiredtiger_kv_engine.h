@@ -48,6 +48,7 @@
 #include "mongo/platform/mutex.h"
 #include "mongo/util/concurrency/with_lock.h"
 #include "mongo/util/elapsed_tracker.h"
+#include "mongo/util/periodic_runner.h"
 
 namespace mongo {
 
@@ -58,6 +59,9 @@ class WiredTigerSessionCache;
 class WiredTigerSizeStorer;
 class WiredTigerEngineRuntimeConfigParameter;
 
+Status onUpdateInteractiveTicketBudgetPercent(const int& percent);
+Status onUpdateBatchTicketBudgetPercent(const int& percent);
+
 struct WiredTigerFileVersion {
     // MongoDB 4.4+ will not open on datafiles left behind by 4.2.5 and earlier. MongoDB 4.4
     // shutting down in FCV 4.2 will leave data files that 4.2.6+ will understand
@@ -258,6 +262,8 @@ public:
 
     Timestamp getAllDurableTimestamp() const override;
 
+    bool isCacheUnderPressure() const override;
+
     bool supportsClusteredIdIndex() const final override {
         return true;
     }
@@ -389,6 +395,12 @@ private:
     Status _salvageIfNeeded(const char* uri);
     void _ensureIdentPath(StringData ident);
 
+    /**
+     * Run periodically to sample the read and write ticket holders and, once per adjustment
+     * interval, let their controllers resize them.
+     */
+    void _adjustTicketConcurrency();
+
     /**
      * Recreates a WiredTiger ident from the provided URI by dropping and recreating the ident.
      * This moves aside the existing data file, if one exists, with an added ".corrupt" suffix.
@@ -465,6 +477,11 @@ private:
 
     std::unique_ptr<WiredTigerSessionSweeper> _sessionSweeper;
 
+    // Drives the adaptive sizing of the read and write ticket holders.
+    PeriodicJobAnchor _ticketControllerJob;
+    bool _ticketControllersActive = false;
+    Date_t _lastTicketAdjustment;
+
     std::string _rsOptions;
     std::string _indexOptions;
 
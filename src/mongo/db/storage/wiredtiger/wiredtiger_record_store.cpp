@@ -38,6 +38,7 @@
 
 #include "mongo/db/storage/wiredtiger/wiredtiger_record_store.h"
 
+#include <algorithm>
 #include <memory>
 
 #include "mongo/base/checked_cast.h"
@@ -1815,6 +1816,27 @@ StatusWith<RecordData> WiredTigerRecordStore::updateWithDamages(
     const char* damageSource,
     const mutablebson::DamageVector& damages) {
 
+    // Damages which change the size of the record cannot be applied to the oplog, and logged tables
+    // must not use WT_CURSOR::modify, as WiredTiger's recovery is not trusted with operations that
+    // are not idempotent. Apply the damages to a copy of the record and rewrite it instead.
+    const bool changesSize = std::any_of(damages.begin(), damages.end(), [](const auto& damage) {
+        return damage.size != damage.targetSize;
+    });
+    if (_isLogged || (_oplogStones && changesSize)) {
+        std::string data(oldRec.data(), oldRec.size());
+        for (const auto& damage : damages) {
+            data.replace(damage.targetOffset,
+                         damage.targetSize,
+                         damageSource + damage.sourceOffset,
+                         damage.size);
+        }
+        auto status = updateRecord(opCtx, id, data.data(), data.size());
+        if (!status.isOK()) {
+            return status;
+        }
+        return RecordData(data.data(), data.size()).getOwned();
+    }
+
     const int nentries = damages.size();
     mutablebson::DamageVector::const_iterator where = damages.begin();
     const mutablebson::DamageVector::const_iterator end = damages.cend();
@@ -1824,7 +1846,7 @@ StatusWith<RecordData> WiredTigerRecordStore::updateWithDamages(
         entries[i].data.data = damageSource + where->sourceOffset;
         entries[i].data.size = where->size;
         entries[i].offset = where->targetOffset;
-        entries[i].size = where->size;
+        entries[i].size = where->targetSize;
         // Account for both the amount of old data we are overwriting (size) and new data we are
         // inserting (data.size).
         modifiedDataSize += entries[i].size;
@@ -1849,8 +1871,14 @@ StatusWith<RecordData> WiredTigerRecordStore::updateWithDamages(
 
     WT_ITEM value;
     invariantWTOK(c->get_value(c, &value));
+    auto newRec = RecordData(static_cast<const char*>(value.data), value.size).getOwned();
 
-    return RecordData(static_cast<const char*>(value.data), value.size).getOwned();
+    _increaseDataSize(opCtx, newRec.size() - oldRec.size());
+    if (!_oplogStones) {
+        _cappedDeleteAsNeeded(opCtx, id);
+    }
+
+    return newRec;
 }
 
 std::unique_ptr<RecordCursor> WiredTigerRecordStore::getRandomCursor(
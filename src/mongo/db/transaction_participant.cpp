@@ -1105,6 +1105,9 @@ void TransactionParticipant::Participant::refreshLocksForPreparedTransaction(
 
 Timestamp TransactionParticipant::Participant::prepareTransaction(
     OperationContext* opCtx, boost::optional<repl::OpTime> prepareOptime) {
+    uassert(5411700,
+            "Cannot prepare a transaction which has buffered writes that were not applied",
+            !hasBufferedInserts());
 
     auto abortGuard = makeGuard([&] {
         // Prepare transaction on secondaries should always succeed.
@@ -1284,7 +1287,7 @@ TxnResponseMetadata TransactionParticipant::Participant::getResponseMetadata() {
     // Currently the response metadata only contains a single field, which is whether or not the
     // transaction is read-only so far.
     return {o().txnState.isInSet(TransactionState::kInProgress) &&
-            p().transactionOperations.empty()};
+            p().transactionOperations.empty() && p().bufferedInserts.empty()};
 }
 
 void TransactionParticipant::Participant::clearOperationsInMemory(OperationContext* opCtx) {
@@ -1295,12 +1298,43 @@ void TransactionParticipant::Participant::clearOperationsInMemory(OperationConte
     p().transactionOperationBytes = 0;
     p().transactionOperations.clear();
     p().numberOfPreImagesToWrite = 0;
+    p().bufferedInserts.clear();
+    p().bufferedInsertBytes = 0;
+}
+
+size_t TransactionParticipant::Participant::bufferInserts(const NamespaceString& nss,
+                                                          std::vector<InsertStatement> stmts) {
+    invariant(o().txnState.isInProgress(), str::stream() << "Current state: " << o().txnState);
+    invariant(p().autoCommit && !*p().autoCommit && o().activeTxnNumber != kUninitializedTxnNumber);
+
+    auto& bufferedInserts = p().bufferedInserts;
+    if (bufferedInserts.empty() || bufferedInserts.back().first != nss) {
+        bufferedInserts.emplace_back(nss, std::vector<InsertStatement>{});
+    }
+
+    // The documents outlive the command which inserted them, so they must not point into its
+    // request buffer.
+    auto& buffered = bufferedInserts.back().second;
+    for (auto& stmt : stmts) {
+        stmt.doc = stmt.doc.getOwned();
+        p().bufferedInsertBytes += stmt.doc.objsize();
+        buffered.push_back(std::move(stmt));
+    }
+    return p().bufferedInsertBytes;
+}
+
+TransactionParticipant::BufferedInserts TransactionParticipant::Participant::takeBufferedInserts() {
+    p().bufferedInsertBytes = 0;
+    return std::exchange(p().bufferedInserts, {});
 }
 
 void TransactionParticipant::Participant::commitUnpreparedTransaction(OperationContext* opCtx) {
     uassert(ErrorCodes::InvalidOptions,
             "commitTransaction must provide commitTimestamp to prepared transaction.",
             !o().txnState.isPrepared());
+    uassert(5411701,
+            "Cannot commit a transaction which has buffered writes that were not applied",
+            !hasBufferedInserts());
 
     auto txnOps = retrieveCompletedTransactionOperations(opCtx);
     auto opObserver = opCtx->getServiceContext()->getOpObserver();
@@ -2300,6 +2334,8 @@ void TransactionParticipant::Participant::_resetTransactionState(
 
     p().transactionOperationBytes = 0;
     p().transactionOperations.clear();
+    p().bufferedInserts.clear();
+    p().bufferedInsertBytes = 0;
     o(wl).prepareOpTime = repl::OpTime();
     o(wl).recoveryPrepareOpTime = repl::OpTime();
     p().autoCommit = boost::none;
@@ -167,6 +167,11 @@ class TransactionParticipant {
 public:
     static inline MutableObserverRegistry<int32_t> observeTransactionLifetimeLimitSeconds;
 
+    // Inserts of a multi-document transaction which have been buffered rather than applied, in
+    // statement order. Consecutive inserts into the same namespace share an entry. See
+    // 'Participant::bufferInserts'.
+    using BufferedInserts = std::vector<std::pair<NamespaceString, std::vector<InsertStatement>>>;
+
     TransactionParticipant();
 
     TransactionParticipant(const TransactionParticipant&) = delete;
@@ -530,6 +535,28 @@ public:
          */
         void clearOperationsInMemory(OperationContext* opCtx);
 
+        /**
+         * Adds 'stmts' to the write set of inserts into 'nss' which are buffered for the current
+         * multi-document transaction instead of being applied to storage right away. The write set
+         * keeps its own copy of the documents and preserves the order in which they were buffered.
+         * Returns the total size in bytes of all the documents buffered so far. It is illegal to
+         * buffer writes when no multi-document transaction is in progress.
+         */
+        size_t bufferInserts(const NamespaceString& nss, std::vector<InsertStatement> stmts);
+
+        /**
+         * Removes and returns the inserts buffered for the current transaction, so that the caller
+         * can apply them.
+         */
+        BufferedInserts takeBufferedInserts();
+
+        /**
+         * Returns true if the current transaction has buffered inserts which have not been applied.
+         */
+        bool hasBufferedInserts() const {
+            return !p().bufferedInserts.empty();
+        }
+
         /**
          * Yield or reacquire locks for prepared transactions, used on replication state transition.
          */
@@ -963,6 +990,11 @@ private:
         // Number of operations that have pre-images to be written to noop oplog entries.
         size_t numberOfPreImagesToWrite{0};
 
+        // Inserts of the current multi-document transaction which have been buffered and not yet
+        // applied to storage, and the total size in bytes of their documents.
+        BufferedInserts bufferedInserts;
+        size_t bufferedInsertBytes{0};
+
         // The autocommit setting of this transaction. Should always be false for multi-statement
         // transaction. Currently only needed for diagnostics reporting.
         boost::optional<bool> autoCommit;
@@ -39,6 +39,7 @@
 #include "mongo/db/op_observer_noop.h"
 #include "mongo/db/op_observer_registry.h"
 #include "mongo/db/operation_context.h"
+#include "mongo/db/ops/write_ops_exec.h"
 #include "mongo/db/repl/mock_repl_coord_server_fixture.h"
 #include "mongo/db/repl/oplog.h"
 #include "mongo/db/repl/oplog_entry.h"
@@ -536,6 +537,157 @@ TEST_F(TxnParticipantTest, AbortClearsStoredStatements) {
     ASSERT_TRUE(txnParticipant.transactionIsAborted());
 }
 
+TEST_F(TxnParticipantTest, BufferedInsertsMustBeAppliedBeforeCommitAndAreClearedByAbort) {
+    auto sessionCheckout = checkOutSession();
+    auto txnParticipant = TransactionParticipant::get(opCtx());
+    txnParticipant.unstashTransactionResources(opCtx(), "insert");
+    ASSERT_TRUE(txnParticipant.getResponseMetadata().getReadOnly());
+
+    const auto doc = BSON("_id" << 1 << "TestValue" << 0);
+    std::vector<InsertStatement> stmts;
+    stmts.emplace_back(doc);
+    ASSERT_EQ(size_t(doc.objsize()), txnParticipant.bufferInserts(kNss, std::move(stmts)));
+    ASSERT_TRUE(txnParticipant.hasBufferedInserts());
+
+    // Buffered inserts are writes, even though no operation has been added to the transaction.
+    ASSERT_TRUE(txnParticipant.getTransactionOperationsForTest().empty());
+    ASSERT_FALSE(txnParticipant.getResponseMetadata().getReadOnly());
+
+    // The transaction cannot commit with writes which were never applied.
+    ASSERT_THROWS_CODE(
+        txnParticipant.commitUnpreparedTransaction(opCtx()), AssertionException, 5411701);
+
+    // The transaction machinery cannot store an empty locker.
+    { Lock::GlobalLock lk(opCtx(), MODE_IX, Date_t::now(), Lock::InterruptBehavior::kThrow); }
+    txnParticipant.stashTransactionResources(opCtx());
+    txnParticipant.abortTransaction(opCtx());
+    ASSERT_FALSE(txnParticipant.hasBufferedInserts());
+    ASSERT_TRUE(txnParticipant.transactionIsAborted());
+}
+
+/**
+ * Returns the _id of each document in 'kNss', in the order in which they were written.
+ */
+std::vector<int> readIdsInRecordOrder(OperationContext* opCtx) {
+    AutoGetCollectionForRead collection(opCtx, kNss);
+    std::vector<int> ids;
+    auto cursor = collection.getCollection()->getCursor(opCtx);
+    while (auto record = cursor->next()) {
+        ids.push_back(record->data.toBson()["_id"].numberInt());
+    }
+    return ids;
+}
+
+/**
+ * Buffers an insert of a document with the given _id whose data belongs to a temporary buffer
+ * which is gone by the time the insert is applied.
+ */
+void bufferInsertOfUnownedDoc(TransactionParticipant::Participant& txnParticipant, int id) {
+    const auto holder = BSON("doc" << BSON("_id" << id));
+    std::vector<InsertStatement> stmts;
+    stmts.emplace_back(holder["doc"].Obj());
+    ASSERT_FALSE(stmts.front().doc.isOwned());
+    txnParticipant.bufferInserts(kNss, std::move(stmts));
+}
+
+TEST_F(TxnParticipantTest, BufferedInsertsAreAppliedInStatementOrderBeforeCommit) {
+    auto sessionCheckout = checkOutSession();
+    auto txnParticipant = TransactionParticipant::get(opCtx());
+    txnParticipant.unstashTransactionResources(opCtx(), "insert");
+    for (int id : {3, 1, 2}) {
+        bufferInsertOfUnownedDoc(txnParticipant, id);
+    }
+    txnParticipant.stashTransactionResources(opCtx());
+
+    // The service entry point applies the buffered inserts before running commitTransaction.
+    txnParticipant.unstashTransactionResources(opCtx(), "commitTransaction");
+    write_ops_exec::flushBufferedTransactionWrites(opCtx());
+    ASSERT_FALSE(txnParticipant.hasBufferedInserts());
+    txnParticipant.commitUnpreparedTransaction(opCtx());
+    txnParticipant.stashTransactionResources(opCtx());
+    ASSERT_TRUE(txnParticipant.transactionIsCommitted());
+
+    runFunctionFromDifferentOpCtx([](OperationContext* newOpCtx) {
+        ASSERT(readIdsInRecordOrder(newOpCtx) == std::vector<int>({3, 1, 2}));
+    });
+}
+
+TEST_F(TxnParticipantTest, BufferedInsertsAreAppliedBeforePrepare) {
+    auto sessionCheckout = checkOutSession();
+    auto txnParticipant = TransactionParticipant::get(opCtx());
+    txnParticipant.unstashTransactionResources(opCtx(), "insert");
+    bufferInsertOfUnownedDoc(txnParticipant, 1);
+    bufferInsertOfUnownedDoc(txnParticipant, 2);
+    txnParticipant.stashTransactionResources(opCtx());
+
+    txnParticipant.unstashTransactionResources(opCtx(), "prepareTransaction");
+    ASSERT_THROWS_CODE(txnParticipant.prepareTransaction(opCtx(), {}), AssertionException, 5411700);
+    ASSERT_TRUE(txnParticipant.transactionIsInProgress());
+
+    // The service entry point applies the buffered inserts before running prepareTransaction.
+    write_ops_exec::flushBufferedTransactionWrites(opCtx());
+    const auto prepareTimestamp = txnParticipant.prepareTransaction(opCtx(), {});
+    const auto commitTS = Timestamp(prepareTimestamp.getSecs(), prepareTimestamp.getInc() + 1);
+    txnParticipant.commitPreparedTransaction(opCtx(), commitTS, {});
+    txnParticipant.stashTransactionResources(opCtx());
+    ASSERT_TRUE(txnParticipant.transactionIsCommitted());
+
+    runFunctionFromDifferentOpCtx([](OperationContext* newOpCtx) {
+        ASSERT(readIdsInRecordOrder(newOpCtx) == std::vector<int>({1, 2}));
+    });
+}
+
+TEST_F(TxnParticipantTest, BufferedInsertsAreAppliedBeforeAnInsertWhichIsNotBuffered) {
+    auto sessionCheckout = checkOutSession();
+    auto txnParticipant = TransactionParticipant::get(opCtx());
+    txnParticipant.unstashTransactionResources(opCtx(), "insert");
+    bufferInsertOfUnownedDoc(txnParticipant, 1);
+
+    // Inserts which bypass document validation are never buffered.
+    write_ops::Insert insertOp(kNss);
+    insertOp.getWriteCommandBase().setBypassDocumentValidation(true);
+    insertOp.setDocuments({BSON("_id" << 2)});
+    const auto result = write_ops_exec::performInserts(opCtx(), insertOp);
+    ASSERT_EQ(1U, result.results.size());
+    ASSERT_OK(result.results.front().getStatus());
+    ASSERT_FALSE(txnParticipant.hasBufferedInserts());
+
+    txnParticipant.commitUnpreparedTransaction(opCtx());
+    txnParticipant.stashTransactionResources(opCtx());
+    ASSERT_TRUE(txnParticipant.transactionIsCommitted());
+
+    runFunctionFromDifferentOpCtx([](OperationContext* newOpCtx) {
+        ASSERT(readIdsInRecordOrder(newOpCtx) == std::vector<int>({1, 2}));
+    });
+}
+
+TEST_F(TxnParticipantTest, DuplicateKeyInBufferedInsertsIsReportedWhenTheyAreApplied) {
+    auto sessionCheckout = checkOutSession();
+    auto txnParticipant = TransactionParticipant::get(opCtx());
+    txnParticipant.unstashTransactionResources(opCtx(), "insert");
+    bufferInsertOfUnownedDoc(txnParticipant, 1);
+    write_ops_exec::flushBufferedTransactionWrites(opCtx());
+
+    // The duplicate is accepted when it is buffered, and is reported by the next statement which
+    // applies the buffered inserts.
+    bufferInsertOfUnownedDoc(txnParticipant, 2);
+    bufferInsertOfUnownedDoc(txnParticipant, 1);
+    ASSERT_THROWS_CODE(write_ops_exec::flushBufferedTransactionWrites(opCtx()),
+                       AssertionException,
+                       ErrorCodes::DuplicateKey);
+
+    // Aborting the transaction discards both the applied inserts and those still buffered.
+    bufferInsertOfUnownedDoc(txnParticipant, 3);
+    txnParticipant.stashTransactionResources(opCtx());
+    txnParticipant.abortTransaction(opCtx());
+    ASSERT_FALSE(txnParticipant.hasBufferedInserts());
+    ASSERT_TRUE(txnParticipant.transactionIsAborted());
+
+    runFunctionFromDifferentOpCtx([](OperationContext* newOpCtx) {
+        ASSERT(readIdsInRecordOrder(newOpCtx).empty());
+    });
+}
+
 // This test makes sure the commit machinery works even when no operations are done on the
 // transaction.
 TEST_F(TxnParticipantTest, EmptyUnpreparedTransactionCommit) {
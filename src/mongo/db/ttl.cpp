@@ -41,9 +41,11 @@
 #include "mongo/db/catalog/index_catalog.h"
 #include "mongo/db/client.h"
 #include "mongo/db/commands/fsync_locked.h"
+#include "mongo/db/commands/server_status.h"
 #include "mongo/db/commands/server_status_metric.h"
 #include "mongo/db/concurrency/write_conflict_exception.h"
 #include "mongo/db/db_raii.h"
+#include "mongo/db/exec/batched_delete_stage.h"
 #include "mongo/db/exec/delete.h"
 #include "mongo/db/index/index_descriptor.h"
 #include "mongo/db/namespace_string.h"
@@ -53,12 +55,15 @@
 #include "mongo/db/service_context.h"
 #include "mongo/db/stats/resource_consumption_metrics.h"
 #include "mongo/db/storage/durable_catalog.h"
+#include "mongo/db/storage/storage_engine.h"
 #include "mongo/db/timeseries/bucket_catalog.h"
 #include "mongo/db/ttl_collection_cache.h"
 #include "mongo/db/ttl_gen.h"
 #include "mongo/logv2/log.h"
 #include "mongo/util/background.h"
 #include "mongo/util/concurrency/idle_thread_block.h"
+#include "mongo/util/concurrency/thread_pool.h"
+#include "mongo/util/timer.h"
 
 namespace mongo {
 
@@ -79,9 +84,206 @@ ServerStatusMetricField<Counter64> ttlPassesDisplay("ttl.passes", &ttlPasses);
 ServerStatusMetricField<Counter64> ttlDeletedDocumentsDisplay("ttl.deletedDocuments",
                                                               &ttlDeletedDocuments);
 
+Counter64 ttlThrottledMillis;
+ServerStatusMetricField<Counter64> ttlThrottledMillisDisplay("ttl.throttledMillis",
+                                                             &ttlThrottledMillis);
+
+namespace {
+
+// Upper bound on the number of documents deleted under one acquisition of the collection lock when
+// deletion is rate limited. The lock is released while waiting for more of the deletion budget.
+constexpr long long kMaxThrottledDeletesPerSlice = 1000;
+
+/**
+ * Returns true if the majority commit point trails this node's last applied write by more than
+ * ttlMonitorMaxReplicationLagSecs.
+ */
+bool isMajorityCommitLagging(OperationContext* opCtx) {
+    auto replCoord = repl::ReplicationCoordinator::get(opCtx);
+    if (replCoord->getReplicationMode() != repl::ReplicationCoordinator::modeReplSet) {
+        return false;
+    }
+
+    const auto lastApplied = replCoord->getMyLastAppliedOpTimeAndWallTime().wallTime;
+    const auto lastCommitted = replCoord->getLastCommittedOpTimeAndWallTime().wallTime;
+    return lastApplied - lastCommitted > Seconds(ttlMonitorMaxReplicationLagSecs.load());
+}
+
+/**
+ * Shares the TTL deletion budget between all of the TTL workers.
+ *
+ * The budget is a token bucket refilled at ttlMonitorMaxDeletesPerSecond and holding at most one
+ * second worth of deletes. While the majority commit point lags or the storage engine cache is
+ * under pressure, the bucket is refilled at ttlMonitorThrottledDeletesPerSecond instead. Those
+ * signals are sampled at most once a second.
+ */
+class TTLDeletionRateLimiter {
+public:
+    /**
+     * Waits until deletes are allowed and returns how many, which is at most 'wanted'. Returns
+     * boost::none without waiting when deletion is not rate limited.
+     */
+    boost::optional<long long> acquire(OperationContext* opCtx, long long wanted) {
+        while (true) {
+            Milliseconds wait;
+            {
+                stdx::lock_guard<Latch> lk(_mutex);
+                const auto now = Date_t::now();
+                const auto rate = _currentRate(opCtx, now);
+                if (rate == 0) {
+                    _tokens = 0;
+                    _lastRefill = now;
+                    return boost::none;
+                }
+
+                _tokens = std::min<double>(
+                    rate, _tokens + rate * durationCount<Milliseconds>(now - _lastRefill) / 1000.0);
+                _lastRefill = now;
+                if (_tokens >= 1) {
+                    const auto granted = std::min(wanted, static_cast<long long>(_tokens));
+                    _tokens -= granted;
+                    return granted;
+                }
+
+                wait = Milliseconds(static_cast<long long>(std::ceil((1 - _tokens) * 1000 / rate)));
+            }
+
+            opCtx->sleepFor(wait);
+            ttlThrottledMillis.increment(durationCount<Milliseconds>(wait));
+        }
+    }
+
+    /**
+     * Returns deletes that were acquired but not used to the budget.
+     */
+    void release(long long unused) {
+        stdx::lock_guard<Latch> lk(_mutex);
+        _tokens += unused;
+    }
+
+    bool isBackingOff() const {
+        stdx::lock_guard<Latch> lk(_mutex);
+        return _backingOff;
+    }
+
+private:
+    /**
+     * Returns the number of deletes per second currently allowed, or 0 if unlimited. Deletion is
+     * only throttled further, while replication lags or the cache is under pressure, when a maximum
+     * rate is configured, so that the TTL monitor keeps deleting at full speed by default.
+     */
+    int _currentRate(OperationContext* opCtx, Date_t now) {
+        const int maxRate = ttlMonitorMaxDeletesPerSecond.load();
+        if (maxRate == 0) {
+            if (_backingOff) {
+                LOGV2(5411102, "Stopped throttling TTL deletion as it is no longer rate limited");
+                _backingOff = false;
+            }
+            return 0;
+        }
+
+        if (now - _lastBackoffCheck >= Seconds(1)) {
+            _lastBackoffCheck = now;
+
+            const bool lagging = isMajorityCommitLagging(opCtx);
+            const bool cachePressure =
+                opCtx->getServiceContext()->getStorageEngine()->isCacheUnderPressure();
+            const bool backingOff = lagging || cachePressure;
+            if (backingOff && !_backingOff) {
+                LOGV2(5411100,
+                      "Throttling TTL deletion",
+                      "majorityCommitLagging"_attr = lagging,
+                      "cacheUnderPressure"_attr = cachePressure);
+            } else if (!backingOff && _backingOff) {
+                LOGV2(5411101, "Stopped throttling TTL deletion");
+            }
+            _backingOff = backingOff;
+        }
+
+        if (!_backingOff) {
+            return maxRate;
+        }
+        return std::min(maxRate, ttlMonitorThrottledDeletesPerSecond.load());
+    }
+
+    mutable Mutex _mutex = MONGO_MAKE_LATCH("TTLDeletionRateLimiter::_mutex");
+
+    double _tokens = 0;
+    Date_t _lastRefill;
+    Date_t _lastBackoffCheck;
+    bool _backingOff = false;
+};
+
+/**
+ * A range of the keys of a TTL index. The start key is always included.
+ */
+struct TTLIndexRange {
+    Date_t start;
+    Date_t end;
+    bool includeEnd;
+};
+
+/**
+ * A unit of work for the TTL monitor: deleting the expired documents of one collection, found
+ * through either a TTL index or the clustered _id.
+ */
+struct TTLJob {
+    UUID uuid;
+    NamespaceString nss;
+    TTLCollectionCache::Info info;
+
+    // Set once the expired range has been computed by the first slice of the job, or upfront for
+    // the jobs a TTL index range is split into.
+    boost::optional<TTLIndexRange> range;
+    bool planned = false;
+};
+
+/**
+ * The outcome of deleting from a TTLJob under a single acquisition of the collection lock.
+ */
+struct TTLSliceResult {
+    long long numDeleted = 0;
+    bool exhausted = true;
+
+    // Set by the first slice of a job. See TTLCollectionStats::backlog.
+    boost::optional<Seconds> backlog;
+};
+
+/**
+ * Per-collection deletion progress, reported in the "ttl" serverStatus section.
+ */
+struct TTLCollectionStats {
+    NamespaceString nss;
+    long long deletedDocuments = 0;
+    long long lastPassDeletedDocuments = 0;
+    Milliseconds lastPassWorkTime{0};
+
+    // How far past its expiration the oldest expired document was when the last pass started.
+    Seconds backlog{0};
+    long long pass = 0;
+};
+
+}  // namespace
+
 class TTLMonitor : public BackgroundJob {
 public:
-    explicit TTLMonitor() : BackgroundJob(false /* selfDelete */) {}
+    explicit TTLMonitor() : BackgroundJob(false /* selfDelete */) {
+        if (ttlMonitorWorkers > 1) {
+            ThreadPool::Options options;
+            options.poolName = "TTLMonitorWorkers";
+            options.minThreads = 0;
+            options.maxThreads = ttlMonitorWorkers;
+            options.onCreateThread = [](const std::string& threadName) {
+                Client::initThread(threadName);
+                AuthorizationSession::get(cc())->grantInternalAuthorization(&cc());
+
+                stdx::lock_guard<Client> lk(cc());
+                cc().setSystemOperationKillableByStepdown(lk);
+            };
+            _workers = std::make_unique<ThreadPool>(std::move(options));
+            _workers->startup();
+        }
+    }
 
     static TTLMonitor* get(ServiceContext* serviceCtx) {
         return getTTLMonitor(serviceCtx).get();
@@ -164,9 +366,31 @@ public:
             _shuttingDownCV.notify_one();
         }
         wait();
+        if (_workers) {
+            _workers->shutdown();
+            _workers->join();
+        }
         LOGV2(3684101, "Finished shutting down TTL collection monitor thread");
     }
 
+    /**
+     * Appends the deletion progress of every collection the last TTL pass ran on.
+     */
+    void appendStats(BSONObjBuilder* builder) const {
+        builder->append("throttled", _rateLimiter.isBackingOff());
+
+        BSONObjBuilder collections(builder->subobjStart("collections"));
+        stdx::lock_guard<Latch> lk(_passMutex);
+        for (const auto& [uuid, stats] : _collectionStats) {
+            BSONObjBuilder collection(collections.subobjStart(stats.nss.ns()));
+            collection.append("deletedDocuments", stats.deletedDocuments);
+            collection.append("lastPassDeletedDocuments", stats.lastPassDeletedDocuments);
+            collection.append("lastPassWorkMillis",
+                              durationCount<Milliseconds>(stats.lastPassWorkTime));
+            collection.append("backlogSecs", durationCount<Seconds>(stats.backlog));
+        }
+    }
+
 private:
     /**
      * Gets all TTL specifications for every collection and deletes expired documents.
@@ -187,9 +411,19 @@ private:
         // Increment the metric after the TTL work has been finished.
         ON_BLOCK_EXIT([&] { ttlPasses.increment(); });
 
+        {
+            stdx::lock_guard<Latch> lk(_passMutex);
+            ++_pass;
+        }
+        _passInterrupted.store(false);
+
         // Perform a pass for every collection and index described as being TTL.
         for (const auto& [uuid, infos] : ttlInfos) {
             for (const auto& info : infos) {
+                if (_passInterrupted.load()) {
+                    break;
+                }
+
                 // Skip collections that have not been made visible yet. The TTLCollectionCache
                 // already has the index information available, so we want to avoid removing it
                 // until the collection is visible.
@@ -205,40 +439,138 @@ private:
                     continue;
                 }
 
-                try {
-                    deleteExpired(opCtx, &ttlCollectionCache, uuid, *nss, info);
-                } catch (const ExceptionForCat<ErrorCategory::Interruption>&) {
-                    LOGV2_WARNING(22537,
-                                  "TTLMonitor was interrupted, waiting before doing another pass",
-                                  "wait"_attr = Milliseconds(Seconds(ttlMonitorSleepSecs.load())));
+                TTLJob job{uuid, *nss, info};
+                if (_workers) {
+                    _scheduleJob(&ttlCollectionCache, std::move(job));
+                } else {
+                    _runJob(opCtx, &ttlCollectionCache, std::move(job));
+                }
+            }
+        }
+
+        _waitForJobs();
+
+        stdx::lock_guard<Latch> lk(_passMutex);
+        for (auto it = _collectionStats.begin(); it != _collectionStats.end();) {
+            if (it->second.pass != _pass) {
+                _collectionStats.erase(it++);
+            } else {
+                ++it;
+            }
+        }
+    }
+
+    /**
+     * Runs 'job' on one of the TTL workers.
+     */
+    void _scheduleJob(TTLCollectionCache* ttlCollectionCache, TTLJob job) {
+        {
+            stdx::lock_guard<Latch> lk(_passMutex);
+            ++_outstandingJobs;
+        }
+
+        _workers->schedule([this, ttlCollectionCache, job = std::move(job)](Status status) mutable {
+            ON_BLOCK_EXIT([&] {
+                stdx::lock_guard<Latch> lk(_passMutex);
+                if (--_outstandingJobs == 0) {
+                    _jobsDrainedCV.notify_all();
+                }
+            });
+
+            if (!status.isOK() || _passInterrupted.load()) {
+                return;
+            }
+
+            const auto opCtx = cc().makeOperationContext();
+            _runJob(opCtx.get(), ttlCollectionCache, std::move(job));
+        });
+    }
+
+    /**
+     * Waits until every job scheduled on the TTL workers during this pass has finished.
+     */
+    void _waitForJobs() {
+        if (!_workers) {
+            return;
+        }
+
+        stdx::unique_lock<Latch> lk(_passMutex);
+        _jobsDrainedCV.wait(lk, [&] { return _outstandingJobs == 0; });
+    }
+
+    /**
+     * Deletes the expired documents of 'job' in slices, each taking the collection lock once and
+     * deleting no more than the rate limiter allows.
+     */
+    void _runJob(OperationContext* opCtx, TTLCollectionCache* ttlCollectionCache, TTLJob job) {
+        try {
+            while (!_passInterrupted.load()) {
+                const auto budget = _rateLimiter.acquire(opCtx, kMaxThrottledDeletesPerSlice);
+
+                Timer timer;
+                const auto result = deleteExpired(opCtx, ttlCollectionCache, &job, budget);
+                if (budget) {
+                    _rateLimiter.release(*budget - (result ? result->numDeleted : 0));
+                }
+                if (!result) {
+                    return;
+                }
+
+                _recordProgress(job, *result, Milliseconds(timer.millis()));
+                if (result->exhausted) {
                     return;
-                } catch (const DBException& ex) {
-                    LOGV2_ERROR(5400703,
-                                "Error running TTL job on collection",
-                                "collection"_attr = nss,
-                                "error"_attr = ex);
-                    continue;
                 }
             }
+        } catch (const ExceptionForCat<ErrorCategory::Interruption>&) {
+            LOGV2_WARNING(22537,
+                          "TTLMonitor was interrupted, waiting before doing another pass",
+                          "wait"_attr = Milliseconds(Seconds(ttlMonitorSleepSecs.load())));
+            _passInterrupted.store(true);
+        } catch (const DBException& ex) {
+            LOGV2_ERROR(5400703,
+                        "Error running TTL job on collection",
+                        "collection"_attr = job.nss,
+                        "error"_attr = ex);
+        }
+    }
+
+    void _recordProgress(const TTLJob& job, const TTLSliceResult& result, Milliseconds workTime) {
+        stdx::lock_guard<Latch> lk(_passMutex);
+        auto& stats = _collectionStats[job.uuid];
+        if (stats.pass != _pass) {
+            stats.pass = _pass;
+            stats.lastPassDeletedDocuments = 0;
+            stats.lastPassWorkTime = Milliseconds(0);
+            stats.backlog = Seconds(0);
+        }
+
+        stats.nss = job.nss;
+        stats.deletedDocuments += result.numDeleted;
+        stats.lastPassDeletedDocuments += result.numDeleted;
+        stats.lastPassWorkTime += workTime;
+        if (result.backlog) {
+            stats.backlog = std::max(stats.backlog, *result.backlog);
         }
     }
 
     /**
-     * Deletes expired data on the given collection with the provided information.
+     * Deletes expired data on the given collection with the provided information. Deletes no more
+     * than 'budget' documents if one is given. Returns boost::none if the job does not apply to the
+     * collection, or not on this node.
      */
-    void deleteExpired(OperationContext* opCtx,
-                       TTLCollectionCache* ttlCollectionCache,
-                       const UUID& uuid,
-                       const NamespaceString& nss,
-                       const TTLCollectionCache::Info& info) {
+    boost::optional<TTLSliceResult> deleteExpired(OperationContext* opCtx,
+                                                  TTLCollectionCache* ttlCollectionCache,
+                                                  TTLJob* job,
+                                                  boost::optional<long long> budget) {
+        const auto& nss = job->nss;
         if (nss.isTemporaryReshardingCollection()) {
             // For resharding, the donor shard primary is responsible for performing the TTL
             // deletions.
-            return;
+            return boost::none;
         }
 
         if (nss.isDropPendingNamespace()) {
-            return;
+            return boost::none;
         }
 
         uassertStatusOK(userAllowedWriteNS(nss));
@@ -246,8 +578,8 @@ private:
         AutoGetCollection coll(opCtx, nss, MODE_IX);
         // The collection with `uuid` might be renamed before the lock and the wrong namespace would
         // be locked and looked up so we double check here.
-        if (!coll || coll->uuid() != uuid)
-            return;
+        if (!coll || coll->uuid() != job->uuid)
+            return boost::none;
 
         if (MONGO_unlikely(hangTTLMonitorWithLock.shouldFail())) {
             LOGV2(22534, "Hanging due to hangTTLMonitorWithLock fail point");
@@ -255,21 +587,23 @@ private:
         }
 
         if (!repl::ReplicationCoordinator::get(opCtx)->canAcceptWritesFor(opCtx, nss)) {
-            return;
+            return boost::none;
         }
 
         ResourceConsumption::ScopedMetricsCollector scopedMetrics(opCtx, nss.db().toString());
 
         const auto& collection = coll.getCollection();
-        stdx::visit(
+        return stdx::visit(
             visit_helper::Overloaded{
                 [&](const TTLCollectionCache::ClusteredId&) {
-                    deleteExpiredWithCollscan(opCtx, ttlCollectionCache, collection);
+                    return deleteExpiredWithCollscan(
+                        opCtx, ttlCollectionCache, collection, job, budget);
                 },
                 [&](const TTLCollectionCache::IndexName& indexName) {
-                    deleteExpiredWithIndex(opCtx, ttlCollectionCache, collection, indexName);
+                    return deleteExpiredWithIndex(
+                        opCtx, ttlCollectionCache, collection, indexName, job, budget);
                 }},
-            info);
+            job->info);
     }
 
     /**
@@ -294,26 +628,28 @@ private:
      * Removes documents from the collection using the specified TTL index after a sufficient
      * amount of time has passed according to its expiry specification.
      */
-    void deleteExpiredWithIndex(OperationContext* opCtx,
-                                TTLCollectionCache* ttlCollectionCache,
-                                const CollectionPtr& collection,
-                                std::string indexName) {
+    boost::optional<TTLSliceResult> deleteExpiredWithIndex(OperationContext* opCtx,
+                                                           TTLCollectionCache* ttlCollectionCache,
+                                                           const CollectionPtr& collection,
+                                                           std::string indexName,
+                                                           TTLJob* job,
+                                                           boost::optional<long long> budget) {
         if (!DurableCatalog::get(opCtx)->isIndexPresent(
                 opCtx, collection->getCatalogId(), indexName)) {
             ttlCollectionCache->deregisterTTLInfo(collection->uuid(), indexName);
-            return;
+            return boost::none;
         }
 
         BSONObj spec =
             DurableCatalog::get(opCtx)->getIndexSpec(opCtx, collection->getCatalogId(), indexName);
         if (!spec.hasField(IndexDescriptor::kExpireAfterSecondsFieldName)) {
             ttlCollectionCache->deregisterTTLInfo(collection->uuid(), indexName);
-            return;
+            return boost::none;
         }
 
         if (!DurableCatalog::get(opCtx)->isIndexReady(
                 opCtx, collection->getCatalogId(), indexName)) {
-            return;
+            return boost::none;
         }
 
         const BSONObj key = spec["key"].Obj();
@@ -322,7 +658,7 @@ private:
             LOGV2_ERROR(22540,
                         "key for ttl index can only have 1 field, skipping TTL job",
                         "index"_attr = spec);
-            return;
+            return boost::none;
         }
 
         LOGV2_DEBUG(22533,
@@ -335,14 +671,14 @@ private:
         const IndexDescriptor* desc = collection->getIndexCatalog()->findIndexByName(opCtx, name);
         if (!desc) {
             LOGV2_DEBUG(22535, 1, "index not found; skipping ttl job", "index"_attr = spec);
-            return;
+            return boost::none;
         }
 
         if (IndexType::INDEX_BTREE != IndexNames::nameToType(desc->getAccessMethodName())) {
             LOGV2_ERROR(22541,
                         "special index can't be used as a TTL index, skipping TTL job",
                         "index"_attr = spec);
-            return;
+            return boost::none;
         }
 
         BSONElement secondsExpireElt = spec[IndexDescriptor::kExpireAfterSecondsFieldName];
@@ -352,26 +688,55 @@ private:
                         "field"_attr = IndexDescriptor::kExpireAfterSecondsFieldName,
                         "type"_attr = typeName(secondsExpireElt.type()),
                         "index"_attr = spec);
-            return;
+            return boost::none;
         }
 
         const Date_t kDawnOfTime =
             Date_t::fromMillisSinceEpoch(std::numeric_limits<long long>::min());
-        const auto expirationDate = safeExpirationDate(collection, secondsExpireElt.numberLong());
-        const BSONObj startKey = BSON("" << kDawnOfTime);
-        const BSONObj endKey = BSON("" << expirationDate);
         // The canonical check as to whether a key pattern element is "ascending" or
         // "descending" is (elt.number() >= 0).  This is defined by the Ordering class.
         const InternalPlanner::Direction direction = (key.firstElement().number() >= 0)
             ? InternalPlanner::Direction::FORWARD
             : InternalPlanner::Direction::BACKWARD;
 
+        boost::optional<Seconds> backlog;
+        if (!job->planned) {
+            job->planned = true;
+
+            const auto expirationDate =
+                safeExpirationDate(collection, secondsExpireElt.numberLong());
+            auto scan = InternalPlanner::indexScan(opCtx,
+                                                   &collection,
+                                                   desc,
+                                                   BSON("" << kDawnOfTime),
+                                                   BSON("" << expirationDate),
+                                                   BoundInclusion::kIncludeBothStartAndEndKeys,
+                                                   PlanYieldPolicy::YieldPolicy::NO_YIELD,
+                                                   direction);
+            BSONObj earliestKey;
+            if (scan->getNext(&earliestKey, nullptr) == PlanExecutor::IS_EOF) {
+                TTLSliceResult result;
+                result.backlog = Seconds(0);
+                return result;
+            }
+
+            const auto earliest = earliestKey.firstElement().Date();
+            backlog = duration_cast<Seconds>(expirationDate - earliest);
+            job->range = partitionExpiredRange(
+                ttlCollectionCache, *job, kDawnOfTime, earliest, expirationDate);
+        }
+
+        const auto& range = *job->range;
+        const BSONObj startKey = BSON("" << range.start);
+        const BSONObj endKey = BSON("" << range.end);
+
         // We need to pass into the DeleteStageParams (below) a CanonicalQuery with a BSONObj that
         // queries for the expired documents correctly so that we do not delete documents that are
         // not actually expired when our snapshot changes during deletion.
         const char* keyFieldName = key.firstElement().fieldName();
-        BSONObj query =
-            BSON(keyFieldName << BSON("$gte" << kDawnOfTime << "$lte" << expirationDate));
+        BSONObj query = BSON(keyFieldName << BSON("$gte" << range.start
+                                                         << (range.includeEnd ? "$lte" : "$lt")
+                                                         << range.end));
         auto findCommand = std::make_unique<FindCommand>(collection->ns());
         findCommand->setFilter(query);
         auto canonicalQuery = CanonicalQuery::canonicalize(opCtx, std::move(findCommand));
@@ -381,33 +746,74 @@ private:
         params->isMulti = true;
         params->canonicalQuery = canonicalQuery.getValue().get();
 
-        auto exec =
-            InternalPlanner::deleteWithIndexScan(opCtx,
-                                                 &collection,
-                                                 std::move(params),
-                                                 desc,
-                                                 startKey,
-                                                 endKey,
-                                                 BoundInclusion::kIncludeBothStartAndEndKeys,
-                                                 PlanYieldPolicy::YieldPolicy::YIELD_AUTO,
-                                                 direction);
+        auto batchedDeleteParams = makeBatchedDeleteParams(collection, budget);
+        const bool batched = bool(batchedDeleteParams);
+        params->returnDeleted = budget && !batched;
+
+        auto exec = InternalPlanner::deleteWithIndexScan(
+            opCtx,
+            &collection,
+            std::move(params),
+            desc,
+            startKey,
+            endKey,
+            range.includeEnd ? BoundInclusion::kIncludeBothStartAndEndKeys
+                             : BoundInclusion::kIncludeStartKeyOnly,
+            PlanYieldPolicy::YieldPolicy::YIELD_AUTO,
+            direction,
+            std::move(batchedDeleteParams));
+
+        auto result = executeDelete(exec.get(), budget, batched);
+        result.backlog = backlog;
+        ttlDeletedDocuments.increment(result.numDeleted);
+        LOGV2_DEBUG(22536, 1, "deleted: {numDeleted}", "numDeleted"_attr = result.numDeleted);
+        return result;
+    }
 
-        try {
-            const auto numDeleted = exec->executeDelete();
-            ttlDeletedDocuments.increment(numDeleted);
-            LOGV2_DEBUG(22536, 1, "deleted: {numDeleted}", "numDeleted"_attr = numDeleted);
-        } catch (const ExceptionFor<ErrorCodes::QueryPlanKilled>&) {
-            // It is expected that a collection drop can kill a query plan while the TTL monitor
-            // is deleting an old document, so ignore this error.
+    /**
+     * Splits the expired keys of a TTL index, from 'earliest' to 'expirationDate', into
+     * ttlMonitorIndexRangePartitions ranges spanning equal amounts of time. Schedules a job on the
+     * TTL workers for every range but the first, which is returned for 'job' to delete itself. The
+     * first range reaches back to 'dawnOfTime'.
+     */
+    TTLIndexRange partitionExpiredRange(TTLCollectionCache* ttlCollectionCache,
+                                        const TTLJob& job,
+                                        Date_t dawnOfTime,
+                                        Date_t earliest,
+                                        Date_t expirationDate) {
+        const int numPartitions = _workers ? ttlMonitorIndexRangePartitions.load() : 1;
+        if (numPartitions == 1) {
+            return {dawnOfTime, expirationDate, true};
+        }
+
+        // Computed in floating point as the expired keys may span more than a long long allows.
+        const double span = static_cast<double>(expirationDate.toMillisSinceEpoch()) -
+            static_cast<double>(earliest.toMillisSinceEpoch());
+        const auto boundary = [&](int i) {
+            return earliest + Milliseconds(static_cast<long long>(span * i / numPartitions));
+        };
+
+        for (int i = 1; i < numPartitions; ++i) {
+            const bool last = i == numPartitions - 1;
+            TTLJob partition{job.uuid, job.nss, job.info};
+            partition.range =
+                TTLIndexRange{boundary(i), last ? expirationDate : boundary(i + 1), last};
+            partition.planned = true;
+            _scheduleJob(ttlCollectionCache, std::move(partition));
         }
+
+        return {dawnOfTime, boundary(1), false};
     }
 
     /*
      * Removes expired documents from a collection clustered by _id using a bounded collection scan.
      */
-    void deleteExpiredWithCollscan(OperationContext* opCtx,
-                                   TTLCollectionCache* ttlCollectionCache,
-                                   const CollectionPtr& collection) {
+    boost::optional<TTLSliceResult> deleteExpiredWithCollscan(
+        OperationContext* opCtx,
+        TTLCollectionCache* ttlCollectionCache,
+        const CollectionPtr& collection,
+        TTLJob* job,
+        boost::optional<long long> budget) {
         auto collOptions =
             DurableCatalog::get(opCtx)->getCollectionOptions(opCtx, collection->getCatalogId());
         uassert(5400701,
@@ -419,7 +825,7 @@ private:
         if (!expireAfterSeconds) {
             ttlCollectionCache->deregisterTTLInfo(collection->uuid(),
                                                   TTLCollectionCache::ClusteredId{});
-            return;
+            return boost::none;
         }
 
         LOGV2_DEBUG(5400704,
@@ -435,9 +841,25 @@ private:
         endOID.init(expirationDate, true /* max */);
         const auto endId = RecordId(endOID.view().view(), OID::kOIDSize);
 
+        boost::optional<Seconds> backlog;
+        if (!job->planned) {
+            job->planned = true;
+
+            // The collection is ordered by _id, so its first record is the oldest one.
+            auto cursor = collection->getCursor(opCtx);
+            auto oldest = cursor->next();
+            backlog = oldest && oldest->id <= endId
+                ? duration_cast<Seconds>(expirationDate - OID::from(oldest->id.strData()).asDateT())
+                : Seconds(0);
+        }
+
         auto params = std::make_unique<DeleteStageParams>();
         params->isMulti = true;
 
+        auto batchedDeleteParams = makeBatchedDeleteParams(collection, budget);
+        const bool batched = bool(batchedDeleteParams);
+        params->returnDeleted = budget && !batched;
+
         // Deletes records using a bounded collection scan from the beginning of time to the
         // expiration time (inclusive).
         auto exec =
@@ -447,18 +869,83 @@ private:
                                                       PlanYieldPolicy::YieldPolicy::YIELD_AUTO,
                                                       InternalPlanner::Direction::FORWARD,
                                                       boost::none /* minRecord */,
-                                                      endId);
+                                                      endId,
+                                                      std::move(batchedDeleteParams));
+
+        auto result = executeDelete(exec.get(), budget, batched);
+        result.backlog = backlog;
+        ttlDeletedDocuments.increment(result.numDeleted);
+        LOGV2_DEBUG(5400702, 1, "deleted", "numDeleted"_attr = result.numDeleted);
+        return result;
+    }
+
+    /**
+     * Returns the parameters to delete expired documents from 'collection' in batches, or nullptr
+     * if they are deleted one at a time, either because batching is turned off or because the
+     * collection requires its deletes to be logged individually.
+     */
+    std::unique_ptr<BatchedDeleteStageParams> makeBatchedDeleteParams(
+        const CollectionPtr& collection, boost::optional<long long> budget) {
+        if (!ttlMonitorBatchDeletes.load() || !BatchedDeleteStage::canBatchDeletes(collection)) {
+            return nullptr;
+        }
 
+        auto batchedDeleteParams = std::make_unique<BatchedDeleteStageParams>();
+        if (budget) {
+            batchedDeleteParams->targetPassDocs = *budget;
+        }
+        return batchedDeleteParams;
+    }
+
+    /**
+     * Runs a TTL delete plan to completion, or until it has deleted 'budget' documents if one is
+     * given. Unless the plan is 'batched', and so stops on its own once it has deleted 'budget'
+     * documents, it must return the deleted documents in the latter case.
+     */
+    TTLSliceResult executeDelete(PlanExecutor* exec,
+                                 boost::optional<long long> budget,
+                                 bool batched) {
+        TTLSliceResult result;
         try {
-            const auto numDeleted = exec->executeDelete();
-            ttlDeletedDocuments.increment(numDeleted);
-            LOGV2_DEBUG(5400702, 1, "deleted", "numDeleted"_attr = numDeleted);
+            if (!budget || batched) {
+                result.numDeleted = exec->executeDelete();
+                result.exhausted = !budget || result.numDeleted < *budget;
+                return result;
+            }
+
+            BSONObj deleted;
+            while (result.numDeleted < *budget) {
+                if (exec->getNext(&deleted, nullptr) == PlanExecutor::IS_EOF) {
+                    return result;
+                }
+                ++result.numDeleted;
+            }
+            result.exhausted = false;
         } catch (const ExceptionFor<ErrorCodes::QueryPlanKilled>&) {
             // It is expected that a collection drop can kill a query plan while the TTL monitor
             // is deleting an old document, so ignore this error.
         }
+        return result;
     }
 
+    // Runs TTL jobs in parallel when ttlMonitorWorkers is greater than 1.
+    std::unique_ptr<ThreadPool> _workers;
+
+    TTLDeletionRateLimiter _rateLimiter;
+
+    // Set when a TTL job is interrupted, so that the rest of the pass is skipped.
+    AtomicWord<bool> _passInterrupted{false};
+
+    // Protects the pass state below.
+    mutable Mutex _passMutex = MONGO_MAKE_LATCH("TTLMonitorPassMutex");
+
+    // Signaled when the last outstanding job of a pass finishes.
+    stdx::condition_variable _jobsDrainedCV;
+
+    long long _outstandingJobs = 0;
+    long long _pass = 0;
+    stdx::unordered_map<UUID, TTLCollectionStats, UUID::Hash> _collectionStats;
+
     // Protects the state below.
     mutable Mutex _stateMutex = MONGO_MAKE_LATCH("TTLMonitorStateMutex");
 
@@ -469,6 +956,33 @@ private:
     bool _shuttingDown = false;
 };
 
+namespace {
+
+/**
+ * Reports the TTL deletion progress of every collection the last TTL pass ran on.
+ */
+class TTLServerStatusSection : public ServerStatusSection {
+public:
+    TTLServerStatusSection() : ServerStatusSection("ttl") {}
+
+    bool includeByDefault() const override {
+        return false;
+    }
+
+    BSONObj generateSection(OperationContext* opCtx, const BSONElement& configElem) const override {
+        auto ttlMonitor = TTLMonitor::get(opCtx->getServiceContext());
+        if (!ttlMonitor) {
+            return BSONObj();
+        }
+
+        BSONObjBuilder builder;
+        ttlMonitor->appendStats(&builder);
+        return builder.obj();
+    }
+} ttlServerStatusSection;
+
+}  // namespace
+
 void startTTLMonitor(ServiceContext* serviceContext) {
     std::unique_ptr<TTLMonitor> ttlMonitor = std::make_unique<TTLMonitor>();
     ttlMonitor->go();
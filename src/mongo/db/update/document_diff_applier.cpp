@@ -29,6 +29,9 @@
 
 #include "mongo/platform/basic.h"
 
+#include <algorithm>
+
+#include "mongo/bson/util/builder.h"
 #include "mongo/db/field_ref.h"
 #include "mongo/db/update/document_diff_applier.h"
 #include "mongo/db/update_index_data.h"
@@ -294,6 +297,211 @@ private:
     const UpdateIndexData* _indexData;
     bool _indexesAffected = false;
 };
+
+/**
+ * Translates a diff into damages against the buffer of the pre image. It follows the same rules as
+ * DiffApplier, so that applying the damages yields a post image identical to the one applyDiff()
+ * builds. Every damage is computed against the offsets of the unmodified pre image; they are
+ * sorted by descending offset at the end so that each one can be applied after the ones before it.
+ */
+class DamagesCalculator {
+public:
+    explicit DamagesCalculator(const BSONObj& preImage) : _base(preImage.objdata()) {}
+
+    boost::optional<DamagesOutput> compute(const BSONObj& preImage, DocumentDiffReader* reader) {
+        computeObjectDamages(preImage, reader);
+        if (_failed) {
+            return boost::none;
+        }
+
+        std::sort(_damages.begin(),
+                  _damages.end(),
+                  [](const mutablebson::DamageEvent& lhs, const mutablebson::DamageEvent& rhs) {
+                      return lhs.targetOffset > rhs.targetOffset;
+                  });
+        return DamagesOutput{_source.release(), std::move(_damages)};
+    }
+
+private:
+    // Mutually recursive with computeArrayDamages(). Returns the change in size of 'preImage'.
+    int computeObjectDamages(const BSONObj& preImage, DocumentDiffReader* reader) {
+        const DocumentDiffTables tables = buildObjDiffTables(reader);
+
+        StringDataSet fieldsToSkipInserting;
+        int sizeDelta = 0;
+
+        for (auto&& elt : preImage) {
+            auto it = tables.fieldMap.find(elt.fieldNameStringData());
+            if (it == tables.fieldMap.end()) {
+                continue;
+            }
+
+            stdx::visit(
+                visit_helper::Overloaded{
+                    [this, &elt, &sizeDelta](Delete) {
+                        sizeDelta += replaceElement(elt, nullptr, 0);
+                    },
+
+                    [this, &elt, &sizeDelta, &fieldsToSkipInserting](const Update& update) {
+                        sizeDelta +=
+                            replaceElement(elt, update.newElt.rawdata(), update.newElt.size());
+                        fieldsToSkipInserting.insert(elt.fieldNameStringData());
+                    },
+
+                    [this, &elt, &sizeDelta](const Insert&) {
+                        // Remove the pre-image version of the field. It gets added at the end.
+                        sizeDelta += replaceElement(elt, nullptr, 0);
+                    },
+
+                    [this, &elt, &sizeDelta](const SubDiff& subDiff) {
+                        stdx::visit(
+                            [this, &elt, &sizeDelta](auto reader) {
+                                sizeDelta += computeSubDiffDamages(elt, std::move(reader));
+                            },
+                            subDiff.reader);
+                    },
+                },
+                it->second);
+
+            if (_failed) {
+                return 0;
+            }
+        }
+
+        // Insert the remaining fields just before the terminating byte of the object.
+        const size_t sourceOffset = _source.len();
+        for (auto&& elt : tables.fieldsToInsert) {
+            if (!fieldsToSkipInserting.count(elt.fieldNameStringData())) {
+                _source.appendBuf(elt.rawdata(), elt.size());
+            }
+        }
+        if (const size_t inserted = _source.len() - sourceOffset) {
+            const size_t terminatorOffset = offsetOf(preImage.objdata()) + preImage.objsize() - 1;
+            addDamage(sourceOffset, terminatorOffset, 0, inserted);
+            sizeDelta += inserted;
+        }
+
+        updateObjectSize(preImage, sizeDelta);
+        return sizeDelta;
+    }
+
+    // Mutually recursive with computeObjectDamages(). Returns the change in size of 'preImage'.
+    int computeArrayDamages(const BSONObj& arrayPreImage, ArrayDiffReader* reader) {
+        if (reader->newSize()) {
+            // Resizing an array renumbers or pads its elements, fall back to applying the diff.
+            _failed = true;
+            return 0;
+        }
+
+        int sizeDelta = 0;
+        auto nextMod = reader->next();
+        size_t idx = 0;
+        for (BSONObjIterator preImageIt(arrayPreImage); preImageIt.more() && nextMod;
+             ++idx, ++preImageIt) {
+            if (idx != nextMod->first) {
+                continue;
+            }
+
+            const BSONElement elt = *preImageIt;
+            stdx::visit(
+                visit_helper::Overloaded{
+                    [this, &elt, &sizeDelta](const BSONElement& update) {
+                        invariant(!update.eoo());
+                        // The array index keeps the field name of the pre image element.
+                        const size_t sourceOffset = _source.len();
+                        _source.appendChar(update.type());
+                        _source.appendStr(elt.fieldNameStringData());
+                        _source.appendBuf(update.value(), update.valuesize());
+                        sizeDelta += replaceElementFromSource(elt, sourceOffset);
+                    },
+                    [this, &elt, &sizeDelta](auto reader) {
+                        sizeDelta += computeSubDiffDamages(elt, std::move(reader));
+                    },
+                },
+                nextMod->second);
+
+            if (_failed) {
+                return 0;
+            }
+            nextMod = reader->next();
+        }
+
+        if (nextMod) {
+            // The pre image array is shorter than the diff expects.
+            _failed = true;
+            return 0;
+        }
+
+        updateObjectSize(arrayPreImage, sizeDelta);
+        return sizeDelta;
+    }
+
+    template <typename Reader>
+    int computeSubDiffDamages(const BSONElement& elt, Reader reader) {
+        if constexpr (std::is_same_v<Reader, DocumentDiffReader>) {
+            if (elt.type() == BSONType::Object) {
+                return computeObjectDamages(elt.embeddedObject(), &reader);
+            }
+        } else if constexpr (std::is_same_v<Reader, ArrayDiffReader>) {
+            if (elt.type() == BSONType::Array) {
+                return computeArrayDamages(elt.embeddedObject(), &reader);
+            }
+        }
+
+        // There's a type mismatch, so like applyDiff() we set the field to null and expect some
+        // future operation to overwrite it.
+        const size_t sourceOffset = _source.len();
+        _source.appendChar(BSONType::jstNULL);
+        _source.appendStr(elt.fieldNameStringData());
+        return replaceElementFromSource(elt, sourceOffset);
+    }
+
+    /**
+     * Replaces the bytes of 'elt' with 'size' bytes of 'data' and returns the change in size.
+     */
+    int replaceElement(const BSONElement& elt, const char* data, size_t size) {
+        const size_t sourceOffset = _source.len();
+        _source.appendBuf(data, size);
+        return replaceElementFromSource(elt, sourceOffset);
+    }
+
+    /**
+     * Replaces the bytes of 'elt' with the bytes appended to the source since 'sourceOffset' and
+     * returns the change in size.
+     */
+    int replaceElementFromSource(const BSONElement& elt, size_t sourceOffset) {
+        const size_t size = _source.len() - sourceOffset;
+        addDamage(sourceOffset, offsetOf(elt.rawdata()), elt.size(), size);
+        return static_cast<int>(size) - elt.size();
+    }
+
+    void updateObjectSize(const BSONObj& obj, int sizeDelta) {
+        if (sizeDelta == 0) {
+            return;
+        }
+        const size_t sourceOffset = _source.len();
+        _source.appendNum(static_cast<int>(obj.objsize() + sizeDelta));
+        addDamage(sourceOffset, offsetOf(obj.objdata()), sizeof(int), sizeof(int));
+    }
+
+    void addDamage(size_t sourceOffset, size_t targetOffset, size_t targetSize, size_t size) {
+        mutablebson::DamageEvent damage;
+        damage.sourceOffset = sourceOffset;
+        damage.targetOffset = targetOffset;
+        damage.targetSize = targetSize;
+        damage.size = size;
+        _damages.push_back(damage);
+    }
+
+    size_t offsetOf(const char* ptr) const {
+        return ptr - _base;
+    }
+
+    const char* const _base;
+    BufBuilder _source;
+    mutablebson::DamageVector _damages;
+    bool _failed = false;
+};
 }  // namespace
 
 ApplyDiffOutput applyDiff(const BSONObj& pre, const Diff& diff, const UpdateIndexData* indexData) {
@@ -304,4 +512,9 @@ ApplyDiffOutput applyDiff(const BSONObj& pre, const Diff& diff, const UpdateInde
     applier.applyDiffToObject(pre, &path, &reader, &out);
     return {out.obj(), applier.indexesAffected()};
 }
+
+boost::optional<DamagesOutput> computeDamages(const BSONObj& pre, const Diff& diff) {
+    DocumentDiffReader reader(diff);
+    return DamagesCalculator(pre).compute(pre, &reader);
+}
 }  // namespace mongo::doc_diff
@@ -29,9 +29,13 @@
 
 #pragma once
 
+#include <boost/optional.hpp>
+
 #include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/bson/mutable/damage_vector.h"
 #include "mongo/db/update/document_diff_serialization.h"
 #include "mongo/db/update_index_data.h"
+#include "mongo/util/shared_buffer.h"
 
 namespace mongo {
 namespace doc_diff {
@@ -46,5 +50,18 @@ struct ApplyDiffOutput {
  * indexData' parameter is optional, if provided computes whether the indexes are affected.
  */
 ApplyDiffOutput applyDiff(const BSONObj& pre, const Diff& diff, const UpdateIndexData* indexData);
+
+struct DamagesOutput {
+    SharedBuffer damageSource;
+    mutablebson::DamageVector damages;
+};
+
+/**
+ * Computes the damages which, applied in order to the bytes of 'pre', produce the same post image
+ * as applyDiff(). The damages may change the size of the document. Returns boost::none if the diff
+ * cannot be expressed as damages to 'pre', for instance because it resizes an array or pads it
+ * with new elements. Throws if the diff is invalid.
+ */
+boost::optional<DamagesOutput> computeDamages(const BSONObj& pre, const Diff& diff);
 }  // namespace doc_diff
 }  // namespace mongo
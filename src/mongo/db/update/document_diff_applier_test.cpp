@@ -33,6 +33,7 @@
 
 #include "mongo/bson/json.h"
 #include "mongo/db/update/document_diff_applier.h"
+#include "mongo/db/update/document_diff_calculator.h"
 #include "mongo/db/update/document_diff_serialization.h"
 #include "mongo/db/update/document_diff_test_helpers.h"
 #include "mongo/logv2/log.h"
@@ -41,9 +42,34 @@
 namespace mongo::doc_diff {
 namespace {
 /**
- * Checks that applying the diff (once or twice) to 'preImage' produces the expected post image.
+ * Applies the damages computed for 'diff' to a copy of 'preImage'. Returns boost::none if the diff
+ * cannot be expressed as damages.
+ */
+boost::optional<std::string> applyDamages(const BSONObj& preImage, const Diff& diff) {
+    auto damagesOutput = computeDamages(preImage, diff);
+    if (!damagesOutput) {
+        return boost::none;
+    }
+
+    std::string postImage(preImage.objdata(), preImage.objsize());
+    for (const auto& damage : damagesOutput->damages) {
+        postImage.replace(damage.targetOffset,
+                          damage.targetSize,
+                          damagesOutput->damageSource.get() + damage.sourceOffset,
+                          damage.size);
+    }
+    return postImage;
+}
+
+/**
+ * Checks that applying the diff (once or twice) to 'preImage' produces the expected post image,
+ * both through applyDiff() and through the damages computed from the diff.
  */
 void checkDiff(const BSONObj& preImage, const BSONObj& expectedPost, const Diff& diff) {
+    if (auto damagedPostImage = applyDamages(preImage, diff)) {
+        ASSERT_BSONOBJ_BINARY_EQ(BSONObj(damagedPostImage->data()), expectedPost);
+    }
+
     BSONObj postImage = applyDiffTestHelper(preImage, diff);
 
     // This *MUST* check for binary equality, which is what we enforce between replica set
@@ -398,5 +424,62 @@ TEST(DiffApplierTest, DuplicateFieldNames) {
         4728000);
 }
 
+TEST(DiffApplierTest, DamagesChangeSizeOfNestedObjects) {
+    const BSONObj preImage(fromjson(
+        "{a: 1, obj: {b: 'short', c: {d: 1}, e: [1, 'two', {f: 3}]}, g: 'unchanged', h: 1}"));
+    const auto diff = fromjson(
+        "{d: {h: false}, u: {z: 'new'}, i: {a: 'moved'},"
+        " sobj: {u: {b: 'a much longer string'}, sc: {d: {d: false}, i: {x: 1}},"
+        "        se: {a: true, u1: 'longer', s2: {d: {f: false}}}}}");
+
+    auto damagedPostImage = applyDamages(preImage, diff);
+    ASSERT(damagedPostImage);
+    ASSERT_BSONOBJ_BINARY_EQ(BSONObj(damagedPostImage->data()),
+                             applyDiffTestHelper(preImage, diff));
+    ASSERT_BSONOBJ_BINARY_EQ(BSONObj(damagedPostImage->data()),
+                             fromjson("{obj: {b: 'a much longer string', c: {x: 1},"
+                                      " e: [1, 'longer', {}]}, g: 'unchanged', z: 'new',"
+                                      " a: 'moved'}"));
+}
+
+TEST(DiffApplierTest, DamagesRoundTripSizeChangingDiffs) {
+    const BSONObj preImage(
+        fromjson("{_id: 1, s: 'abcdefghijklmnopqrstuvwxyz', n: 1, obj: {x: 'xxxxxxxxxx', y: 2},"
+                 " arr: ['aaaaaaaaaa', {z: 'zzzzzzzzzz'}], tail: 'unchanged'}"));
+    const std::vector<BSONObj> postImages = {
+        // Grow and shrink top-level fields.
+        fromjson("{_id: 1, s: 'abcdefghijklmnopqrstuvwxyz0123456789', n: 1.5,"
+                 " obj: {x: 'xxxxxxxxxx', y: 2}, arr: ['aaaaaaaaaa', {z: 'zzzzzzzzzz'}],"
+                 " tail: 'unchanged'}"),
+        fromjson("{_id: 1, s: 'a', n: 1, obj: {x: 'xxxxxxxxxx', y: 2},"
+                 " arr: ['aaaaaaaaaa', {z: 'zzzzzzzzzz'}], tail: 'unchanged'}"),
+        // Resize nested objects and array elements without resizing the array.
+        fromjson("{_id: 1, s: 'abcdefghijklmnopqrstuvwxyz', n: 1, obj: {x: 'x', y: 2, w: 'new'},"
+                 " arr: ['a much longer string than before', {z: 'z'}], tail: 'unchanged'}"),
+        // Remove, add and change the type of fields.
+        fromjson("{_id: 1, s: {now: 'an object'}, obj: {y: 'two'},"
+                 " arr: ['aaaaaaaaaa', {z: 'zzzzzzzzzz'}], tail: 'unchanged', added: [1, 2, 3]}"),
+    };
+
+    for (const auto& postImage : postImages) {
+        auto diffResult = computeDiff(preImage, postImage, 0, nullptr);
+        ASSERT(diffResult);
+        ASSERT_BSONOBJ_BINARY_EQ(applyDiffTestHelper(preImage, diffResult->diff), postImage);
+
+        auto damagedPostImage = applyDamages(preImage, diffResult->diff);
+        ASSERT(damagedPostImage);
+        ASSERT_EQ(damagedPostImage->size(), static_cast<size_t>(postImage.objsize()));
+        ASSERT_BSONOBJ_BINARY_EQ(BSONObj(damagedPostImage->data()), postImage);
+    }
+}
+
+TEST(DiffApplierTest, NoDamagesForArrayResize) {
+    const BSONObj preImage(fromjson("{arr: [1, 2, 3]}"));
+
+    ASSERT_FALSE(computeDamages(preImage, fromjson("{sarr: {a: true, l: 2}}")));
+    ASSERT_FALSE(computeDamages(preImage, fromjson("{sarr: {a: true, u5: 1}}")));
+    ASSERT(computeDamages(preImage, fromjson("{sarr: {a: true, u2: 1}}")));
+}
+
 }  // namespace
 }  // namespace mongo::doc_diff
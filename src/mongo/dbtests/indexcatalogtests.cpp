@@ -33,8 +33,10 @@
 #include "mongo/db/catalog/index_catalog.h"
 #include "mongo/db/client.h"
 #include "mongo/db/db_raii.h"
+#include "mongo/db/index/index_access_method.h"
 #include "mongo/db/index/index_descriptor.h"
 #include "mongo/db/storage/durable_catalog.h"
+#include "mongo/db/storage/key_string.h"
 #include "mongo/dbtests/dbtests.h"
 
 namespace IndexCatalogTests {
@@ -231,6 +233,93 @@ private:
     Database* _db;
 };
 
+/**
+ * Test that IndexAccessMethod::insertSortedKeys() rejects a batch of keys which collide with each
+ * other in a unique index before inserting any of them.
+ */
+class InsertSortedKeysRejectsDuplicatesWithinBatch {
+public:
+    InsertSortedKeysRejectsDuplicatesWithinBatch() {
+        const ServiceContext::UniqueOperationContext opCtxPtr = cc().makeOperationContext();
+        OperationContext& opCtx = *opCtxPtr;
+        Lock::DBLock lk(&opCtx, _nss.db(), MODE_X);
+        OldClientContext ctx(&opCtx, _nss.ns());
+        WriteUnitOfWork wuow(&opCtx);
+
+        _db = ctx.db();
+        _coll = _db->createCollection(&opCtx, _nss);
+        _catalog = _coll->getIndexCatalog();
+        wuow.commit();
+    }
+
+    ~InsertSortedKeysRejectsDuplicatesWithinBatch() {
+        const ServiceContext::UniqueOperationContext opCtxPtr = cc().makeOperationContext();
+        OperationContext& opCtx = *opCtxPtr;
+        Lock::DBLock lk(&opCtx, _nss.db(), MODE_X);
+        OldClientContext ctx(&opCtx, _nss.ns());
+        WriteUnitOfWork wuow(&opCtx);
+
+        _db->dropCollection(&opCtx, _nss).transitional_ignore();
+        wuow.commit();
+    }
+
+    void run() {
+        const ServiceContext::UniqueOperationContext opCtxPtr = cc().makeOperationContext();
+        OperationContext& opCtx = *opCtxPtr;
+        dbtests::WriteContextForTests ctx(&opCtx, _nss.ns());
+
+        ASSERT_OK(dbtests::createIndexFromSpec(&opCtx,
+                                               _nss.ns(),
+                                               BSON("name"
+                                                    << "x_1"
+                                                    << "key" << BSON("x" << 1) << "unique" << true
+                                                    << "v" << static_cast<int>(kIndexVersion))));
+        const IndexDescriptor* desc = _catalog->findIndexByName(&opCtx, "x_1");
+        ASSERT(desc);
+        IndexAccessMethod* accessMethod = desc->getEntry()->accessMethod();
+        SortedDataInterface* sortedData = accessMethod->getSortedDataInterface();
+
+        InsertDeleteOptions options;
+        _catalog->prepareInsertDeleteOptions(&opCtx, _nss, desc, &options);
+        options.dupsAllowed = false;
+
+        // Keys of the records with the given ids and values of 'x', as a batch insert sorts them.
+        auto makeKeys = [&](std::vector<std::pair<int64_t, int>> records) {
+            KeyStringSet keys;
+            for (const auto& [id, x] : records) {
+                keys.insert(KeyString::HeapBuilder(sortedData->getKeyStringVersion(),
+                                                   BSON("" << x),
+                                                   sortedData->getOrdering(),
+                                                   RecordId(id))
+                                .release());
+            }
+            return keys;
+        };
+
+        WriteUnitOfWork wuow(&opCtx);
+
+        // Records 2 and 3 both have x: 2, so their keys are adjacent once sorted.
+        int64_t numInserted = -1;
+        Status status = accessMethod->insertSortedKeys(
+            &opCtx, makeKeys({{1, 1}, {2, 2}, {3, 2}, {4, 3}}), options, &numInserted);
+        ASSERT_EQ(ErrorCodes::DuplicateKey, status.code());
+        ASSERT_EQ(0, numInserted);
+        ASSERT(sortedData->isEmpty(&opCtx));
+
+        ASSERT_OK(accessMethod->insertSortedKeys(
+            &opCtx, makeKeys({{1, 1}, {2, 2}, {4, 3}}), options, &numInserted));
+        ASSERT_EQ(3, numInserted);
+        ASSERT_EQ(3, sortedData->numEntries(&opCtx));
+
+        wuow.commit();
+    }
+
+private:
+    IndexCatalog* _catalog;
+    Collection* _coll;
+    Database* _db;
+};
+
 class IndexCatalogTests : public OldStyleSuiteSpecification {
 public:
     IndexCatalogTests() : OldStyleSuiteSpecification("indexcatalogtests") {}
@@ -238,6 +327,7 @@ public:
         add<IndexIteratorTests>();
         add<IndexCatalogEntryDroppedTest>();
         add<RefreshEntry>();
+        add<InsertSortedKeysRejectsDuplicatesWithinBatch>();
     }
 };
 
@@ -0,0 +1,245 @@
+/**
+ *    Copyright (C) 2021-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+/**
+ * This file tests db/exec/batched_delete_stage.cpp.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <limits>
+#include <memory>
+
+#include "mongo/db/catalog/collection.h"
+#include "mongo/db/client.h"
+#include "mongo/db/db_raii.h"
+#include "mongo/db/dbdirectclient.h"
+#include "mongo/db/exec/batched_delete_stage.h"
+#include "mongo/db/exec/collection_scan.h"
+#include "mongo/db/service_context.h"
+#include "mongo/db/storage/storage_options.h"
+#include "mongo/dbtests/dbtests.h"
+#include "mongo/util/fail_point.h"
+#include "mongo/util/scopeguard.h"
+
+namespace QueryStageBatchedDelete {
+
+static const NamespaceString nss("unittests.QueryStageBatchedDelete");
+
+class QueryStageBatchedDeleteBase {
+public:
+    QueryStageBatchedDeleteBase() : _client(&_opCtx) {
+        dbtests::WriteContextForTests ctx(&_opCtx, nss.ns());
+
+        for (size_t i = 0; i < numObj(); ++i) {
+            _client.insert(nss.ns(), BSON("_id" << static_cast<long long>(i)));
+        }
+    }
+
+    virtual ~QueryStageBatchedDeleteBase() {
+        dbtests::WriteContextForTests ctx(&_opCtx, nss.ns());
+        _client.dropCollection(nss.ns());
+    }
+
+    /**
+     * Returns a stage which deletes every document of 'coll' in batches of 'targetBatchDocs'.
+     */
+    std::unique_ptr<BatchedDeleteStage> makeBatchedDeleteStage(const CollectionPtr& coll,
+                                                               long long targetBatchDocs) {
+        CollectionScanParams collScanParams;
+        collScanParams.direction = CollectionScanParams::FORWARD;
+        collScanParams.tailable = false;
+
+        auto deleteStageParams = std::make_unique<DeleteStageParams>();
+        deleteStageParams->isMulti = true;
+
+        auto batchedDeleteParams = std::make_unique<BatchedDeleteStageParams>();
+        batchedDeleteParams->targetBatchDocs = targetBatchDocs;
+        batchedDeleteParams->targetBatchBytes = std::numeric_limits<long long>::max();
+
+        return std::make_unique<BatchedDeleteStage>(
+            _expCtx.get(),
+            std::move(deleteStageParams),
+            std::move(batchedDeleteParams),
+            &_ws,
+            coll,
+            new CollectionScan(_expCtx.get(), coll, collScanParams, &_ws, nullptr));
+    }
+
+    /**
+     * Works 'stage' until it has committed its first batch, checking that nothing is deleted
+     * before then. Returns the state the stage returned when it committed the batch.
+     */
+    PlanStage::StageState workUntilFirstBatch(const CollectionPtr& coll,
+                                              BatchedDeleteStage* stage) {
+        const auto stats = static_cast<const DeleteStats*>(stage->getSpecificStats());
+        for (size_t i = 0; i <= numObj(); ++i) {
+            WorkingSetID id = WorkingSet::INVALID_ID;
+            auto state = stage->work(&id);
+            if (stats->docsDeleted > 0) {
+                return state;
+            }
+            ASSERT_EQUALS(PlanStage::NEED_TIME, state);
+            ASSERT_EQUALS(static_cast<long long>(numObj()), coll->numRecords(&_opCtx));
+        }
+        FAIL("The batched delete stage never committed a batch");
+        MONGO_UNREACHABLE;
+    }
+
+    static size_t numObj() {
+        return 50;
+    }
+
+protected:
+    const ServiceContext::UniqueOperationContext _txnPtr = cc().makeOperationContext();
+    OperationContext& _opCtx = *_txnPtr;
+
+    boost::intrusive_ptr<ExpressionContext> _expCtx =
+        make_intrusive<ExpressionContext>(&_opCtx, nullptr, nss);
+
+    WorkingSet _ws;
+    DBDirectClient _client;
+};
+
+// The documents are deleted only once a whole batch of them has been buffered, all at once.
+class QueryStageBatchedDeleteCommitsWholeBatches : public QueryStageBatchedDeleteBase {
+public:
+    void run() {
+        dbtests::WriteContextForTests ctx(&_opCtx, nss.ns());
+        const CollectionPtr& coll = ctx.getCollection();
+        ASSERT(coll);
+
+        auto deleteStage = makeBatchedDeleteStage(coll, 10);
+        const auto stats = static_cast<const DeleteStats*>(deleteStage->getSpecificStats());
+
+        ASSERT_EQUALS(PlanStage::NEED_TIME, workUntilFirstBatch(coll, deleteStage.get()));
+        ASSERT_EQUALS(10U, stats->docsDeleted);
+        ASSERT_EQUALS(static_cast<long long>(numObj() - 10), coll->numRecords(&_opCtx));
+
+        while (!deleteStage->isEOF()) {
+            WorkingSetID id = WorkingSet::INVALID_ID;
+            auto state = deleteStage->work(&id);
+            ASSERT(PlanStage::NEED_TIME == state || PlanStage::IS_EOF == state);
+            ASSERT_EQUALS(0U, stats->docsDeleted % 10);
+        }
+        ASSERT_EQUALS(numObj(), stats->docsDeleted);
+        ASSERT_EQUALS(0, coll->numRecords(&_opCtx));
+    }
+};
+
+// A document which is deleted by someone else while it is buffered across a yield is skipped when
+// the batch is deleted.
+class QueryStageBatchedDeleteStagedDocumentDeletedDuringYield : public QueryStageBatchedDeleteBase {
+public:
+    void run() {
+        dbtests::WriteContextForTests ctx(&_opCtx, nss.ns());
+        const CollectionPtr& coll = ctx.getCollection();
+        ASSERT(coll);
+
+        auto deleteStage = makeBatchedDeleteStage(coll, 10);
+        const auto stats = static_cast<const DeleteStats*>(deleteStage->getSpecificStats());
+
+        // Buffer some documents, including the first one, without filling the batch.
+        for (int i = 0; i < 5; ++i) {
+            WorkingSetID id = WorkingSet::INVALID_ID;
+            ASSERT_EQUALS(PlanStage::NEED_TIME, deleteStage->work(&id));
+        }
+        ASSERT_EQUALS(0U, stats->docsDeleted);
+
+        static_cast<PlanStage*>(deleteStage.get())->saveState();
+        _client.remove(nss.ns(), BSON("_id" << 0LL));
+        static_cast<PlanStage*>(deleteStage.get())->restoreState(&coll);
+
+        while (!deleteStage->isEOF()) {
+            WorkingSetID id = WorkingSet::INVALID_ID;
+            auto state = deleteStage->work(&id);
+            ASSERT(PlanStage::NEED_TIME == state || PlanStage::IS_EOF == state);
+        }
+        ASSERT_EQUALS(numObj() - 1, stats->docsDeleted);
+        ASSERT_EQUALS(0, coll->numRecords(&_opCtx));
+    }
+};
+
+// A write conflict rolls back the whole batch, which is deleted again after yielding.
+class QueryStageBatchedDeleteRetriesBatchOnWriteConflict : public QueryStageBatchedDeleteBase {
+public:
+    void run() {
+        if (storageGlobalParams.engine != "wiredTiger") {
+            return;
+        }
+
+        dbtests::WriteContextForTests ctx(&_opCtx, nss.ns());
+        const CollectionPtr& coll = ctx.getCollection();
+        ASSERT(coll);
+
+        auto deleteStage = makeBatchedDeleteStage(coll, 10);
+        const auto stats = static_cast<const DeleteStats*>(deleteStage->getSpecificStats());
+
+        // Buffering documents does not write anything, so the write conflict hits the first delete
+        // of the batch.
+        auto failPoint = globalFailPointRegistry().find("WTWriteConflictException");
+        failPoint->setMode(FailPoint::nTimes, 1);
+        ON_BLOCK_EXIT([&] { failPoint->setMode(FailPoint::off); });
+
+        auto state = PlanStage::NEED_TIME;
+        for (size_t i = 0; i <= numObj() && state == PlanStage::NEED_TIME; ++i) {
+            WorkingSetID id = WorkingSet::INVALID_ID;
+            state = deleteStage->work(&id);
+        }
+        ASSERT_EQUALS(PlanStage::NEED_YIELD, state);
+        ASSERT_EQUALS(0U, stats->docsDeleted);
+        ASSERT_EQUALS(static_cast<long long>(numObj()), coll->numRecords(&_opCtx));
+
+        // Yield, then retry the same batch.
+        static_cast<PlanStage*>(deleteStage.get())->saveState();
+        _opCtx.recoveryUnit()->abandonSnapshot();
+        static_cast<PlanStage*>(deleteStage.get())->restoreState(&coll);
+
+        WorkingSetID id = WorkingSet::INVALID_ID;
+        ASSERT_EQUALS(PlanStage::NEED_TIME, deleteStage->work(&id));
+        ASSERT_EQUALS(10U, stats->docsDeleted);
+        ASSERT_EQUALS(static_cast<long long>(numObj() - 10), coll->numRecords(&_opCtx));
+    }
+};
+
+class All : public OldStyleSuiteSpecification {
+public:
+    All() : OldStyleSuiteSpecification("query_stage_batched_delete") {}
+
+    void setupTests() {
+        add<QueryStageBatchedDeleteCommitsWholeBatches>();
+        add<QueryStageBatchedDeleteStagedDocumentDeletedDuringYield>();
+        add<QueryStageBatchedDeleteRetriesBatchOnWriteConflict>();
+    }
+};
+
+OldStyleSuiteInitializer<All> all;
+
+}  // namespace QueryStageBatchedDelete
@@ -44,6 +44,7 @@
 #include "mongo/db/dbdirectclient.h"
 #include "mongo/db/exec/collection_scan.h"
 #include "mongo/db/exec/plan_stage.h"
+#include "mongo/db/exec/shared_oplog_scan.h"
 #include "mongo/db/json.h"
 #include "mongo/db/matcher/expression_parser.h"
 #include "mongo/db/namespace_string.h"
@@ -52,6 +53,7 @@
 #include "mongo/dbtests/dbtests.h"
 #include "mongo/unittest/unittest.h"
 #include "mongo/util/fail_point.h"
+#include "mongo/util/scopeguard.h"
 
 namespace query_stage_collection_scan {
 
@@ -802,4 +804,61 @@ TEST_F(QueryStageCollectionScanTest, QueryTestCollscanClusteredInnerRangeExclusi
 
     ASSERT_EQ(count, expectedIds.size());
 }
+
+// The shared oplog scan hands each subscriber the entries its filter matches, and only considers
+// CRUD entries for the subscribers watching their namespace.
+TEST_F(QueryStageCollectionScanTest, SharedOplogScanDispatchesMatchingEntries) {
+    const NamespaceString oplogNss{"unittests.QueryStageCollectionScanSharedOplogScan"};
+    DBDirectClient client(&_opCtx);
+    ON_BLOCK_EXIT([&] { client.dropCollection(oplogNss.ns()); });
+
+    auto makeEntry = [](unsigned inc, StringData op, StringData ns, BSONObj o) {
+        return BSON("ts" << Timestamp(1, inc) << "op" << op << "ns" << ns << "o" << o);
+    };
+    client.insert(oplogNss.ns(), makeEntry(1, "n", "", BSONObj()));
+    client.insert(oplogNss.ns(), makeEntry(2, "i", "test.a", BSON("keep" << true)));
+    client.insert(oplogNss.ns(), makeEntry(3, "i", "test.b", BSON("keep" << true)));
+    client.insert(oplogNss.ns(), makeEntry(4, "i", "other.a", BSON("keep" << true)));
+    client.insert(oplogNss.ns(), makeEntry(5, "u", "test.a", BSON("keep" << false)));
+    client.insert(oplogNss.ns(), makeEntry(6, "c", "test.$cmd", BSON("drop" << "a")));
+
+    AutoGetCollectionForReadCommand collection(&_opCtx, oplogNss);
+    vector<RecordId> recordIds;
+    getRecordIds(collection.getCollection(), CollectionScanParams::FORWARD, &recordIds);
+    ASSERT_EQ(6U, recordIds.size());
+
+    auto filter = MatchExpressionParser::parse(BSON("o.keep" << true), _expCtx);
+    ASSERT_OK(filter.getStatus());
+
+    SharedOplogScan scan;
+    auto collectionSubscription = scan.join(
+        _expCtx, NamespaceString("test.a"), filter.getValue().get(), recordIds[0]);
+    auto databaseSubscription = scan.join(
+        _expCtx, NamespaceString::makeCollectionlessAggregateNSS("test"), nullptr, recordIds[0]);
+    ASSERT(collectionSubscription);
+    ASSERT(databaseSubscription);
+    ASSERT_EQ(2U, scan.numSubscribers());
+
+    auto drain = [&](SharedOplogScan::Subscription* subscription) {
+        std::vector<unsigned> increments;
+        for (;;) {
+            auto next = subscription->next(&_opCtx, collection.getCollection());
+            ASSERT_FALSE(next.detached);
+            if (!next.entry) {
+                ASSERT_EQ(Timestamp(1, 6), next.scannedThrough);
+                return increments;
+            }
+            increments.push_back(next.entry->obj["ts"].timestamp().getInc());
+        }
+    };
+    ASSERT(drain(collectionSubscription.get()) == std::vector<unsigned>({2}));
+    ASSERT(drain(databaseSubscription.get()) == std::vector<unsigned>({2, 3, 5, 6}));
+
+    // The scan is past the first entry, so a stream which has only seen it cannot join any more.
+    ASSERT_FALSE(scan.join(_expCtx, NamespaceString("test.b"), nullptr, recordIds[0]));
+
+    collectionSubscription.reset();
+    databaseSubscription.reset();
+    ASSERT_EQ(0U, scan.numSubscribers());
+}
 }  // namespace query_stage_collection_scan
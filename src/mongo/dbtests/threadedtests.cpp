@@ -259,7 +259,7 @@ private:
     };
 
     Hotel _hotel;
-    TicketHolder _tickets;
+    SemaphoreTicketHolder _tickets;
 
     virtual void subthread(int x) {
         string threadName = (str::stream() << "ticketHolder" << x);
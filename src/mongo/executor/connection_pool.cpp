@@ -226,9 +226,12 @@ class ConnectionPool::SpecificPool final
     : public std::enable_shared_from_this<ConnectionPool::SpecificPool> {
     static constexpr auto kDiagnosticLogLevel = 4;
 
+    friend class ConnectionPool;
+
 public:
     /**
-     * Whenever a function enters a specific pool, the function needs to be guarded by the lock.
+     * Whenever a function enters a specific pool, the function needs to be guarded by the pool's
+     * own lock.
      *
      * This callback also (perhaps overly aggressively) binds a shared pointer to the guard.
      * It is *always* safe to reference the original specific pool in the guarded function object.
@@ -243,7 +246,7 @@ public:
     auto guardCallback(Callback&& cb) {
         return
             [this, cb = std::forward<Callback>(cb), anchor = shared_from_this()](auto&&... args) {
-                stdx::lock_guard lk(_parent->_mutex);
+                stdx::lock_guard lk(_mutex);
                 cb(std::forward<decltype(args)>(args)...);
                 updateState();
             };
@@ -270,8 +273,7 @@ public:
     void updateState();
 
     /**
-     * Gets a connection from the specific pool. Sinks a unique_lock from the
-     * parent to preserve the lock on _mutex
+     * Gets a connection from the specific pool. The caller must hold this pool's _mutex.
      */
     Future<ConnectionHandle> getConnection(Milliseconds timeout);
 
@@ -280,6 +282,8 @@ public:
      * and calls processFailure below with the status provided. This immediately removes this pool
      * from the ConnectionPool. The actual destruction will happen eventually as ConnectionHandles
      * are deleted.
+     *
+     * The caller must hold this pool's _mutex. The parent's _mutex is acquired to delist the pool.
      */
     void triggerShutdown(const Status& status);
 
@@ -392,12 +396,18 @@ private:
     // Update the event timer for this host pool
     void updateEventTimer();
 
-    // Update the controller and potentially change the controls
+    // Update the controller and potentially change the controls. This acquires this pool's
+    // _mutex itself and releases it before touching any other pool in the same host group.
     void updateController();
 
 private:
     const std::shared_ptr<ConnectionPool> _parent;
 
+    // Guards everything below. Pools for different hosts never contend with each other, and this
+    // is always acquired before the parent's _mutex.
+    mutable Mutex _mutex = MONGO_MAKE_LATCH(HierarchicalAcquisitionLevel(2),
+                                            "ExecutorConnectionPool::SpecificPool::_mutex");
+
     const transport::ConnectSSLMode _sslMode;
     const HostAndPort _hostAndPort;
 
@@ -481,37 +491,34 @@ ConnectionPool::~ConnectionPool() {
 void ConnectionPool::shutdown() {
     _factory->shutdown();
 
-    // Grab all current pools (under the lock)
-    auto pools = [&] {
-        stdx::lock_guard lk(_mutex);
-        return _pools;
-    }();
+    // Grab all current pools. Each one delists itself from the map as it shuts down.
+    auto pools = _getPools();
 
-    for (const auto& pair : pools) {
-        stdx::lock_guard lk(_mutex);
-        pair.second->triggerShutdown(
+    for (const auto& pair : *pools) {
+        auto& pool = pair.second;
+        stdx::lock_guard lk(pool->_mutex);
+        pool->triggerShutdown(
             Status(ErrorCodes::ShutdownInProgress, "Shutting down the connection pool"));
     }
 }
 
 void ConnectionPool::dropConnections(const HostAndPort& hostAndPort) {
-    stdx::lock_guard lk(_mutex);
-
-    auto iter = _pools.find(hostAndPort);
+    auto pool = _findPool(hostAndPort);
 
-    if (iter == _pools.end())
+    if (!pool)
         return;
 
-    auto& pool = iter->second;
+    stdx::lock_guard lk(pool->_mutex);
     pool->triggerShutdown(
         Status(ErrorCodes::PooledConnectionsDropped, "Pooled connections dropped"));
 }
 
 void ConnectionPool::dropConnections(transport::Session::TagMask tags) {
-    stdx::lock_guard lk(_mutex);
+    auto pools = _getPools();
 
-    for (const auto& pair : _pools) {
+    for (const auto& pair : *pools) {
         auto& pool = pair.second;
+        stdx::lock_guard lk(pool->_mutex);
 
         if (pool->matchesTags(tags))
             continue;
@@ -524,14 +531,12 @@ void ConnectionPool::dropConnections(transport::Session::TagMask tags) {
 void ConnectionPool::mutateTags(
     const HostAndPort& hostAndPort,
     const std::function<transport::Session::TagMask(transport::Session::TagMask)>& mutateFunc) {
-    stdx::lock_guard lk(_mutex);
+    auto pool = _findPool(hostAndPort);
 
-    auto iter = _pools.find(hostAndPort);
-
-    if (iter == _pools.end())
+    if (!pool)
         return;
 
-    auto pool = iter->second;
+    stdx::lock_guard lk(pool->_mutex);
     pool->mutateTags(mutateFunc);
 }
 
@@ -550,31 +555,75 @@ void ConnectionPool::get_forTest(const HostAndPort& hostAndPort,
 SemiFuture<ConnectionPool::ConnectionHandle> ConnectionPool::get(const HostAndPort& hostAndPort,
                                                                  transport::ConnectSSLMode sslMode,
                                                                  Milliseconds timeout) {
-    stdx::lock_guard lk(_mutex);
-
-    auto& pool = _pools[hostAndPort];
-    if (!pool) {
-        pool = SpecificPool::make(shared_from_this(), hostAndPort, sslMode);
-    } else {
+    while (true) {
+        auto pool = _getOrMakePool(hostAndPort, sslMode);
+        invariant(pool);
         pool->fassertSSLModeIs(sslMode);
+
+        stdx::lock_guard lk(pool->_mutex);
+        if (pool->_health.isShutdown) {
+            // The pool was delisted between the lookup and taking its lock, so the next lookup
+            // will find or make its replacement.
+            continue;
+        }
+
+        auto connFuture = pool->getConnection(timeout);
+        pool->updateState();
+
+        return std::move(connFuture).semi();
     }
+}
 
-    invariant(pool);
+auto ConnectionPool::_getPools() const -> std::shared_ptr<PoolMap> {
+    return atomic_load(&_pools);
+}
+
+auto ConnectionPool::_findPool(const HostAndPort& hostAndPort) const
+    -> std::shared_ptr<SpecificPool> {
+    auto pools = _getPools();
 
-    auto connFuture = pool->getConnection(timeout);
-    pool->updateState();
+    auto iter = pools->find(hostAndPort);
+    if (iter == pools->end())
+        return nullptr;
 
-    return std::move(connFuture).semi();
+    return iter->second;
 }
 
-void ConnectionPool::appendConnectionStats(ConnectionPoolStats* stats) const {
+auto ConnectionPool::_getOrMakePool(const HostAndPort& hostAndPort,
+                                    transport::ConnectSSLMode sslMode)
+    -> std::shared_ptr<SpecificPool> {
+    // Nearly every request is for a host that already has a pool, so look there first without
+    // taking any lock.
+    if (auto pool = _findPool(hostAndPort)) {
+        return pool;
+    }
+
     stdx::lock_guard lk(_mutex);
 
+    // Someone else may have made the pool since we took our snapshot
+    auto iter = _pools->find(hostAndPort);
+    if (iter != _pools->end()) {
+        return iter->second;
+    }
+
+    auto pool = SpecificPool::make(shared_from_this(), hostAndPort, sslMode);
+
+    auto poolsCopy = std::make_shared<PoolMap>(*_pools);
+    poolsCopy->emplace(hostAndPort, pool);
+    atomic_store(&_pools, std::move(poolsCopy));
+
+    return pool;
+}
+
+void ConnectionPool::appendConnectionStats(ConnectionPoolStats* stats) const {
     _controller->updateConnectionPoolStats(stats);
-    for (const auto& kv : _pools) {
+
+    auto pools = _getPools();
+    for (const auto& kv : *pools) {
         HostAndPort host = kv.first;
 
         auto& pool = kv.second;
+        stdx::lock_guard lk(pool->_mutex);
         ConnectionStatsPer hostStats{pool->inUseConnections(),
                                      pool->availableConnections(),
                                      pool->createdConnections(),
@@ -584,10 +633,9 @@ void ConnectionPool::appendConnectionStats(ConnectionPoolStats* stats) const {
 }
 
 size_t ConnectionPool::getNumConnectionsPerHost(const HostAndPort& hostAndPort) const {
-    stdx::lock_guard lk(_mutex);
-    auto iter = _pools.find(hostAndPort);
-    if (iter != _pools.end()) {
-        return iter->second->openConnections();
+    if (auto pool = _findPool(hostAndPort)) {
+        stdx::lock_guard lk(pool->_mutex);
+        return pool->openConnections();
     }
 
     return 0;
@@ -681,7 +729,7 @@ Future<ConnectionPool::ConnectionHandle> ConnectionPool::SpecificPool::getConnec
 
 auto ConnectionPool::SpecificPool::makeHandle(ConnectionInterface* connection) -> ConnectionHandle {
     auto deleter = [this, anchor = shared_from_this()](ConnectionInterface* connection) {
-        stdx::lock_guard lk(_parent->_mutex);
+        stdx::lock_guard lk(_mutex);
         returnConnection(connection);
         _lastActiveTime = _parent->_factory->now();
         updateState();
@@ -904,8 +952,17 @@ void ConnectionPool::SpecificPool::triggerShutdown(const Status& status) {
     // Make sure the pool lifetime lasts until the end of this function,
     // it could be only in the map of pools
     auto anchor = shared_from_this();
-    _parent->_controller->removeHost(_id);
-    _parent->_pools.erase(_hostAndPort);
+    {
+        stdx::lock_guard lk(_parent->_mutex);
+        _parent->_controller->removeHost(_id);
+
+        auto iter = _parent->_pools->find(_hostAndPort);
+        if (iter != _parent->_pools->end() && iter->second.get() == this) {
+            auto poolsCopy = std::make_shared<PoolMap>(*_parent->_pools);
+            poolsCopy->erase(_hostAndPort);
+            atomic_store(&_parent->_pools, std::move(poolsCopy));
+        }
+    }
 
     processFailure(status);
 
@@ -1149,37 +1206,52 @@ void ConnectionPool::SpecificPool::updateEventTimer() {
 }
 
 void ConnectionPool::SpecificPool::updateController() {
-    if (_health.isShutdown) {
+    auto hostGroup = [&]() -> boost::optional<HostGroupState> {
+        stdx::lock_guard lk(_mutex);
+        _updateScheduled = false;
+
+        if (_health.isShutdown) {
+            return boost::none;
+        }
+
+        // Update our own state
+        HostState state{
+            _health,
+            requestsPending(),
+            refreshingConnections(),
+            availableConnections(),
+            inUseConnections(),
+        };
+        LOGV2_DEBUG(22578,
+                    kDiagnosticLogLevel,
+                    "Updating pool controller for {hostAndPort} with state: {poolState}",
+                    "Updating pool controller",
+                    "hostAndPort"_attr = _hostAndPort,
+                    "poolState"_attr = state);
+        return _parent->_controller->updateHost(_id, std::move(state));
+    }();
+
+    if (!hostGroup) {
         return;
     }
 
-    auto& controller = *_parent->_controller;
-
-    // Update our own state
-    HostState state{
-        _health,
-        requestsPending(),
-        refreshingConnections(),
-        availableConnections(),
-        inUseConnections(),
-    };
-    LOGV2_DEBUG(22578,
-                kDiagnosticLogLevel,
-                "Updating pool controller for {hostAndPort} with state: {poolState}",
-                "Updating pool controller",
-                "hostAndPort"_attr = _hostAndPort,
-                "poolState"_attr = state);
-    auto hostGroup = controller.updateHost(_id, std::move(state));
+    // Our own lock is released from here on, since the host group may include other pools whose
+    // locks are at the same level as ours.
 
     // If we can shutdown, then do so
-    if (hostGroup.canShutdown) {
-        for (const auto& host : hostGroup.hosts) {
-            auto it = _parent->_pools.find(host);
-            if (it == _parent->_pools.end()) {
+    if (hostGroup->canShutdown) {
+        for (const auto& host : hostGroup->hosts) {
+            auto pool = _parent->_findPool(host);
+            if (!pool) {
+                continue;
+            }
+
+            stdx::lock_guard lk(pool->_mutex);
+            if (pool->_health.isShutdown) {
+                // Somebody else got here first
                 continue;
             }
 
-            auto& pool = it->second;
             if (!pool->_health.isExpired) {
                 // Just because a HostGroup "canShutdown" doesn't mean that a SpecificPool should
                 // shutdown. For example, it is always inappropriate to shutdown a SpecificPool with
@@ -1210,12 +1282,11 @@ void ConnectionPool::SpecificPool::updateController() {
 
 
     // Make sure all related hosts exist
-    for (const auto& host : hostGroup.hosts) {
-        if (auto& pool = _parent->_pools[host]; !pool) {
-            pool = SpecificPool::make(_parent, host, _sslMode);
-        }
+    for (const auto& host : hostGroup->hosts) {
+        _parent->_getOrMakePool(host, _sslMode);
     }
 
+    stdx::lock_guard lk(_mutex);
     spawnConnections();
 }
 
@@ -1242,8 +1313,6 @@ void ConnectionPool::SpecificPool::updateState() {
         .getAsync([this, anchor = shared_from_this()](Status&& status) mutable {
             invariant(status);
 
-            stdx::lock_guard lk(_parent->_mutex);
-            _updateScheduled = false;
             updateController();
         });
 }
@@ -271,11 +271,35 @@ private:
 
     std::shared_ptr<ControllerInterface> _controller;
 
-    // The global mutex for specific pool access and the generation counter
+    using PoolMap = stdx::unordered_map<HostAndPort, std::shared_ptr<SpecificPool>>;
+
+    /**
+     * Returns the current snapshot of the host map. The snapshot is immutable, so it can be
+     * searched or iterated without holding any lock.
+     */
+    std::shared_ptr<PoolMap> _getPools() const;
+
+    /**
+     * Returns the pool for the given host, or nullptr if there is none.
+     */
+    std::shared_ptr<SpecificPool> _findPool(const HostAndPort& hostAndPort) const;
+
+    /**
+     * Returns the pool for the given host, creating and publishing it if there is none yet.
+     */
+    std::shared_ptr<SpecificPool> _getOrMakePool(const HostAndPort& hostAndPort,
+                                                 transport::ConnectSSLMode sslMode);
+
+    // Serializes changes to the host map and the registration of hosts with the controller. Each
+    // SpecificPool guards its own state with its own mutex, which is always acquired before this
+    // one, so this is only ever held for the short time it takes to add or remove a host.
     mutable Mutex _mutex =
         MONGO_MAKE_LATCH(HierarchicalAcquisitionLevel(1), "ExecutorConnectionPool::_mutex");
     PoolId _nextPoolId = 0;
-    stdx::unordered_map<HostAndPort, std::shared_ptr<SpecificPool>> _pools;
+
+    // Copy-on-write map of pools by host. Writers copy the map and swap the copy into place with
+    // atomic_store() while holding _mutex, readers take a snapshot with atomic_load().
+    std::shared_ptr<PoolMap> _pools = std::make_shared<PoolMap>();
 
     EgressTagCloserManager* _manager;
 };
@@ -0,0 +1,214 @@
+/**
+ *    Copyright (C) 2021-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#define MONGO_LOGV2_DEFAULT_COMPONENT ::mongo::logv2::LogComponent::kTest
+
+#include "mongo/platform/basic.h"
+
+#include <benchmark/benchmark.h>
+
+#include "mongo/executor/connection_pool.h"
+#include "mongo/util/concurrency/thread_pool.h"
+
+namespace mongo {
+namespace executor {
+namespace {
+
+const int kMaxPerfThreads = 64;
+
+/**
+ * A timer that never fires. The benchmark only ever runs for a few seconds, which is far less than
+ * any of the pool's refresh or expiration timeouts.
+ */
+class BenchmarkTimer final : public ConnectionPool::TimerInterface {
+public:
+    void setTimeout(Milliseconds timeout, TimeoutCallback cb) override {}
+    void cancelTimeout() override {}
+    Date_t now() override {
+        return Date_t::now();
+    }
+};
+
+/**
+ * A connection that completes its setup and refreshes successfully on the executor, without doing
+ * any networking.
+ */
+class BenchmarkConnection final : public ConnectionPool::ConnectionInterface {
+public:
+    BenchmarkConnection(const HostAndPort& hostAndPort,
+                        size_t generation,
+                        std::shared_ptr<OutOfLineExecutor> executor)
+        : ConnectionInterface(generation),
+          _hostAndPort(hostAndPort),
+          _executor(std::move(executor)) {}
+
+    const HostAndPort& getHostAndPort() const override {
+        return _hostAndPort;
+    }
+    transport::ConnectSSLMode getSslMode() const override {
+        return transport::kGlobalSSLMode;
+    }
+    bool isHealthy() override {
+        return true;
+    }
+
+    void setTimeout(Milliseconds timeout, TimeoutCallback cb) override {}
+    void cancelTimeout() override {}
+    Date_t now() override {
+        return Date_t::now();
+    }
+
+private:
+    void setup(Milliseconds timeout, SetupCallback cb) override {
+        // The pool holds its own lock when it asks for a setup, so the callback has to run later.
+        _executor->schedule(
+            [this, cb = std::move(cb)](Status) mutable { cb(this, Status::OK()); });
+    }
+
+    void refresh(Milliseconds timeout, RefreshCallback cb) override {
+        _executor->schedule(
+            [this, cb = std::move(cb)](Status) mutable { cb(this, Status::OK()); });
+    }
+
+    const HostAndPort _hostAndPort;
+    const std::shared_ptr<OutOfLineExecutor> _executor;
+};
+
+class BenchmarkFactory final : public ConnectionPool::DependentTypeFactoryInterface {
+public:
+    BenchmarkFactory() {
+        ThreadPool::Options options;
+        options.poolName = "ConnectionPoolBenchmark";
+        options.minThreads = 1;
+        options.maxThreads = 4;
+        auto threadPool = std::make_shared<ThreadPool>(std::move(options));
+        threadPool->startup();
+        _threadPool = threadPool;
+        _executor = std::move(threadPool);
+    }
+
+    std::shared_ptr<ConnectionPool::ConnectionInterface> makeConnection(
+        const HostAndPort& hostAndPort,
+        transport::ConnectSSLMode sslMode,
+        size_t generation) override {
+        return std::make_shared<BenchmarkConnection>(hostAndPort, generation, _executor);
+    }
+
+    std::shared_ptr<ConnectionPool::TimerInterface> makeTimer() override {
+        return std::make_shared<BenchmarkTimer>();
+    }
+
+    const std::shared_ptr<OutOfLineExecutor>& getExecutor() override {
+        return _executor;
+    }
+
+    Date_t now() override {
+        return Date_t::now();
+    }
+
+    void shutdown() override {
+        _threadPool->shutdown();
+        _threadPool->join();
+    }
+
+private:
+    std::shared_ptr<ThreadPool> _threadPool;
+    std::shared_ptr<OutOfLineExecutor> _executor;
+};
+
+class ConnectionPoolBenchmark : public benchmark::Fixture {
+public:
+    void setUpPool(int numHosts) {
+        _pool = std::make_shared<ConnectionPool>(std::make_shared<BenchmarkFactory>(),
+                                                 "ConnectionPoolBenchmark");
+        _hosts.clear();
+        for (int i = 0; i < numHosts; ++i) {
+            _hosts.emplace_back("localhost", 20000 + i);
+        }
+    }
+
+    void tearDownPool() {
+        _pool->shutdown();
+        _pool.reset();
+    }
+
+    /**
+     * Checks a connection out of the pool for the host this thread is assigned to and immediately
+     * returns it, which is the common case for a warmed up pool.
+     */
+    void checkOutAndReturn(const benchmark::State& state) {
+        const auto& host = _hosts[state.thread_index % _hosts.size()];
+        auto handle = _pool->get(host, transport::kGlobalSSLMode, Seconds(30)).get();
+        handle->indicateSuccess();
+    }
+
+protected:
+    std::shared_ptr<ConnectionPool> _pool;
+    std::vector<HostAndPort> _hosts;
+};
+
+BENCHMARK_DEFINE_F(ConnectionPoolBenchmark, BM_CheckOutSingleHost)(benchmark::State& state) {
+    if (state.thread_index == 0) {
+        setUpPool(1);
+    }
+
+    for (auto keepRunning : state) {
+        checkOutAndReturn(state);
+    }
+
+    if (state.thread_index == 0) {
+        tearDownPool();
+    }
+}
+
+BENCHMARK_DEFINE_F(ConnectionPoolBenchmark, BM_CheckOutManyHosts)(benchmark::State& state) {
+    // Give every thread a host of its own, so that any contention left is between hosts.
+    if (state.thread_index == 0) {
+        setUpPool(state.threads);
+    }
+
+    for (auto keepRunning : state) {
+        checkOutAndReturn(state);
+    }
+
+    if (state.thread_index == 0) {
+        tearDownPool();
+    }
+}
+
+BENCHMARK_REGISTER_F(ConnectionPoolBenchmark, BM_CheckOutSingleHost)
+    ->ThreadRange(1, kMaxPerfThreads)
+    ->UseRealTime();
+BENCHMARK_REGISTER_F(ConnectionPoolBenchmark, BM_CheckOutManyHosts)
+    ->ThreadRange(1, kMaxPerfThreads)
+    ->UseRealTime();
+
+}  // namespace
+}  // namespace executor
+}  // namespace mongo
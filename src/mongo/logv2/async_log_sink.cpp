@@ -0,0 +1,272 @@
+/**
+ *    Copyright (C) 2021-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/logv2/async_log_sink.h"
+
+#include <fmt/format.h>
+
+#include "mongo/logv2/attribute_storage.h"
+#include "mongo/logv2/json_formatter.h"
+#include "mongo/logv2/log_component.h"
+#include "mongo/logv2/log_tag.h"
+#include "mongo/logv2/log_truncation.h"
+#include "mongo/util/concurrency/thread_name.h"
+#include "mongo/util/time_support.h"
+
+namespace mongo::logv2 {
+namespace {
+
+// Upper bound on how long the writer thread sleeps when idle, in case a wakeup is missed.
+constexpr Milliseconds kIdleWait{100};
+
+// How long a producer blocked on a full queue waits before checking again.
+constexpr Milliseconds kFullWait{1};
+
+size_t roundUpToPowerOfTwo(size_t n) {
+    size_t result = 1;
+    while (result < n) {
+        result <<= 1;
+    }
+    return result;
+}
+
+}  // namespace
+
+std::string formatDroppedLogLines(uint64_t count, LogTimestampFormat timestampFormat) {
+    DynamicAttributes attrs;
+    attrs.add("count", static_cast<long long>(count));
+
+    fmt::memory_buffer buffer;
+    JSONFormatter(nullptr, timestampFormat)
+        .format(buffer,
+                LogSeverity::Warning(),
+                LogComponent::kControl,
+                Date_t::now(),
+                5400500,
+                getThreadName(),
+                "Dropped log lines because the asynchronous log queue was full",
+                TypeErasedAttributeStorage(attrs),
+                LogTag::kNone,
+                LogTruncation::Disabled);
+    // Commented out log line below to get validation of the log id with the errorcodes linter
+    // LOGV2_WARNING(5400500, "Dropped log lines because the asynchronous log queue was full");
+    return fmt::to_string(buffer);
+}
+
+AsyncLogQueue::AsyncLogQueue(size_t capacity,
+                             LogOverflowPolicy policy,
+                             WriteFn write,
+                             FlushFn flush,
+                             DroppedFn dropped)
+    : _capacity(roundUpToPowerOfTwo(std::max(capacity, size_t(2)))),
+      _mask(_capacity - 1),
+      _policy(policy),
+      _write(std::move(write)),
+      _flush(std::move(flush)),
+      _dropped(std::move(dropped)),
+      _slots(new Slot[_capacity]) {
+    for (size_t i = 0; i < _capacity; ++i) {
+        _slots[i].sequence.store(i);
+    }
+    _thread = stdx::thread([this] { _run(); });
+}
+
+AsyncLogQueue::~AsyncLogQueue() {
+    _shutdown.store(true);
+    {
+        stdx::lock_guard lock(_mutex);
+        _writerCV.notify_one();
+    }
+    _thread.join();
+}
+
+bool AsyncLogQueue::push(StringData line) {
+    while (!_tryPush(line)) {
+        if (_policy == LogOverflowPolicy::kDrop) {
+            _droppedPending.fetchAndAdd(1);
+            _droppedTotal.fetchAndAdd(1);
+            return false;
+        }
+
+        // The queue is full and we must not lose the line; wait for the writer to make room.
+        _waiters.fetchAndAdd(1);
+        {
+            stdx::unique_lock lock(_mutex);
+            _writerCV.notify_one();
+            _waitersCV.wait_for(lock, kFullWait.toSystemDuration());
+        }
+        _waiters.fetchAndSubtract(1);
+    }
+
+    if (_writerIdle.load()) {
+        _wakeWriter();
+    }
+    return true;
+}
+
+bool AsyncLogQueue::_tryPush(StringData line) {
+    uint64_t pos = _enqueuePos.load();
+    while (true) {
+        Slot& slot = _slots[pos & _mask];
+        const int64_t diff = int64_t(slot.sequence.load()) - int64_t(pos);
+        if (diff == 0) {
+            // The slot is free for position 'pos'; try to claim it.
+            if (_enqueuePos.compareAndSwap(&pos, pos + 1)) {
+                slot.line.assign(line.rawData(), line.size());
+                slot.sequence.store(pos + 1);
+                return true;
+            }
+            // 'pos' was reloaded by the failed compareAndSwap.
+        } else if (diff < 0) {
+            // The writer has not consumed the line from the previous lap yet: the queue is full.
+            return false;
+        } else {
+            // Another producer claimed this position first.
+            pos = _enqueuePos.load();
+        }
+    }
+}
+
+void AsyncLogQueue::_wakeWriter() {
+    stdx::lock_guard lock(_mutex);
+    _writerCV.notify_one();
+}
+
+bool AsyncLogQueue::flush(Milliseconds timeout) {
+    const uint64_t target = _enqueuePos.load();
+    if (_flushedPos.load() >= target) {
+        return true;
+    }
+
+    const auto deadline = timeout == Milliseconds::max()
+        ? Date_t::max()
+        : Date_t::now() + timeout;
+
+    _waiters.fetchAndAdd(1);
+    stdx::unique_lock lock(_mutex);
+    _writerCV.notify_one();
+    bool flushed = true;
+    while (_flushedPos.load() < target) {
+        if (Date_t::now() >= deadline) {
+            flushed = false;
+            break;
+        }
+        _waitersCV.wait_for(lock, kIdleWait.toSystemDuration());
+    }
+    lock.unlock();
+    _waiters.fetchAndSubtract(1);
+    return flushed;
+}
+
+bool AsyncLogQueue::drainOnCallerThread(Milliseconds timeout) {
+    const auto deadline = Date_t::now() + timeout;
+    stdx::unique_lock lock(_consumerMutex, stdx::defer_lock);
+    while (!lock.try_lock()) {
+        if (Date_t::now() >= deadline) {
+            return false;
+        }
+        sleepmillis(1);
+    }
+    _drainAndFlush();
+    return true;
+}
+
+size_t AsyncLogQueue::_drain() {
+    size_t written = 0;
+    while (true) {
+        Slot& slot = _slots[_dequeuePos & _mask];
+        if (slot.sequence.load() != _dequeuePos + 1) {
+            break;
+        }
+
+        _write(slot.line);
+        slot.sequence.store(_dequeuePos + _capacity);
+        ++_dequeuePos;
+        ++written;
+
+        // Let producers blocked on a full queue in as soon as there is room.
+        if (_waiters.load() > 0 && written % (_capacity / 2) == 0) {
+            stdx::lock_guard lock(_mutex);
+            _waitersCV.notify_all();
+        }
+    }
+    return written;
+}
+
+size_t AsyncLogQueue::_drainAndFlush() {
+    const size_t written = _drain();
+
+    const auto dropped = _droppedPending.swap(0);
+    if (dropped) {
+        _dropped(dropped);
+    }
+
+    if (written > 0 || dropped) {
+        _flush();
+        _flushedPos.store(_dequeuePos);
+        if (_waiters.load() > 0) {
+            stdx::lock_guard lock(_mutex);
+            _waitersCV.notify_all();
+        }
+    }
+    return written;
+}
+
+void AsyncLogQueue::_run() {
+    setThreadName("AsyncLogWriter");
+
+    while (true) {
+        size_t written;
+        {
+            stdx::lock_guard lock(_consumerMutex);
+            written = _drainAndFlush();
+        }
+        if (written > 0) {
+            continue;
+        }
+
+        if (_shutdown.load()) {
+            // Nothing was left to write after the final drain.
+            return;
+        }
+
+        // The queue looked empty. Announce that we are going to sleep and look once more, so that a
+        // producer which pushed before seeing the announcement is not missed. Every line before
+        // _flushedPos has been written, whichever thread wrote it.
+        stdx::unique_lock lock(_mutex);
+        _writerIdle.store(true);
+        const uint64_t next = _flushedPos.load();
+        if (_slots[next & _mask].sequence.load() != next + 1 && !_shutdown.load()) {
+            _writerCV.wait_for(lock, kIdleWait.toSystemDuration());
+        }
+        _writerIdle.store(false);
+    }
+}
+
+}  // namespace mongo::logv2
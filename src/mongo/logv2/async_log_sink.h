@@ -0,0 +1,293 @@
+/**
+ *    Copyright (C) 2021-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <boost/log/attributes/value_extraction.hpp>
+#include <boost/log/core/record_view.hpp>
+#include <boost/log/detail/locking_ptr.hpp>
+#include <boost/log/sinks/basic_sink_backend.hpp>
+#include <boost/log/sinks/frontend_requirements.hpp>
+#include <boost/shared_ptr.hpp>
+#include <functional>
+#include <memory>
+#include <string>
+
+#include "mongo/base/string_data.h"
+#include "mongo/logv2/attributes.h"
+#include "mongo/logv2/log_format.h"
+#include "mongo/logv2/log_severity.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/util/duration.h"
+
+namespace mongo::logv2 {
+
+/**
+ * Bounded multi-producer, single-consumer ring buffer of formatted log lines, drained by a
+ * dedicated writer thread.
+ *
+ * Producers claim a slot with a single compare-and-swap and never take a lock unless the queue is
+ * full under LogOverflowPolicy::kBlock, or the writer thread is asleep and needs to be woken. Slot
+ * strings are reused, so once they have grown to the size of a typical line, pushing does not
+ * allocate.
+ *
+ * The writer thread hands each line to 'write' and calls 'flush' after every batch, so the
+ * underlying file is flushed once per batch rather than once per line.
+ */
+class AsyncLogQueue {
+public:
+    using WriteFn = std::function<void(const std::string&)>;
+    using FlushFn = std::function<void()>;
+    using DroppedFn = std::function<void(uint64_t)>;
+
+    /**
+     * 'capacity' is rounded up to a power of two.
+     */
+    AsyncLogQueue(size_t capacity,
+                  LogOverflowPolicy policy,
+                  WriteFn write,
+                  FlushFn flush,
+                  DroppedFn dropped);
+
+    /**
+     * Writes out everything that is still queued, then stops the writer thread.
+     */
+    ~AsyncLogQueue();
+
+    AsyncLogQueue(const AsyncLogQueue&) = delete;
+    AsyncLogQueue& operator=(const AsyncLogQueue&) = delete;
+
+    /**
+     * Queues 'line' for writing. Returns false if the line was dropped because the queue was full.
+     */
+    bool push(StringData line);
+
+    /**
+     * Waits until every line pushed before this call has been written and flushed, or until
+     * 'timeout' elapses. Returns true if the queue was flushed in time.
+     */
+    bool flush(Milliseconds timeout);
+
+    /**
+     * Writes out and flushes everything queued so far on the calling thread rather than waiting
+     * for the writer thread, which may be stuck or already gone when the process is on its way
+     * down. Returns false without writing anything if the writer thread does not let go of the
+     * queue within 'timeout'.
+     */
+    bool drainOnCallerThread(Milliseconds timeout);
+
+    /**
+     * Total number of lines dropped since construction.
+     */
+    uint64_t droppedCount() const {
+        return _droppedTotal.load();
+    }
+
+private:
+    struct Slot {
+        // Equal to the position of the next push expected into this slot, or to that position plus
+        // one once the slot has been filled and is waiting for the writer thread.
+        AtomicWord<uint64_t> sequence;
+        std::string line;
+    };
+
+    bool _tryPush(StringData line);
+    void _wakeWriter();
+    void _run();
+
+    // Writes out everything currently queued and returns the number of lines written. Must hold
+    // _consumerMutex.
+    size_t _drain();
+
+    // Drains the queue, reports dropped lines and flushes. Must hold _consumerMutex.
+    size_t _drainAndFlush();
+
+    const size_t _capacity;
+    const size_t _mask;
+    const LogOverflowPolicy _policy;
+    const WriteFn _write;
+    const FlushFn _flush;
+    const DroppedFn _dropped;
+
+    std::unique_ptr<Slot[]> _slots;
+
+    // Next position to be claimed by a producer.
+    AtomicWord<uint64_t> _enqueuePos{0};
+
+    // Held by whichever thread is writing lines out: the writer thread, or a thread draining the
+    // queue itself through drainOnCallerThread().
+    stdx::mutex _consumerMutex;  // NOLINT
+
+    // Next position to be written out. Guarded by _consumerMutex.
+    uint64_t _dequeuePos = 0;
+
+    // Every line before this position has been written and flushed.
+    AtomicWord<uint64_t> _flushedPos{0};
+
+    AtomicWord<uint64_t> _droppedPending{0};
+    AtomicWord<uint64_t> _droppedTotal{0};
+
+    AtomicWord<bool> _writerIdle{false};
+    AtomicWord<int32_t> _waiters{0};
+    AtomicWord<bool> _shutdown{false};
+
+    // Only used to park the writer thread when the queue is empty, and producers or flushers
+    // while they wait for the writer thread.
+    stdx::mutex _mutex;  // NOLINT
+    stdx::condition_variable _writerCV;
+    stdx::condition_variable _waitersCV;
+
+    stdx::thread _thread;
+};
+
+/**
+ * Formats the line an asynchronous sink writes after dropping 'count' lines.
+ */
+std::string formatDroppedLogLines(uint64_t count, LogTimestampFormat timestampFormat);
+
+/**
+ * boost::log backend which forwards formatted records to another backend, optionally through an
+ * AsyncLogQueue so that the wrapped backend's I/O happens on a dedicated thread.
+ *
+ * Formatting still happens on the logging thread: the attributes of a record refer to objects
+ * owned by the caller and are only valid for the duration of the LOGV2 call, while the formatted
+ * string can be copied cheaply.
+ *
+ * When writing asynchronously the wrapped backend is handed an empty record_view, so it must only
+ * depend on the formatted string. Records at Error severity or above write out the queue on the
+ * logging thread, so that they are on disk even if the process goes away before the writer
+ * thread gets to them.
+ */
+template <typename Backend>
+class AsyncLogSink
+    : public boost::log::sinks::basic_formatted_sink_backend<
+          char,
+          boost::log::sinks::combine_requirements<boost::log::sinks::concurrent_feeding,
+                                                  boost::log::sinks::flushing>::type> {
+public:
+    // How long an Error or Severe record, or a drain on the way out of the process, waits for the
+    // writer thread to let go of the queue. Bounded because the writer thread may itself be the
+    // one that is failing.
+    static constexpr Milliseconds kSynchronousDrainTimeout{5000};
+
+    explicit AsyncLogSink(boost::shared_ptr<Backend> backend) : _backend(std::move(backend)) {}
+
+    ~AsyncLogSink() {
+        // Drain the queue while the backend is still alive.
+        _queue.reset();
+    }
+
+    /**
+     * Switches to writing through a queue of 'capacity' lines. Must be called before the sink
+     * receives any records. 'timestampFormat' is used to report dropped lines.
+     */
+    void startAsync(size_t capacity, LogOverflowPolicy policy, LogTimestampFormat timestampFormat) {
+        _queue = std::make_unique<AsyncLogQueue>(
+            capacity,
+            policy,
+            [this](const std::string& line) {
+                stdx::lock_guard lock(_backendMutex);
+                _backend->consume(boost::log::record_view(), line);
+            },
+            [this] {
+                stdx::lock_guard lock(_backendMutex);
+                _flushBackend();
+            },
+            [this, timestampFormat](uint64_t count) {
+                auto line = formatDroppedLogLines(count, timestampFormat);
+                stdx::lock_guard lock(_backendMutex);
+                _backend->consume(boost::log::record_view(), line);
+            });
+    }
+
+    bool isAsync() const {
+        return bool(_queue);
+    }
+
+    /**
+     * Locking accessor to the wrapped backend. Excludes the writer thread.
+     */
+    auto lockedBackend() {
+        return boost::log::aux::locking_ptr(_backend, _backendMutex);
+    }
+
+    void consume(boost::log::record_view const& rec, string_type const& formatted_string) {
+        if (!_queue) {
+            stdx::lock_guard lock(_backendMutex);
+            _backend->consume(rec, formatted_string);
+            return;
+        }
+
+        _queue->push(formatted_string);
+
+        // Errors are often the last thing logged before the process goes down, and the writer
+        // thread may go down with it, so they are written out before the logging call returns.
+        auto severity = boost::log::extract<LogSeverity>(attributes::severity(), rec);
+        if (severity && severity.get() >= LogSeverity::Error()) {
+            _queue->drainOnCallerThread(kSynchronousDrainTimeout);
+        }
+    }
+
+    /**
+     * Writes out everything still queued on the calling thread. Used on the way out of the
+     * process, when the writer thread cannot be relied on.
+     */
+    void drainOnCallerThread() {
+        if (_queue) {
+            _queue->drainOnCallerThread(kSynchronousDrainTimeout);
+        }
+    }
+
+    void flush() {
+        if (_queue) {
+            _queue->flush(Milliseconds::max());
+            return;
+        }
+
+        stdx::lock_guard lock(_backendMutex);
+        _flushBackend();
+    }
+
+private:
+    void _flushBackend() {
+        if constexpr (boost::log::sinks::has_requirement<typename Backend::frontend_requirements,
+                                                         boost::log::sinks::flushing>::value) {
+            _backend->flush();
+        }
+    }
+
+    boost::shared_ptr<Backend> _backend;
+    stdx::mutex _backendMutex;  // NOLINT
+    std::unique_ptr<AsyncLogQueue> _queue;
+};
+
+}  // namespace mongo::logv2
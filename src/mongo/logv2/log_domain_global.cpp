@@ -30,6 +30,7 @@
 #include "log_domain_global.h"
 
 #include "mongo/config.h"
+#include "mongo/logv2/async_log_sink.h"
 #include "mongo/logv2/component_settings_filter.h"
 #include "mongo/logv2/composite_backend.h"
 #include "mongo/logv2/console.h"
@@ -66,12 +67,13 @@ struct LogDomainGlobal::Impl {
                              UserAssertSink>
         SyslogBackend;
 #endif
-    typedef CompositeBackend<FileRotateSink, RamLogSink, RamLogSink, UserAssertSink>
+    typedef CompositeBackend<AsyncLogSink<FileRotateSink>, RamLogSink, RamLogSink, UserAssertSink>
         RotatableFileBackend;
 
     Impl(LogDomainGlobal& parent);
     Status configure(LogDomainGlobal::ConfigurationOptions const& options);
     Status rotate(bool rename, StringData renameSuffix);
+    void drainFileWrites();
 
     const ConfigurationOptions& config() const;
 
@@ -82,6 +84,9 @@ struct LogDomainGlobal::Impl {
     ConfigurationOptions _config;
     boost::shared_ptr<boost::log::sinks::unlocked_sink<ConsoleBackend>> _consoleSink;
     boost::shared_ptr<boost::log::sinks::unlocked_sink<RotatableFileBackend>> _rotatableFileSink;
+    // The file writer inside _rotatableFileSink, kept separately so that it can be drained without
+    // taking the composite backend's locks.
+    boost::shared_ptr<AsyncLogSink<FileRotateSink>> _asyncFileSink;
 #ifndef _WIN32
     boost::shared_ptr<boost::log::sinks::unlocked_sink<SyslogBackend>> _syslogSink;
 #endif
@@ -158,17 +163,28 @@ Status LogDomainGlobal::Impl::configure(LogDomainGlobal::ConfigurationOptions co
 #endif
 
     if (options.fileEnabled) {
-        auto backend = boost::make_shared<RotatableFileBackend>(
-            boost::make_shared<FileRotateSink>(options.timestampFormat),
-            boost::make_shared<RamLogSink>(RamLog::get("global")),
-            boost::make_shared<RamLogSink>(RamLog::get("startupWarnings")),
-            boost::make_shared<UserAssertSink>());
-        Status ret = backend->lockedBackend<0>()->addFile(
+        auto fileSink = boost::make_shared<FileRotateSink>(options.timestampFormat);
+        Status ret = fileSink->addFile(
             options.filePath,
             options.fileOpenMode == ConfigurationOptions::OpenMode::kAppend ? true : false);
         if (!ret.isOK())
             return ret;
-        backend->lockedBackend<0>()->auto_flush(true);
+        // The asynchronous writer flushes once per batch of lines instead.
+        fileSink->auto_flush(!options.fileAsync);
+
+        auto asyncSink = boost::make_shared<AsyncLogSink<FileRotateSink>>(std::move(fileSink));
+        if (options.fileAsync) {
+            asyncSink->startAsync(options.fileAsyncQueueSize,
+                                  options.fileAsyncOverflowPolicy,
+                                  options.timestampFormat);
+        }
+
+        _asyncFileSink = asyncSink;
+        auto backend = boost::make_shared<RotatableFileBackend>(
+            std::move(asyncSink),
+            boost::make_shared<RamLogSink>(RamLog::get("global")),
+            boost::make_shared<RamLogSink>(RamLog::get("startupWarnings")),
+            boost::make_shared<UserAssertSink>());
         backend->setFilter<2>(
             TaggedSeverityFilter(_parent, {LogTag::kStartupWarnings}, LogSeverity::Log()));
 
@@ -180,6 +196,7 @@ Status LogDomainGlobal::Impl::configure(LogDomainGlobal::ConfigurationOptions co
     } else if (_rotatableFileSink) {
         boost::log::core::get()->remove_sink(_rotatableFileSink);
         _rotatableFileSink.reset();
+        _asyncFileSink.reset();
     }
 
     auto setFormatters = [this](auto&& mkFmt) {
@@ -224,12 +241,18 @@ const LogDomainGlobal::ConfigurationOptions& LogDomainGlobal::Impl::config() con
 
 Status LogDomainGlobal::Impl::rotate(bool rename, StringData renameSuffix) {
     if (_rotatableFileSink) {
-        auto backend = _rotatableFileSink->locked_backend()->lockedBackend<0>();
+        auto backend = _rotatableFileSink->locked_backend()->lockedBackend<0>()->lockedBackend();
         return backend->rotate(rename, renameSuffix);
     }
     return Status::OK();
 }
 
+void LogDomainGlobal::Impl::drainFileWrites() {
+    if (_asyncFileSink) {
+        _asyncFileSink->drainOnCallerThread();
+    }
+}
+
 LogSource& LogDomainGlobal::Impl::source() {
     // Use a thread_local logger so we don't need to have locking. thread_locals are destroyed
     // before statics so keep track of number of thread_locals we have active and if this code
@@ -283,6 +306,10 @@ Status LogDomainGlobal::rotate(bool rename, StringData renameSuffix) {
     return _impl->rotate(rename, renameSuffix);
 }
 
+void LogDomainGlobal::drainFileWrites() {
+    _impl->drainFileWrites();
+}
+
 LogComponentSettings& LogDomainGlobal::settings() {
     return _impl->_settings;
 }
@@ -51,6 +51,12 @@ public:
         LogFormat format{LogFormat::kDefault};
         const AtomicWord<int32_t>* maxAttributeSizeKB = nullptr;
 
+        // When set, the log file is written and flushed by a dedicated thread which is fed
+        // through a queue of 'fileAsyncQueueSize' formatted lines.
+        bool fileAsync{false};
+        size_t fileAsyncQueueSize{16 * 1024};
+        LogOverflowPolicy fileAsyncOverflowPolicy{LogOverflowPolicy::kBlock};
+
         void makeDisabled();
     };
 
@@ -62,6 +68,11 @@ public:
     Status configure(ConfigurationOptions const& options);
     Status rotate(bool rename, StringData renameSuffix);
 
+    /**
+     * Writes out, on the calling thread, any lines still queued for an asynchronous log file.
+     */
+    void drainFileWrites();
+
     const ConfigurationOptions& config() const;
 
     LogComponentSettings& settings();
@@ -34,4 +34,15 @@ namespace mongo::logv2 {
 enum class LogFormat { kDefault, kJson, kPlain };
 enum class LogTimestampFormat { kISO8601UTC, kISO8601Local };
 
+/**
+ * What a thread does when the queue of an asynchronous log sink is full.
+ */
+enum class LogOverflowPolicy {
+    // Wait for the writer thread to make room. No log line is ever lost.
+    kBlock,
+    // Discard the line and count it. The writer thread reports the number of discarded lines once
+    // it catches up.
+    kDrop,
+};
+
 }  // namespace mongo::logv2
@@ -32,6 +32,8 @@
 #include "mongo/logv2/log_util.h"
 
 #include "mongo/logv2/log.h"
+#include "mongo/logv2/log_domain_global.h"
+#include "mongo/logv2/log_manager.h"
 #include "mongo/platform/atomic_word.h"
 #include "mongo/util/time_support.h"
 
@@ -84,6 +86,10 @@ bool rotateLogs(bool renameFiles, boost::optional<StringData> logType) {
     }
 }
 
+void flushLogsBeforeExit() {
+    LogManager::global().getGlobalDomainInternal().drainFileWrites();
+}
+
 bool shouldRedactLogs() {
     return redactionEnabled.loadRelaxed();
 }
@@ -61,6 +61,12 @@ void addLogRotator(StringData logType, LogRotateCallback cb);
  */
 bool rotateLogs(bool renameFiles, boost::optional<StringData> logType = boost::none);
 
+/**
+ * Writes out log lines still queued for the log file. Called on the way out of the process, when
+ * the asynchronous log writer cannot be relied on to get to them first.
+ */
+void flushLogsBeforeExit();
+
 /**
  * Returns true if system logs should be redacted.
  */
@@ -36,6 +36,7 @@
 #include "mongo/platform/basic.h"
 
 #include <benchmark/benchmark.h>
+#include <boost/filesystem/operations.hpp>
 #include <boost/iostreams/device/null.hpp>
 #include <boost/iostreams/stream.hpp>
 #include <boost/log/sinks/sync_frontend.hpp>
@@ -97,6 +98,40 @@ private:
     bool _shouldInit;
 };
 
+// Logs to a real file through the global domain's file sink, which is written either on the logging
+// thread or by the asynchronous writer depending on the benchmark argument.
+class ScopedFileLogV2Bench {
+public:
+    ScopedFileLogV2Bench(benchmark::State& state) {
+        _shouldInit = state.thread_index == 0;
+        if (_shouldInit) {
+            _path = (boost::filesystem::temp_directory_path() /
+                     boost::filesystem::unique_path("logv2_bm_%%%%-%%%%-%%%%.log"))
+                        .string();
+
+            logv2::LogDomainGlobal::ConfigurationOptions config;
+            config.makeDisabled();
+            config.fileEnabled = true;
+            config.filePath = _path;
+            config.fileAsync = state.range(0) != 0;
+            invariant(
+                logv2::LogManager::global().getGlobalDomainInternal().configure(config).isOK());
+        }
+    }
+
+    ~ScopedFileLogV2Bench() {
+        if (_shouldInit) {
+            invariant(logv2::LogManager::global().getGlobalDomainInternal().configure({}).isOK());
+            boost::system::error_code ec;
+            boost::filesystem::remove(_path, ec);
+        }
+    }
+
+private:
+    std::string _path;
+    bool _shouldInit;
+};
+
 // "Expensive" way to create a string.
 std::string createLongString() {
     return std::string(1000, 'a') + std::string(1000, 'b') + std::string(1000, 'c') +
@@ -150,17 +185,47 @@ void BM_EnabledLogV2ManySmallArg(benchmark::State& state) {
     }
 }
 
+void BM_FileLogV2(benchmark::State& state) {
+    ScopedFileLogV2Bench init(state);
+
+    for (auto _ : state)
+        LOGV2(5400501, "enabled log");
+}
+
+void BM_FileLogV2ManySmallArg(benchmark::State& state) {
+    ScopedFileLogV2Bench init(state);
+
+    for (auto _ : state) {
+        LOGV2(5400502,
+              "enabled log {}{}{}{}{}",
+              "1"_attr = 1,
+              "2"_attr = 2,
+              "3"_attr = "3",
+              "4"_attr = 4.0,
+              "5"_attr = "5"_sd);
+    }
+}
+
 void ThreadCounts(benchmark::internal::Benchmark* b) {
     int tc[] = {1, 2, 4, 8};
     for (int t : tc)
         b->Threads(t);
 }
 
+// Argument is 0 for synchronous and 1 for asynchronous file writes.
+void FileThreadCounts(benchmark::internal::Benchmark* b) {
+    for (int async : {0, 1})
+        for (int t : {1, 2, 4, 8})
+            b->Arg(async)->Threads(t);
+}
+
 BENCHMARK(BM_NoopLogV2)->Apply(ThreadCounts);
 BENCHMARK(BM_NoopLogV2Arg)->Apply(ThreadCounts);
 BENCHMARK(BM_EnabledLogV2)->Apply(ThreadCounts);
 BENCHMARK(BM_EnabledLogV2ExpensiveArg)->Apply(ThreadCounts);
 BENCHMARK(BM_EnabledLogV2ManySmallArg)->Apply(ThreadCounts);
+BENCHMARK(BM_FileLogV2)->Apply(FileThreadCounts);
+BENCHMARK(BM_FileLogV2ManySmallArg)->Apply(FileThreadCounts);
 
 }  // namespace
 }  // namespace mongo
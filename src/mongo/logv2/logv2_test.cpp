@@ -40,6 +40,7 @@
 #include "mongo/bson/bsonobjbuilder.h"
 #include "mongo/bson/json.h"
 #include "mongo/bson/oid.h"
+#include "mongo/logv2/async_log_sink.h"
 #include "mongo/logv2/bson_formatter.h"
 #include "mongo/logv2/component_settings_filter.h"
 #include "mongo/logv2/composite_backend.h"
@@ -1746,6 +1747,106 @@ TEST_F(LogV2Test, UserAssert) {
                              });
 }
 
+TEST_F(LogV2Test, AsyncSink) {
+    std::vector<std::string> lines;
+    auto backend = boost::make_shared<AsyncLogSink<LogCaptureBackend>>(
+        boost::make_shared<LogCaptureBackend>(lines));
+    backend->startAsync(4, LogOverflowPolicy::kBlock, LogTimestampFormat::kISO8601UTC);
+    auto sink = wrapInUnlockedSink(backend);
+    applyDefaultFilterToSink(sink);
+    sink->set_formatter(PlainFormatter());
+    attachSink(sink);
+
+    // More lines than the queue holds, so that producers have to wait for the writer.
+    constexpr int kLines = 100;
+    for (int i = 0; i < kLines; ++i) {
+        LOGV2(5400503, "async {i}", "i"_attr = i);
+    }
+    sink->flush();
+    ASSERT_EQUALS(lines.size(), size_t(kLines));
+    for (int i = 0; i < kLines; ++i) {
+        ASSERT_EQUALS(lines[i], fmt::format("async {}", i));
+    }
+
+    // Error and Severe records are written out before the logging call returns.
+    LOGV2_ERROR(5400505, "error");
+    ASSERT_EQUALS(lines.back(), "error");
+    LOGV2_FATAL_CONTINUE(5400504, "fatal");
+    ASSERT_EQUALS(lines.back(), "fatal");
+}
+
+TEST(AsyncLogQueue, DropOnOverflow) {
+    std::vector<std::string> lines;
+    uint64_t reportedDropped = 0;
+
+    // Hold up the writer thread inside its first write until every line has been pushed.
+    stdx::mutex mutex;  // NOLINT
+    stdx::unique_lock<stdx::mutex> blockWriter(mutex);
+    AtomicWord<bool> writerStarted{false};
+
+    AsyncLogQueue queue(
+        4,
+        LogOverflowPolicy::kDrop,
+        [&](const std::string& line) {
+            writerStarted.store(true);
+            stdx::lock_guard<stdx::mutex> lk(mutex);
+            lines.push_back(line);
+        },
+        [] {},
+        [&](uint64_t count) { reportedDropped += count; });
+
+    ASSERT(queue.push("first"));
+    while (!writerStarted.load()) {
+        stdx::this_thread::yield();
+    }
+
+    // The slot of "first" is only released once it has been written, so three more lines fit.
+    for (int i = 0; i < 10; ++i) {
+        queue.push(std::to_string(i));
+    }
+    ASSERT_EQUALS(queue.droppedCount(), 7U);
+
+    blockWriter.unlock();
+    ASSERT(queue.flush(Milliseconds::max()));
+    ASSERT(lines == (std::vector<std::string>{"first", "0", "1", "2"}));
+    ASSERT_EQUALS(reportedDropped, 7U);
+}
+
+TEST(AsyncLogQueue, DrainOnCallerThread) {
+    std::vector<std::string> lines;
+
+    // Hold up the writer thread inside its first write.
+    stdx::mutex mutex;  // NOLINT
+    stdx::unique_lock<stdx::mutex> blockWriter(mutex);
+    AtomicWord<bool> writerStarted{false};
+
+    AsyncLogQueue queue(
+        4,
+        LogOverflowPolicy::kBlock,
+        [&](const std::string& line) {
+            writerStarted.store(true);
+            stdx::lock_guard<stdx::mutex> lk(mutex);
+            lines.push_back(line);
+        },
+        [] {},
+        [](uint64_t) {});
+
+    ASSERT(queue.push("first"));
+    while (!writerStarted.load()) {
+        stdx::this_thread::yield();
+    }
+    ASSERT(queue.push("second"));
+
+    // The writer thread is stuck, so draining gives up rather than hanging.
+    ASSERT_FALSE(queue.drainOnCallerThread(Milliseconds(10)));
+
+    // Once it lets go, everything pushed so far is written by the time draining returns.
+    blockWriter.unlock();
+    ASSERT(queue.drainOnCallerThread(Seconds(60)));
+    stdx::lock_guard<stdx::mutex> lk(mutex);
+    ASSERT(lines == (std::vector<std::string>{"first", "second"}));
+}
+
 class UnstructuredLoggingTest : public LogV2JsonBsonTest {};
 
 TEST_F(UnstructuredLoggingTest, NoArgs) {
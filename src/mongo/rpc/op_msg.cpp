@@ -233,13 +233,24 @@ namespace {
 void serializeHelper(const std::vector<OpMsg::DocumentSequence>& sequences,
                      const BSONObj& body,
                      OpMsgBuilder* output) {
+    // Reserve room for the whole message up front, so that large batches of documents are copied
+    // into the buffer once rather than again each time it grows.
+    size_t size = 1 /* body kind byte */ + body.objsize();
+    for (auto&& seq : sequences) {
+        size += 1 /* section kind byte */ + sizeof(int32_t) + seq.name.size() + 1;
+        for (auto&& obj : seq.objs) {
+            size += obj.objsize();
+        }
+    }
+    output->reserveBytes(size);
+
     for (auto&& seq : sequences) {
         auto docSeq = output->beginDocSequence(seq.name);
         for (auto&& obj : seq.objs) {
             docSeq.append(obj);
         }
     }
-    output->beginBody().appendElements(body);
+    output->setBody(body);
 }
 }  // namespace
 
@@ -298,6 +309,16 @@ BSONObjBuilder OpMsgBuilder::beginBody() {
     return BSONObjBuilder(_buf);
 }
 
+void OpMsgBuilder::setBody(const BSONObj& body) {
+    invariant(_state == kEmpty || _state == kDocSequence);
+    invariant(!_openBuilder);
+    _state = kBody;
+    _buf.appendStruct(Section::kBody);
+    invariant(_bodyStart == 0);
+    _bodyStart = _buf.len();  // Cannot be 0.
+    _buf.appendBuf(body.objdata(), body.objsize());
+}
+
 BSONObjBuilder OpMsgBuilder::resumeBody() {
     invariant(_state == kBody);
     invariant(_bodyStart != 0);
@@ -105,7 +105,8 @@ struct OpMsg {
     }
 
     /**
-     * Parses and returns an OpMsg containing unowned BSON.
+     * Parses and returns an OpMsg containing unowned BSON. The body and the documents of every
+     * sequence point into the buffer of 'message', so nothing is copied.
      */
     static OpMsg parse(const Message& message);
 
@@ -221,9 +222,12 @@ public:
      * done() on the returned builder before calling any methods on this object.
      */
     BSONObjBuilder beginBody();
-    void setBody(const BSONObj& body) {
-        beginBody().appendElements(body);
-    }
+
+    /**
+     * Begins the body with a copy of 'body', appended with a single memcpy rather than element by
+     * element. More fields may still be added with resumeBody().
+     */
+    void setBody(const BSONObj& body);
 
     /**
      * Returns a builder that can be used to append new fields to the body.
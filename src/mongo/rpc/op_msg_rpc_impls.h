@@ -54,7 +54,7 @@ private:
 class OpMsgReplyBuilder final : public rpc::ReplyBuilderInterface {
 public:
     ReplyBuilderInterface& setRawCommandReply(const BSONObj& reply) override {
-        _builder.beginBody().appendElements(reply);
+        _builder.setBody(reply);
         return *this;
     }
     BSONObjBuilder getBodyBuilder() override {
@@ -823,6 +823,64 @@ TEST(OpMsgSerializer, BodyAndInPlaceSequenceInPlaceWithReset) {
                    });
 }
 
+TEST(OpMsgSerializer, SetBodyThenResumeBody) {
+    OpMsgBuilder builder;
+
+    {
+        auto seq = builder.beginDocSequence("docs");
+        seq.append(fromjson("{a: 1}"));
+    }
+
+    builder.setBody(fromjson("{ping: 1}"));
+    builder.resumeBody().append("$db", "foo");
+
+    testSerializer(builder.finish(),
+                   OpMsgBytes{
+                       kNoFlags,  //
+                       kDocSequenceSection,
+                       Sized{
+                           "docs",  //
+                           fromjson("{a: 1}"),
+                       },
+
+                       kBodySection,
+                       fromjson("{ping: 1, $db: 'foo'}"),
+                   });
+}
+
+TEST(OpMsgSerializer, LargeSequenceRoundTrips) {
+    OpMsg msg;
+    msg.body = fromjson("{insert: 'coll', $db: 'foo'}");
+    msg.sequences = {{"documents", {}}};
+    for (int i = 0; i < 1000; ++i) {
+        msg.sequences[0].objs.push_back(BSON("_id" << i << "x" << std::string(100, 'x')));
+    }
+
+    auto serialized = msg.serialize();
+    auto parsed = OpMsg::parse(serialized);
+    ASSERT_BSONOBJ_EQ(parsed.body, msg.body);
+    ASSERT_EQ(parsed.sequences[0].objs.size(), 1000U);
+}
+
+TEST_F(OpMsgParser, ParseDoesNotCopy) {
+    OpMsg msg;
+    msg.body = fromjson("{ping: 1}");
+    msg.sequences = {{"docs", {fromjson("{a: 1}"), fromjson("{a: 2}")}}};
+    auto serialized = msg.serialize();
+
+    const char* const begin = serialized.buf();
+    const char* const end = begin + serialized.size();
+    auto inMessage = [&](const BSONObj& obj) {
+        return obj.objdata() >= begin && obj.objdata() + obj.objsize() <= end;
+    };
+
+    auto parsed = OpMsg::parseOwned(serialized);
+    ASSERT(inMessage(parsed.body));
+    for (auto&& obj : parsed.sequences[0].objs) {
+        ASSERT(inMessage(obj));
+    }
+}
+
 TEST(OpMsgSerializer, ReplaceFlagsWorks) {
     {
         auto msg = OpMsgBytes{~0u}.done();
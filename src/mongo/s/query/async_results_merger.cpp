@@ -42,6 +42,7 @@
 #include "mongo/executor/remote_command_request.h"
 #include "mongo/executor/remote_command_response.h"
 #include "mongo/s/catalog/type_shard.h"
+#include "mongo/s/query/async_results_merger_params_gen.h"
 #include "mongo/util/assert_util.h"
 
 namespace mongo {
@@ -93,8 +94,30 @@ int compareSortKeys(BSONObj leftSortKey, BSONObj rightSortKey, BSONObj sortKeyPa
     return leftSortKey.woCompare(rightSortKey, sortKeyPattern, rules);
 }
 
+/**
+ * Returns the ordering with which to encode the sort keys of the results merged according to
+ * 'params', or boost::none if they cannot be encoded.
+ */
+boost::optional<Ordering> makeSortKeyOrdering(const AsyncResultsMergerParams& params) {
+    const auto& sort = params.getSort();
+    if (!sort || static_cast<size_t>(sort->nFields()) > Ordering::kMaxCompoundIndexKeys) {
+        return boost::none;
+    }
+    return Ordering::make(*sort);
+}
+
 }  // namespace
 
+int AsyncResultsMerger::MergingComparator::operator()(size_t lhs, size_t rhs) const {
+    if (_sortKeysAreEncoded) {
+        return _remotes[lhs].sortKeyBuffer.front().compare(_remotes[rhs].sortKeyBuffer.front());
+    }
+    return compareSortKeys(
+        extractSortKey(*_remotes[lhs].docBuffer.front().getResult(), _compareWholeSortKey),
+        extractSortKey(*_remotes[rhs].docBuffer.front().getResult(), _compareWholeSortKey),
+        _sort);
+}
+
 AsyncResultsMerger::AsyncResultsMerger(OperationContext* opCtx,
                                        std::shared_ptr<executor::TaskExecutor> executor,
                                        AsyncResultsMergerParams params)
@@ -105,13 +128,19 @@ AsyncResultsMerger::AsyncResultsMerger(OperationContext* opCtx,
       // since that is not supported we treat boost::none (unspecified) to mean 'kNormal'.
       _tailableMode(params.getTailableMode().value_or(TailableModeEnum::kNormal)),
       _params(std::move(params)),
-      _mergeQueue(MergingComparator(
-          _remotes, _params.getSort().value_or(BSONObj()), _params.getCompareWholeSortKey())),
+      _sortKeyOrdering(makeSortKeyOrdering(_params)),
+      _mergeQueue(MergingComparator(_remotes,
+                                    _params.getSort().value_or(BSONObj()),
+                                    _params.getCompareWholeSortKey(),
+                                    _sortKeyOrdering.has_value())),
       _promisedMinSortKeys(PromisedMinSortKeyComparator(_params.getSort().value_or(BSONObj()))) {
     if (params.getTxnNumber()) {
         invariant(params.getSessionId());
     }
 
+    _remotes.reserve(_params.getRemotes().size());
+    _mergeQueue.resize(_params.getRemotes().size());
+
     size_t remoteIndex = 0;
     for (const auto& remote : _params.getRemotes()) {
         _remotes.emplace_back(remote.getHostAndPort(),
@@ -213,6 +242,7 @@ void AsyncResultsMerger::addNewShardCursors(std::vector<RemoteCursor>&& newCurso
     stdx::lock_guard<Latch> lk(_mutex);
     // Create a new entry in the '_remotes' list for each new shard, and add the first cursor batch
     // to its buffer. This ensures the shard's initial high water mark is respected, if it exists.
+    _mergeQueue.resize(_remotes.size() + newCursors.size());
     for (auto&& remote : newCursors) {
         const auto newIndex = _remotes.size();
         _remotes.emplace_back(remote.getHostAndPort(),
@@ -312,7 +342,7 @@ bool AsyncResultsMerger::_readySortedTailable(WithLock lk) {
     }
 
     auto smallestRemote = _mergeQueue.top();
-    auto smallestResult = _remotes[smallestRemote].docBuffer.front();
+    const auto& smallestResult = _remotes[smallestRemote].docBuffer.front();
     auto keyWeWantToReturn =
         extractSortKey(*smallestResult.getResult(), _params.getCompareWholeSortKey());
     // We should always have a minPromisedSortKey from every shard in the sorted tailable case.
@@ -355,7 +385,7 @@ StatusWith<ClusterQueryResult> AsyncResultsMerger::nextReady() {
     return _params.getSort() ? _nextReadySorted(lk) : _nextReadyUnsorted(lk);
 }
 
-ClusterQueryResult AsyncResultsMerger::_nextReadySorted(WithLock) {
+ClusterQueryResult AsyncResultsMerger::_nextReadySorted(WithLock lk) {
     // Tailable non-awaitData cursors cannot have a sort.
     invariant(_tailableMode != TailableModeEnum::kTailable);
 
@@ -364,20 +394,22 @@ ClusterQueryResult AsyncResultsMerger::_nextReadySorted(WithLock) {
     }
 
     size_t smallestRemote = _mergeQueue.top();
-    _mergeQueue.pop();
+    auto& remote = _remotes[smallestRemote];
 
-    invariant(!_remotes[smallestRemote].docBuffer.empty());
-    invariant(_remotes[smallestRemote].status.isOK());
+    invariant(!remote.docBuffer.empty());
+    invariant(!_sortKeyOrdering || remote.sortKeyBuffer.size() == remote.docBuffer.size());
+    invariant(remote.status.isOK());
 
-    ClusterQueryResult front = _remotes[smallestRemote].docBuffer.front();
-    _remotes[smallestRemote].docBuffer.pop();
-
-    // Re-populate the merging queue with the next result from 'smallestRemote', if it has a
-    // next result.
-    if (!_remotes[smallestRemote].docBuffer.empty()) {
-        _mergeQueue.push(smallestRemote);
+    ClusterQueryResult front = std::move(remote.docBuffer.front());
+    remote.docBuffer.pop();
+    if (_sortKeyOrdering) {
+        remote.sortKeyBuffer.pop();
     }
 
+    // Replay the merge with the next result from 'smallestRemote', if it has a next result.
+    // Otherwise the remote drops out of the merge until its next batch arrives.
+    _mergeQueue.replayTop(remote.hasNext());
+
     // For sorted tailable awaitData cursors, update the high water mark to the document's sort key.
     if (_tailableMode == TailableModeEnum::kTailableAndAwaitData) {
         if (_remotes[smallestRemote].eligibleForHighWaterMark) {
@@ -386,17 +418,18 @@ ClusterQueryResult AsyncResultsMerger::_nextReadySorted(WithLock) {
         }
     }
 
+    _maybePrefetchNextBatch(lk, smallestRemote);
     return front;
 }
 
-ClusterQueryResult AsyncResultsMerger::_nextReadyUnsorted(WithLock) {
+ClusterQueryResult AsyncResultsMerger::_nextReadyUnsorted(WithLock lk) {
     size_t remotesAttempted = 0;
     while (remotesAttempted < _remotes.size()) {
         // It is illegal to call this method if there is an error received from any shard.
         invariant(_remotes[_gettingFromRemote].status.isOK());
 
         if (_remotes[_gettingFromRemote].hasNext()) {
-            ClusterQueryResult front = _remotes[_gettingFromRemote].docBuffer.front();
+            ClusterQueryResult front = std::move(_remotes[_gettingFromRemote].docBuffer.front());
             _remotes[_gettingFromRemote].docBuffer.pop();
 
             if (_tailableMode == TailableModeEnum::kTailable &&
@@ -407,6 +440,7 @@ ClusterQueryResult AsyncResultsMerger::_nextReadyUnsorted(WithLock) {
                 _eofNext = true;
             }
 
+            _maybePrefetchNextBatch(lk, _gettingFromRemote);
             return front;
         }
 
@@ -420,6 +454,45 @@ ClusterQueryResult AsyncResultsMerger::_nextReadyUnsorted(WithLock) {
     return {};
 }
 
+void AsyncResultsMerger::_maybePrefetchNextBatch(WithLock lk, size_t remoteIndex) {
+    auto& remote = _remotes[remoteIndex];
+    ++remote.consumedSinceLastBatch;
+
+    // Tailable cursors are excluded: an awaitData getMore may block on the shard until new data
+    // arrives, and batches from tailable cursors are passed through to the client as-is. So are
+    // cursors opened in a transaction, whose getMores must not run concurrently with the other
+    // statements of the transaction, and, unless enabled separately, those opened in a session.
+    if (_tailableMode != TailableModeEnum::kNormal ||
+        !internalQueryEnableMongosGetMorePrefetch.load() || _params.getTxnNumber() ||
+        (_params.getSessionId() && !internalQueryEnableMongosGetMorePrefetchForSessions.load())) {
+        return;
+    }
+
+    // If the buffer is already empty, the next call to nextEvent() will schedule the getMore.
+    if (!remote.hasNext() || remote.exhausted() || remote.cbHandle.isValid() ||
+        _lifecycleState != kAlive || !_opCtx) {
+        return;
+    }
+
+    // We prefetch once the remaining results would be consumed, at the rate observed since the last
+    // batch arrived, in no more time than that batch took to arrive. That is, when
+    //   remaining / (consumed / elapsed) <= roundTrip
+    // which is rearranged below to avoid dividing.
+    const auto roundTripMillis = durationCount<Milliseconds>(remote.lastBatchRoundTrip);
+    const auto elapsedMillis =
+        durationCount<Milliseconds>(_executor->now() - remote.batchReceivedAt);
+    if (roundTripMillis <= 0 || elapsedMillis <= 0) {
+        return;
+    }
+
+    const auto remaining = static_cast<long long>(remote.docBuffer.size());
+    if (remaining * elapsedMillis > remote.consumedSinceLastBatch * roundTripMillis) {
+        return;
+    }
+
+    remote.status = _askForNextBatch(lk, remoteIndex);
+}
+
 Status AsyncResultsMerger::_askForNextBatch(WithLock, size_t remoteIndex) {
     invariant(_opCtx, "Cannot schedule a getMore without an OperationContext");
     auto& remote = _remotes[remoteIndex];
@@ -479,6 +552,7 @@ Status AsyncResultsMerger::_askForNextBatch(WithLock, size_t remoteIndex) {
     }
 
     remote.cbHandle = callbackStatus.getValue();
+    remote.batchRequestedAt = _executor->now();
     return Status::OK();
 }
 
@@ -709,6 +783,8 @@ void AsyncResultsMerger::_cleanUpFailedBatch(WithLock lk, Status status, size_t
         remote.partialResultsReturned = (remote.status != ErrorCodes::ExchangePassthrough);
         std::queue<ClusterQueryResult> emptyBuffer;
         std::swap(remote.docBuffer, emptyBuffer);
+        std::queue<KeyString::Value> emptySortKeyBuffer;
+        std::swap(remote.sortKeyBuffer, emptySortKeyBuffer);
         remote.status = Status::OK();
         remote.cursorId = 0;
     }
@@ -736,6 +812,12 @@ void AsyncResultsMerger::_processBatchResults(WithLock lk,
     // Update the cursorId; it is sent as '0' when the cursor has been exhausted on the shard.
     remote.cursorId = cursorResponse.getCursorId();
 
+    // Record how long this batch took to arrive, and restart the measurement of the rate at which
+    // this remote's results are consumed.
+    remote.batchReceivedAt = _executor->now();
+    remote.lastBatchRoundTrip = remote.batchReceivedAt - remote.batchRequestedAt;
+    remote.consumedSinceLastBatch = 0;
+
     // Save the batch in the remote's buffer.
     if (!_addBatchToBuffer(lk, remoteIndex, cursorResponse)) {
         return;
@@ -764,6 +846,9 @@ bool AsyncResultsMerger::_addBatchToBuffer(WithLock lk,
                                            const CursorResponse& response) {
     auto& remote = _remotes[remoteIndex];
     _updateRemoteMetadata(lk, remoteIndex, response);
+
+    // Reused across the batch to avoid reallocating the KeyString buffer for every result.
+    KeyString::Builder sortKeyBuilder(KeyString::Version::kLatestVersion);
     for (const auto& obj : response.getBatch()) {
         // If there's a sort, we're expecting the remote node to have given us back a sort key.
         if (_params.getSort()) {
@@ -781,17 +866,23 @@ bool AsyncResultsMerger::_addBatchToBuffer(WithLock lk,
                                          << "' was not of type Object in document: " << obj);
                 return false;
             }
+
+            // Decode the sort key once, into a form which the merge can compare with memcmp.
+            if (_sortKeyOrdering) {
+                sortKeyBuilder.resetToKey(extractSortKey(obj, _params.getCompareWholeSortKey()),
+                                          *_sortKeyOrdering);
+                remote.sortKeyBuffer.push(sortKeyBuilder.getValueCopy());
+            }
         }
 
-        ClusterQueryResult result(obj);
-        remote.docBuffer.push(result);
+        remote.docBuffer.emplace(obj);
         ++remote.fetchedCount;
     }
 
-    // If we're doing a sorted merge, then we have to make sure to put this remote onto the merge
-    // queue.
+    // If we're doing a sorted merge, then we have to make sure this remote participates in the
+    // merge.
     if (_params.getSort() && !response.getBatch().empty()) {
-        _mergeQueue.push(remoteIndex);
+        _mergeQueue.activate(remoteIndex);
     }
     return true;
 }
@@ -893,19 +984,6 @@ bool AsyncResultsMerger::RemoteCursorData::exhausted() const {
     return cursorId == 0;
 }
 
-//
-// AsyncResultsMerger::MergingComparator
-//
-
-bool AsyncResultsMerger::MergingComparator::operator()(const size_t& lhs, const size_t& rhs) {
-    const ClusterQueryResult& leftDoc = _remotes[lhs].docBuffer.front();
-    const ClusterQueryResult& rightDoc = _remotes[rhs].docBuffer.front();
-
-    return compareSortKeys(extractSortKey(*leftDoc.getResult(), _compareWholeSortKey),
-                           extractSortKey(*rightDoc.getResult(), _compareWholeSortKey),
-                           _sort) > 0;
-}
-
 bool AsyncResultsMerger::PromisedMinSortKeyComparator::operator()(
     const MinSortKeyRemoteIdPair& lhs, const MinSortKeyRemoteIdPair& rhs) const {
     auto sortKeyComp = compareSortKeys(lhs.first, rhs.first, _sort);
@@ -35,13 +35,16 @@
 
 #include "mongo/base/status_with.h"
 #include "mongo/bson/bsonobj.h"
+#include "mongo/bson/ordering.h"
 #include "mongo/db/cursor_id.h"
+#include "mongo/db/storage/key_string.h"
 #include "mongo/executor/task_executor.h"
 #include "mongo/platform/mutex.h"
 #include "mongo/s/query/async_results_merger_params_gen.h"
 #include "mongo/s/query/cluster_query_result.h"
 #include "mongo/stdx/future.h"
 #include "mongo/util/concurrency/with_lock.h"
+#include "mongo/util/loser_tree.h"
 #include "mongo/util/net/hostandport.h"
 #include "mongo/util/time_support.h"
 
@@ -68,6 +71,16 @@ class CursorResponse;
  * This requires waiting until we have a response from every remote before returning results.
  * Without a sort, we are ready to return results as soon as we have *any* response from a remote.
  *
+ * Sorted streams are merged through a loser tree keyed on each remote's next result. The $sortKey
+ * of every buffered result is encoded into a KeyString once, when its batch arrives, so that each
+ * comparison made by the merge is a single memcmp rather than a walk over two BSON sort keys.
+ *
+ * For non-tailable cursors, the ARM also tries to keep each remote's buffer from running dry: when
+ * a remote's remaining buffered results would be consumed, at the rate observed since its last
+ * batch arrived, in less time than that batch's getMore round trip took, the next getMore is issued
+ * immediately rather than waiting for the buffer to drain. See
+ * 'internalQueryEnableMongosGetMorePrefetch'.
+ *
  * On any error, the caller is responsible for shutting down the ARM using the kill() method.
  *
  * Does not throw exceptions.
@@ -89,8 +102,8 @@ public:
      * the hosts on which they exist in _remotes.
      *
      * Additionally copies each remote's first batch of results, if one exists, into that remote's
-     * docBuffer. If a sort is specified in the ClusterClientCursorParams, places the remotes with
-     * buffered results onto _mergeQueue.
+     * docBuffer. If a sort is specified in the ClusterClientCursorParams, activates the remotes
+     * with buffered results in _mergeQueue.
      *
      * The TaskExecutor* must remain valid for the lifetime of the ARM.
      *
@@ -316,26 +329,45 @@ private:
         // Count of fetched docs during ARM processing of the current batch. Used to reduce the
         // batchSize in getMore when mongod returned less docs than the requested batchSize.
         long long fetchedCount = 0;
+
+        // Only populated if there is a sort which '_sortKeyOrdering' can encode. Holds the
+        // KeyString encoding of the $sortKey of each result in 'docBuffer', in the same order, so
+        // that the merge never has to re-extract or re-compare BSON sort keys.
+        std::queue<KeyString::Value> sortKeyBuffer;
+
+        // Bookkeeping used to decide when to prefetch the next batch for this remote. The time at
+        // which the outstanding (or most recent) getMore was scheduled, the time at which the most
+        // recent batch arrived, how long that batch's round trip took, and the number of results
+        // consumed from this remote since that batch arrived.
+        Date_t batchRequestedAt;
+        Date_t batchReceivedAt;
+        Milliseconds lastBatchRoundTrip{0};
+        long long consumedSinceLastBatch = 0;
     };
 
+    /**
+     * Orders remotes by the sort key of the next result in their buffers. Compares the pre-encoded
+     * sort keys if 'sortKeysAreEncoded' is true, and the $sortKey of the buffered documents
+     * otherwise. Only valid for remotes which have a buffered result.
+     */
     class MergingComparator {
     public:
         MergingComparator(const std::vector<RemoteCursorData>& remotes,
-                          const BSONObj& sort,
-                          bool compareWholeSortKey)
-            : _remotes(remotes), _sort(sort), _compareWholeSortKey(compareWholeSortKey) {}
+                          BSONObj sort,
+                          bool compareWholeSortKey,
+                          bool sortKeysAreEncoded)
+            : _remotes(remotes),
+              _sort(std::move(sort)),
+              _compareWholeSortKey(compareWholeSortKey),
+              _sortKeysAreEncoded(sortKeysAreEncoded) {}
 
-        bool operator()(const size_t& lhs, const size_t& rhs);
+        int operator()(size_t lhs, size_t rhs) const;
 
     private:
         const std::vector<RemoteCursorData>& _remotes;
-
         const BSONObj _sort;
-
-        // When '_compareWholeSortKey' is true, $sortKey is a scalar value, rather than an object.
-        // We extract the sort key {$sortKey: <value>}. The sort key pattern '_sort' is verified to
-        // be {$sortKey: 1}.
         const bool _compareWholeSortKey;
+        const bool _sortKeysAreEncoded;
     };
 
     using MinSortKeyRemoteIdPair = std::pair<BSONObj, size_t>;
@@ -370,6 +402,13 @@ private:
      */
     Status _askForNextBatch(WithLock, size_t remoteIndex);
 
+    /**
+     * Issues a getMore to the given remote ahead of its buffer draining, if the rate at which its
+     * results are being consumed suggests that the buffer will run dry before a new batch could
+     * arrive. Only applies to non-tailable cursors.
+     */
+    void _maybePrefetchNextBatch(WithLock, size_t remoteIndex);
+
     /**
      * Checks whether or not the remote cursors are all exhausted.
      */
@@ -484,9 +523,15 @@ private:
     // Data tracking the state of our communication with each of the remote nodes.
     std::vector<RemoteCursorData> _remotes;
 
-    // The top of this priority queue is the index into '_remotes' for the remote host that has the
-    // next document to return, according to the sort order. Used only if there is a sort.
-    std::priority_queue<size_t, std::vector<size_t>, MergingComparator> _mergeQueue;
+    // The ordering used to encode each buffered $sortKey into a KeyString, derived from the sort
+    // pattern. Not set if there is no sort, or if the sort pattern has more fields than an Ordering
+    // can describe, in which case the merge compares the BSON sort keys instead.
+    const boost::optional<Ordering> _sortKeyOrdering;
+
+    // The top of this loser tree is the index into '_remotes' for the remote host that has the next
+    // document to return, according to the sort order. A remote is active in the tree exactly when
+    // it has buffered results. Used only if there is a sort.
+    LoserTree<MergingComparator> _mergeQueue;
 
     // The index into '_remotes' for the remote from which we are currently retrieving results.
     // Used only if there is *not* a sort.
@@ -441,6 +441,187 @@ TEST_F(AsyncResultsMergerTest, CompoundSortKey) {
     ASSERT_TRUE(unittest::assertGet(arm->nextReady()).isEOF());
 }
 
+TEST_F(AsyncResultsMergerTest, SortedMergeOrdersNumericTypesTogetherAndBreaksTiesByShard) {
+    BSONObj findCmd = fromjson("{find: 'testcoll', sort: {a: 1}}");
+    std::vector<RemoteCursor> cursors;
+    std::vector<BSONObj> batch1 = {fromjson("{$sortKey: [1]}"), fromjson("{$sortKey: [3.0]}")};
+    cursors.push_back(makeRemoteCursor(
+        kTestShardIds[0], kTestShardHosts[0], CursorResponse(kTestNss, 0, std::move(batch1))));
+    std::vector<BSONObj> batch2 = {fromjson("{$sortKey: [{$numberLong: '2'}]}"),
+                                   fromjson("{$sortKey: [3]}")};
+    cursors.push_back(makeRemoteCursor(
+        kTestShardIds[1], kTestShardHosts[1], CursorResponse(kTestNss, 0, std::move(batch2))));
+    std::vector<BSONObj> batch3 = {fromjson("{$sortKey: [1.5]}"), fromjson("{$sortKey: [4]}")};
+    cursors.push_back(makeRemoteCursor(
+        kTestShardIds[2], kTestShardHosts[2], CursorResponse(kTestNss, 0, std::move(batch3))));
+    auto arm = makeARMFromExistingCursors(std::move(cursors), findCmd);
+
+    // All of the results were in the first batches, so the ARM is immediately ready. Sort keys of
+    // different numeric types compare by value, and equal keys are returned in shard order.
+    std::vector<BSONObj> expected = {fromjson("{$sortKey: [1]}"),
+                                     fromjson("{$sortKey: [1.5]}"),
+                                     fromjson("{$sortKey: [{$numberLong: '2'}]}"),
+                                     fromjson("{$sortKey: [3.0]}"),
+                                     fromjson("{$sortKey: [3]}"),
+                                     fromjson("{$sortKey: [4]}")};
+    for (const auto& obj : expected) {
+        ASSERT_TRUE(arm->ready());
+        auto result = unittest::assertGet(arm->nextReady()).getResult();
+        ASSERT_BSONOBJ_EQ(obj, *result);
+        ASSERT_EQ(obj["$sortKey"].Array()[0].type(), (*result)["$sortKey"].Array()[0].type());
+    }
+
+    ASSERT_TRUE(arm->ready());
+    ASSERT_TRUE(unittest::assertGet(arm->nextReady()).isEOF());
+}
+
+TEST_F(AsyncResultsMergerTest, SortedMergeWithMoreSortFieldsThanAnOrderingCanDescribe) {
+    // The sort keys cannot be encoded with an Ordering, which describes at most 32 fields, so the
+    // merge compares the $sortKey of the buffered documents instead.
+    const int kNumSortFields = Ordering::kMaxCompoundIndexKeys + 1;
+    BSONObjBuilder sortBuilder;
+    for (int i = 0; i < kNumSortFields; ++i) {
+        sortBuilder.append(str::stream() << "f" << i, i == kNumSortFields - 1 ? -1 : 1);
+    }
+    BSONObj findCmd = BSON("find"
+                           << "testcoll"
+                           << "sort" << sortBuilder.obj());
+
+    // Builds a result whose sort key is all zeros but for the last, descending, field.
+    auto makeResult = [&](int last) {
+        BSONArrayBuilder sortKey;
+        for (int i = 0; i < kNumSortFields - 1; ++i) {
+            sortKey.append(0);
+        }
+        sortKey.append(last);
+        return BSON("last" << last << "$sortKey" << sortKey.arr());
+    };
+
+    std::vector<RemoteCursor> cursors;
+    std::vector<BSONObj> batch1 = {makeResult(5), makeResult(1)};
+    cursors.push_back(makeRemoteCursor(
+        kTestShardIds[0], kTestShardHosts[0], CursorResponse(kTestNss, 0, std::move(batch1))));
+    std::vector<BSONObj> batch2 = {makeResult(6), makeResult(3)};
+    cursors.push_back(makeRemoteCursor(
+        kTestShardIds[1], kTestShardHosts[1], CursorResponse(kTestNss, 0, std::move(batch2))));
+    auto arm = makeARMFromExistingCursors(std::move(cursors), findCmd);
+
+    for (int last : {6, 5, 3, 1}) {
+        ASSERT_TRUE(arm->ready());
+        ASSERT_EQ(last, (*unittest::assertGet(arm->nextReady()).getResult())["last"].numberInt());
+    }
+    ASSERT_TRUE(arm->ready());
+    ASSERT_TRUE(unittest::assertGet(arm->nextReady()).isEOF());
+}
+
+TEST_F(AsyncResultsMergerTest, PrefetchesNextBatchBeforeBufferDrains) {
+    BSONObj findCmd = fromjson("{find: 'testcoll', batchSize: 4}");
+    std::vector<RemoteCursor> cursors;
+    cursors.push_back(
+        makeRemoteCursor(kTestShardIds[0], kTestShardHosts[0], CursorResponse(kTestNss, 1, {})));
+    auto arm = makeARMFromExistingCursors(std::move(cursors), findCmd);
+
+    auto advanceClock = [&](Milliseconds amount) {
+        executor::NetworkInterfaceMock* net = network();
+        net->enterNetwork();
+        net->advanceTime(net->now() + amount);
+        net->exitNetwork();
+    };
+    auto hasPendingRequest = [&] {
+        executor::NetworkInterfaceMock* net = network();
+        net->enterNetwork();
+        auto hasReadyRequests = net->hasReadyRequests();
+        net->exitNetwork();
+        return hasReadyRequests;
+    };
+
+    // The first getMore takes 10ms to come back.
+    ASSERT_FALSE(arm->ready());
+    auto readyEvent = unittest::assertGet(arm->nextEvent());
+    advanceClock(Milliseconds(10));
+    std::vector<CursorResponse> responses;
+    std::vector<BSONObj> batch1 = {
+        fromjson("{_id: 1}"), fromjson("{_id: 2}"), fromjson("{_id: 3}"), fromjson("{_id: 4}")};
+    responses.emplace_back(kTestNss, CursorId(1), batch1);
+    scheduleNetworkResponses(std::move(responses));
+    executor()->waitForEvent(readyEvent);
+
+    // Results are then consumed at a rate of one per 5ms. After the first result, the remaining
+    // three would take longer than a round trip to consume, so nothing is prefetched.
+    advanceClock(Milliseconds(5));
+    ASSERT_TRUE(arm->ready());
+    ASSERT_BSONOBJ_EQ(fromjson("{_id: 1}"), *unittest::assertGet(arm->nextReady()).getResult());
+    ASSERT_FALSE(hasPendingRequest());
+
+    // After the second, the remaining two would be consumed within a round trip, so the ARM asks
+    // for the next batch even though results are still buffered.
+    advanceClock(Milliseconds(5));
+    ASSERT_TRUE(arm->ready());
+    ASSERT_BSONOBJ_EQ(fromjson("{_id: 2}"), *unittest::assertGet(arm->nextReady()).getResult());
+    ASSERT_TRUE(hasPendingRequest());
+
+    responses.clear();
+    std::vector<BSONObj> batch2 = {fromjson("{_id: 5}")};
+    responses.emplace_back(kTestNss, CursorId(0), batch2);
+    scheduleNetworkResponses(std::move(responses));
+
+    for (int id = 3; id <= 5; ++id) {
+        ASSERT_TRUE(arm->ready());
+        ASSERT_BSONOBJ_EQ(BSON("_id" << id), *unittest::assertGet(arm->nextReady()).getResult());
+    }
+    ASSERT_TRUE(arm->ready());
+    ASSERT_TRUE(unittest::assertGet(arm->nextReady()).isEOF());
+}
+
+TEST_F(AsyncResultsMergerTest, DoesNotPrefetchForSessionCursorsByDefault) {
+    operationContext()->setLogicalSessionId(makeLogicalSessionIdForTest());
+
+    BSONObj findCmd = fromjson("{find: 'testcoll', batchSize: 3}");
+    std::vector<RemoteCursor> cursors;
+    cursors.push_back(
+        makeRemoteCursor(kTestShardIds[0], kTestShardHosts[0], CursorResponse(kTestNss, 1, {})));
+    auto arm = makeARMFromExistingCursors(std::move(cursors), findCmd);
+
+    auto advanceClock = [&](Milliseconds amount) {
+        executor::NetworkInterfaceMock* net = network();
+        net->enterNetwork();
+        net->advanceTime(net->now() + amount);
+        net->exitNetwork();
+    };
+
+    // The first getMore takes 10ms to come back.
+    ASSERT_FALSE(arm->ready());
+    auto readyEvent = unittest::assertGet(arm->nextEvent());
+    advanceClock(Milliseconds(10));
+    std::vector<CursorResponse> responses;
+    std::vector<BSONObj> batch1 = {
+        fromjson("{_id: 1}"), fromjson("{_id: 2}"), fromjson("{_id: 3}")};
+    responses.emplace_back(kTestNss, CursorId(1), batch1);
+    scheduleNetworkResponses(std::move(responses));
+    executor()->waitForEvent(readyEvent);
+
+    // The results are consumed fast enough that a cursor outside of a session would prefetch, but
+    // the next getMore is only sent once the buffer is empty.
+    for (int id = 1; id <= 3; ++id) {
+        advanceClock(Milliseconds(1));
+        ASSERT_TRUE(arm->ready());
+        ASSERT_BSONOBJ_EQ(BSON("_id" << id), *unittest::assertGet(arm->nextReady()).getResult());
+        executor::NetworkInterfaceMock* net = network();
+        net->enterNetwork();
+        ASSERT_FALSE(net->hasReadyRequests());
+        net->exitNetwork();
+    }
+
+    ASSERT_FALSE(arm->ready());
+    readyEvent = unittest::assertGet(arm->nextEvent());
+    responses.clear();
+    responses.emplace_back(kTestNss, CursorId(0), std::vector<BSONObj>{});
+    scheduleNetworkResponses(std::move(responses));
+    executor()->waitForEvent(readyEvent);
+    ASSERT_TRUE(arm->ready());
+    ASSERT_TRUE(unittest::assertGet(arm->nextReady()).isEOF());
+}
+
 TEST_F(AsyncResultsMergerTest, SortedButNoSortKey) {
     BSONObj findCmd = fromjson("{find: 'testcoll', sort: {a: -1, b: 1}}");
     std::vector<RemoteCursor> cursors;
@@ -35,6 +35,8 @@
 #include "mongo/bson/util/bson_extract.h"
 #include "mongo/client/connpool.h"
 #include "mongo/db/auth/authorization_session.h"
+#include "mongo/db/pipeline/document_source_exchange.h"
+#include "mongo/db/pipeline/document_source_group.h"
 #include "mongo/db/pipeline/document_source_limit.h"
 #include "mongo/db/pipeline/document_source_skip.h"
 #include "mongo/db/pipeline/sharded_agg_helpers.h"
@@ -49,6 +51,7 @@
 #include "mongo/s/query/cluster_cursor_manager.h"
 #include "mongo/s/query/cluster_query_knobs_gen.h"
 #include "mongo/s/query/document_source_merge_cursors.h"
+#include "mongo/s/query/document_source_parallel_merge.h"
 #include "mongo/s/query/router_stage_limit.h"
 #include "mongo/s/query/router_stage_pipeline.h"
 #include "mongo/s/query/router_stage_remove_metadata_fields.h"
@@ -158,6 +161,86 @@ BSONObj createCommandForMergingShard(Document serializedCommand,
                                  mergeCmdObj);
 }
 
+/**
+ * If 'internalQueryMongosMergeParallelism' is greater than 1 and the merge pipeline begins with an
+ * unsorted $mergeCursors followed by a merging $group, replaces those two stages with a
+ * $_internalParallelMerge stage. The results from the shards are then hash-partitioned on the
+ * group key by an Exchange, and each partition is merged by its own $group on its own thread. The
+ * merging $group does not specify an output order, so the remainder of the pipeline is unaffected.
+ */
+void parallelizeMergeOnMongos(Pipeline* mergePipeline,
+                              const boost::optional<BSONObj>& shardCursorsSortSpec) {
+    const auto parallelism = internalQueryMongosMergeParallelism.load();
+    const auto& expCtx = mergePipeline->getContext();
+    if (parallelism <= 1 || shardCursorsSortSpec || expCtx->explain || expCtx->getCollator() ||
+        expCtx->tailableMode != TailableModeEnum::kNormal ||
+        expCtx->opCtx->inMultiDocumentTransaction()) {
+        return;
+    }
+
+    auto& sources = mergePipeline->getSources();
+    if (sources.size() < 2) {
+        return;
+    }
+    auto mergeCursors = dynamic_cast<DocumentSourceMergeCursors*>(sources.front().get());
+    auto mergingGroup = dynamic_cast<DocumentSourceGroup*>(std::next(sources.begin())->get());
+    if (!mergeCursors || !mergingGroup || !mergingGroup->doingMerge() ||
+        mergeCursors->getNumRemotes() < 2) {
+        return;
+    }
+
+    // The $mergeCursors stage becomes the input of the Exchange, which is driven by whichever
+    // partition thread needs more documents, so give it an ExpressionContext of its own.
+    const auto mergeCursorsSpec = mergeCursors->serialize().getDocument().toBson();
+    auto inputExpCtx = expCtx->copyWith(expCtx->ns);
+    auto inputPipeline = Pipeline::create(
+        {DocumentSourceMergeCursors::createFromBson(mergeCursorsSpec.firstElement(), inputExpCtx)},
+        inputExpCtx);
+    mergeCursors->dismissCursorOwnership();
+
+    // Split the space of 64-bit hashes of the group key into equal ranges, one per partition.
+    std::vector<BSONObj> boundaries{BSON("" << MINKEY)};
+    const auto rangeWidth = std::numeric_limits<uint64_t>::max() / parallelism;
+    for (int partition = 1; partition < parallelism; ++partition) {
+        const auto boundary = static_cast<uint64_t>(std::numeric_limits<long long>::min()) +
+            static_cast<uint64_t>(partition) * rangeWidth;
+        boundaries.push_back(BSON("" << static_cast<long long>(boundary)));
+    }
+    boundaries.push_back(BSON("" << MAXKEY));
+
+    ExchangeSpec exchangeSpec;
+    exchangeSpec.setPolicy(ExchangePolicyEnum::kKeyRange);
+    exchangeSpec.setConsumers(parallelism);
+    exchangeSpec.setKey(BSON("_id"
+                             << "hashed"));
+    exchangeSpec.setBoundaries(std::move(boundaries));
+    boost::intrusive_ptr<Exchange> exchange =
+        new Exchange(std::move(exchangeSpec), std::move(inputPipeline));
+
+    // Each partition re-parses the merging $group so that no state is shared between threads.
+    const auto mergingGroupSpec = mergingGroup->serialize().getDocument().toBson();
+    std::vector<std::unique_ptr<Pipeline, PipelineDeleter>> partitionPipelines;
+    for (int partition = 0; partition < parallelism; ++partition) {
+        auto partitionExpCtx = expCtx->copyWith(expCtx->ns);
+        boost::intrusive_ptr<DocumentSource> consumer = new DocumentSourceExchange(
+            partitionExpCtx,
+            exchange,
+            partition,
+            partitionExpCtx->mongoProcessInterface->getResourceYielder());
+        auto partitionPipeline = Pipeline::create(
+            {consumer,
+             DocumentSourceGroup::createFromBson(mergingGroupSpec.firstElement(), partitionExpCtx)},
+            partitionExpCtx);
+        partitionPipeline->detachFromOperationContext();
+        partitionPipelines.push_back(std::move(partitionPipeline));
+    }
+
+    sources.pop_front();
+    sources.pop_front();
+    mergePipeline->addInitialSource(
+        DocumentSourceParallelMerge::create(expCtx, exchange, std::move(partitionPipelines)));
+}
+
 Status dispatchMergingPipeline(const boost::intrusive_ptr<ExpressionContext>& expCtx,
                                const ClusterAggregate::Namespaces& namespaces,
                                Document serializedCommand,
@@ -191,6 +274,8 @@ Status dispatchMergingPipeline(const boost::intrusive_ptr<ExpressionContext>& ex
     // then ignore the internalQueryProhibitMergingOnMongoS parameter.
     if (mergePipeline->requiredToRunOnMongos() ||
         (!internalQueryProhibitMergingOnMongoS.load() && mergePipeline->canRunOnMongos())) {
+        parallelizeMergeOnMongos(mergePipeline,
+                                 shardDispatchResults.splitPipeline->shardCursorsSortSpec);
         return runPipelineOnMongoS(namespaces,
                                    batchSize,
                                    std::move(shardDispatchResults.splitPipeline->mergePipeline),
@@ -0,0 +1,222 @@
+/**
+ *    Copyright (C) 2021-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/s/query/document_source_parallel_merge.h"
+
+#include "mongo/db/auth/authorization_session.h"
+#include "mongo/db/client.h"
+#include "mongo/util/scopeguard.h"
+
+namespace mongo {
+
+constexpr StringData DocumentSourceParallelMerge::kStageName;
+
+boost::intrusive_ptr<DocumentSourceParallelMerge> DocumentSourceParallelMerge::create(
+    const boost::intrusive_ptr<ExpressionContext>& expCtx,
+    boost::intrusive_ptr<Exchange> exchange,
+    std::vector<std::unique_ptr<Pipeline, PipelineDeleter>> partitionPipelines) {
+    invariant(exchange);
+    invariant(partitionPipelines.size() == exchange->getConsumers());
+    return new DocumentSourceParallelMerge(
+        expCtx, std::move(exchange), std::move(partitionPipelines));
+}
+
+DocumentSourceParallelMerge::DocumentSourceParallelMerge(
+    const boost::intrusive_ptr<ExpressionContext>& expCtx,
+    boost::intrusive_ptr<Exchange> exchange,
+    std::vector<std::unique_ptr<Pipeline, PipelineDeleter>> partitionPipelines)
+    : DocumentSource(kStageName, expCtx),
+      _exchange(std::move(exchange)),
+      _partitionPipelines(std::move(partitionPipelines)),
+      _workerOpCtxs(_partitionPipelines.size(), nullptr) {}
+
+DocumentSourceParallelMerge::~DocumentSourceParallelMerge() {
+    // The workers refer to this stage, so they must be gone before it is destroyed. This is a no-op
+    // if the stage was disposed of.
+    stopWorkers();
+}
+
+Value DocumentSourceParallelMerge::serialize(
+    boost::optional<ExplainOptions::Verbosity> explain) const {
+    return Value(Document{
+        {kStageName,
+         Document{{"exchange", Document{_exchange->getSpec().toBSON()}},
+                  {"partitionPipeline", Value(_partitionPipelines.front()->serialize())}}}});
+}
+
+DocumentSource::GetNextResult DocumentSourceParallelMerge::doGetNext() {
+    if (_workers.empty()) {
+        startWorkers();
+    }
+
+    while (_numFinishedPartitions < _partitionPipelines.size()) {
+        auto result = [&] {
+            try {
+                return _results.pop(pExpCtx->opCtx);
+            } catch (const DBException&) {
+                // The operation running this stage was interrupted, or reached its deadline. The
+                // workers run on behalf of it, so they must not outlive it.
+                stopWorkers();
+                throw;
+            }
+        }();
+        if (result.doc) {
+            return std::move(*result.doc);
+        }
+
+        ++_numFinishedPartitions;
+        if (result.status == ErrorCodes::ExchangePassthrough) {
+            // Another partition hit the error which caused the Exchange to fail. Wait for it to
+            // report the original error.
+            if (_passthroughError.isOK()) {
+                _passthroughError = result.status;
+            }
+            continue;
+        }
+        uassertStatusOK(result.status);
+    }
+
+    uassertStatusOK(_passthroughError);
+    return GetNextResult::makeEOF();
+}
+
+void DocumentSourceParallelMerge::doDispose() {
+    if (_workers.empty()) {
+        // We were never iterated, so the partition pipelines have to be disposed of here. The last
+        // of them to be disposed of will dispose of the Exchange's input pipeline.
+        for (auto&& pipeline : _partitionPipelines) {
+            pipeline.get_deleter().dismissDisposal();
+            pipeline->dispose(pExpCtx->opCtx);
+        }
+    }
+    stopWorkers();
+}
+
+void DocumentSourceParallelMerge::startWorkers() {
+    auto opCtx = pExpCtx->opCtx;
+
+    // The remote cursors have to be established on behalf of the same users as the operation
+    // running this stage, the same way it would forward them if it ran the pipeline itself.
+    auto workerContext = std::make_shared<WorkerContext>();
+    workerContext->serviceContext = opCtx->getServiceContext();
+    auto authSession = AuthorizationSession::get(opCtx->getClient());
+    auto userNames = authSession->getImpersonatedUserNames();
+    auto roleNames = authSession->getImpersonatedRoleNames();
+    if (!userNames.more() && !roleNames.more()) {
+        userNames = authSession->getAuthenticatedUserNames();
+        roleNames = authSession->getAuthenticatedRoleNames();
+    }
+    workerContext->userNames = userNameIteratorToContainer<std::vector<UserName>>(userNames);
+    workerContext->roleNames = roleNameIteratorToContainer<std::vector<RoleName>>(roleNames);
+
+    _workers.reserve(_partitionPipelines.size());
+    for (size_t partitionId = 0; partitionId < _partitionPipelines.size(); ++partitionId) {
+        _workers.emplace_back(
+            [this, workerContext, partitionId] { runPartition(*workerContext, partitionId); });
+    }
+}
+
+void DocumentSourceParallelMerge::runPartition(const WorkerContext& workerContext,
+                                               size_t partitionId) {
+    auto serviceContext = workerContext.serviceContext;
+    ThreadClient tc(str::stream() << "parallelMerge-" << partitionId, serviceContext);
+    if (!workerContext.userNames.empty() || !workerContext.roleNames.empty()) {
+        AuthorizationSession::get(tc.get())->setImpersonatedUserData(workerContext.userNames,
+                                                                    workerContext.roleNames);
+    }
+
+    // The worker outlives the command which started it, since it keeps running on behalf of the
+    // getMores on the cursor, so it gets no deadline of its own. Each command instead waits for
+    // results under its own deadline, and kills the workers if that wait is interrupted.
+    auto opCtx = tc->makeOperationContext();
+
+    {
+        stdx::lock_guard<Latch> lk(_mutex);
+        _workerOpCtxs[partitionId] = opCtx.get();
+        if (_stopping) {
+            stdx::lock_guard<Client> clientLock(*tc.get());
+            serviceContext->killOperation(clientLock, opCtx.get(), ErrorCodes::QueryPlanKilled);
+        }
+    }
+    ON_BLOCK_EXIT([&] {
+        stdx::lock_guard<Latch> lk(_mutex);
+        _workerOpCtxs[partitionId] = nullptr;
+    });
+
+    auto& pipeline = _partitionPipelines[partitionId];
+    pipeline.get_deleter().dismissDisposal();
+    pipeline->reattachToOperationContext(opCtx.get());
+
+    PartitionResult eofOrError;
+    try {
+        while (auto next = pipeline->getNext()) {
+            _results.push({std::move(*next), Status::OK()}, opCtx.get());
+        }
+    } catch (const DBException& ex) {
+        eofOrError.status = ex.toStatus();
+    }
+
+    // Dispose of the partition before reporting that it is done, so that the remote cursors have
+    // been cleaned up by the time the last partition reports back.
+    pipeline->dispose(opCtx.get());
+    pipeline->detachFromOperationContext();
+
+    try {
+        _results.push(std::move(eofOrError), opCtx.get());
+    } catch (const DBException&) {
+        // This stage is no longer consuming results, so there is nobody to report to.
+    }
+}
+
+void DocumentSourceParallelMerge::stopWorkers() {
+    _results.closeConsumerEnd();
+
+    {
+        stdx::lock_guard<Latch> lk(_mutex);
+        _stopping = true;
+        for (auto&& opCtx : _workerOpCtxs) {
+            if (opCtx) {
+                stdx::lock_guard<Client> clientLock(*opCtx->getClient());
+                opCtx->getServiceContext()->killOperation(
+                    clientLock, opCtx, ErrorCodes::QueryPlanKilled);
+            }
+        }
+    }
+
+    for (auto&& worker : _workers) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+}
+
+}  // namespace mongo
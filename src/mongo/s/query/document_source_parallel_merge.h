@@ -0,0 +1,195 @@
+/**
+ *    Copyright (C) 2021-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#pragma once
+
+#include <vector>
+
+#include "mongo/db/auth/role_name.h"
+#include "mongo/db/auth/user_name.h"
+#include "mongo/db/pipeline/document_source.h"
+#include "mongo/db/pipeline/document_source_exchange.h"
+#include "mongo/platform/mutex.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/util/producer_consumer_queue.h"
+
+namespace mongo {
+
+/**
+ * A stage used only internally on mongos to run the merging half of a split pipeline on several
+ * threads at once. The input to this stage is an Exchange which hash-partitions the documents
+ * produced by its input pipeline (typically a $mergeCursors stage), and each partition pipeline
+ * consists of a DocumentSourceExchange consumer followed by the stages which can be executed
+ * independently on each partition, such as a merging $group keyed on the exchange key.
+ *
+ * Upon the first call to getNext(), one worker thread is spawned per partition. Each worker runs
+ * its partition pipeline under its own Client and OperationContext, which impersonate the users
+ * of the operation running this stage, and hands the results to this stage through a bounded
+ * queue. The workers have no deadline of their own, since they outlive the command which started
+ * them: each command which consumes the results, the aggregate or a later getMore, waits for them
+ * under its own deadline. If this stage is interrupted, the workers are killed. Documents
+ * are returned in the order in which the partitions produce them, so this stage must only be used
+ * when the output order is unspecified.
+ */
+class DocumentSourceParallelMerge final : public DocumentSource {
+public:
+    static constexpr StringData kStageName = "$_internalParallelMerge"_sd;
+
+    /**
+     * Creates a new DocumentSourceParallelMerge. 'partitionPipelines' must contain exactly one
+     * pipeline per consumer of 'exchange', in consumer id order, and each must be detached from
+     * its OperationContext.
+     */
+    static boost::intrusive_ptr<DocumentSourceParallelMerge> create(
+        const boost::intrusive_ptr<ExpressionContext>& expCtx,
+        boost::intrusive_ptr<Exchange> exchange,
+        std::vector<std::unique_ptr<Pipeline, PipelineDeleter>> partitionPipelines);
+
+    ~DocumentSourceParallelMerge();
+
+    const char* getSourceName() const final {
+        return kStageName.rawData();
+    }
+
+    Value serialize(boost::optional<ExplainOptions::Verbosity> explain = boost::none) const final;
+
+    StageConstraints constraints(Pipeline::SplitState pipeState) const final {
+        StageConstraints constraints(StreamType::kStreaming,
+                                     PositionRequirement::kFirst,
+                                     HostTypeRequirement::kMongoS,
+                                     DiskUseRequirement::kNoDiskUse,
+                                     FacetRequirement::kNotAllowed,
+                                     TransactionRequirement::kNotAllowed,
+                                     LookupRequirement::kNotAllowed,
+                                     UnionRequirement::kNotAllowed);
+
+        constraints.requiresInputDocSource = false;
+        return constraints;
+    }
+
+    boost::optional<DistributedPlanLogic> distributedPlanLogic() final {
+        return boost::none;
+    }
+
+    size_t getNumPartitions() const {
+        return _partitionPipelines.size();
+    }
+
+protected:
+    GetNextResult doGetNext() final;
+    void doDispose() final;
+
+private:
+    /**
+     * An entry in the queue shared by the worker threads. A document is returned as-is, an EOF
+     * entry indicates that one of the partitions has been exhausted, and a non-OK status is the
+     * error which terminated one of the partitions.
+     */
+    struct PartitionResult {
+        boost::optional<Document> doc;
+        Status status = Status::OK();
+    };
+
+    /**
+     * Measures the entries in the queue by the approximate size of the document they hold, so
+     * that the amount of memory buffered between the workers and this stage is bounded.
+     */
+    struct PartitionResultCost {
+        size_t operator()(const PartitionResult& result) const {
+            return result.doc ? std::max<size_t>(1, result.doc->getApproximateSize()) : 1;
+        }
+    };
+
+    using ResultQueue = MultiProducerSingleConsumerQueue<PartitionResult, PartitionResultCost>;
+
+    // The maximum number of bytes which may be buffered in '_results' at any one time.
+    static constexpr size_t kMaxBufferedBytes = 32 * 1024 * 1024;
+
+    DocumentSourceParallelMerge(
+        const boost::intrusive_ptr<ExpressionContext>& expCtx,
+        boost::intrusive_ptr<Exchange> exchange,
+        std::vector<std::unique_ptr<Pipeline, PipelineDeleter>> partitionPipelines);
+
+    /**
+     * The state of the OperationContext which is running this stage that each worker has to carry
+     * over to its own Client and OperationContext: the users on whose behalf the remote cursors
+     * are established.
+     */
+    struct WorkerContext {
+        ServiceContext* serviceContext;
+        std::vector<UserName> userNames;
+        std::vector<RoleName> roleNames;
+    };
+
+    /**
+     * Spawns one worker thread per partition pipeline.
+     */
+    void startWorkers();
+
+    /**
+     * The body of a worker thread. Drains the partition pipeline identified by 'partitionId' into
+     * '_results', then disposes of it.
+     */
+    void runPartition(const WorkerContext& workerContext, size_t partitionId);
+
+    /**
+     * Interrupts any worker which is still running and waits for all of them to terminate. Safe to
+     * call more than once.
+     */
+    void stopWorkers();
+
+    boost::intrusive_ptr<Exchange> _exchange;
+    std::vector<std::unique_ptr<Pipeline, PipelineDeleter>> _partitionPipelines;
+
+    ResultQueue _results{[] {
+        ResultQueue::Options options;
+        options.maxQueueDepth = kMaxBufferedBytes;
+        return options;
+    }()};
+
+    // Protects '_workerOpCtxs' and '_stopping'.
+    Mutex _mutex = MONGO_MAKE_LATCH("DocumentSourceParallelMerge::_mutex");
+
+    // The OperationContext of each running worker, indexed by partition id, or nullptr if the
+    // worker has not started or has already finished.
+    std::vector<OperationContext*> _workerOpCtxs;
+    bool _stopping = false;
+
+    std::vector<stdx::thread> _workers;
+
+    // The number of partitions which have reported EOF or an error back to this stage.
+    size_t _numFinishedPartitions = 0;
+
+    // The first ExchangePassthrough error reported by a partition. Such an error only indicates
+    // that another partition failed, so we keep looking for the original error before giving up.
+    Status _passthroughError = Status::OK();
+};
+
+}  // namespace mongo
@@ -37,6 +37,7 @@
 #include "mongo/transport/session.h"
 #include "mongo/transport/transport_layer.h"
 #include "mongo/util/assert_util.h"
+#include "mongo/util/concurrency/thread_name.h"
 #include "mongo/util/fail_point.h"
 #include "mongo/util/testing_proctor.h"
 #include "mongo/util/thread_safety_context.h"
@@ -55,6 +56,7 @@ constexpr auto kThreadsRunning = "threadsRunning"_sd;
 constexpr auto kClientsInTotal = "clientsInTotal"_sd;
 constexpr auto kClientsRunning = "clientsRunning"_sd;
 constexpr auto kClientsWaiting = "clientsWaitingForData"_sd;
+constexpr auto kTasksStolen = "tasksStolen"_sd;
 
 struct Handle {
     ~Handle() {
@@ -72,7 +74,8 @@ const auto serviceExecutorFixedRegisterer = ServiceContext::ConstructorActionReg
         auto limits = ThreadPool::Limits{};
         limits.minThreads = 0;
         limits.maxThreads = fixedServiceExecutorThreadLimit;
-        getHandle(ctx).ptr = std::make_shared<ServiceExecutorFixed>(ctx, std::move(limits));
+        getHandle(ctx).ptr = std::make_shared<ServiceExecutorFixed>(
+            ctx, std::move(limits), fixedServiceExecutorUseWorkStealing);
     }};
 }  // namespace
 
@@ -130,14 +133,29 @@ ServiceExecutorFixed::ExecutorThreadContext::~ExecutorThreadContext() {
 thread_local std::unique_ptr<ServiceExecutorFixed::ExecutorThreadContext>
     ServiceExecutorFixed::_executorContext;
 
-ServiceExecutorFixed::ServiceExecutorFixed(ServiceContext* ctx, ThreadPool::Limits limits)
+ServiceExecutorFixed::ServiceExecutorFixed(ServiceContext* ctx,
+                                           ThreadPool::Limits limits,
+                                           bool useWorkStealing)
     : _svcCtx{ctx}, _options(std::move(limits)) {
     _options.poolName = "ServiceExecutorFixed";
     _options.onCreateThread = [this](const auto&) {
         _executorContext = std::make_unique<ExecutorThreadContext>(this);
     };
 
-    _threadPool = std::make_shared<ThreadPool>(_options);
+    if (!useWorkStealing) {
+        _threadPool = std::make_shared<ThreadPool>(_options);
+        return;
+    }
+
+    WorkStealingThreadPool::Options options;
+    options.poolName = _options.poolName;
+    options.minThreads = _options.minThreads;
+    options.maxThreads = _options.maxThreads;
+    options.maxIdleThreadAge = _options.maxIdleThreadAge;
+    options.onCreateThread = _options.onCreateThread;
+    auto pool = std::make_shared<WorkStealingThreadPool>(std::move(options));
+    _workStealingPool = pool.get();
+    _threadPool = std::move(pool);
 }
 
 ServiceExecutorFixed::~ServiceExecutorFixed() {
@@ -163,6 +181,9 @@ void ServiceExecutorFixed::join() noexcept {
     // We only can join when we have joined all of our tasks and canceled all of our sessions.  This
     // thread pool doesn't get to refuse work over its lifetime. It's possible that tasks are stiil
     // blocking. If so, we block until they finish here.
+    if (_reactorThread.joinable()) {
+        _reactorThread.join();
+    }
     _threadPool->shutdown();
     _threadPool->join();
 
@@ -213,7 +234,7 @@ Status ServiceExecutorFixed::start() {
 
     auto reactor = tl->getReactor(TransportLayer::WhichReactor::kIngress);
     invariant(reactor);
-    _threadPool->schedule([this, reactor](Status) {
+    auto runReactor = [this, reactor] {
         {
             // Check to make sure we haven't been shutdown already. Note that there is still a brief
             // race that immediately follows this check. ASIOReactor::stop() is not permanent, thus
@@ -226,7 +247,18 @@ Status ServiceExecutorFixed::start() {
 
         // Start running on the reactor immediately.
         reactor->run();
-    });
+    };
+
+    if (_workStealingPool) {
+        // The reactor runs until shutdown, so it gets a thread of its own rather than a worker,
+        // which would never take another task from its queue nor ever retire.
+        _reactorThread = stdx::thread([runReactor = std::move(runReactor)] {
+            setThreadName("ServiceExecutorFixed-reactor");
+            runReactor();
+        });
+    } else {
+        _threadPool->schedule([runReactor = std::move(runReactor)](Status) { runReactor(); });
+    }
 
     return Status::OK();
 }
@@ -397,9 +429,21 @@ void ServiceExecutorFixed::_schedule(OutOfLineExecutor::Task task) noexcept {
         _stats.tasksScheduled.fetchAndAdd(1);
     }
 
-    _threadPool->schedule([this, task = std::move(task)](Status status) mutable {
+    _runOnPool(std::move(task), boost::none);
+}
+
+void ServiceExecutorFixed::_runOnPool(OutOfLineExecutor::Task task,
+                                      boost::optional<size_t> workerId) {
+    auto wrappedTask = [this, task = std::move(task)](Status status) mutable {
         _executorContext->run([&] { task(std::move(status)); });
-    });
+    };
+
+    if (workerId) {
+        invariant(_workStealingPool);
+        _workStealingPool->scheduleOnWorker(*workerId, std::move(wrappedTask));
+    } else {
+        _threadPool->schedule(std::move(wrappedTask));
+    }
 }
 
 size_t ServiceExecutorFixed::getRunningThreads() const {
@@ -413,6 +457,9 @@ void ServiceExecutorFixed::runOnDataAvailable(const SessionHandle& session,
     yieldIfAppropriate();
 
     auto waiter = Waiter{session, std::move(onCompletionCallback)};
+    if (_workStealingPool) {
+        waiter.homeWorker = _workStealingPool->getCurrentWorkerId();
+    }
 
     WaiterList::iterator it;
     {
@@ -429,6 +476,44 @@ void ServiceExecutorFixed::runOnDataAvailable(const SessionHandle& session,
         _stats.waitersStarted.fetchAndAdd(1);
     }
 
+    if (_workStealingPool) {
+        // Rather than running the callback on whichever worker is next to take a task, as
+        // thenRunOn() would, queue it on the worker which was running the session.
+        session->asyncWaitForData().getAsync(
+            [this, anchor = shared_from_this(), it](Status status) mutable {
+                Waiter waiter;
+                bool isRunning;
+                {
+                    // Remove our waiter from the list, and account for the task in the same
+                    // critical section so that shutdown cannot complete in between.
+                    auto lk = stdx::unique_lock(_mutex);
+                    waiter = std::exchange(*it, {});
+                    _waiters.erase(it);
+
+                    _stats.waitersEnded.fetchAndAdd(1);
+
+                    isRunning = _state == State::kRunning;
+                    if (isRunning) {
+                        _stats.tasksScheduled.fetchAndAdd(1);
+                    }
+                }
+
+                waiter.session.reset();
+                if (!isRunning) {
+                    waiter.onCompletionCallback(kInShutdown);
+                    return;
+                }
+
+                _runOnPool(
+                    [status = std::move(status),
+                     callback = std::move(waiter.onCompletionCallback)](Status poolStatus) mutable {
+                        callback(poolStatus.isOK() ? std::move(status) : std::move(poolStatus));
+                    },
+                    waiter.homeWorker);
+            });
+        return;
+    }
+
     session->asyncWaitForData()
         .thenRunOn(shared_from_this())
         .getAsync([this, anchor = shared_from_this(), it](Status status) mutable {
@@ -455,6 +540,10 @@ void ServiceExecutorFixed::appendStats(BSONObjBuilder* bob) const {
     subbob.append(kClientsInTotal, static_cast<int>(_tasksTotal()));
     subbob.append(kClientsRunning, static_cast<int>(_tasksRunning()));
     subbob.append(kClientsWaiting, static_cast<int>(_tasksWaiting()));
+    if (_workStealingPool) {
+        subbob.append(kTasksStolen,
+                      static_cast<long long>(_workStealingPool->getStats().numStolenTasks));
+    }
 }
 
 int ServiceExecutorFixed::getRecursionDepthForExecutorThread() const {
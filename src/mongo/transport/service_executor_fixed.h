@@ -41,6 +41,8 @@
 #include "mongo/stdx/unordered_map.h"
 #include "mongo/transport/service_executor.h"
 #include "mongo/util/concurrency/thread_pool.h"
+#include "mongo/util/concurrency/thread_pool_interface.h"
+#include "mongo/util/concurrency/work_stealing_thread_pool.h"
 #include "mongo/util/concurrency/with_lock.h"
 #include "mongo/util/future.h"
 #include "mongo/util/hierarchical_acquisition.h"
@@ -52,6 +54,10 @@ namespace transport {
  * A service executor that uses a fixed (configurable) number of threads to execute tasks.
  * This executor always yields before executing scheduled tasks, and never yields before scheduling
  * new tasks (i.e., `ScheduleFlags::kMayYieldBeforeSchedule` is a no-op for this executor).
+ *
+ * If constructed with `useWorkStealing`, the threads are backed by a WorkStealingThreadPool and the
+ * work for a session is resumed on the thread which last waited for data on its behalf, rather
+ * than on whichever thread next takes a task from the shared queue.
  */
 class ServiceExecutorFixed final : public ServiceExecutor,
                                    public std::enable_shared_from_this<ServiceExecutorFixed> {
@@ -61,9 +67,11 @@ class ServiceExecutorFixed final : public ServiceExecutor,
         Status(ErrorCodes::ServiceExecutorInShutdown, "ServiceExecutorFixed is not running");
 
 public:
-    explicit ServiceExecutorFixed(ServiceContext* ctx, ThreadPool::Limits limits);
-    explicit ServiceExecutorFixed(ThreadPool::Limits limits)
-        : ServiceExecutorFixed(nullptr, std::move(limits)) {}
+    explicit ServiceExecutorFixed(ServiceContext* ctx,
+                                  ThreadPool::Limits limits,
+                                  bool useWorkStealing = false);
+    explicit ServiceExecutorFixed(ThreadPool::Limits limits, bool useWorkStealing = false)
+        : ServiceExecutorFixed(nullptr, std::move(limits), useWorkStealing) {}
     virtual ~ServiceExecutorFixed();
 
     static ServiceExecutorFixed* get(ServiceContext* ctx);
@@ -102,6 +110,12 @@ private:
     void _beginShutdown(WithLock);
     void _schedule(OutOfLineExecutor::Task task) noexcept;
 
+    /**
+     * Runs `task` on the thread pool, on the worker identified by `workerId` if one is given. The
+     * caller must have accounted for the task in `_stats.tasksScheduled`.
+     */
+    void _runOnPool(OutOfLineExecutor::Task task, boost::optional<size_t> workerId);
+
     auto _threadsRunning() const {
         auto ended = _stats.threadsEnded.load();
         auto started = _stats.threadsStarted.loadRelaxed();
@@ -157,11 +171,20 @@ private:
     bool _isJoined = false;
 
     ThreadPool::Options _options;
-    std::shared_ptr<ThreadPool> _threadPool;
+    std::shared_ptr<ThreadPoolInterface> _threadPool;
+
+    // Points to `_threadPool` if this executor was constructed with `useWorkStealing`.
+    WorkStealingThreadPool* _workStealingPool = nullptr;
+
+    // Runs the ingress reactor if using work stealing, so that it does not hold one of the workers.
+    stdx::thread _reactorThread;
 
     struct Waiter {
         SessionHandle session;
         OutOfLineExecutor::Task onCompletionCallback;
+
+        // The worker which should run `onCompletionCallback`, if using work stealing.
+        boost::optional<size_t> homeWorker;
     };
     using WaiterList = std::list<Waiter>;
     WaiterList _waiters;
@@ -177,10 +177,10 @@ public:
     public:
         ServiceExecutorHandle(const ServiceExecutorHandle&) = delete;
         ServiceExecutorHandle(ServiceExecutorHandle&&) = delete;
-        ServiceExecutorHandle() {
+        explicit ServiceExecutorHandle(bool useWorkStealing = false) {
             ThreadPool::Limits limits;
             limits.minThreads = limits.maxThreads = kNumExecutorThreads;
-            _executor = std::make_shared<ServiceExecutorFixed>(std::move(limits));
+            _executor = std::make_shared<ServiceExecutorFixed>(std::move(limits), useWorkStealing);
         }
 
         ~ServiceExecutorHandle() {
@@ -380,6 +380,37 @@ TEST_F(ServiceExecutorFixedFixture, RunTaskAfterWaitingForData) {
     ASSERT(ranOnDataAvailable.load());
 }
 
+TEST_F(ServiceExecutorFixedFixture, WorkStealingRunTaskAfterWaitingForData) {
+    auto tl = std::make_unique<TransportLayerMock>();
+    auto session = tl->createSession();
+
+    auto executorHandle = ServiceExecutorHandle(true);
+    executorHandle.start();
+
+    // Wait for data from an executor thread, so that the callback is queued on that thread.
+    AtomicWord<bool> ranOnDataAvailable{false};
+    auto barrier = std::make_shared<unittest::Barrier>(2);
+    auto waiting = std::make_shared<unittest::Barrier>(2);
+    ASSERT_OK(executorHandle->scheduleTask(
+        [&, barrier, waiting, executor = *executorHandle] {
+            executor->runOnDataAvailable(
+                session, [&ranOnDataAvailable, barrier, executor](Status status) mutable -> void {
+                    ASSERT_OK(status);
+                    ASSERT_EQ(executor->getRecursionDepthForExecutorThread(), 1);
+                    ranOnDataAvailable.store(true);
+                    barrier->countDownAndWait();
+                });
+            waiting->countDownAndWait();
+        },
+        ServiceExecutor::kEmptyFlags));
+
+    waiting->countDownAndWait();
+    ASSERT(!ranOnDataAvailable.load());
+    reinterpret_cast<MockSession*>(session.get())->signalAvailableData();
+    barrier->countDownAndWait();
+    ASSERT(ranOnDataAvailable.load());
+}
+
 TEST_F(ServiceExecutorFixedFixture, StartAndShutdownAreDeterministic) {
     auto handle = ServiceExecutorHandle();
 
@@ -38,6 +38,7 @@
 #include "mongo/transport/baton.h"
 #include "mongo/transport/ssl_connection_context.h"
 #include "mongo/transport/transport_layer_asio.h"
+#include "mongo/transport/transport_options_gen.h"
 #include "mongo/util/fail_point.h"
 #include "mongo/util/net/socket_utils.h"
 #ifdef MONGO_CONFIG_SSL
@@ -91,7 +92,8 @@ public:
                 std::shared_ptr<const SSLConnectionContext> transientSSLContext = nullptr) try
         : _socket(std::move(socket)),
           _tl(tl),
-          _isIngressSession(isIngressSession) {
+          _isIngressSession(isIngressSession),
+          _readAheadBufferSize(isIngressSession ? gIngressReadAheadBufferSizeBytes : 0) {
         auto family = endpointToSockAddr(_socket.local_endpoint()).getType();
         if (family == AF_INET || family == AF_INET6) {
             _socket.set_option(asio::ip::tcp::no_delay(true));
@@ -186,6 +188,9 @@ public:
 
     Status waitForData() noexcept override try {
         ensureSync();
+        if (_readAheadBegin != _readAheadEnd) {
+            return Status::OK();
+        }
         asio::error_code ec;
         getSocket().wait(asio::ip::tcp::socket::wait_read, ec);
         return errorCodeToStatus(ec);
@@ -195,6 +200,9 @@ public:
 
     Future<void> asyncWaitForData() noexcept override try {
         ensureAsync();
+        if (_readAheadBegin != _readAheadEnd) {
+            return Future<void>::makeReady();
+        }
         return getSocket().async_wait(asio::ip::tcp::socket::wait_read, UseFuture{});
     } catch (const DBException& ex) {
         return ex.toStatus();
@@ -252,6 +260,10 @@ public:
         if (!getSocket().is_open())
             return false;
 
+        // Bytes which were already read from the socket are still waiting to be consumed.
+        if (_readAheadBegin != _readAheadEnd)
+            return true;
+
         auto swPollEvents = pollASIOSocket(getSocket(), POLLIN, Milliseconds{0});
         if (!swPollEvents.isOK()) {
             if (swPollEvents != ErrorCodes::NetworkTimeout) {
@@ -442,7 +454,7 @@ private:
 
         auto headerBuffer = SharedBuffer::allocate(kHeaderSize);
         auto ptr = headerBuffer.get();
-        return read(asio::buffer(ptr, kHeaderSize), baton)
+        return readWithReadAhead(asio::buffer(ptr, kHeaderSize), baton)
             .then([headerBuffer = std::move(headerBuffer), this, baton]() mutable {
                 if (checkForHTTPRequest(asio::buffer(headerBuffer.get(), kHeaderSize))) {
                     return sendHTTPResponse(baton);
@@ -476,7 +488,7 @@ private:
                 memcpy(buffer.get(), headerBuffer.get(), kHeaderSize);
 
                 MsgData::View msgView(buffer.get());
-                return read(asio::buffer(msgView.data(), msgView.dataLen()), baton)
+                return readWithReadAhead(asio::buffer(msgView.data(), msgView.dataLen()), baton)
                     .then([this, buffer = std::move(buffer), msgLen]() mutable {
                         if (_isIngressSession) {
                             networkCounter.hitPhysicalIn(msgLen);
@@ -486,6 +498,105 @@ private:
             });
     }
 
+    /**
+     * Returns true if reads on this session may go through the read-ahead buffer. TLS sessions
+     * are excluded since the ssl stream does its own buffering, and the first read on a session
+     * must go through read() so that it can detect a TLS handshake.
+     */
+    bool canUseReadAhead() const {
+        if (!_readAheadBufferSize) {
+            return false;
+        }
+#ifdef MONGO_CONFIG_SSL
+        return !_sslSocket && _ranHandshake;
+#else
+        return true;
+#endif
+    }
+
+    /**
+     * Fills 'buffer', first from the bytes left over in the read-ahead buffer and then from the
+     * socket. Small reads from the socket go through the read-ahead buffer, so that a single
+     * syscall typically returns both the header and the body of a message, as well as any
+     * message the client pipelined behind it.
+     */
+    Future<void> readWithReadAhead(asio::mutable_buffer buffer,
+                                   const BatonHandle& baton = nullptr) {
+        if (!canUseReadAhead()) {
+            return read(buffer, baton);
+        }
+
+        if (auto buffered = std::min(buffer.size(), _readAheadEnd - _readAheadBegin)) {
+            memcpy(buffer.data(), _readAheadBuffer.get() + _readAheadBegin, buffered);
+            buffer += buffered;
+            _readAheadBegin += buffered;
+            if (_readAheadBegin == _readAheadEnd) {
+                // Don't hold on to the buffer while the session is idle.
+                _readAheadBuffer = {};
+                _readAheadBegin = _readAheadEnd = 0;
+            }
+        }
+
+        if (buffer.size() == 0) {
+            return Future<void>::makeReady();
+        }
+
+        if (buffer.size() >= _readAheadBufferSize) {
+            // Large messages are read directly into their final destination.
+            return read(buffer, baton);
+        }
+
+        return fillReadAheadBuffer(baton).then(
+            [this, buffer, baton] { return readWithReadAhead(buffer, baton); });
+    }
+
+    /**
+     * Reads whatever is available on the socket, up to the size of the read-ahead buffer, with a
+     * single call to read_some(). Must only be called once the read-ahead buffer is drained.
+     */
+    Future<void> fillReadAheadBuffer(const BatonHandle& baton) {
+        invariant(_readAheadBegin == 0 && _readAheadEnd == 0);
+        if (!_readAheadBuffer) {
+            _readAheadBuffer = SharedBuffer::allocate(_readAheadBufferSize);
+        }
+
+        std::error_code ec;
+        size_t size;
+        do {
+            size = getSocket().read_some(
+                asio::buffer(_readAheadBuffer.get(), _readAheadBufferSize), ec);
+        } while (ec == asio::error::interrupted);  // retry syscall EINTR
+
+        if (!ec) {
+            _readAheadEnd = size;
+            return Future<void>::makeReady();
+        }
+
+        if (((ec == asio::error::would_block) || (ec == asio::error::try_again)) &&
+            (_blockingMode == Async)) {
+            if (auto networkingBaton = baton ? baton->networking() : nullptr;
+                networkingBaton && networkingBaton->canWait()) {
+                return networkingBaton->addSession(*this, NetworkingBaton::Type::In)
+                    .onError([](Status error) {
+                        if (ErrorCodes::isShutdownError(error)) {
+                            // If the baton has detached, it will cancel its polling. Retry so that
+                            // we wait on the reactor below instead.
+                            return Status::OK();
+                        }
+
+                        return error;
+                    })
+                    .then([baton, this] { return fillReadAheadBuffer(baton); });
+            }
+
+            return getSocket()
+                .async_wait(GenericSocket::wait_read, UseFuture{})
+                .then([baton, this] { return fillReadAheadBuffer(baton); });
+        }
+
+        return futurize(ec);
+    }
+
     template <typename MutableBufferSequence>
     Future<void> read(const MutableBufferSequence& buffers, const BatonHandle& baton = nullptr) {
         // TODO SERVER-47229 Guard active ops for cancelation here.
@@ -854,6 +965,14 @@ private:
 
     TransportLayerASIO* const _tl;
     bool _isIngressSession;
+
+    // Bytes read from the socket ahead of the message currently being sourced. Only the range
+    // [_readAheadBegin, _readAheadEnd) of '_readAheadBuffer' is yet to be consumed. The buffer is
+    // released whenever it is drained. A size of zero disables read-ahead for this session.
+    const size_t _readAheadBufferSize;
+    SharedBuffer _readAheadBuffer;
+    size_t _readAheadBegin = 0;
+    size_t _readAheadEnd = 0;
 };
 
 }  // namespace transport
@@ -273,15 +273,26 @@ public:
     }
 
     void sendMessage() {
-        OpMsgBuilder builder;
-        builder.setBody(BSON("ping" << 1));
-        Message msg = builder.finish();
-        msg.header().setResponseToMsgId(0);
-        msg.header().setId(0);
-        OpMsg::appendChecksum(&msg);
+        sendPipelinedMessages(1);
+    }
+
+    /**
+     * Sends 'count' ping messages with a single write, as a client pipelining its requests would.
+     */
+    void sendPipelinedMessages(size_t count) {
+        std::string buffer;
+        for (size_t i = 0; i < count; ++i) {
+            OpMsgBuilder builder;
+            builder.setBody(BSON("ping" << 1));
+            Message msg = builder.finish();
+            msg.header().setResponseToMsgId(0);
+            msg.header().setId(i);
+            OpMsg::appendChecksum(&msg);
+            buffer.append(msg.buf(), msg.size());
+        }
 
         std::error_code ec;
-        asio::write(_sock, asio::buffer(msg.buf(), msg.size()), ec);
+        asio::write(_sock, asio::buffer(buffer.data(), buffer.size()), ec);
         ASSERT_FALSE(ec);
     }
 
@@ -382,5 +393,41 @@ TEST(TransportLayerASIO, SwitchTimeoutModes) {
     tla->shutdown();
 }
 
+/* check that messages read ahead of the one being sourced are neither lost nor waited on */
+class PipelinedMessagesSEP : public TimeoutSEP {
+public:
+    explicit PipelinedMessagesSEP(size_t numMessages) : _numMessages(numMessages) {}
+
+    void startSession(transport::SessionHandle session) override {
+        LOGV2(5400100, "Accepted connection", "remote"_attr = session->remote());
+        startWorkerThread([this, session = std::move(session)]() mutable {
+            for (size_t i = 0; i < _numMessages; ++i) {
+                ASSERT_OK(session->waitForData());
+                auto swMessage = session->sourceMessage();
+                ASSERT_OK(swMessage.getStatus());
+                ASSERT_EQ(swMessage.getValue().header().getId(), static_cast<int32_t>(i));
+                ASSERT_TRUE(OpMsg::parse(swMessage.getValue()).body.hasField("ping"));
+            }
+
+            session.reset();
+            notifyComplete();
+        });
+    }
+
+private:
+    const size_t _numMessages;
+};
+
+TEST(TransportLayerASIO, SourcePipelinedMessages) {
+    PipelinedMessagesSEP sep(10);
+    auto tla = makeAndStartTL(&sep);
+
+    TimeoutConnector connector(tla->listenerPort(), false);
+    connector.sendPipelinedMessages(10);
+
+    ASSERT_TRUE(sep.waitForTimeout(Milliseconds{30000}));
+    tla->shutdown();
+}
+
 }  // namespace
 }  // namespace mongo
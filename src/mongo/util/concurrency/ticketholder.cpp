@@ -33,13 +33,28 @@
 
 #include "mongo/util/concurrency/ticketholder.h"
 
-#include <iostream>
+#include <algorithm>
 
 #include "mongo/logv2/log.h"
+#include "mongo/platform/bits.h"
+#include "mongo/util/scopeguard.h"
 #include "mongo/util/str.h"
+#include "mongo/util/timer.h"
 
 namespace mongo {
 
+StringData toString(AdmissionPriority priority) {
+    switch (priority) {
+        case AdmissionPriority::kInternal:
+            return "internal"_sd;
+        case AdmissionPriority::kInteractive:
+            return "interactive"_sd;
+        case AdmissionPriority::kBatch:
+            return "batch"_sd;
+    }
+    MONGO_UNREACHABLE;
+}
+
 #if defined(__linux__)
 namespace {
 
@@ -71,15 +86,15 @@ void tsFromDate(const Date_t& deadline, struct timespec& ts) {
 }
 }  // namespace
 
-TicketHolder::TicketHolder(int num) : _outof(num) {
+SemaphoreTicketHolder::SemaphoreTicketHolder(int num) : _outof(num) {
     check(sem_init(&_sem, 0, num));
 }
 
-TicketHolder::~TicketHolder() {
+SemaphoreTicketHolder::~SemaphoreTicketHolder() {
     check(sem_destroy(&_sem));
 }
 
-bool TicketHolder::tryAcquire() {
+bool SemaphoreTicketHolder::_tryAcquire(AdmissionPriority) {
     while (0 != sem_trywait(&_sem)) {
         if (errno == EAGAIN)
             return false;
@@ -89,11 +104,9 @@ bool TicketHolder::tryAcquire() {
     return true;
 }
 
-void TicketHolder::waitForTicket(OperationContext* opCtx) {
-    waitForTicketUntil(opCtx, Date_t::max());
-}
-
-bool TicketHolder::waitForTicketUntil(OperationContext* opCtx, Date_t until) {
+bool SemaphoreTicketHolder::_waitForTicketUntil(OperationContext* opCtx,
+                                                Date_t until,
+                                                AdmissionPriority) {
     // Attempt to get a ticket without waiting in order to avoid expensive time calculations.
     if (sem_trywait(&_sem) == 0) {
         return true;
@@ -129,11 +142,24 @@ bool TicketHolder::waitForTicketUntil(OperationContext* opCtx, Date_t until) {
     return true;
 }
 
-void TicketHolder::release() {
+void SemaphoreTicketHolder::_release(AdmissionPriority) {
+    if (_takeBackPending()) {
+        return;
+    }
     check(sem_post(&_sem));
 }
 
-Status TicketHolder::resize(int newSize) {
+bool SemaphoreTicketHolder::_takeBackPending() {
+    int pending = _pendingShrink.load();
+    while (pending > 0) {
+        if (_pendingShrink.compareAndSwap(&pending, pending - 1)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+Status SemaphoreTicketHolder::resize(int newSize) {
     stdx::lock_guard<Latch> lk(_resizeMutex);
 
     if (newSize < 5)
@@ -145,68 +171,82 @@ Status TicketHolder::resize(int newSize) {
                       str::stream() << "Maximum value for semaphore is " << SEM_VALUE_MAX
                                     << "; given " << newSize);
 
-    while (_outof.load() < newSize) {
-        release();
-        _outof.fetchAndAdd(1);
-    }
+    const int delta = newSize - _outof.load();
+    _outof.store(newSize);
 
-    while (_outof.load() > newSize) {
-        waitForTicket();
-        _outof.subtractAndFetch(1);
+    if (delta > 0) {
+        // Tickets still owed by an earlier shrink are forgiven before new ones are handed out.
+        for (int i = 0; i < delta; ++i) {
+            if (!_takeBackPending()) {
+                check(sem_post(&_sem));
+            }
+        }
+        return Status::OK();
     }
 
-    invariant(_outof.load() == newSize);
+    // Shrinking must not wait for the tickets in use to be returned. Take away the ones nobody
+    // holds, and let _release() keep back the rest.
+    _pendingShrink.fetchAndAdd(-delta);
+    while (_pendingShrink.load() > 0 && sem_trywait(&_sem) == 0) {
+        if (!_takeBackPending()) {
+            // A release settled the debt in the meantime.
+            check(sem_post(&_sem));
+            break;
+        }
+    }
     return Status::OK();
 }
 
-int TicketHolder::available() const {
+int SemaphoreTicketHolder::available() const {
     int val = 0;
     check(sem_getvalue(&_sem, &val));
     return val;
 }
 
-int TicketHolder::used() const {
-    return outof() - available();
+int SemaphoreTicketHolder::used() const {
+    return outof() + _pendingShrink.load() - available();
 }
 
-int TicketHolder::outof() const {
+int SemaphoreTicketHolder::outof() const {
     return _outof.load();
 }
 
 #else
 
-TicketHolder::TicketHolder(int num) : _outof(num), _num(num) {}
+SemaphoreTicketHolder::SemaphoreTicketHolder(int num) : _outof(num), _num(num) {}
 
-TicketHolder::~TicketHolder() = default;
+SemaphoreTicketHolder::~SemaphoreTicketHolder() = default;
 
-bool TicketHolder::tryAcquire() {
+bool SemaphoreTicketHolder::_tryAcquire(AdmissionPriority) {
     stdx::lock_guard<Latch> lk(_mutex);
-    return _tryAcquire();
+    return _tryAcquireInLock();
 }
 
-void TicketHolder::waitForTicket(OperationContext* opCtx) {
+bool SemaphoreTicketHolder::_waitForTicketUntil(OperationContext* opCtx,
+                                                Date_t until,
+                                                AdmissionPriority) {
     stdx::unique_lock<Latch> lk(_mutex);
 
-    if (opCtx) {
-        opCtx->waitForConditionOrInterrupt(_newTicket, lk, [this] { return _tryAcquire(); });
-    } else {
-        _newTicket.wait(lk, [this] { return _tryAcquire(); });
+    if (until == Date_t::max()) {
+        if (opCtx) {
+            opCtx->waitForConditionOrInterrupt(
+                _newTicket, lk, [this] { return _tryAcquireInLock(); });
+        } else {
+            _newTicket.wait(lk, [this] { return _tryAcquireInLock(); });
+        }
+        return true;
     }
-}
-
-bool TicketHolder::waitForTicketUntil(OperationContext* opCtx, Date_t until) {
-    stdx::unique_lock<Latch> lk(_mutex);
 
     if (opCtx) {
         return opCtx->waitForConditionOrInterruptUntil(
-            _newTicket, lk, until, [this] { return _tryAcquire(); });
+            _newTicket, lk, until, [this] { return _tryAcquireInLock(); });
     } else {
         return _newTicket.wait_until(
-            lk, until.toSystemTimePoint(), [this] { return _tryAcquire(); });
+            lk, until.toSystemTimePoint(), [this] { return _tryAcquireInLock(); });
     }
 }
 
-void TicketHolder::release() {
+void SemaphoreTicketHolder::_release(AdmissionPriority) {
     {
         stdx::lock_guard<Latch> lk(_mutex);
         _num++;
@@ -214,49 +254,292 @@ void TicketHolder::release() {
     _newTicket.notify_one();
 }
 
-Status TicketHolder::resize(int newSize) {
+Status SemaphoreTicketHolder::resize(int newSize) {
     stdx::lock_guard<Latch> lk(_mutex);
 
+    // Shrinking below the number of tickets in use leaves '_num' negative. The excess tickets
+    // disappear as they are released.
     int used = _outof.load() - _num;
-    if (used > newSize) {
-        std::stringstream ss;
-        ss << "can't resize since we're using (" << used << ") "
-           << "more than newSize(" << newSize << ")";
-
-        std::string errmsg = ss.str();
-        LOGV2(23120, "{errmsg}", "errmsg"_attr = errmsg);
-        return Status(ErrorCodes::BadValue, errmsg);
-    }
-
     _outof.store(newSize);
-    _num = _outof.load() - used;
+    _num = newSize - used;
 
     // Potentially wasteful, but easier to see is correct
     _newTicket.notify_all();
     return Status::OK();
 }
 
-int TicketHolder::available() const {
-    return _num;
+int SemaphoreTicketHolder::available() const {
+    return std::max(0, _num);
 }
 
-int TicketHolder::used() const {
+int SemaphoreTicketHolder::used() const {
     return outof() - _num;
 }
 
-int TicketHolder::outof() const {
+int SemaphoreTicketHolder::outof() const {
     return _outof.load();
 }
 
-bool TicketHolder::_tryAcquire() {
+bool SemaphoreTicketHolder::_tryAcquireInLock() {
     if (_num <= 0) {
-        if (_num < 0) {
-            std::cerr << "DISASTER! in TicketHolder" << std::endl;
-        }
         return false;
     }
     _num--;
     return true;
 }
 #endif
+
+namespace {
+
+size_t queueTimeBucket(Microseconds queueTime) {
+    const auto micros = durationCount<Microseconds>(queueTime);
+    if (micros <= 0) {
+        return 0;
+    }
+    const size_t bucket = 64 - countLeadingZeros64(static_cast<unsigned long long>(micros));
+    return std::min(bucket, PriorityTicketHolder::kNumQueueTimeBuckets - 1);
+}
+
+long long queueTimeBucketLowerBound(size_t bucket) {
+    return bucket == 0 ? 0 : 1LL << (bucket - 1);
+}
+
+}  // namespace
+
+PriorityTicketHolder::PriorityTicketHolder(int num) : _available(num), _outof(num) {
+    stdx::lock_guard<Latch> lk(_mutex);
+    _updateBudgets(lk);
+}
+
+PriorityTicketHolder::~PriorityTicketHolder() = default;
+
+bool PriorityTicketHolder::_tryAcquire(AdmissionPriority priority) {
+    // Never overtake a queued operation of the same or a higher priority. Waiters of lower
+    // priorities, which may only be queued because their budget is used up, do not hold us back.
+    for (size_t i = 0; i <= static_cast<size_t>(priority); ++i) {
+        if (_numQueuedByPriority[i].load() > 0) {
+            return false;
+        }
+    }
+
+    if (_tryTakeTicket(priority)) {
+        _stats[static_cast<size_t>(priority)].immediate.fetchAndAddRelaxed(1);
+        return true;
+    }
+
+    // A failed attempt may have briefly held a slot of the budget and made a concurrent dispatch
+    // pass over a waiter which queued in the meantime. Make sure that waiter is looked at again.
+    if (_numQueued.load() > 0) {
+        stdx::lock_guard<Latch> lk(_mutex);
+        _dispatch(lk);
+    }
+    return false;
+}
+
+bool PriorityTicketHolder::_waitForTicketUntil(OperationContext* opCtx,
+                                               Date_t until,
+                                               AdmissionPriority priority) {
+    if (_tryAcquire(priority)) {
+        return true;
+    }
+
+    const auto i = static_cast<size_t>(priority);
+    Timer queueTimer;
+    Waiter waiter(priority);
+
+    stdx::unique_lock<Latch> lk(_mutex);
+    _queues[i].push_back(&waiter);
+    _numQueued.fetchAndAdd(1);
+    _numQueuedByPriority[i].fetchAndAdd(1);
+
+    // Tickets may have been returned between the failed attempt above and queueing up, in which
+    // case nobody else is going to dispatch them to us.
+    _dispatch(lk);
+
+    const auto removeWaiter = [&] {
+        auto& queue = _queues[i];
+        queue.erase(std::find(queue.begin(), queue.end(), &waiter));
+        _numQueued.fetchAndSubtract(1);
+        _numQueuedByPriority[i].fetchAndSubtract(1);
+    };
+
+    // If the wait is interrupted, leave the queue or give back a ticket that was handed to us
+    // while we were being interrupted.
+    auto interruptGuard = makeGuard([&] {
+        if (!waiter.granted) {
+            removeWaiter();
+            return;
+        }
+        lk.unlock();
+        _release(priority);
+    });
+
+    const auto isGranted = [&] { return waiter.granted; };
+    bool granted;
+    if (opCtx) {
+        granted = opCtx->waitForConditionOrInterruptUntil(waiter.cv, lk, until, isGranted);
+    } else if (until == Date_t::max()) {
+        waiter.cv.wait(lk, isGranted);
+        granted = true;
+    } else {
+        granted = waiter.cv.wait_until(lk, until.toSystemTimePoint(), isGranted);
+    }
+    interruptGuard.dismiss();
+
+    if (!granted) {
+        removeWaiter();
+        _stats[i].timedOut.fetchAndAdd(1);
+        return false;
+    }
+
+    lk.unlock();
+    _recordQueueTime(priority, queueTimer.elapsed());
+    return true;
+}
+
+void PriorityTicketHolder::_release(AdmissionPriority priority) {
+    // Free the budget before the ticket so that whoever picks up the ticket also sees the room.
+    _used[static_cast<size_t>(priority)].fetchAndSubtract(1);
+    _available.fetchAndAdd(1);
+
+    if (_numQueued.load() == 0) {
+        return;
+    }
+
+    stdx::lock_guard<Latch> lk(_mutex);
+    _dispatch(lk);
+}
+
+bool PriorityTicketHolder::_tryTakeTicket(AdmissionPriority priority) {
+    const auto i = static_cast<size_t>(priority);
+
+    // Reserve room within the budget first, so concurrent acquirers can not overshoot it.
+    int used = _used[i].load();
+    do {
+        if (used >= _budget[i].load()) {
+            return false;
+        }
+    } while (!_used[i].compareAndSwap(&used, used + 1));
+
+    int available = _available.load();
+    do {
+        if (available <= 0) {
+            _used[i].fetchAndSubtract(1);
+            return false;
+        }
+    } while (!_available.compareAndSwap(&available, available - 1));
+
+    return true;
+}
+
+void PriorityTicketHolder::_dispatch(WithLock) {
+    for (size_t i = 0; i < kNumAdmissionPriorities; ++i) {
+        auto& queue = _queues[i];
+        while (!queue.empty() && _tryTakeTicket(static_cast<AdmissionPriority>(i))) {
+            auto waiter = queue.front();
+            queue.pop_front();
+            _numQueued.fetchAndSubtract(1);
+            _numQueuedByPriority[i].fetchAndSubtract(1);
+
+            waiter->granted = true;
+            waiter->cv.notify_one();
+        }
+    }
+}
+
+void PriorityTicketHolder::_recordQueueTime(AdmissionPriority priority, Microseconds queueTime) {
+    auto& stats = _stats[static_cast<size_t>(priority)];
+    stats.queued.fetchAndAdd(1);
+    stats.totalQueueTimeMicros.fetchAndAdd(durationCount<Microseconds>(queueTime));
+    stats.queueTimeBuckets[queueTimeBucket(queueTime)].fetchAndAdd(1);
+}
+
+void PriorityTicketHolder::_updateBudgets(WithLock) {
+    const int outof = _outof.load();
+    for (size_t i = 0; i < kNumAdmissionPriorities; ++i) {
+        _budget[i].store(std::max(1, outof * _budgetPercent[i] / 100));
+    }
+}
+
+Status PriorityTicketHolder::resize(int newSize) {
+    if (newSize <= 0) {
+        return Status(ErrorCodes::BadValue,
+                      str::stream() << "Number of tickets must be positive; given " << newSize);
+    }
+
+    stdx::lock_guard<Latch> lk(_mutex);
+
+    // Shrinking can leave '_available' negative. The excess tickets disappear as they are
+    // released.
+    _available.fetchAndAdd(newSize - _outof.load());
+    _outof.store(newSize);
+    _updateBudgets(lk);
+    _dispatch(lk);
+    return Status::OK();
+}
+
+Status PriorityTicketHolder::setBudgetPercent(AdmissionPriority priority, int percent) {
+    if (priority == AdmissionPriority::kInternal) {
+        return Status(ErrorCodes::BadValue, "Internal operations can not be given a budget");
+    }
+    if (percent <= 0 || percent > 100) {
+        return Status(ErrorCodes::BadValue,
+                      str::stream() << "Budget must be a percentage in (0, 100]; given "
+                                    << percent);
+    }
+
+    stdx::lock_guard<Latch> lk(_mutex);
+    _budgetPercent[static_cast<size_t>(priority)] = percent;
+    _updateBudgets(lk);
+    _dispatch(lk);
+    return Status::OK();
+}
+
+int PriorityTicketHolder::available() const {
+    return std::max(0, _available.load());
+}
+
+int PriorityTicketHolder::used() const {
+    return outof() - _available.load();
+}
+
+int PriorityTicketHolder::outof() const {
+    return _outof.load();
+}
+
+int PriorityTicketHolder::usedBy(AdmissionPriority priority) const {
+    return _used[static_cast<size_t>(priority)].load();
+}
+
+int PriorityTicketHolder::queued(AdmissionPriority priority) const {
+    stdx::lock_guard<Latch> lk(_mutex);
+    return _queues[static_cast<size_t>(priority)].size();
+}
+
+void PriorityTicketHolder::appendStats(BSONObjBuilder& b) const {
+    for (size_t i = 0; i < kNumAdmissionPriorities; ++i) {
+        const auto priority = static_cast<AdmissionPriority>(i);
+        const auto& stats = _stats[i];
+
+        BSONObjBuilder pb(b.subobjStart(toString(priority)));
+        pb.append("out", usedBy(priority));
+        pb.append("queued", queued(priority));
+        pb.append("budget", _budget[i].load());
+        pb.append("acquiredImmediately", stats.immediate.load());
+        pb.append("acquiredAfterQueueing", stats.queued.load());
+        pb.append("timedOut", stats.timedOut.load());
+        pb.append("totalQueueTimeMicros", stats.totalQueueTimeMicros.load());
+
+        BSONArrayBuilder histogram(pb.subarrayStart("queueTimeHistogram"));
+        for (size_t bucket = 0; bucket < kNumQueueTimeBuckets; ++bucket) {
+            const auto count = stats.queueTimeBuckets[bucket].load();
+            if (count == 0) {
+                continue;
+            }
+            BSONObjBuilder entry(histogram.subobjStart());
+            entry.append("micros", queueTimeBucketLowerBound(bucket));
+            entry.append("count", count);
+        }
+    }
+}
 }  // namespace mongo
@@ -32,9 +32,14 @@
 #include <semaphore.h>
 #endif
 
+#include <array>
+#include <deque>
+
+#include "mongo/bson/bsonobjbuilder.h"
 #include "mongo/db/operation_context.h"
 #include "mongo/platform/mutex.h"
 #include "mongo/stdx/condition_variable.h"
+#include "mongo/util/concurrency/admission_priority.h"
 #include "mongo/util/concurrency/mutex.h"
 #include "mongo/util/hierarchical_acquisition.h"
 #include "mongo/util/time_support.h"
@@ -46,17 +51,21 @@ class TicketHolder {
     TicketHolder& operator=(const TicketHolder&) = delete;
 
 public:
-    explicit TicketHolder(int num);
-    ~TicketHolder();
+    virtual ~TicketHolder() = default;
 
-    bool tryAcquire();
+    bool tryAcquire(AdmissionPriority priority = AdmissionPriority::kInteractive) {
+        return _tryAcquire(priority);
+    }
 
     /**
      * Attempts to acquire a ticket. Blocks until a ticket is acquired or the OperationContext
      * 'opCtx' is killed, throwing an AssertionException.
      * If 'opCtx' is not provided or equal to nullptr, the wait is not interruptible.
      */
-    void waitForTicket(OperationContext* opCtx);
+    void waitForTicket(OperationContext* opCtx,
+                       AdmissionPriority priority = AdmissionPriority::kInteractive) {
+        _waitForTicketUntil(opCtx, Date_t::max(), priority);
+    }
     void waitForTicket() {
         waitForTicket(nullptr);
     }
@@ -68,38 +77,218 @@ public:
      * proceed.
      * If 'opCtx' is not provided or equal to nullptr, the wait is not interruptible.
      */
-    bool waitForTicketUntil(OperationContext* opCtx, Date_t until);
+    bool waitForTicketUntil(OperationContext* opCtx,
+                            Date_t until,
+                            AdmissionPriority priority = AdmissionPriority::kInteractive) {
+        return _waitForTicketUntil(opCtx, until, priority);
+    }
     bool waitForTicketUntil(Date_t until) {
         return waitForTicketUntil(nullptr, until);
     }
-    void release();
 
-    Status resize(int newSize);
+    /**
+     * Returns a ticket. 'priority' must be the one the ticket was acquired with.
+     */
+    void release(AdmissionPriority priority = AdmissionPriority::kInteractive) {
+        _numReleased.fetchAndAddRelaxed(1);
+        _release(priority);
+    }
+
+    /**
+     * Number of tickets returned over the lifetime of the holder, a measure of the throughput of
+     * the operations it admits.
+     */
+    long long numReleased() const {
+        return _numReleased.load();
+    }
+
+    virtual Status resize(int newSize) = 0;
+
+    virtual int available() const = 0;
+
+    virtual int used() const = 0;
+
+    virtual int outof() const = 0;
+
+    /**
+     * Appends implementation specific statistics to the 'concurrentTransactions' section of
+     * serverStatus.
+     */
+    virtual void appendStats(BSONObjBuilder& b) const {}
+
+protected:
+    TicketHolder() = default;
 
-    int available() const;
+private:
+    virtual bool _tryAcquire(AdmissionPriority priority) = 0;
+
+    virtual bool _waitForTicketUntil(OperationContext* opCtx,
+                                     Date_t until,
+                                     AdmissionPriority priority) = 0;
+
+    virtual void _release(AdmissionPriority priority) = 0;
+
+    AtomicWord<long long> _numReleased{0};
+};
+
+/**
+ * A counting semaphore. Waiters are woken in no particular order and all priorities are treated
+ * the same.
+ *
+ * Shrinking never blocks. Tickets nobody holds are taken away right away, and the rest are kept
+ * back as their holders return them.
+ */
+class SemaphoreTicketHolder final : public TicketHolder {
+public:
+    explicit SemaphoreTicketHolder(int num);
+    ~SemaphoreTicketHolder() override;
 
-    int used() const;
+    Status resize(int newSize) override;
 
-    int outof() const;
+    int available() const override;
+
+    int used() const override;
+
+    int outof() const override;
 
 private:
+    bool _tryAcquire(AdmissionPriority) override;
+
+    bool _waitForTicketUntil(OperationContext* opCtx,
+                             Date_t until,
+                             AdmissionPriority) override;
+
+    void _release(AdmissionPriority) override;
+
 #if defined(__linux__)
     mutable sem_t _sem;
 
+    // Takes back one ticket owed by a shrinking resize, if any. Returns whether it did.
+    bool _takeBackPending();
+
     // You can read _outof without a lock, but have to hold _resizeMutex to change.
     AtomicWord<int> _outof;
+
+    // Tickets a shrinking resize still has to take back. Returned tickets go towards this count
+    // instead of back into the semaphore.
+    AtomicWord<int> _pendingShrink{0};
     Mutex _resizeMutex =
-        MONGO_MAKE_LATCH(HierarchicalAcquisitionLevel(0), "TicketHolder::_resizeMutex");
+        MONGO_MAKE_LATCH(HierarchicalAcquisitionLevel(0), "SemaphoreTicketHolder::_resizeMutex");
 #else
-    bool _tryAcquire();
+    bool _tryAcquireInLock();
 
     AtomicWord<int> _outof;
+
+    // Tickets not held by anyone. Goes negative while a shrinking resize waits for holders to
+    // return their tickets.
     int _num;
-    Mutex _mutex = MONGO_MAKE_LATCH(HierarchicalAcquisitionLevel(0), "TicketHolder::_mutex");
+    Mutex _mutex =
+        MONGO_MAKE_LATCH(HierarchicalAcquisitionLevel(0), "SemaphoreTicketHolder::_mutex");
     stdx::condition_variable _newTicket;
 #endif
 };
 
+/**
+ * Admits operations in priority order, and in FIFO order within a priority.
+ *
+ * While nobody is queued a ticket is taken with a compare-and-swap on the available count. Once
+ * tickets run out, waiters queue up per priority and each released ticket is handed directly to
+ * the oldest waiter of the highest priority that is still within its budget, so a late arrival
+ * can never overtake a queued operation of the same or higher priority. A late arrival of a
+ * higher priority does not wait behind queued operations of lower priorities.
+ *
+ * Each priority has a budget: the percentage of the total tickets that operations of that
+ * priority may hold at once. Keeping the batch budget below 100 leaves tickets for interactive
+ * and internal work even when batch work alone could saturate the holder.
+ */
+class PriorityTicketHolder final : public TicketHolder {
+public:
+    // Buckets are powers of two microseconds, the last one being open ended.
+    static constexpr size_t kNumQueueTimeBuckets = 32;
+
+    explicit PriorityTicketHolder(int num);
+    ~PriorityTicketHolder() override;
+
+    Status resize(int newSize) override;
+
+    int available() const override;
+
+    int used() const override;
+
+    int outof() const override;
+
+    /**
+     * Sets the percentage, in (0, 100], of the tickets that operations of 'priority' may hold
+     * concurrently. Internal operations are never limited.
+     */
+    Status setBudgetPercent(AdmissionPriority priority, int percent);
+
+    int usedBy(AdmissionPriority priority) const;
+
+    int queued(AdmissionPriority priority) const;
+
+    void appendStats(BSONObjBuilder& b) const override;
+
+private:
+    struct Waiter {
+        explicit Waiter(AdmissionPriority priority) : priority(priority) {}
+
+        const AdmissionPriority priority;
+        bool granted = false;
+        stdx::condition_variable cv;
+    };
+
+    struct PriorityStats {
+        AtomicWord<long long> immediate{0};
+        AtomicWord<long long> queued{0};
+        AtomicWord<long long> timedOut{0};
+        AtomicWord<long long> totalQueueTimeMicros{0};
+        std::array<AtomicWord<long long>, kNumQueueTimeBuckets> queueTimeBuckets{};
+    };
+
+    bool _tryAcquire(AdmissionPriority priority) override;
+
+    bool _waitForTicketUntil(OperationContext* opCtx,
+                             Date_t until,
+                             AdmissionPriority priority) override;
+
+    void _release(AdmissionPriority priority) override;
+
+    /**
+     * Takes a ticket for 'priority' if one is available and the priority is within its budget.
+     * Does not look at the queues.
+     */
+    bool _tryTakeTicket(AdmissionPriority priority);
+
+    /**
+     * Hands available tickets to queued waiters in priority order.
+     */
+    void _dispatch(WithLock);
+
+    void _recordQueueTime(AdmissionPriority priority, Microseconds queueTime);
+
+    void _updateBudgets(WithLock);
+
+    // Tickets not held by anyone. Goes negative while a shrinking resize waits for holders to
+    // return their tickets.
+    AtomicWord<int> _available;
+    AtomicWord<int> _outof;
+
+    // Number of waiters across all queues, and in each of them. Acquisition only takes the
+    // lock-free path while no waiter of the same or a higher priority is queued.
+    AtomicWord<int> _numQueued{0};
+    std::array<AtomicWord<int>, kNumAdmissionPriorities> _numQueuedByPriority{};
+
+    std::array<AtomicWord<int>, kNumAdmissionPriorities> _used{};
+    std::array<AtomicWord<int>, kNumAdmissionPriorities> _budget{};
+    std::array<int, kNumAdmissionPriorities> _budgetPercent{{100, 100, 100}};
+    std::array<PriorityStats, kNumAdmissionPriorities> _stats;
+
+    mutable Mutex _mutex =
+        MONGO_MAKE_LATCH(HierarchicalAcquisitionLevel(0), "PriorityTicketHolder::_mutex");
+    std::array<std::deque<Waiter*>, kNumAdmissionPriorities> _queues;
+};
+
 class ScopedTicket {
 public:
     ScopedTicket(TicketHolder* holder) : _holder(holder) {
@@ -32,6 +32,8 @@
 
 #include "mongo/platform/basic.h"
 
+#include "mongo/bson/bsonobj.h"
+#include "mongo/stdx/thread.h"
 #include "mongo/unittest/unittest.h"
 #include "mongo/util/concurrency/ticketholder.h"
 
@@ -39,7 +41,7 @@ namespace {
 using namespace mongo;
 
 TEST(TicketholderTest, BasicTimeout) {
-    TicketHolder holder(1);
+    SemaphoreTicketHolder holder(1);
     ASSERT_EQ(holder.used(), 0);
     ASSERT_EQ(holder.available(), 1);
     ASSERT_EQ(holder.outof(), 1);
@@ -72,4 +74,220 @@ TEST(TicketholderTest, BasicTimeout) {
     holder.release();
     ASSERT_EQ(holder.used(), 0);
 }
+
+TEST(TicketholderTest, ShrinkingDoesNotWaitForTicketsInUse) {
+    SemaphoreTicketHolder holder(10);
+    for (int i = 0; i < 8; ++i) {
+        ASSERT(holder.tryAcquire());
+    }
+
+    // The two free tickets are taken away right away, the other two as they are returned.
+    ASSERT_OK(holder.resize(6));
+    ASSERT_EQ(holder.outof(), 6);
+    ASSERT_EQ(holder.used(), 8);
+    ASSERT_EQ(holder.available(), 0);
+    ASSERT_FALSE(holder.tryAcquire());
+
+    holder.release();
+    holder.release();
+    ASSERT_EQ(holder.used(), 6);
+    ASSERT_EQ(holder.available(), 0);
+    holder.release();
+    ASSERT_EQ(holder.used(), 5);
+    ASSERT_EQ(holder.available(), 1);
+
+    // Tickets still owed by a shrink are forgiven before a grow hands out new ones.
+    for (int i = 0; i < 5; ++i) {
+        holder.release();
+    }
+    for (int i = 0; i < 6; ++i) {
+        ASSERT(holder.tryAcquire());
+    }
+    ASSERT_OK(holder.resize(5));
+    ASSERT_EQ(holder.used(), 6);
+    ASSERT_OK(holder.resize(8));
+    ASSERT_EQ(holder.used(), 6);
+    ASSERT_EQ(holder.available(), 2);
+    for (int i = 0; i < 6; ++i) {
+        holder.release();
+    }
+    ASSERT_EQ(holder.used(), 0);
+    ASSERT_EQ(holder.available(), 8);
+}
+
+/**
+ * Blocks until 'num' operations of 'priority' are queued on 'holder'.
+ */
+void waitForQueued(const PriorityTicketHolder& holder, AdmissionPriority priority, int num) {
+    while (holder.queued(priority) != num) {
+        sleepmillis(1);
+    }
+}
+
+TEST(PriorityTicketholderTest, BasicTimeout) {
+    PriorityTicketHolder holder(1);
+    ASSERT_EQ(holder.used(), 0);
+    ASSERT_EQ(holder.available(), 1);
+    ASSERT_EQ(holder.outof(), 1);
+
+    ASSERT(holder.tryAcquire());
+    ASSERT_EQ(holder.used(), 1);
+    ASSERT_EQ(holder.available(), 0);
+    ASSERT_FALSE(holder.tryAcquire());
+    ASSERT_FALSE(holder.waitForTicketUntil(Date_t::now() + Milliseconds(5)));
+    ASSERT_EQ(holder.queued(AdmissionPriority::kInteractive), 0);
+
+    holder.release();
+    ASSERT_EQ(holder.used(), 0);
+    ASSERT(holder.waitForTicketUntil(Date_t::now()));
+    holder.release();
+
+    BSONObjBuilder b;
+    holder.appendStats(b);
+    auto stats = b.obj();
+    ASSERT_EQ(stats["interactive"]["acquiredImmediately"].numberLong(), 2);
+    ASSERT_EQ(stats["interactive"]["timedOut"].numberLong(), 1);
+}
+
+TEST(PriorityTicketholderTest, BudgetLimitsPriority) {
+    PriorityTicketHolder holder(4);
+    ASSERT_OK(holder.setBudgetPercent(AdmissionPriority::kBatch, 50));
+    ASSERT_NOT_OK(holder.setBudgetPercent(AdmissionPriority::kInternal, 50));
+    ASSERT_NOT_OK(holder.setBudgetPercent(AdmissionPriority::kBatch, 0));
+
+    ASSERT(holder.tryAcquire(AdmissionPriority::kBatch));
+    ASSERT(holder.tryAcquire(AdmissionPriority::kBatch));
+    ASSERT_FALSE(holder.tryAcquire(AdmissionPriority::kBatch));
+    ASSERT_EQ(holder.usedBy(AdmissionPriority::kBatch), 2);
+
+    // The rest of the tickets remain available to other priorities.
+    ASSERT(holder.tryAcquire(AdmissionPriority::kInteractive));
+    ASSERT(holder.tryAcquire(AdmissionPriority::kInternal));
+    ASSERT_EQ(holder.available(), 0);
+
+    holder.release(AdmissionPriority::kInternal);
+    holder.release(AdmissionPriority::kInteractive);
+    holder.release(AdmissionPriority::kBatch);
+    holder.release(AdmissionPriority::kBatch);
+    ASSERT_EQ(holder.used(), 0);
+}
+
+TEST(PriorityTicketholderTest, ReleaseWakesHighestPriorityFirst) {
+    PriorityTicketHolder holder(1);
+    holder.waitForTicket(nullptr, AdmissionPriority::kInteractive);
+
+    std::vector<AdmissionPriority> admitted;
+    Mutex mutex = MONGO_MAKE_LATCH();
+    auto waitAndRecord = [&](AdmissionPriority priority) {
+        return stdx::thread([&, priority] {
+            holder.waitForTicket(nullptr, priority);
+            {
+                stdx::lock_guard<Latch> lk(mutex);
+                admitted.push_back(priority);
+            }
+            holder.release(priority);
+        });
+    };
+
+    auto batch = waitAndRecord(AdmissionPriority::kBatch);
+    waitForQueued(holder, AdmissionPriority::kBatch, 1);
+    auto interactive = waitAndRecord(AdmissionPriority::kInteractive);
+    waitForQueued(holder, AdmissionPriority::kInteractive, 1);
+    auto internal = waitAndRecord(AdmissionPriority::kInternal);
+    waitForQueued(holder, AdmissionPriority::kInternal, 1);
+
+    holder.release(AdmissionPriority::kInteractive);
+    batch.join();
+    interactive.join();
+    internal.join();
+
+    ASSERT_EQ(admitted.size(), 3U);
+    ASSERT(admitted[0] == AdmissionPriority::kInternal);
+    ASSERT(admitted[1] == AdmissionPriority::kInteractive);
+    ASSERT(admitted[2] == AdmissionPriority::kBatch);
+    ASSERT_EQ(holder.used(), 0);
+}
+
+TEST(PriorityTicketholderTest, WaitersOfSamePriorityAreAdmittedInArrivalOrder) {
+    PriorityTicketHolder holder(1);
+    holder.waitForTicket();
+
+    std::vector<int> admitted;
+    Mutex mutex = MONGO_MAKE_LATCH();
+    std::vector<stdx::thread> threads;
+    for (int i = 0; i < 4; ++i) {
+        threads.emplace_back([&, i] {
+            holder.waitForTicket();
+            {
+                stdx::lock_guard<Latch> lk(mutex);
+                admitted.push_back(i);
+            }
+            holder.release();
+        });
+        waitForQueued(holder, AdmissionPriority::kInteractive, i + 1);
+    }
+
+    // A newcomer must not overtake the queue even though it never blocks.
+    ASSERT_FALSE(holder.tryAcquire());
+
+    holder.release();
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    ASSERT(admitted == std::vector<int>({0, 1, 2, 3}));
+
+    BSONObjBuilder b;
+    holder.appendStats(b);
+    auto stats = b.obj()["interactive"].Obj();
+    ASSERT_EQ(stats["acquiredAfterQueueing"].numberLong(), 4);
+    long long histogramCount = 0;
+    for (auto&& bucket : stats["queueTimeHistogram"].Array()) {
+        histogramCount += bucket["count"].numberLong();
+    }
+    ASSERT_EQ(histogramCount, 4);
+}
+
+TEST(PriorityTicketholderTest, QueuedLowerPriorityDoesNotHoldBackHigherPriority) {
+    PriorityTicketHolder holder(4);
+    ASSERT_OK(holder.setBudgetPercent(AdmissionPriority::kBatch, 25));
+    ASSERT(holder.tryAcquire(AdmissionPriority::kBatch));
+
+    // The batch budget is used up, so another batch operation queues although tickets are left.
+    stdx::thread batch([&] {
+        holder.waitForTicket(nullptr, AdmissionPriority::kBatch);
+        holder.release(AdmissionPriority::kBatch);
+    });
+    waitForQueued(holder, AdmissionPriority::kBatch, 1);
+
+    // Interactive operations still get the tickets which the batch waiter can not use.
+    ASSERT(holder.tryAcquire(AdmissionPriority::kInteractive));
+    ASSERT(holder.waitForTicketUntil(nullptr, Date_t::now(), AdmissionPriority::kInteractive));
+    holder.release(AdmissionPriority::kInteractive);
+    holder.release(AdmissionPriority::kInteractive);
+
+    holder.release(AdmissionPriority::kBatch);
+    batch.join();
+    ASSERT_EQ(holder.used(), 0);
+}
+
+TEST(PriorityTicketholderTest, ResizeHandsOutNewTickets) {
+    PriorityTicketHolder holder(1);
+    holder.waitForTicket();
+
+    stdx::thread waiter([&] {
+        holder.waitForTicket();
+        holder.release();
+    });
+    waitForQueued(holder, AdmissionPriority::kInteractive, 1);
+    ASSERT_OK(holder.resize(2));
+    waiter.join();
+
+    // Shrinking below the number of tickets in use takes effect as tickets are released.
+    ASSERT_OK(holder.resize(1));
+    ASSERT_EQ(holder.available(), 0);
+    ASSERT_FALSE(holder.tryAcquire());
+    holder.release();
+    ASSERT_EQ(holder.available(), 1);
+    ASSERT_NOT_OK(holder.resize(0));
+}
 }  // namespace
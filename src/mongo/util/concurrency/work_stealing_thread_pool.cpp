@@ -0,0 +1,419 @@
+/**
+ *    Copyright (C) 2021-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#define MONGO_LOGV2_DEFAULT_COMPONENT ::mongo::logv2::LogComponent::kDefault
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/util/concurrency/work_stealing_thread_pool.h"
+
+#include <algorithm>
+#include <fmt/format.h>
+
+#include "mongo/base/status.h"
+#include "mongo/logv2/log.h"
+#include "mongo/util/assert_util.h"
+#include "mongo/util/concurrency/idle_thread_block.h"
+#include "mongo/util/concurrency/thread_name.h"
+
+namespace mongo {
+namespace {
+
+using namespace fmt::literals;
+
+// The pool and worker id of the calling thread, if it is a worker of some WorkStealingThreadPool.
+struct CurrentWorker {
+    const WorkStealingThreadPool* pool = nullptr;
+    size_t id = 0;
+};
+thread_local CurrentWorker currentWorker;
+
+WorkStealingThreadPool::Options cleanUpOptions(WorkStealingThreadPool::Options&& options) {
+    if (options.threadNamePrefix.empty()) {
+        options.threadNamePrefix = "{}-"_format(options.poolName);
+    }
+    if (options.maxThreads < 1) {
+        LOGV2_FATAL(5400200,
+                    "Cannot create pool with maximum number of threads less than 1",
+                    "poolName"_attr = options.poolName,
+                    "maxThreads"_attr = options.maxThreads);
+    }
+    if (options.minThreads > options.maxThreads) {
+        LOGV2_FATAL(5400201,
+                    "Cannot create pool with minimum number of threads larger than the "
+                    "configured maximum",
+                    "poolName"_attr = options.poolName,
+                    "minThreads"_attr = options.minThreads,
+                    "maxThreads"_attr = options.maxThreads);
+    }
+    return {std::move(options)};
+}
+
+}  // namespace
+
+WorkStealingThreadPool::WorkStealingThreadPool(Options options)
+    : _options(cleanUpOptions(std::move(options))), _workers(_options.maxThreads) {
+    // Tasks scheduled before startup() are queued on the first worker.
+    _workers[0] = std::make_unique<Worker>();
+}
+
+WorkStealingThreadPool::~WorkStealingThreadPool() {
+    stdx::unique_lock<Latch> lk(_mutex);
+    _shutdown(lk);
+    if (_state != shutdownComplete) {
+        _join(lk);
+    }
+
+    invariant(_numPendingTasks.load() == 0);
+}
+
+void WorkStealingThreadPool::startup() {
+    stdx::lock_guard<Latch> lk(_mutex);
+    if (_state != preStart) {
+        LOGV2_FATAL(5400202,
+                    "Attempted to start pool that has already started",
+                    "poolName"_attr = _options.poolName);
+    }
+    _state = running;
+    _stateChange.notify_all();
+
+    const auto numToStart =
+        std::clamp(_numPendingTasks.load(), _options.minThreads, _options.maxThreads);
+    for (size_t i = 0; i < numToStart; ++i) {
+        _startWorker(lk, i);
+    }
+}
+
+void WorkStealingThreadPool::shutdown() {
+    stdx::lock_guard<Latch> lk(_mutex);
+    _shutdown(lk);
+}
+
+void WorkStealingThreadPool::_shutdown(WithLock) {
+    if (_state != preStart && _state != running) {
+        return;
+    }
+
+    _state = joinRequired;
+    _acceptingTasks.store(false);
+    _stateChange.notify_all();
+
+    // Wake every worker so that it can finish the remaining tasks and exit.
+    for (auto workerId : _sleepingWorkers) {
+        auto& worker = *_workers[workerId];
+        worker.sleeping = false;
+        worker.wakeUp.notify_one();
+    }
+    _sleepingWorkers.clear();
+}
+
+void WorkStealingThreadPool::join() {
+    stdx::unique_lock<Latch> lk(_mutex);
+    _join(lk);
+}
+
+void WorkStealingThreadPool::_join(stdx::unique_lock<Latch>& lk) {
+    _stateChange.wait(lk, [this] { return _state != preStart && _state != running; });
+    if (_state != joinRequired) {
+        LOGV2_FATAL(5400203,
+                    "Attempted to join pool more than once",
+                    "poolName"_attr = _options.poolName);
+    }
+    _state = joining;
+
+    std::vector<stdx::thread> threadsToJoin;
+    for (size_t i = 0; i < _numWorkers.load(); ++i) {
+        if (_workers[i]->thread.joinable()) {
+            threadsToJoin.push_back(std::move(_workers[i]->thread));
+        }
+    }
+    lk.unlock();
+    for (auto& thread : threadsToJoin) {
+        thread.join();
+    }
+
+    // If the pool was never started, or every worker had retired, nobody ran the tasks left in the
+    // queues.
+    if (_numPendingTasks.load() > 0) {
+        _drainPendingTasks();
+    }
+    lk.lock();
+
+    invariant(_state == joining);
+    _state = shutdownComplete;
+    _stateChange.notify_all();
+}
+
+void WorkStealingThreadPool::_drainPendingTasks() {
+    // Tasks cannot be run inline because they can create OperationContexts and the join() caller
+    // may already have one associated with the thread.
+    stdx::thread cleanThread = stdx::thread([&] {
+        const std::string threadName = "{}{}"_format(_options.threadNamePrefix, 0);
+        setThreadName(threadName);
+        currentWorker = {this, 0};
+        if (_options.onCreateThread)
+            _options.onCreateThread(threadName);
+        while (auto task = _pop(0)) {
+            (*task)(Status::OK());
+        }
+    });
+    cleanThread.join();
+}
+
+void WorkStealingThreadPool::schedule(Task task) {
+    if (currentWorker.pool == this) {
+        _push(currentWorker.id, std::move(task));
+        return;
+    }
+
+    const auto numWorkers = std::max<size_t>(_numWorkers.load(), 1);
+    _push(_nextWorkerId.fetchAndAdd(1) % numWorkers, std::move(task));
+}
+
+void WorkStealingThreadPool::scheduleOnWorker(size_t workerId, Task task) {
+    invariant(workerId < std::max<size_t>(_numWorkers.load(), 1));
+    _push(workerId, std::move(task));
+}
+
+boost::optional<size_t> WorkStealingThreadPool::getCurrentWorkerId() const {
+    if (currentWorker.pool != this) {
+        return boost::none;
+    }
+    return currentWorker.id;
+}
+
+WorkStealingThreadPool::Stats WorkStealingThreadPool::getStats() const {
+    Stats stats;
+    stats.numThreads = _numRunningWorkers.load();
+    stats.numIdleThreads = _numIdleThreads.load();
+    stats.numPendingTasks = _numPendingTasks.load();
+    stats.numStolenTasks = _numStolenTasks.load();
+    return stats;
+}
+
+void WorkStealingThreadPool::_push(size_t workerId, Task task) {
+    _numPendingTasks.fetchAndAdd(1);
+    if (!_acceptingTasks.load()) {
+        _numPendingTasks.fetchAndSubtract(1);
+        task(Status(ErrorCodes::ShutdownInProgress,
+                    "Shutdown of thread pool {} in progress"_format(_options.poolName)));
+        return;
+    }
+
+    {
+        auto& worker = *_workers[workerId];
+        stdx::lock_guard<Latch> lk(worker.mutex);
+        worker.tasks.push_back(std::move(task));
+    }
+
+    _wakeOrStartWorker(workerId);
+}
+
+boost::optional<OutOfLineExecutor::Task> WorkStealingThreadPool::_pop(size_t workerId) {
+    {
+        auto& worker = *_workers[workerId];
+        stdx::lock_guard<Latch> lk(worker.mutex);
+        if (!worker.tasks.empty()) {
+            auto task = std::move(worker.tasks.front());
+            worker.tasks.pop_front();
+            _numPendingTasks.fetchAndSubtract(1);
+            return std::move(task);
+        }
+    }
+
+    // Steal the oldest task of another worker, so that the tasks queued on a worker which stays
+    // busy, or has retired, still run in the order in which they were queued.
+    const auto numWorkers = std::max<size_t>(_numWorkers.load(), 1);
+    for (size_t i = 1; i < numWorkers; ++i) {
+        auto& victim = *_workers[(workerId + i) % numWorkers];
+        stdx::lock_guard<Latch> lk(victim.mutex);
+        if (!victim.tasks.empty()) {
+            auto task = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+            _numPendingTasks.fetchAndSubtract(1);
+            _numStolenTasks.fetchAndAdd(1);
+            return std::move(task);
+        }
+    }
+
+    return boost::none;
+}
+
+void WorkStealingThreadPool::_wakeOrStartWorker(size_t workerId) {
+    // A worker increments '_numIdleThreads' before it checks '_numPendingTasks' and goes to sleep,
+    // and _push() increments '_numPendingTasks' before we get here, so either the worker sees the
+    // new task or we see the idle worker.
+    if (_numIdleThreads.load() == 0 && _numRunningWorkers.load() == _options.maxThreads) {
+        return;
+    }
+
+    stdx::lock_guard<Latch> lk(_mutex);
+    if (_wakeWorker(lk, workerId)) {
+        return;
+    }
+
+    if (_numIdleThreads.load() < _numPendingTasks.load()) {
+        _startWorker(lk, workerId);
+    }
+}
+
+bool WorkStealingThreadPool::_wakeWorker(WithLock, size_t workerId) {
+    auto wake = [&](size_t id) {
+        auto& worker = *_workers[id];
+        worker.sleeping = false;
+        _sleepingWorkers.erase(
+            std::find(_sleepingWorkers.begin(), _sleepingWorkers.end(), id));
+        worker.wakeUp.notify_one();
+    };
+
+    if (_workers[workerId]->sleeping) {
+        wake(workerId);
+        return true;
+    }
+
+    if (!_sleepingWorkers.empty()) {
+        // Prefer the worker which went to sleep last, since its cache is the warmest.
+        wake(_sleepingWorkers.back());
+        return true;
+    }
+
+    return false;
+}
+
+void WorkStealingThreadPool::_startWorker(WithLock, size_t preferredWorkerId) {
+    if (_state != running || _numRunningWorkers.load() == _options.maxThreads) {
+        return;
+    }
+
+    // Restart a retired worker rather than add a new one, preferably the one on which a task was
+    // just queued.
+    const auto numWorkers = _numWorkers.load();
+    auto workerId = numWorkers;
+    if (preferredWorkerId < numWorkers && !_workers[preferredWorkerId]->running) {
+        workerId = preferredWorkerId;
+    } else if (!_retiredWorkers.empty()) {
+        workerId = _retiredWorkers.back();
+    }
+    _retiredWorkers.erase(std::remove(_retiredWorkers.begin(), _retiredWorkers.end(), workerId),
+                          _retiredWorkers.end());
+
+    // The worker must exist before '_numWorkers' makes it visible to other threads.
+    if (!_workers[workerId]) {
+        _workers[workerId] = std::make_unique<Worker>();
+    }
+
+    auto& worker = *_workers[workerId];
+    if (worker.thread.joinable()) {
+        // The previous thread of the worker retired, which it did last thing under '_mutex'.
+        worker.thread.join();
+    }
+    worker.running = true;
+    _numRunningWorkers.fetchAndAdd(1);
+
+    auto threadName = "{}{}"_format(_options.threadNamePrefix, workerId);
+    worker.thread =
+        stdx::thread([this, workerId, threadName] { _workerBody(workerId, threadName); });
+    if (workerId == numWorkers) {
+        _numWorkers.store(workerId + 1);
+    }
+}
+
+bool WorkStealingThreadPool::_sleepUntilWokenOrRetired(stdx::unique_lock<Latch>& lk,
+                                                       size_t workerId) {
+    auto& self = *_workers[workerId];
+    MONGO_IDLE_THREAD_BLOCK;
+    while (!self.wakeUp.wait_for(lk, _options.maxIdleThreadAge.toSystemDuration(), [&] {
+        return !self.sleeping;
+    })) {
+        // Like ThreadPool, retire a thread which has been idle for 'maxIdleThreadAge' while there
+        // are more than 'minThreads'. The queue of the worker stays, since tasks may still be
+        // queued on it by id: other workers steal them, and queueing one may restart the worker.
+        if (_state != running || _numRunningWorkers.load() <= _options.minThreads ||
+            _numPendingTasks.load() > 0) {
+            continue;
+        }
+
+        self.sleeping = false;
+        _sleepingWorkers.erase(
+            std::find(_sleepingWorkers.begin(), _sleepingWorkers.end(), workerId));
+        self.running = false;
+        _retiredWorkers.push_back(workerId);
+        _numRunningWorkers.fetchAndSubtract(1);
+        return true;
+    }
+    return false;
+}
+
+void WorkStealingThreadPool::_workerBody(size_t workerId, const std::string& threadName) noexcept {
+    setThreadName(threadName);
+    currentWorker = {this, workerId};
+    if (_options.onCreateThread)
+        _options.onCreateThread(threadName);
+    LOGV2_DEBUG(5400204,
+                1,
+                "Starting thread",
+                "threadName"_attr = threadName,
+                "poolName"_attr = _options.poolName);
+
+    auto& self = *_workers[workerId];
+    while (true) {
+        if (auto task = _pop(workerId)) {
+            // Note that if the task throws, the task destructor will run before the exception hits
+            // the noexcept boundary.
+            (*task)(Status::OK());
+            continue;
+        }
+
+        stdx::unique_lock<Latch> lk(_mutex);
+        _numIdleThreads.fetchAndAdd(1);
+        if (_numPendingTasks.load() == 0) {
+            if (_state != running) {
+                _numIdleThreads.fetchAndSubtract(1);
+                break;
+            }
+
+            self.sleeping = true;
+            _sleepingWorkers.push_back(workerId);
+            if (_sleepUntilWokenOrRetired(lk, workerId)) {
+                _numIdleThreads.fetchAndSubtract(1);
+                break;
+            }
+        }
+        _numIdleThreads.fetchAndSubtract(1);
+    }
+
+    LOGV2_DEBUG(5400205,
+                1,
+                "Shutting down thread",
+                "threadName"_attr = threadName,
+                "poolName"_attr = _options.poolName);
+}
+
+}  // namespace mongo
@@ -0,0 +1,223 @@
+/**
+ *    Copyright (C) 2021-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#pragma once
+
+#include <boost/optional.hpp>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "mongo/platform/atomic_word.h"
+#include "mongo/platform/mutex.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/util/concurrency/thread_pool_interface.h"
+#include "mongo/util/concurrency/with_lock.h"
+#include "mongo/util/duration.h"
+
+namespace mongo {
+
+/**
+ * A thread pool in which every worker thread owns a queue of tasks, rather than all threads
+ * sharing a single queue.
+ *
+ * Tasks scheduled from one of the pool's own threads are queued on that thread, and
+ * scheduleOnWorker() queues a task on a specific thread, so that a caller can keep related work
+ * (e.g. all of the work for a client session) on the same thread. A worker runs the tasks in its
+ * own queue in FIFO order, and once that is empty it steals the oldest queued task from
+ * the queue of another worker. Tasks scheduled from other threads are spread round-robin across
+ * the workers.
+ *
+ * Like ThreadPool, the pool starts at least 'minThreads' threads at startup and starts another
+ * thread whenever there are more pending tasks than idle threads, up to 'maxThreads'. A thread
+ * which has been idle for 'maxIdleThreadAge' retires while there are more than 'minThreads'. Since
+ * queued tasks may refer to a worker by its id, the queue of a retired worker stays: its tasks are
+ * stolen by the other workers, and a task queued on it may start it again. The queue of a worker is
+ * only allocated once its thread is first started.
+ */
+class WorkStealingThreadPool final : public ThreadPoolInterface {
+public:
+    /**
+     * Structure used to configure an instance of WorkStealingThreadPool.
+     */
+    struct Options {
+        // Name of the thread pool, used for logging.
+        std::string poolName = "WorkStealingThreadPool";
+
+        // Prefix used to name threads. The id of the worker is appended to it. If this is empty,
+        // the prefix will be the pool name followed by a hyphen.
+        std::string threadNamePrefix;
+
+        // Number of threads to start when the pool is started.
+        size_t minThreads = 1;
+
+        // The pool will never grow to contain more than this many threads.
+        size_t maxThreads = 8;
+
+        // A thread which has been idle for this long retires, unless the pool would be left with
+        // fewer than 'minThreads' threads.
+        Milliseconds maxIdleThreadAge = Seconds{30};
+
+        /** If callable, called before each worker thread begins consuming tasks. */
+        std::function<void(const std::string&)> onCreateThread;
+    };
+
+    /**
+     * Structure used to return information about the thread pool via getStats().
+     */
+    struct Stats {
+        // The number of threads currently in the pool, idle or active.
+        size_t numThreads;
+
+        // The number of idle threads currently in the pool.
+        size_t numIdleThreads;
+
+        // The number of tasks waiting to be executed by the pool.
+        size_t numPendingTasks;
+
+        // The number of tasks which were executed by a thread other than the one they were queued
+        // on.
+        size_t numStolenTasks;
+    };
+
+    explicit WorkStealingThreadPool(Options options);
+
+    WorkStealingThreadPool(const WorkStealingThreadPool&) = delete;
+    WorkStealingThreadPool& operator=(const WorkStealingThreadPool&) = delete;
+
+    ~WorkStealingThreadPool() override;
+
+    // from OutOfLineExecutor (base of ThreadPoolInterface)
+    void schedule(Task task) override;
+
+    // from ThreadPoolInterface
+    void startup() override;
+    void shutdown() override;
+    void join() override;
+
+    /**
+     * Queues 'task' on the worker identified by 'workerId', which must have been returned by
+     * getCurrentWorkerId(). The task still runs on another thread if that worker stays busy while
+     * others are idle.
+     */
+    void scheduleOnWorker(size_t workerId, Task task);
+
+    /**
+     * Returns the id of the worker running the calling thread, or boost::none if the calling
+     * thread does not belong to this pool.
+     */
+    boost::optional<size_t> getCurrentWorkerId() const;
+
+    /**
+     * Returns statistics about the thread pool's utilization.
+     */
+    Stats getStats() const;
+
+private:
+    /**
+     * Lifecycle states of the pool, with the same meaning as they have for ThreadPool.
+     */
+    enum LifecycleState { preStart, running, joinRequired, joining, shutdownComplete };
+
+    struct Worker {
+        // Guards 'tasks'.
+        Mutex mutex = MONGO_MAKE_LATCH("WorkStealingThreadPool::Worker::mutex");
+        std::deque<Task> tasks;
+
+        // Guarded by the pool's '_mutex'. A sleeping worker waits on 'wakeUp' until another thread
+        // clears 'sleeping'. A worker which is not 'running' has retired, or was never started.
+        bool sleeping = false;
+        bool running = false;
+        stdx::condition_variable wakeUp;
+
+        stdx::thread thread;
+    };
+
+    void _push(size_t workerId, Task task);
+    boost::optional<Task> _pop(size_t workerId);
+    void _wakeOrStartWorker(size_t workerId);
+
+    /**
+     * Wakes 'workerId' if it is sleeping, otherwise any other sleeping worker so that it may steal
+     * the task just queued. Returns false if no worker was sleeping.
+     */
+    bool _wakeWorker(WithLock, size_t workerId);
+
+    /**
+     * Starts a thread for a retired worker, preferably 'preferredWorkerId', or else for a new one.
+     */
+    void _startWorker(WithLock, size_t preferredWorkerId);
+
+    /**
+     * Waits until the sleeping 'workerId' is woken, or retires it once it has been idle for long
+     * enough, in which case returns true and the thread must exit.
+     */
+    bool _sleepUntilWokenOrRetired(stdx::unique_lock<Latch>& lk, size_t workerId);
+
+    void _workerBody(size_t workerId, const std::string& threadName) noexcept;
+    void _shutdown(WithLock);
+    void _join(stdx::unique_lock<Latch>& lk);
+    void _drainPendingTasks();
+
+    const Options _options;
+
+    // Guards '_state', '_sleepingWorkers', the 'sleeping' flag of every worker and the starting
+    // of new threads.
+    mutable Mutex _mutex = MONGO_MAKE_LATCH("WorkStealingThreadPool::_mutex");
+    stdx::condition_variable _stateChange;
+    LifecycleState _state = preStart;
+
+    // One slot per potential thread, sized up front so that the queues can be accessed without
+    // holding '_mutex'. Only the first '_numWorkers' slots hold a worker, which is created when its
+    // thread is started, except that the first one exists from construction so that tasks
+    // scheduled before startup() can be queued on it.
+    std::vector<std::unique_ptr<Worker>> _workers;
+    AtomicWord<size_t> _numWorkers{0};
+
+    std::vector<size_t> _sleepingWorkers;
+    std::vector<size_t> _retiredWorkers;
+
+    // Cleared by shutdown(). Checked without holding '_mutex' on every call to schedule(), after
+    // '_numPendingTasks' has been incremented, so that a worker cannot exit while a task is being
+    // queued.
+    AtomicWord<bool> _acceptingTasks{true};
+
+    // The number of workers with a thread, out of the first '_numWorkers'.
+    AtomicWord<size_t> _numRunningWorkers{0};
+    AtomicWord<size_t> _numIdleThreads{0};
+    AtomicWord<size_t> _numPendingTasks{0};
+    AtomicWord<size_t> _numStolenTasks{0};
+    AtomicWord<size_t> _nextWorkerId{0};
+};
+
+}  // namespace mongo
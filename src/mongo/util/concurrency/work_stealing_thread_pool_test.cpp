@@ -0,0 +1,206 @@
+/**
+ *    Copyright (C) 2021-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/base/init.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/unittest/death_test.h"
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/concurrency/notification.h"
+#include "mongo/util/concurrency/thread_pool_test_common.h"
+#include "mongo/util/concurrency/work_stealing_thread_pool.h"
+#include "mongo/util/time_support.h"
+
+namespace {
+using namespace mongo;
+
+MONGO_INITIALIZER(WorkStealingThreadPoolCommonTests)(InitializerContext*) {
+    addTestsForThreadPool("WorkStealingThreadPoolCommon", []() {
+        return std::make_unique<WorkStealingThreadPool>(WorkStealingThreadPool::Options());
+    });
+}
+
+TEST(WorkStealingThreadPoolTest, GetCurrentWorkerIdOutsideOfPool) {
+    WorkStealingThreadPool pool(WorkStealingThreadPool::Options{});
+    pool.startup();
+    ASSERT_FALSE(pool.getCurrentWorkerId());
+}
+
+TEST(WorkStealingThreadPoolTest, ScheduleOnWorkerRunsOnThatWorker) {
+    WorkStealingThreadPool::Options options;
+    options.minThreads = 1;
+    options.maxThreads = 1;
+    WorkStealingThreadPool pool(options);
+    pool.startup();
+
+    Notification<boost::optional<size_t>> firstWorker;
+    pool.schedule([&](auto status) {
+        ASSERT_OK(status);
+        firstWorker.set(pool.getCurrentWorkerId());
+    });
+    auto workerId = firstWorker.get();
+    ASSERT(workerId);
+
+    Notification<boost::optional<size_t>> secondWorker;
+    pool.scheduleOnWorker(*workerId, [&](auto status) {
+        ASSERT_OK(status);
+        secondWorker.set(pool.getCurrentWorkerId());
+    });
+    ASSERT_EQ(*workerId, *secondWorker.get());
+}
+
+TEST(WorkStealingThreadPoolTest, IdleWorkerStealsTaskQueuedOnBusyWorker) {
+    WorkStealingThreadPool::Options options;
+    options.minThreads = 2;
+    options.maxThreads = 2;
+    WorkStealingThreadPool pool(options);
+    pool.startup();
+
+    // The first task queues a second one on its own worker and then waits for it to run, which
+    // can only happen if the other worker steals it.
+    Notification<void> stolenTaskRan;
+    Notification<void> done;
+    pool.schedule([&](auto status) {
+        ASSERT_OK(status);
+        const auto workerId = pool.getCurrentWorkerId();
+        pool.schedule([&, workerId](auto status) {
+            ASSERT_OK(status);
+            ASSERT_NE(*workerId, *pool.getCurrentWorkerId());
+            stolenTaskRan.set();
+        });
+        stolenTaskRan.get();
+        done.set();
+    });
+    done.get();
+
+    auto stats = pool.getStats();
+    ASSERT_EQ(2U, stats.numThreads);
+    ASSERT_GTE(stats.numStolenTasks, 1U);
+}
+
+TEST(WorkStealingThreadPoolTest, StartsMinThreadsAndGrowsOnDemand) {
+    WorkStealingThreadPool::Options options;
+    options.minThreads = 1;
+    options.maxThreads = 1000;
+    WorkStealingThreadPool pool(options);
+    pool.startup();
+    ASSERT_EQ(1U, pool.getStats().numThreads);
+
+    // Each task blocks its thread until all of them run, so the pool must start a thread for each.
+    constexpr size_t kNumTasks = 3;
+    AtomicWord<size_t> numRunning{0};
+    Notification<void> allRunning;
+    Notification<void> release;
+    for (size_t i = 0; i < kNumTasks; ++i) {
+        pool.schedule([&](auto status) {
+            ASSERT_OK(status);
+            if (numRunning.addAndFetch(1) == kNumTasks) {
+                allRunning.set();
+            }
+            release.get();
+        });
+    }
+    allRunning.get();
+    // A task scheduled while the first thread is still starting up may start one more thread.
+    ASSERT_GTE(pool.getStats().numThreads, kNumTasks);
+    ASSERT_LTE(pool.getStats().numThreads, kNumTasks + 1);
+
+    release.set();
+    pool.shutdown();
+    pool.join();
+}
+
+TEST(WorkStealingThreadPoolTest, RetiresIdleThreadsAndRestartsWorkerWithQueuedTask) {
+    WorkStealingThreadPool::Options options;
+    options.minThreads = 1;
+    options.maxThreads = 1000;
+    options.maxIdleThreadAge = Milliseconds{100};
+    WorkStealingThreadPool pool(options);
+    pool.startup();
+
+    constexpr size_t kNumTasks = 3;
+    AtomicWord<size_t> numRunning{0};
+    Notification<void> allRunning;
+    Notification<void> release;
+    std::vector<size_t> workerIds(kNumTasks);
+    for (size_t i = 0; i < kNumTasks; ++i) {
+        pool.schedule([&, i](auto status) {
+            ASSERT_OK(status);
+            workerIds[i] = *pool.getCurrentWorkerId();
+            if (numRunning.addAndFetch(1) == kNumTasks) {
+                allRunning.set();
+            }
+            release.get();
+        });
+    }
+    allRunning.get();
+    ASSERT_GTE(pool.getStats().numThreads, kNumTasks);
+    release.set();
+
+    // Once idle for long enough, all threads but 'minThreads' retire.
+    while (pool.getStats().numThreads > options.minThreads) {
+        sleepmillis(10);
+    }
+    ASSERT_EQ(options.minThreads, pool.getStats().numThreads);
+
+    // A task queued on a worker whose thread has retired still runs.
+    for (auto workerId : workerIds) {
+        Notification<void> ran;
+        pool.scheduleOnWorker(workerId, [&](auto status) {
+            ASSERT_OK(status);
+            ran.set();
+        });
+        ran.get();
+    }
+
+    pool.shutdown();
+    pool.join();
+}
+
+DEATH_TEST_REGEX(WorkStealingThreadPoolTest,
+                 MaxThreadsTooFewDies,
+                 "Cannot create pool.*with maximum number of threads.*less than 1") {
+    WorkStealingThreadPool::Options options;
+    options.maxThreads = 0;
+    WorkStealingThreadPool pool(options);
+}
+
+DEATH_TEST_REGEX(WorkStealingThreadPoolTest,
+                 MinThreadsTooManyDies,
+                 "Cannot create pool.*with minimum number of threads.*larger than the configured "
+                 "maximum") {
+    WorkStealingThreadPool::Options options;
+    options.minThreads = 4;
+    options.maxThreads = 2;
+    WorkStealingThreadPool pool(options);
+}
+
+}  // namespace
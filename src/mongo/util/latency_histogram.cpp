@@ -0,0 +1,99 @@
+/**
+ *    Copyright (C) 2021-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/util/latency_histogram.h"
+
+#include <algorithm>
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/platform/bits.h"
+
+namespace mongo {
+
+LatencyHistogram::LatencyHistogram(const LatencyHistogram& other) {
+    *this = other;
+}
+
+LatencyHistogram& LatencyHistogram::operator=(const LatencyHistogram& other) {
+    for (int i = 0; i < kNumBuckets; ++i) {
+        _buckets[i].store(other._buckets[i].loadRelaxed());
+    }
+    _count.store(other._count.loadRelaxed());
+    _sum.store(other._sum.loadRelaxed());
+    return *this;
+}
+
+void LatencyHistogram::record(Microseconds latency) {
+    const uint64_t micros = std::max<int64_t>(durationCount<Microseconds>(latency), 0);
+    _buckets[bucketFor(micros)].fetchAndAddRelaxed(1);
+    _count.fetchAndAddRelaxed(1);
+    _sum.fetchAndAddRelaxed(micros);
+}
+
+void LatencyHistogram::append(BSONObjBuilder* builder) const {
+    builder->append("count", static_cast<long long>(count()));
+    builder->append("sumMicros", static_cast<long long>(sum()));
+
+    BSONArrayBuilder arrayBuilder(builder->subarrayStart("buckets"));
+    for (int i = 0; i < kNumBuckets; ++i) {
+        arrayBuilder.append(static_cast<long long>(bucketCount(i)));
+    }
+    arrayBuilder.doneFast();
+}
+
+int LatencyHistogram::bucketFor(uint64_t micros) {
+    if (micros < static_cast<uint64_t>(kSubBuckets)) {
+        return static_cast<int>(micros);
+    }
+
+    const int exponent = 63 - countLeadingZeros64(micros);
+    if (exponent >= kMaxExponent) {
+        return kNumBuckets - 1;
+    }
+
+    // The kSubBucketBits bits following the leading one select the linear sub-bucket.
+    const int shift = exponent - kSubBucketBits;
+    const int subBucket = static_cast<int>(micros >> shift) & (kSubBuckets - 1);
+    return kSubBuckets + shift * kSubBuckets + subBucket;
+}
+
+uint64_t LatencyHistogram::lowerBound(int bucket) {
+    if (bucket < kSubBuckets) {
+        return static_cast<uint64_t>(bucket);
+    }
+
+    const int shift = (bucket - kSubBuckets) / kSubBuckets;
+    const uint64_t subBucket = (bucket - kSubBuckets) % kSubBuckets;
+    return (kSubBuckets + subBucket) << shift;
+}
+
+}  // namespace mongo
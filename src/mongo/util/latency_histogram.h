@@ -0,0 +1,114 @@
+/**
+ *    Copyright (C) 2021-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+#include "mongo/platform/atomic_word.h"
+#include "mongo/util/duration.h"
+
+namespace mongo {
+
+class BSONObjBuilder;
+
+/**
+ * A fixed-size, log-linear latency histogram in the style of HdrHistogram.
+ *
+ * Every power of two is split into kSubBuckets linear sub-buckets, which bounds the relative
+ * error of any bucket to 1/kSubBuckets while keeping the whole histogram to a few hundred bytes.
+ * Latencies at or above 2^kMaxExponent microseconds (~71 minutes) land in the last bucket.
+ *
+ * record() is a pair of relaxed atomic increments so that it can sit on the operation completion
+ * path; readers get a view which is consistent per counter but not across counters.
+ *
+ * The serialized form always contains every bucket so that successive samples have an identical
+ * schema, which lets FTDC delta-encode them instead of starting a new chunk.
+ */
+class LatencyHistogram {
+public:
+    static constexpr int kSubBucketBits = 2;
+    static constexpr int kSubBuckets = 1 << kSubBucketBits;
+    static constexpr int kMaxExponent = 32;
+    static constexpr int kNumBuckets = kSubBuckets + (kMaxExponent - kSubBucketBits) * kSubBuckets;
+
+    LatencyHistogram() = default;
+    LatencyHistogram(const LatencyHistogram& other);
+    LatencyHistogram& operator=(const LatencyHistogram& other);
+
+    /**
+     * Records a single operation which took 'latency'. Negative latencies count as zero.
+     */
+    void record(Microseconds latency);
+
+    /**
+     * Total number of recorded operations.
+     */
+    uint64_t count() const {
+        return _count.loadRelaxed();
+    }
+
+    /**
+     * Sum of all recorded latencies, in microseconds.
+     */
+    uint64_t sum() const {
+        return _sum.loadRelaxed();
+    }
+
+    /**
+     * Number of operations recorded in 'bucket'.
+     */
+    uint64_t bucketCount(int bucket) const {
+        return _buckets[bucket].loadRelaxed();
+    }
+
+    /**
+     * Appends { count, sumMicros, buckets: [ ... ] } to 'builder'.
+     */
+    void append(BSONObjBuilder* builder) const;
+
+    /**
+     * Returns the bucket that a latency of 'micros' is recorded in.
+     */
+    static int bucketFor(uint64_t micros);
+
+    /**
+     * Returns the inclusive lower bound, in microseconds, of 'bucket'.
+     */
+    static uint64_t lowerBound(int bucket);
+
+private:
+    std::array<AtomicWord<uint64_t>, kNumBuckets> _buckets{};
+    AtomicWord<uint64_t> _count{0};
+    AtomicWord<uint64_t> _sum{0};
+};
+
+}  // namespace mongo
@@ -0,0 +1,92 @@
+/**
+ *    Copyright (C) 2021-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/latency_histogram.h"
+
+namespace mongo {
+namespace {
+
+TEST(LatencyHistogramTest, BucketBoundaries) {
+    ASSERT_EQ(LatencyHistogram::bucketFor(0), 0);
+    ASSERT_EQ(LatencyHistogram::bucketFor(3), 3);
+    ASSERT_EQ(LatencyHistogram::bucketFor(4), 4);
+    ASSERT_EQ(LatencyHistogram::bucketFor(7), 7);
+    ASSERT_EQ(LatencyHistogram::bucketFor(8), 8);
+    ASSERT_EQ(LatencyHistogram::bucketFor(9), 8);
+    ASSERT_EQ(LatencyHistogram::bucketFor(10), 9);
+    ASSERT_EQ(LatencyHistogram::bucketFor(1ULL << 40), LatencyHistogram::kNumBuckets - 1);
+
+    // Every bucket's lower bound maps back to that bucket, and the value just below it maps to
+    // the previous bucket.
+    for (int i = 1; i < LatencyHistogram::kNumBuckets; ++i) {
+        auto lower = LatencyHistogram::lowerBound(i);
+        ASSERT_EQ(LatencyHistogram::bucketFor(lower), i);
+        ASSERT_EQ(LatencyHistogram::bucketFor(lower - 1), i - 1);
+    }
+}
+
+TEST(LatencyHistogramTest, RelativeErrorIsBounded) {
+    for (uint64_t micros = 4; micros < (1ULL << 32); micros = micros * 3 / 2 + 1) {
+        auto lower = LatencyHistogram::lowerBound(LatencyHistogram::bucketFor(micros));
+        ASSERT_LTE(lower, micros);
+        ASSERT_LTE(micros - lower, lower / LatencyHistogram::kSubBuckets);
+    }
+}
+
+TEST(LatencyHistogramTest, RecordAndAppend) {
+    LatencyHistogram histogram;
+    histogram.record(Microseconds(5));
+    histogram.record(Microseconds(5));
+    histogram.record(Milliseconds(2));
+    histogram.record(Microseconds(-1));
+
+    ASSERT_EQ(histogram.count(), 4U);
+    ASSERT_EQ(histogram.sum(), 2010U);
+    ASSERT_EQ(histogram.bucketCount(0), 1U);
+    ASSERT_EQ(histogram.bucketCount(LatencyHistogram::bucketFor(5)), 2U);
+    ASSERT_EQ(histogram.bucketCount(LatencyHistogram::bucketFor(2000)), 1U);
+
+    LatencyHistogram copy(histogram);
+    ASSERT_EQ(copy.count(), 4U);
+
+    BSONObjBuilder builder;
+    copy.append(&builder);
+    auto obj = builder.obj();
+    ASSERT_EQ(obj["count"].numberLong(), 4);
+    ASSERT_EQ(obj["sumMicros"].numberLong(), 2010);
+    ASSERT_EQ(obj["buckets"].Obj().nFields(), LatencyHistogram::kNumBuckets);
+}
+
+}  // namespace
+}  // namespace mongo
@@ -0,0 +1,199 @@
+/**
+ *    Copyright (C) 2021-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#pragma once
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+#include "mongo/util/assert_util.h"
+
+namespace mongo {
+
+/**
+ * A tournament tree of losers used to repeatedly select the smallest head element of a fixed set
+ * of sorted streams ("players") during a k-way merge.
+ *
+ * Players are identified by their index in [0, numPlayers()). The tree does not hold the streams
+ * itself; instead 'Comparator' is invoked as 'int operator()(size_t lhs, size_t rhs)' and must
+ * compare the current head elements of the two players, returning a value less than, equal to or
+ * greater than zero. A player is 'active' while its stream has a head element. Ties are broken in
+ * favour of the lower player index, so the merge is stable with respect to player order.
+ *
+ * Replacing the head of the winning player with replayTop() costs exactly one comparison per level
+ * of the tree, i.e. ceil(log2(numPlayers())), as opposed to the roughly 2*log2(k) comparisons a
+ * binary heap pays for a pop followed by a push. A player which becomes active while it is not the
+ * winner (for instance because a new batch arrived for an empty stream) invalidates the losers
+ * recorded along its path, so activate() schedules a full rebuild on the next call to top() or
+ * empty(); this costs numPlayers() - 1 comparisons and is expected to be rare relative to
+ * replayTop().
+ *
+ * This class is not thread safe.
+ */
+template <typename Comparator>
+class LoserTree {
+public:
+    explicit LoserTree(Comparator comparator, size_t numPlayers = 0)
+        : _comparator(std::move(comparator)) {
+        resize(numPlayers);
+    }
+
+    /**
+     * Changes the number of players to 'numPlayers'. Existing players keep their active state;
+     * newly added players start inactive.
+     */
+    void resize(size_t numPlayers) {
+        _active.resize(numPlayers, false);
+        _needsRebuild = true;
+    }
+
+    size_t numPlayers() const {
+        return _active.size();
+    }
+
+    /**
+     * Returns true if no player is active.
+     */
+    bool empty() {
+        _rebuildIfNeeded();
+        return _nodes.empty() || !_active[_nodes[0]];
+    }
+
+    /**
+     * Returns the index of the active player with the smallest head element. Invalid to call if
+     * empty() is true.
+     */
+    size_t top() {
+        _rebuildIfNeeded();
+        invariant(!_nodes.empty() && _active[_nodes[0]]);
+        return _nodes[0];
+    }
+
+    /**
+     * Marks 'player' as having a head element. Has no effect if the player is already active.
+     */
+    void activate(size_t player) {
+        invariant(player < _active.size());
+        if (!_active[player]) {
+            _active[player] = true;
+            _needsRebuild = true;
+        }
+    }
+
+    /**
+     * Must be called after the head element of the current winner (the player returned by top())
+     * has been consumed. 'stillActive' indicates whether the winning player has another head
+     * element; if not, it becomes inactive until the next call to activate().
+     */
+    void replayTop(bool stillActive) {
+        _rebuildIfNeeded();
+        invariant(!_nodes.empty());
+
+        size_t winner = _nodes[0];
+        invariant(_active[winner]);
+        _active[winner] = stillActive;
+
+        // Walk from the winner's leaf to the root, playing the new head element against the loser
+        // recorded at each internal node. Whoever wins the match proceeds upward.
+        const size_t numPlayers = _active.size();
+        for (size_t node = (numPlayers + winner) / 2; node > 0; node /= 2) {
+            if (_beats(_nodes[node], winner)) {
+                std::swap(_nodes[node], winner);
+            }
+        }
+        _nodes[0] = winner;
+    }
+
+private:
+    /**
+     * Returns true if 'lhs' should be ordered before 'rhs'. Inactive players lose every match.
+     */
+    bool _beats(size_t lhs, size_t rhs) {
+        if (!_active[lhs]) {
+            return false;
+        }
+        if (!_active[rhs]) {
+            return true;
+        }
+        const int cmp = _comparator(lhs, rhs);
+        return cmp < 0 || (cmp == 0 && lhs < rhs);
+    }
+
+    /**
+     * The tree is laid out as an implicit binary heap of 2 * numPlayers() - 1 nodes: internal nodes
+     * occupy positions [1, numPlayers()) and the leaf for player 'i' is position numPlayers() + i.
+     * Only internal nodes are materialized in '_nodes', each holding the loser of the match played
+     * there. '_nodes[0]' holds the overall winner.
+     */
+    void _rebuildIfNeeded() {
+        if (!_needsRebuild) {
+            return;
+        }
+        _needsRebuild = false;
+
+        const size_t numPlayers = _active.size();
+        _nodes.assign(numPlayers, 0);
+        if (numPlayers == 0) {
+            return;
+        }
+
+        _winners.assign(numPlayers, 0);
+        auto winnerAt = [&](size_t node) {
+            return node >= numPlayers ? node - numPlayers : _winners[node];
+        };
+        for (size_t node = numPlayers - 1; node > 0; --node) {
+            size_t left = winnerAt(2 * node);
+            size_t right = winnerAt(2 * node + 1);
+            if (_beats(right, left)) {
+                std::swap(left, right);
+            }
+            _winners[node] = left;
+            _nodes[node] = right;
+        }
+        _nodes[0] = numPlayers == 1 ? 0 : _winners[1];
+    }
+
+    Comparator _comparator;
+
+    // Whether each player currently has a head element.
+    std::vector<bool> _active;
+
+    // '_nodes[0]' is the overall winner; every other entry is the loser of the match played at
+    // that internal node.
+    std::vector<size_t> _nodes;
+
+    // Scratch space used while rebuilding, kept to avoid reallocating on every rebuild.
+    std::vector<size_t> _winners;
+
+    bool _needsRebuild = true;
+};
+
+}  // namespace mongo
@@ -0,0 +1,179 @@
+/**
+ *    Copyright (C) 2021-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include <algorithm>
+#include <deque>
+#include <vector>
+
+#include "mongo/platform/random.h"
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/loser_tree.h"
+
+namespace mongo {
+namespace {
+
+/**
+ * Merges the given sorted runs through a LoserTree and returns the (value, run index) pairs in the
+ * order in which the tree produced them.
+ */
+std::vector<std::pair<int, size_t>> mergeRuns(std::vector<std::deque<int>> runs) {
+    auto comparator = [&](size_t lhs, size_t rhs) {
+        return runs[lhs].front() - runs[rhs].front();
+    };
+    LoserTree<decltype(comparator)> tree(comparator, runs.size());
+    for (size_t i = 0; i < runs.size(); ++i) {
+        if (!runs[i].empty()) {
+            tree.activate(i);
+        }
+    }
+
+    std::vector<std::pair<int, size_t>> out;
+    while (!tree.empty()) {
+        auto winner = tree.top();
+        out.emplace_back(runs[winner].front(), winner);
+        runs[winner].pop_front();
+        tree.replayTop(!runs[winner].empty());
+    }
+    return out;
+}
+
+TEST(LoserTreeTest, EmptyTree) {
+    auto comparator = [](size_t, size_t) { return 0; };
+    LoserTree<decltype(comparator)> tree(comparator);
+    ASSERT_TRUE(tree.empty());
+    ASSERT_EQ(tree.numPlayers(), 0u);
+
+    tree.resize(3);
+    ASSERT_TRUE(tree.empty());
+}
+
+TEST(LoserTreeTest, SinglePlayer) {
+    auto out = mergeRuns({{1, 2, 3}});
+    ASSERT_EQ(out.size(), 3u);
+    for (size_t i = 0; i < out.size(); ++i) {
+        ASSERT_EQ(out[i].first, static_cast<int>(i + 1));
+    }
+}
+
+TEST(LoserTreeTest, MergesRunsOfVaryingLengths) {
+    auto out = mergeRuns({{1, 4, 9}, {}, {2, 3, 10, 11}, {0}, {5, 6, 7, 8}});
+    ASSERT_EQ(out.size(), 12u);
+    for (size_t i = 0; i < out.size(); ++i) {
+        ASSERT_EQ(out[i].first, static_cast<int>(i));
+    }
+}
+
+TEST(LoserTreeTest, TiesAreBrokenByPlayerIndex) {
+    auto out = mergeRuns({{1, 2}, {1, 2}, {1, 2}});
+    std::vector<std::pair<int, size_t>> expected = {{1, 0}, {1, 1}, {1, 2}, {2, 0}, {2, 1}, {2, 2}};
+    ASSERT_TRUE(out == expected);
+}
+
+TEST(LoserTreeTest, MatchesSortForRandomRuns) {
+    PseudoRandom prng(12345);
+    for (size_t numRuns : {2, 3, 5, 7, 8, 13, 64, 100}) {
+        std::vector<std::deque<int>> runs(numRuns);
+        std::vector<int> all;
+        for (auto&& run : runs) {
+            auto len = prng.nextInt32(20);
+            for (int i = 0; i < len; ++i) {
+                run.push_back(prng.nextInt32(50));
+            }
+            std::sort(run.begin(), run.end());
+            all.insert(all.end(), run.begin(), run.end());
+        }
+        std::sort(all.begin(), all.end());
+
+        auto out = mergeRuns(runs);
+        ASSERT_EQ(out.size(), all.size());
+        for (size_t i = 0; i < all.size(); ++i) {
+            ASSERT_EQ(out[i].first, all[i]);
+        }
+    }
+}
+
+TEST(LoserTreeTest, PlayerReactivatedAfterDraining) {
+    std::vector<std::deque<int>> runs = {{1, 5}, {2}, {3}};
+    auto comparator = [&](size_t lhs, size_t rhs) {
+        return runs[lhs].front() - runs[rhs].front();
+    };
+    LoserTree<decltype(comparator)> tree(comparator, runs.size());
+    for (size_t i = 0; i < runs.size(); ++i) {
+        tree.activate(i);
+    }
+
+    auto consumeTop = [&] {
+        auto winner = tree.top();
+        auto value = runs[winner].front();
+        runs[winner].pop_front();
+        tree.replayTop(!runs[winner].empty());
+        return value;
+    };
+
+    ASSERT_EQ(consumeTop(), 1);
+    ASSERT_EQ(consumeTop(), 2);
+
+    // Player 1 drained; give it a new head element which sorts before everything else.
+    runs[1].push_back(4);
+    tree.activate(1);
+    ASSERT_EQ(consumeTop(), 3);
+    ASSERT_EQ(consumeTop(), 4);
+    ASSERT_EQ(consumeTop(), 5);
+    ASSERT_TRUE(tree.empty());
+}
+
+TEST(LoserTreeTest, ResizeAddsInactivePlayers) {
+    std::vector<std::deque<int>> runs = {{2, 4}};
+    auto comparator = [&](size_t lhs, size_t rhs) {
+        return runs[lhs].front() - runs[rhs].front();
+    };
+    LoserTree<decltype(comparator)> tree(comparator, runs.size());
+    tree.activate(0);
+    ASSERT_EQ(tree.top(), 0u);
+
+    runs.push_back({1, 3});
+    tree.resize(runs.size());
+    ASSERT_EQ(tree.top(), 0u);
+
+    tree.activate(1);
+    std::vector<int> out;
+    while (!tree.empty()) {
+        auto winner = tree.top();
+        out.push_back(runs[winner].front());
+        runs[winner].pop_front();
+        tree.replayTop(!runs[winner].empty());
+    }
+    ASSERT_TRUE(out == std::vector<int>({1, 2, 3, 4}));
+}
+
+}  // namespace
+}  // namespace mongo
@@ -45,6 +45,7 @@
 
 #include "mongo/base/string_data.h"
 #include "mongo/logv2/log.h"
+#include "mongo/logv2/log_util.h"
 #include "mongo/platform/compiler.h"
 #include "mongo/stdx/exception.h"
 #include "mongo/stdx/thread.h"
@@ -94,6 +95,7 @@ int sehExceptionFilter(unsigned int code, struct _EXCEPTION_POINTERS* excPointer
 // exception and take the dump bypassing the unhandled exception handler.
 //
 void endProcessWithSignal(int signalNum) {
+    logv2::flushLogsBeforeExit();
 
     __try {
         RaiseException(STATUS_EXIT_ABRUPT, EXCEPTION_NONCONTINUABLE, 0, nullptr);
@@ -106,6 +108,8 @@ void endProcessWithSignal(int signalNum) {
 #else
 
 void endProcessWithSignal(int signalNum) {
+    logv2::flushLogsBeforeExit();
+
     // This works by restoring the system-default handler for the given signal and re-raising it, in
     // order to get the system default termination behavior (i.e., dumping core, or just exiting).
     struct sigaction defaultedSignals;
@@ -348,6 +352,7 @@ void reportOutOfMemoryErrorAndExit() {
     mallocFreeOStream << "out of memory.\n";
     writeMallocFreeStreamToLog();
     printStackTrace();
+    logv2::flushLogsBeforeExit();
     quickExit(EXIT_ABRUPT);
 }
 